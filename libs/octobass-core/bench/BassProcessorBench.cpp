@@ -0,0 +1,227 @@
+#include <benchmark/benchmark.h>
+
+#include <octobir-core/IRProcessor.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "BenchSupport.hpp"
+#include "octobass-core/BassProcessor.hpp"
+#include "octobass-core/Compressor.hpp"
+#include "octobass-core/Crossover.hpp"
+#include "octobass-core/GraphicEQ.hpp"
+#include "octobass-core/NamProcessor.hpp"
+#include "octobass-core/NoiseGate.hpp"
+
+using namespace octob;
+
+// Cost of each stage of BassProcessor::processMono in isolation and of the full chain,
+// on the same grid of sample rates and block sizes so the stages can be set against the
+// chain at each setting. Counters are ns_per_sample and rtf (see octobir-core's
+// BenchSupport.hpp); names and arguments are fixed so JSON from different commits can be
+// compared with Google Benchmark's tools/compare.py.
+
+namespace
+{
+
+const std::vector<int64_t> kSampleRates = {44100, 48000, 96000};
+const std::vector<int64_t> kBlockSizes = {64, 1024};
+const std::vector<int64_t> kActiveBandCounts = {0, 1, 6, 12, 24};
+
+const std::string kInputPath = std::string(TEST_DATA_DIR) + "/INPUT_amp_output_no_ir.wav";
+const std::string kIrPath = std::string(TEST_DATA_DIR) + "/INPUT_ir_a.wav";
+const std::string kModelPath = std::string(TEST_DATA_DIR) + "/INPUT_VHD.nam";
+
+constexpr float kSquash = 0.6f;
+constexpr float kGateOnThresholdDb = -50.0f;
+
+const char* const kCompressorModeNames[NumCompressionModes] = {"vca", "opto", "fet", "bus"};
+
+SampleRate rateArg(const benchmark::State& state)
+{
+  return static_cast<SampleRate>(state.range(0));
+}
+
+FrameCount blockArg(const benchmark::State& state)
+{
+  return static_cast<FrameCount>(state.range(1));
+}
+
+// Boosts `count` bands spread evenly over the 24, alternating +/-6 dB.
+void setActiveBands(GraphicEQ& eq, int count)
+{
+  for (int i = 0; i < count; ++i)
+    eq.setBandGain(i * kGraphicEQNumBands / count, i % 2 ? -6.0f : 6.0f);
+}
+
+// Runs processBlock(input, output, numFrames) over the looped tests/data DI, after a short
+// untimed warm-up, and reports throughput.
+template <typename ProcessBlock>
+void runStage(benchmark::State& state, SampleRate sampleRate, FrameCount blockSize,
+              ProcessBlock processBlock)
+{
+  LoopedSignal signal;
+  if (!signal.load(kInputPath, blockSize))
+  {
+    state.SkipWithError("could not read tests/data/INPUT_amp_output_no_ir.wav");
+    return;
+  }
+
+  std::vector<float> output(blockSize);
+  for (FrameCount done = 0; done < 8192; done += blockSize)
+  {
+    processBlock(signal.at(0), output.data(), blockSize);
+    signal.advance(blockSize);
+  }
+
+  const ThroughputTimer timer;
+  for (auto _ : state)
+  {
+    processBlock(signal.at(0), output.data(), blockSize);
+    signal.advance(blockSize);
+    benchmark::DoNotOptimize(output.data());
+    benchmark::ClobberMemory();
+  }
+  timer.report(state, blockSize, sampleRate);
+}
+
+void BM_GraphicEQ(benchmark::State& state)
+{
+  GraphicEQ eq;
+  eq.setSampleRate(rateArg(state));
+  setActiveBands(eq, static_cast<int>(state.range(2)));
+  runStage(state, rateArg(state), blockArg(state),
+           [&](const float* in, float* out, FrameCount n) { eq.process(in, out, n); });
+}
+
+void BM_Crossover(benchmark::State& state)
+{
+  Crossover crossover;
+  crossover.setSampleRate(rateArg(state));
+  std::vector<float> high(blockArg(state));
+  runStage(state, rateArg(state), blockArg(state),
+           [&](const float* in, float* out, FrameCount n)
+           { crossover.process(in, out, high.data(), n); });
+}
+
+void runCompressor(benchmark::State& state, int mode)
+{
+  Compressor compressor;
+  compressor.setSampleRate(rateArg(state));
+  compressor.setMode(mode);
+  compressor.setSquash(kSquash);
+  runStage(state, rateArg(state), blockArg(state),
+           [&](const float* in, float* out, FrameCount n) { compressor.process(in, out, n); });
+}
+
+void runNoiseGate(benchmark::State& state, bool enabled)
+{
+  NoiseGate gate;
+  gate.setSampleRate(rateArg(state));
+  gate.setThresholdDb(enabled ? kGateOnThresholdDb : DefaultGateThresholdDb);
+  runStage(state, rateArg(state), blockArg(state),
+           [&](const float* in, float* out, FrameCount n) { gate.process(in, in, out, n); });
+}
+
+void BM_Nam(benchmark::State& state)
+{
+  NamProcessor nam;
+  nam.setSampleRate(rateArg(state));
+  nam.setMaxBlockSize(blockArg(state));
+  std::string error;
+  if (!nam.loadModel(kModelPath, error))
+  {
+    state.SkipWithError(error.c_str());
+    return;
+  }
+  runStage(state, rateArg(state), blockArg(state),
+           [&](const float* in, float* out, FrameCount n) { nam.process(in, out, n); });
+}
+
+// The high band's IR stage: IRProcessor's mono path with BassProcessor's default engine.
+void BM_IR(benchmark::State& state)
+{
+  IRProcessor ir;
+  ir.setSampleRate(rateArg(state));
+  ir.setMaxBlockSize(blockArg(state));
+  std::string error;
+  if (!ir.loadImpulseResponse1(kIrPath, error))
+  {
+    state.SkipWithError(error.c_str());
+    return;
+  }
+  runStage(state, rateArg(state), blockArg(state),
+           [&](const float* in, float* out, FrameCount n) { ir.processMono(in, out, n); });
+}
+
+// Every stage active: EQ, NAM, IR, high band blend, compressor, gate and dry/wet mix.
+void BM_Chain(benchmark::State& state)
+{
+  BassProcessor proc;
+  proc.setSampleRate(rateArg(state));
+  proc.setMaxBlockSize(blockArg(state));
+  std::string error;
+  if (!proc.loadImpulseResponse(kIrPath, error) || !proc.loadNamModel(kModelPath, error))
+  {
+    state.SkipWithError(error.c_str());
+    return;
+  }
+  for (int i = 0; i < 6; ++i)
+    proc.setGraphicEQBandGain(i * kGraphicEQNumBands / 6, i % 2 ? -6.0f : 6.0f);
+  proc.setSquash(kSquash);
+  proc.setGateThreshold(kGateOnThresholdDb);
+  proc.setHighBandMix(0.8f);
+  proc.setDryWetMix(0.9f);
+  runStage(state, rateArg(state), blockArg(state),
+           [&](const float* in, float* out, FrameCount n) { proc.processMono(in, out, n); });
+}
+
+// Sample rate and block size first in every benchmark, so rows line up across stages.
+void applyGrid(benchmark::internal::Benchmark* bench)
+{
+  bench->ArgNames({"rate", "block"})
+      ->ArgsProduct({kSampleRates, kBlockSizes})
+      ->Unit(benchmark::kMicrosecond);
+}
+
+void registerBenchmarks()
+{
+  benchmark::RegisterBenchmark("GraphicEQ", BM_GraphicEQ)
+      ->ArgNames({"rate", "block", "bands"})
+      ->ArgsProduct({kSampleRates, kBlockSizes, kActiveBandCounts})
+      ->Unit(benchmark::kMicrosecond);
+  applyGrid(benchmark::RegisterBenchmark("Crossover", BM_Crossover));
+
+  for (int mode = 0; mode < NumCompressionModes; ++mode)
+  {
+    const std::string name = std::string("Compressor/") + kCompressorModeNames[mode];
+    applyGrid(benchmark::RegisterBenchmark(name.c_str(), [mode](benchmark::State& state)
+                                           { runCompressor(state, mode); }));
+  }
+
+  applyGrid(benchmark::RegisterBenchmark("NoiseGate/off", [](benchmark::State& state)
+                                         { runNoiseGate(state, false); }));
+  applyGrid(benchmark::RegisterBenchmark("NoiseGate/on", [](benchmark::State& state)
+                                         { runNoiseGate(state, true); }));
+  applyGrid(benchmark::RegisterBenchmark("Nam", BM_Nam));
+  applyGrid(benchmark::RegisterBenchmark("IR", BM_IR));
+  applyGrid(benchmark::RegisterBenchmark("Chain", BM_Chain));
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv))
+    return 1;
+
+  benchmark::AddCustomContext("octobass_nam_model", "INPUT_VHD.nam");
+  benchmark::AddCustomContext("octobass_ir", "INPUT_ir_a.wav");
+  registerBenchmarks();
+
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
@@ -1,6 +1,10 @@
 #pragma once
 
+#include <octobir-core/DelayLine.hpp>
+#include <octobir-core/ForkJoinWorker.hpp>
 #include <octobir-core/IRProcessor.hpp>
+#include <octobir-core/SilenceDetector.hpp>
+#include <atomic>
 #include <string>
 #include <vector>
 
@@ -28,6 +32,12 @@ class BassProcessor
   void clearImpulseResponse();
   bool isIRLoaded() const;
   std::string getCurrentIRPath() const;
+  // Prepares IR files in the background so a later load of one of them is a swap; see
+  // IRProcessor::prefetchImpulseResponses().
+  void prefetchImpulseResponses(const std::vector<std::string>& filepaths);
+  // Convolution engine for the IR, Auto by default
+  void setIREngine(ConvolutionEngineType type);
+  ConvolutionEngineType getIREngine() const { return irProcessor_.getIRAEngine(); }
 
   // NAM model loading
   bool loadNamModel(const std::string& filepath, std::string& errorMessage);
@@ -68,8 +78,21 @@ class BassProcessor
 
   void reset();
 
+  // Non-realtime rendering: the IR leaves zero-latency mode for IRProcessor's render
+  // engines, with the low band delayed to match, and while the compressor is on it runs
+  // on a helper thread alongside the high band chain.
+  void setRenderMode(bool enabled);
+  bool getRenderMode() const { return irProcessor_.getRenderMode(); }
+
   // Queries
   int getLatencySamples() const;
+  // Latency once pending IR engine changes are picked up; see IRProcessor.
+  int getStagedLatencySamples() const { return irProcessor_.getStagedLatencySamples(); }
+  // Samples of output that follow the last non-silent input: the IR's tail, an allowance
+  // for the NAM model's receptive field and time for the filters to ring out. Once the
+  // input has been silent that long, processMono() outputs silence without running the
+  // chain until signal returns.
+  int getTailLengthSamples() const;
   float getCrossoverFrequency() const { return crossover_.getFrequency(); }
   float getSquash() const { return compressor_.getSquash(); }
   int getCompressionMode() const { return compressor_.getMode(); }
@@ -91,16 +114,24 @@ class BassProcessor
   IRProcessor irProcessor_;
   NoiseGate noiseGate_;
 
+  // Render mode's helper thread for the low band, and whether the audio thread uses it.
+  ForkJoinWorker bandWorker_;
+  std::atomic<bool> parallelBands_{false};
+
+  SilenceDetector silence_;
+  std::atomic<bool> namModelLoaded_{false};
+  int namTailSamples_;
+  int settleTailSamples_;
+
   std::vector<Sample> eqBuffer_;
   std::vector<Sample> lowBandBuffer_;
   std::vector<Sample> highBandBuffer_;
   std::vector<Sample> dryBuffer_;
   std::vector<Sample> dryHighBandBuffer_;
-  std::vector<Sample> delayedLowBuffer_;
 
-  // Delay compensation for low band path
-  std::vector<Sample> lowBandDelayBuffer_;
-  size_t lowBandDelayWritePos_;
+  // Delay compensation for low band path, allocated in setMaxBlockSize() for the largest
+  // latency the IR engine can report. Bypassed while the IR adds no latency.
+  DelayLine lowBandDelay_;
   int currentIRLatency_;
 
   float lowBandLevelDb_;
@@ -124,15 +155,11 @@ class BassProcessor
   std::string currentIRPath_;
   std::string currentNamModelPath_;
 
-  void updateDelayBuffer();
+  void processHighBand(FrameCount numFrames);
+  void compressLowBand(FrameCount numFrames);
 
   static float clamp(float value, float minVal, float maxVal);
   static float dbToLinear(float db);
-
-  static void writeToDelayBuffer(std::vector<Sample>& buffer, size_t& writePos, const Sample* input,
-                                 FrameCount numFrames);
-  static void readFromDelayBuffer(const std::vector<Sample>& buffer, size_t writePos,
-                                  Sample* output, FrameCount numFrames, int delaySamples);
 };
 
 }  // namespace octob
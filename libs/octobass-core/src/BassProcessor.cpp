@@ -1,5 +1,7 @@
 #include "octobass-core/BassProcessor.hpp"
 
+#include <octobir-core/ConvolutionEngine.hpp>
+
 #include <algorithm>
 #include <cmath>
 #include <cstring>
@@ -7,8 +9,23 @@
 namespace octob
 {
 
+namespace
+{
+// NAM's receptive field is not exposed by its API; this covers the standard WaveNet
+// architectures (about 4k samples at 48 kHz) with room to spare.
+constexpr float kNamTailMs = 200.0f;
+// Time for the EQ, crossover and gate to ring out below the silence threshold.
+constexpr float kSettleTailMs = 200.0f;
+
+int msToSamples(float ms, SampleRate sampleRate)
+{
+  return static_cast<int>(std::ceil(ms * 0.001 * sampleRate));
+}
+}  // namespace
+
 BassProcessor::BassProcessor()
-    : lowBandDelayWritePos_(0),
+    : namTailSamples_(msToSamples(kNamTailMs, 44100.0)),
+      settleTailSamples_(msToSamples(kSettleTailMs, 44100.0)),
       currentIRLatency_(0),
       lowBandLevelDb_(DefaultBandLevelDb),
       highInputGainDb_(DefaultHighInputGainDb),
@@ -31,6 +48,8 @@ BassProcessor::BassProcessor()
   irProcessor_.setBlend(-1.0f);  // 100% IR A
   irProcessor_.setDynamicModeEnabled(false);
   irProcessor_.setOutputGain(0.0f);
+  // Zero-latency convolution keeps the low band aligned without a compensation delay
+  irProcessor_.setZeroLatencyMode(true);
 }
 
 BassProcessor::~BassProcessor() = default;
@@ -43,6 +62,8 @@ void BassProcessor::setSampleRate(SampleRate sampleRate)
   namProcessor_.setSampleRate(sampleRate);
   irProcessor_.setSampleRate(sampleRate);
   noiseGate_.setSampleRate(sampleRate);
+  namTailSamples_ = msToSamples(kNamTailMs, sampleRate);
+  settleTailSamples_ = msToSamples(kSettleTailMs, sampleRate);
 
   // 5ms smoothing on static makeup gain to prevent clicks during parameter changes
   constexpr float kMakeupSmoothMs = 5.0f;
@@ -57,10 +78,13 @@ void BassProcessor::setMaxBlockSize(FrameCount maxBlockSize)
   highBandBuffer_.resize(maxBlockSize, 0.0f);
   dryBuffer_.resize(maxBlockSize, 0.0f);
   dryHighBandBuffer_.resize(maxBlockSize, 0.0f);
-  delayedLowBuffer_.resize(maxBlockSize, 0.0f);
   namProcessor_.setMaxBlockSize(maxBlockSize);
   irProcessor_.setMaxBlockSize(maxBlockSize);
-  updateDelayBuffer();
+
+  // Room for the largest latency the IR engine can report plus one block, so a latency
+  // change on the audio thread never reallocates.
+  lowBandDelay_.allocate(static_cast<size_t>(ConvolutionEngine::MaxLatencySamples),
+                         maxBlockSize);
 }
 
 bool BassProcessor::loadImpulseResponse(const std::string& filepath, std::string& errorMessage)
@@ -73,13 +97,15 @@ bool BassProcessor::loadImpulseResponse(const std::string& filepath, std::string
   return false;
 }
 
+void BassProcessor::prefetchImpulseResponses(const std::vector<std::string>& filepaths)
+{
+  irProcessor_.prefetchImpulseResponses(1, filepaths);
+}
+
 void BassProcessor::clearImpulseResponse()
 {
   irProcessor_.clearImpulseResponse1();
   currentIRPath_.clear();
-  currentIRLatency_ = 0;
-  lowBandDelayBuffer_.clear();
-  lowBandDelayWritePos_ = 0;
 }
 
 bool BassProcessor::isIRLoaded() const
@@ -92,11 +118,17 @@ std::string BassProcessor::getCurrentIRPath() const
   return currentIRPath_;
 }
 
+void BassProcessor::setIREngine(ConvolutionEngineType type)
+{
+  irProcessor_.setIRAEngine(type);
+}
+
 bool BassProcessor::loadNamModel(const std::string& filepath, std::string& errorMessage)
 {
   if (namProcessor_.loadModel(filepath, errorMessage))
   {
     currentNamModelPath_ = filepath;
+    namModelLoaded_.store(true, std::memory_order_relaxed);
     return true;
   }
   return false;
@@ -106,6 +138,7 @@ void BassProcessor::clearNamModel()
 {
   namProcessor_.clearModel();
   currentNamModelPath_.clear();
+  namModelLoaded_.store(false, std::memory_order_relaxed);
 }
 
 bool BassProcessor::isNamModelLoaded() const
@@ -197,6 +230,22 @@ void BassProcessor::processMono(const Sample* input, Sample* output, FrameCount
   if (numFrames == 0)
     return;
 
+  // Once the input has been silent for longer than the tail, nothing is left to output.
+  // The compressor and gate restart as they would settle after a long silence, so the
+  // chain wakes the same however long it slept.
+  const bool wasIdle = silence_.isIdle();
+  silence_.setTailSamples(static_cast<FrameCount>(getTailLengthSamples()));
+  if (silence_.skip(SilenceDetector::isSilent(input, numFrames), numFrames))
+  {
+    if (!wasIdle)
+    {
+      compressor_.reset();
+      noiseGate_.reset();
+    }
+    std::fill(output, output + numFrames, 0.0f);
+    return;
+  }
+
   // Save dry input for dry/wet blend
   std::copy(input, input + numFrames, dryBuffer_.data());
 
@@ -206,6 +255,75 @@ void BassProcessor::processMono(const Sample* input, Sample* output, FrameCount
   // Split into low and high bands
   crossover_.process(eqBuffer_.data(), lowBandBuffer_.data(), highBandBuffer_.data(), numFrames);
 
+  // Compression and its static makeup do not depend on the high band, so in render mode
+  // the low band is compressed on the helper thread while this one runs the high band
+  // chain, and delayed to match the IR afterwards instead of before.
+  const bool compress = compressor_.getSquash() > 0.0f;
+  const bool parallelBands = compress && parallelBands_.load(std::memory_order_relaxed);
+  struct LowBandJob
+  {
+    BassProcessor* processor;
+    FrameCount numFrames;
+  };
+  LowBandJob lowBandJob = {this, numFrames};
+  if (parallelBands)
+    bandWorker_.fork(
+        [](void* context)
+        {
+          const LowBandJob& job = *static_cast<const LowBandJob*>(context);
+          job.processor->compressLowBand(job.numFrames);
+        },
+        &lowBandJob);
+
+  processHighBand(numFrames);
+
+  if (parallelBands)
+    bandWorker_.join();
+
+  // Update latency compensation if IR latency changed; the old delay's contents would
+  // play back misaligned, so the line starts over from silence.
+  int irLatency = irProcessor_.getLatencySamples();
+  if (irLatency != currentIRLatency_)
+  {
+    currentIRLatency_ = irLatency;
+    if (lowBandDelay_.getCapacity() > 0)
+      lowBandDelay_.clear();
+  }
+
+  // Apply delay compensation to low band. The block is in the line once written, so it
+  // can be read back over itself.
+  if (currentIRLatency_ > 0 && lowBandDelay_.getCapacity() > 0)
+  {
+    lowBandDelay_.write(lowBandBuffer_.data(), numFrames);
+    lowBandDelay_.read(lowBandBuffer_.data(), numFrames,
+                       static_cast<size_t>(currentIRLatency_));
+  }
+
+  // Apply compression to low band (skip entirely when squash is off)
+  if (compress && !parallelBands)
+    compressLowBand(numFrames);
+
+  // Apply band levels, sum, and output gain into highBandBuffer_ (reused as scratch)
+  // Solo: include a band if it's soloed, or if the other band is NOT soloed (normal mode)
+  bool includeLow = lowBandSolo_ || !highBandSolo_;
+  bool includeHigh = highBandSolo_ || !lowBandSolo_;
+  for (FrameCount i = 0; i < numFrames; ++i)
+  {
+    float low = includeLow ? lowBandBuffer_[i] * lowBandLevelLinear_ : 0.0f;
+    float high = includeHigh ? highBandBuffer_[i] : 0.0f;
+    highBandBuffer_[i] = (low + high) * outputGainLinear_;
+  }
+
+  // Noise gate: key signal is the clean pre-split input, applied to the wet sum
+  noiseGate_.process(dryBuffer_.data(), highBandBuffer_.data(), highBandBuffer_.data(), numFrames);
+
+  // Dry/wet blend
+  for (FrameCount i = 0; i < numFrames; ++i)
+    output[i] = dryBuffer_[i] * (1.0f - dryWetMix_) + highBandBuffer_[i] * dryWetMix_;
+}
+
+void BassProcessor::processHighBand(FrameCount numFrames)
+{
   // Save dry high band for wet/dry blend before any processing
   if (highBandMix_ < 1.0f)
     std::copy(highBandBuffer_.data(), highBandBuffer_.data() + numFrames,
@@ -235,58 +353,20 @@ void BassProcessor::processMono(const Sample* input, Sample* output, FrameCount
     for (FrameCount i = 0; i < numFrames; ++i)
       highBandBuffer_[i] = dryHighBandBuffer_[i] * dry + highBandBuffer_[i] * wet;
   }
+}
 
-  // Update latency compensation if IR latency changed
-  int irLatency = irProcessor_.getLatencySamples();
-  if (irLatency != currentIRLatency_)
-  {
-    currentIRLatency_ = irLatency;
-    updateDelayBuffer();
-  }
-
-  // Apply delay compensation to low band
-  if (currentIRLatency_ > 0 && !lowBandDelayBuffer_.empty())
-  {
-    Sample* delayedLow = delayedLowBuffer_.data();
-    writeToDelayBuffer(lowBandDelayBuffer_, lowBandDelayWritePos_, lowBandBuffer_.data(),
-                       numFrames);
-    readFromDelayBuffer(lowBandDelayBuffer_, lowBandDelayWritePos_, delayedLow, numFrames,
-                        currentIRLatency_);
-    std::copy(delayedLow, delayedLow + numFrames, lowBandBuffer_.data());
-  }
-
-  // Apply compression to low band (skip entirely when squash is off)
-  if (compressor_.getSquash() > 0.0f)
-  {
-    compressor_.process(lowBandBuffer_.data(), lowBandBuffer_.data(), numFrames);
-
-    // Static makeup gain: compensate level based on compressor parameters, not signal.
-    // Smoothed over 5ms to prevent clicks during parameter changes.
-    float targetMakeupLinear = dbToLinear(compressor_.getStaticMakeupDb());
-    for (FrameCount i = 0; i < numFrames; ++i)
-    {
-      currentMakeupLinear_ += (targetMakeupLinear - currentMakeupLinear_) * makeupSmoothCoeff_;
-      lowBandBuffer_[i] *= currentMakeupLinear_;
-    }
-  }
+void BassProcessor::compressLowBand(FrameCount numFrames)
+{
+  compressor_.process(lowBandBuffer_.data(), lowBandBuffer_.data(), numFrames);
 
-  // Apply band levels, sum, and output gain into highBandBuffer_ (reused as scratch)
-  // Solo: include a band if it's soloed, or if the other band is NOT soloed (normal mode)
-  bool includeLow = lowBandSolo_ || !highBandSolo_;
-  bool includeHigh = highBandSolo_ || !lowBandSolo_;
+  // Static makeup gain: compensate level based on compressor parameters, not signal.
+  // Smoothed over 5ms to prevent clicks during parameter changes.
+  float targetMakeupLinear = dbToLinear(compressor_.getStaticMakeupDb());
   for (FrameCount i = 0; i < numFrames; ++i)
   {
-    float low = includeLow ? lowBandBuffer_[i] * lowBandLevelLinear_ : 0.0f;
-    float high = includeHigh ? highBandBuffer_[i] : 0.0f;
-    highBandBuffer_[i] = (low + high) * outputGainLinear_;
+    currentMakeupLinear_ += (targetMakeupLinear - currentMakeupLinear_) * makeupSmoothCoeff_;
+    lowBandBuffer_[i] *= currentMakeupLinear_;
   }
-
-  // Noise gate: key signal is the clean pre-split input, applied to the wet sum
-  noiseGate_.process(dryBuffer_.data(), highBandBuffer_.data(), highBandBuffer_.data(), numFrames);
-
-  // Dry/wet blend
-  for (FrameCount i = 0; i < numFrames; ++i)
-    output[i] = dryBuffer_[i] * (1.0f - dryWetMix_) + highBandBuffer_[i] * dryWetMix_;
 }
 
 void BassProcessor::reset()
@@ -304,10 +384,19 @@ void BassProcessor::reset()
   std::fill(highBandBuffer_.begin(), highBandBuffer_.end(), 0.0f);
   std::fill(dryBuffer_.begin(), dryBuffer_.end(), 0.0f);
   std::fill(dryHighBandBuffer_.begin(), dryHighBandBuffer_.end(), 0.0f);
-  std::fill(delayedLowBuffer_.begin(), delayedLowBuffer_.end(), 0.0f);
-  std::fill(lowBandDelayBuffer_.begin(), lowBandDelayBuffer_.end(), 0.0f);
-  lowBandDelayWritePos_ = 0;
+  if (lowBandDelay_.getCapacity() > 0)
+    lowBandDelay_.clear();
   currentIRLatency_ = 0;
+  silence_.reset();
+}
+
+void BassProcessor::setRenderMode(bool enabled)
+{
+  if (enabled)
+    bandWorker_.start();
+  parallelBands_.store(enabled, std::memory_order_relaxed);
+  irProcessor_.setRenderMode(enabled);
+  irProcessor_.setZeroLatencyMode(!enabled);
 }
 
 int BassProcessor::getLatencySamples() const
@@ -315,21 +404,11 @@ int BassProcessor::getLatencySamples() const
   return irProcessor_.getLatencySamples();
 }
 
-void BassProcessor::updateDelayBuffer()
+int BassProcessor::getTailLengthSamples() const
 {
-  if (currentIRLatency_ > 0)
-  {
-    size_t bufferSize = static_cast<size_t>(currentIRLatency_) + lowBandBuffer_.size();
-    if (lowBandDelayBuffer_.size() < bufferSize)
-    {
-      lowBandDelayBuffer_.resize(bufferSize, 0.0f);
-    }
-  }
-  else
-  {
-    lowBandDelayBuffer_.clear();
-    lowBandDelayWritePos_ = 0;
-  }
+  return irProcessor_.getTailLengthSamples() +
+         (namModelLoaded_.load(std::memory_order_relaxed) ? namTailSamples_ : 0) +
+         settleTailSamples_;
 }
 
 float BassProcessor::clamp(float value, float minVal, float maxVal)
@@ -342,28 +421,4 @@ float BassProcessor::dbToLinear(float db)
   return std::exp2(db * 0.16609640474f);
 }
 
-void BassProcessor::writeToDelayBuffer(std::vector<Sample>& buffer, size_t& writePos,
-                                       const Sample* input, FrameCount numFrames)
-{
-  const size_t bufferSize = buffer.size();
-  for (FrameCount i = 0; i < numFrames; ++i)
-  {
-    buffer[writePos] = input[i];
-    writePos = (writePos + 1) % bufferSize;
-  }
-}
-
-void BassProcessor::readFromDelayBuffer(const std::vector<Sample>& buffer, size_t writePos,
-                                        Sample* output, FrameCount numFrames, int delaySamples)
-{
-  const size_t bufferSize = buffer.size();
-  size_t readPos =
-      (writePos + bufferSize - numFrames - static_cast<size_t>(delaySamples)) % bufferSize;
-  for (FrameCount i = 0; i < numFrames; ++i)
-  {
-    output[i] = buffer[readPos];
-    readPos = (readPos + 1) % bufferSize;
-  }
-}
-
 }  // namespace octob
@@ -7,10 +7,12 @@
 #include <NAM/lstm.h>
 #include <NAM/wavenet.h>
 
+#include <octobir-core/RealtimeHandoff.hpp>
+
 #include <algorithm>
-#include <atomic>
 #include <cstddef>
 #include <filesystem>
+#include <mutex>
 #include <stdexcept>
 #include <vector>
 
@@ -53,42 +55,45 @@ namespace octob
 
 struct NamProcessor::Impl
 {
-  // Active model, only touched by the audio thread (after initial setup)
-  std::unique_ptr<nam::DSP> model;
+  struct Model
+  {
+    std::unique_ptr<nam::DSP> dsp;  // null passes audio through
+  };
+
+  // Models are prepared on the control side and handed to the audio thread without
+  // locks. The one a new model replaces is parked by process() and freed here on the
+  // next load or clear, so the audio thread never frees a model.
+  RealtimeHandoff<Model> models;
+  nam::DSP* active = nullptr;  // audio thread's view of models.get()
+
+  // Control-side state, serialized by controlMutex. The getters answer from here so they
+  // never read what the audio thread owns.
+  std::mutex controlMutex;
   std::string modelPath;
+  double expectedSampleRate = 0.0;
+  bool modelLoaded = false;
+
   double sampleRate = 44100.0;
   int maxBlockSize = 0;
   std::vector<NAM_SAMPLE> inputBuffer;
   std::vector<NAM_SAMPLE> outputBuffer;
 
-  // Thread-safe model swap: message thread stages a fully-prepared model here,
-  // audio thread picks it up at the start of the next process() call.
-  std::unique_ptr<nam::DSP> pendingModel;
-  std::string pendingModelPath;
-  std::atomic<bool> hasPendingModel{false};
-  std::atomic<bool> pendingClear{false};
-
-  void resetModel()
+  // Audio thread, at the start of each block.
+  void acquireModel()
   {
-    if (model && maxBlockSize > 0)
-    {
-      model->ResetAndPrewarm(sampleRate, maxBlockSize);
-    }
+    if (models.acquire())
+      active = models.get()->dsp.get();
   }
 
-  void consumePending()
+  // Called with controlMutex held, from the calls that are not concurrent with process()
+  // (sample rate, block size and reset), so the model in use can be prewarmed directly.
+  void resetModel()
   {
-    if (pendingClear.load(std::memory_order_acquire))
-    {
-      model.reset();
-      modelPath.clear();
-      pendingClear.store(false, std::memory_order_release);
-    }
-    if (hasPendingModel.load(std::memory_order_acquire))
+    acquireModel();
+    models.collect();
+    if (active && maxBlockSize > 0)
     {
-      model = std::move(pendingModel);
-      modelPath = std::move(pendingModelPath);
-      hasPendingModel.store(false, std::memory_order_release);
+      active->ResetAndPrewarm(sampleRate, maxBlockSize);
     }
   }
 };
@@ -113,14 +118,19 @@ bool NamProcessor::loadModel(const std::string& filepath, std::string& errorMess
       return false;
     }
 
+    std::lock_guard<std::mutex> lock(impl_->controlMutex);
     if (impl_->maxBlockSize > 0)
     {
       newModel->ResetAndPrewarm(impl_->sampleRate, impl_->maxBlockSize);
     }
 
-    impl_->pendingModel = std::move(newModel);
-    impl_->pendingModelPath = filepath;
-    impl_->hasPendingModel.store(true, std::memory_order_release);
+    impl_->expectedSampleRate = newModel->GetExpectedSampleRate();
+    impl_->modelPath = filepath;
+    impl_->modelLoaded = true;
+
+    auto model = std::make_unique<Impl::Model>();
+    model->dsp = std::move(newModel);
+    impl_->models.publish(std::move(model));
 
     return true;
   }
@@ -133,38 +143,35 @@ bool NamProcessor::loadModel(const std::string& filepath, std::string& errorMess
 
 void NamProcessor::clearModel()
 {
-  impl_->hasPendingModel.store(false, std::memory_order_release);
-  impl_->pendingModel.reset();
-  impl_->pendingModelPath.clear();
-  impl_->pendingClear.store(true, std::memory_order_release);
+  std::lock_guard<std::mutex> lock(impl_->controlMutex);
+  impl_->expectedSampleRate = 0.0;
+  impl_->modelPath.clear();
+  impl_->modelLoaded = false;
+  impl_->models.publish(std::make_unique<Impl::Model>());
 }
 
 bool NamProcessor::isModelLoaded() const
 {
-  if (impl_->pendingClear.load(std::memory_order_acquire))
-    return false;
-  if (impl_->hasPendingModel.load(std::memory_order_acquire))
-    return true;
-  return impl_->model != nullptr;
+  std::lock_guard<std::mutex> lock(impl_->controlMutex);
+  return impl_->modelLoaded;
 }
 
 std::string NamProcessor::getCurrentModelPath() const
 {
-  if (impl_->pendingClear.load(std::memory_order_acquire))
-    return {};
-  if (impl_->hasPendingModel.load(std::memory_order_acquire))
-    return impl_->pendingModelPath;
+  std::lock_guard<std::mutex> lock(impl_->controlMutex);
   return impl_->modelPath;
 }
 
 void NamProcessor::setSampleRate(double sampleRate)
 {
+  std::lock_guard<std::mutex> lock(impl_->controlMutex);
   impl_->sampleRate = sampleRate;
   impl_->resetModel();
 }
 
 void NamProcessor::setMaxBlockSize(size_t maxBlockSize)
 {
+  std::lock_guard<std::mutex> lock(impl_->controlMutex);
   impl_->maxBlockSize = static_cast<int>(maxBlockSize);
   impl_->inputBuffer.resize(maxBlockSize);
   impl_->outputBuffer.resize(maxBlockSize);
@@ -173,9 +180,10 @@ void NamProcessor::setMaxBlockSize(size_t maxBlockSize)
 
 void NamProcessor::process(const float* input, float* output, size_t numFrames)
 {
-  impl_->consumePending();
+  impl_->acquireModel();
+  nam::DSP* model = impl_->active;
 
-  if (!impl_->model || numFrames == 0)
+  if (!model || numFrames == 0)
   {
     if (input != output)
     {
@@ -188,7 +196,7 @@ void NamProcessor::process(const float* input, float* output, size_t numFrames)
   // NAM_SAMPLE is float, can use buffers directly with pointer indirection
   NAM_SAMPLE* inPtr = const_cast<NAM_SAMPLE*>(input);
   NAM_SAMPLE* outPtr = output;
-  impl_->model->process(&inPtr, &outPtr, static_cast<int>(numFrames));
+  model->process(&inPtr, &outPtr, static_cast<int>(numFrames));
 #else
   // NAM_SAMPLE is double, need conversion buffers
   auto& inBuf = impl_->inputBuffer;
@@ -199,7 +207,7 @@ void NamProcessor::process(const float* input, float* output, size_t numFrames)
 
   NAM_SAMPLE* inPtr = inBuf.data();
   NAM_SAMPLE* outPtr = outBuf.data();
-  impl_->model->process(&inPtr, &outPtr, static_cast<int>(numFrames));
+  model->process(&inPtr, &outPtr, static_cast<int>(numFrames));
 
   for (size_t i = 0; i < numFrames; ++i)
     output[i] = static_cast<float>(outBuf[i]);
@@ -208,6 +216,7 @@ void NamProcessor::process(const float* input, float* output, size_t numFrames)
 
 void NamProcessor::reset()
 {
+  std::lock_guard<std::mutex> lock(impl_->controlMutex);
   impl_->resetModel();
 }
 
@@ -218,11 +227,8 @@ int NamProcessor::getLatencySamples() const
 
 double NamProcessor::getExpectedSampleRate() const
 {
-  if (impl_->hasPendingModel.load(std::memory_order_acquire) && impl_->pendingModel)
-    return impl_->pendingModel->GetExpectedSampleRate();
-  if (impl_->model)
-    return impl_->model->GetExpectedSampleRate();
-  return 0.0;
+  std::lock_guard<std::mutex> lock(impl_->controlMutex);
+  return impl_->expectedSampleRate;
 }
 
 }  // namespace octob
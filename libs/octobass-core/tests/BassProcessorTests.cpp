@@ -268,6 +268,95 @@ TEST_F(BassProcessorTest, LatencyReporting)
   EXPECT_EQ(proc.getLatencySamples(), 0);
 }
 
+TEST_F(BassProcessorTest, IREngineSelection)
+{
+  EXPECT_EQ(proc.getIREngine(), ConvolutionEngineType::Auto);
+
+  proc.setIREngine(ConvolutionEngineType::Pffft);
+  EXPECT_EQ(proc.getIREngine(), ConvolutionEngineType::Pffft);
+
+  std::string err;
+  ASSERT_TRUE(proc.loadImpulseResponse(irAPath_, err)) << err;
+  std::vector<float> in(kBlockSize, 0.0f);
+  std::vector<float> out(kBlockSize, 0.0f);
+  proc.processMono(in.data(), out.data(), kBlockSize);
+  EXPECT_TRUE(proc.isIRLoaded());
+}
+
+// Render mode swaps the zero-latency IR for large partitions and compresses the low band
+// on a helper thread; once aligned by the reported latency the output matches realtime.
+TEST_F(BassProcessorTest, RenderMode_MatchesRealtimeAfterLatency)
+{
+  constexpr size_t kNumSamples = kBlockSize * 40;
+  // Leading silence lets the makeup gain ramp settle before the aligned signal.
+  auto input = generateWhiteNoise(kNumSamples);
+  std::fill(input.begin(), input.begin() + kBlockSize * 10, 0.0f);
+
+  auto renderThrough = [&](BassProcessor& bass, bool renderMode)
+  {
+    bass.setSampleRate(44100.0);
+    bass.setMaxBlockSize(kBlockSize);
+    bass.setIREngine(ConvolutionEngineType::Pffft);
+    bass.setSquash(0.6f);
+    std::string err;
+    EXPECT_TRUE(bass.loadImpulseResponse(irAPath_, err)) << err;
+    bass.setRenderMode(renderMode);
+    std::vector<float> output(kNumSamples, 0.0f);
+    for (size_t offset = 0; offset < kNumSamples; offset += kBlockSize)
+      bass.processMono(input.data() + offset, output.data() + offset, kBlockSize);
+    return output;
+  };
+
+  BassProcessor realtime;
+  const auto expected = renderThrough(realtime, false);
+  EXPECT_EQ(realtime.getLatencySamples(), 0);
+
+  BassProcessor rendering;
+  const auto output = renderThrough(rendering, true);
+  EXPECT_TRUE(rendering.getRenderMode());
+  const int latency = rendering.getLatencySamples();
+  ASSERT_GT(latency, 0);
+  EXPECT_EQ(rendering.getStagedLatencySamples(), latency);
+
+  for (size_t i = 0; i + static_cast<size_t>(latency) < kNumSamples; ++i)
+    ASSERT_NEAR(output[i + static_cast<size_t>(latency)], expected[i], 1e-3f) << "at sample " << i;
+
+  rendering.setRenderMode(false);
+  EXPECT_EQ(rendering.getStagedLatencySamples(), 0);
+}
+
+TEST_F(BassProcessorTest, Silence_IdlesAfterTailAndWakesOnSignal)
+{
+  std::string err;
+  ASSERT_TRUE(proc.loadImpulseResponse(irAPath_, err)) << err;
+  proc.setSquash(0.5f);
+
+  auto noise = generateWhiteNoise(kBlockSize * 4);
+  std::vector<float> out(kBlockSize);
+  for (size_t offset = 0; offset < noise.size(); offset += kBlockSize)
+    proc.processMono(noise.data() + offset, out.data(), kBlockSize);
+
+  const int tail = proc.getTailLengthSamples();
+  EXPECT_GT(tail, 0);
+
+  std::vector<float> silence(kBlockSize, 0.0f);
+  const int tailBlocks = (tail + kBlockSize - 1) / kBlockSize;
+  for (int b = 0; b < tailBlocks; ++b)
+    proc.processMono(silence.data(), out.data(), kBlockSize);
+  for (int b = 0; b < 4; ++b)
+  {
+    std::fill(out.begin(), out.end(), 1.0f);
+    proc.processMono(silence.data(), out.data(), kBlockSize);
+    EXPECT_EQ(peakLevel(out), 0.0f) << "idle block " << b;
+  }
+
+  // Signal returning mid-block is processed from its first sample
+  std::vector<float> wake(kBlockSize, 0.0f);
+  std::copy(noise.begin(), noise.begin() + kBlockSize / 2, wake.begin() + kBlockSize / 2);
+  proc.processMono(wake.data(), out.data(), kBlockSize);
+  EXPECT_GT(std::abs(out[kBlockSize / 2]), 0.0f);
+}
+
 TEST_F(BassProcessorTest, Reset_ClearsAllState)
 {
   constexpr size_t kNumSamples = kBlockSize;
@@ -0,0 +1,125 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "RealtimeGuard.hpp"
+#include "octobass-core/BassProcessor.hpp"
+#include "octobass-core/NamProcessor.hpp"
+
+using namespace octob;
+
+// processMono() and NamProcessor::process() must run without allocating, freeing or
+// locking once prepared, including on the block that picks up a new IR or model.
+// Uses the allocation and lock counting from octobir-core's test RealtimeGuard.
+
+namespace
+{
+
+constexpr int kBlockSize = 512;
+
+const std::string kIrPath = std::string(TEST_DATA_DIR) + "/INPUT_ir_a.wav";
+const std::string kModelPath = std::string(TEST_DATA_DIR) + "/INPUT_VHD.nam";
+
+void prepare(BassProcessor& proc)
+{
+  proc.setSampleRate(48000.0);
+  proc.setMaxBlockSize(kBlockSize);
+  // WDL, which Auto may pick, grows its internal queues on first use and is third-party.
+  proc.setIREngine(ConvolutionEngineType::Pffft);
+  // Exercise every stage of the chain.
+  proc.setSquash(0.7f);
+  proc.setGateThreshold(-60.0f);
+  proc.setHighBandMix(0.5f);
+  proc.setDryWetMix(0.8f);
+  proc.setGraphicEQBandGain(4, 6.0f);
+}
+
+}  // namespace
+
+TEST(RealtimeSafetyTest, NamProcessIsRealtimeSafe)
+{
+  NamProcessor proc;
+  proc.setSampleRate(48000.0);
+  proc.setMaxBlockSize(kBlockSize);
+  std::vector<float> input(kBlockSize, 0.1f);
+  std::vector<float> output(kBlockSize);
+
+  std::string err;
+  ASSERT_TRUE(proc.loadModel(kModelPath, err)) << err;
+  auto report = runRealtime([&] { proc.process(input.data(), output.data(), kBlockSize); });
+  EXPECT_TRUE(report.isClean()) << "after load: " << report.describe();
+
+  proc.clearModel();
+  report = runRealtime([&] { proc.process(input.data(), output.data(), kBlockSize); });
+  EXPECT_TRUE(report.isClean()) << "after clear: " << report.describe();
+}
+
+TEST(RealtimeSafetyTest, ProcessMonoIsRealtimeSafe)
+{
+  BassProcessor proc;
+  prepare(proc);
+  std::vector<float> input(kBlockSize, 0.2f);
+  std::vector<float> output(kBlockSize);
+
+  std::string err;
+  ASSERT_TRUE(proc.loadImpulseResponse(kIrPath, err)) << err;
+  ASSERT_TRUE(proc.loadNamModel(kModelPath, err)) << err;
+  auto report = runRealtime(
+      [&]
+      {
+        for (int i = 0; i < 4; ++i)
+          proc.processMono(input.data(), output.data(), kBlockSize);
+      });
+  EXPECT_TRUE(report.isClean()) << "after load: " << report.describe();
+
+  proc.clearImpulseResponse();
+  proc.clearNamModel();
+  report = runRealtime([&] { proc.processMono(input.data(), output.data(), kBlockSize); });
+  EXPECT_TRUE(report.isClean()) << "after clear: " << report.describe();
+}
+
+// A second thread keeps loading and clearing the IR and the model while the audio
+// thread processes. Sample rate and block size changes are not made concurrently with
+// processing here; hosts do not make them while the processor is running.
+TEST(RealtimeSafetyTest, ProcessMonoStaysRealtimeSafeUnderConcurrentLoads)
+{
+  BassProcessor proc;
+  prepare(proc);
+
+  std::atomic<bool> done{false};
+  std::thread control(
+      [&]
+      {
+        std::string err;
+        for (int i = 0; i < 12; ++i)
+        {
+          proc.loadImpulseResponse(kIrPath, err);
+          proc.loadNamModel(kModelPath, err);
+          proc.clearImpulseResponse();
+          if (i % 2)
+            proc.clearNamModel();
+        }
+        done = true;
+      });
+
+  std::vector<float> input(kBlockSize, 0.2f);
+  std::vector<float> output(kBlockSize);
+  RealtimeReport total;
+  long blocks = 0;
+  while (!done.load())
+  {
+    const RealtimeReport report =
+        runRealtime([&] { proc.processMono(input.data(), output.data(), kBlockSize); });
+    total.allocations += report.allocations;
+    total.frees += report.frees;
+    total.locks += report.locks;
+    ++blocks;
+  }
+  control.join();
+
+  EXPECT_GT(blocks, 0);
+  EXPECT_TRUE(total.isClean()) << total.describe() << " over " << blocks << " blocks";
+}
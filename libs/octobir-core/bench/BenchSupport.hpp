@@ -0,0 +1,92 @@
+#pragma once
+
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "dr_wav.h"
+#include "octobir-core/Types.hpp"
+
+// DR_WAV_IMPLEMENTATION is compiled into octobir-core via IRLoader.cpp.
+
+namespace octob
+{
+
+// Shared by octobir-core-bench and octobass-core-bench so their counters mean the same
+// thing. Every benchmark reports:
+//   ns_per_sample  wall-clock time per frame processed
+//   rtf            seconds of audio processed per second of wall-clock time (real-time
+//                  factor; above 1 is faster than real time)
+
+inline bool readWav(const std::string& path, std::vector<float>& interleaved,
+                    unsigned int& channels)
+{
+  drwav_uint32 numChannels = 0;
+  drwav_uint32 sampleRate = 0;
+  drwav_uint64 totalFrames = 0;
+  float* raw = drwav_open_file_and_read_pcm_frames_f32(path.c_str(), &numChannels, &sampleRate,
+                                                       &totalFrames, nullptr);
+  if (raw == nullptr)
+    return false;
+
+  interleaved.assign(raw, raw + totalFrames * numChannels);
+  channels = numChannels;
+  drwav_free(raw, nullptr);
+  return true;
+}
+
+// The first channel of a tests/data recording, looped; at(offset) gives a block that
+// many frames ahead, so extra inputs such as a sidechain can read the same material.
+struct LoopedSignal
+{
+  std::vector<float> samples;
+  size_t length = 0;
+  size_t position = 0;
+
+  bool load(const std::string& path, FrameCount maxBlockSize)
+  {
+    unsigned int channels = 0;
+    std::vector<float> interleaved;
+    if (!readWav(path, interleaved, channels) || interleaved.empty())
+      return false;
+
+    length = interleaved.size() / channels;
+    samples.resize(length + maxBlockSize);
+    for (size_t i = 0; i < samples.size(); ++i)
+      samples[i] = interleaved[(i % length) * channels];
+    return true;
+  }
+
+  const float* at(size_t offset) const { return samples.data() + (position + offset) % length; }
+
+  void advance(FrameCount numFrames) { position = (position + numFrames) % length; }
+};
+
+// Started just before the benchmark loop; report() sets the throughput counters.
+class ThroughputTimer
+{
+ public:
+  ThroughputTimer() : start_(std::chrono::steady_clock::now()) {}
+
+  void report(benchmark::State& state, FrameCount framesPerIteration,
+              SampleRate sampleRate) const
+  {
+    const double elapsedNs =
+        std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start_)
+            .count();
+    const double frames =
+        static_cast<double>(state.iterations()) * static_cast<double>(framesPerIteration);
+
+    state.SetItemsProcessed(static_cast<int64_t>(frames));
+    state.counters["ns_per_sample"] = elapsedNs / frames;
+    state.counters["rtf"] = (frames / sampleRate) / (elapsedNs * 1e-9);
+  }
+
+ private:
+  std::chrono::steady_clock::time_point start_;
+};
+
+}  // namespace octob
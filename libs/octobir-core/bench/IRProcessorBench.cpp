@@ -0,0 +1,264 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "BenchSupport.hpp"
+#include "octobir-core/IRProcessor.hpp"
+
+using namespace octob;
+
+// Throughput of IRProcessor across IR length, block size, channel layout and IR slot
+// configuration, reported as ns_per_sample and rtf (see BenchSupport.hpp). Names and
+// arguments are fixed so JSON from different commits can be compared with Google
+// Benchmark's tools/compare.py.
+
+namespace
+{
+
+constexpr SampleRate kSampleRate = 48000.0;
+
+// Taps of the IRs swept by IRLength, from a short cabinet to 10 s of reverb.
+const std::vector<int64_t> kIRLengths = {128, 1024, 8192, 48000, 480000};
+const std::vector<int64_t> kBlockSizes = {1, 16, 64, 256, 1024, 4096};
+
+// IR and block size used when sweeping layouts and slots.
+constexpr size_t kLayoutTaps = 48000;
+constexpr FrameCount kLayoutBlockSize = 256;
+
+enum class Layout
+{
+  Mono,
+  MonoToStereo,
+  Stereo,
+  MonoSidechain,
+  MonoToStereoSidechain,
+  StereoSidechain,
+};
+
+enum class Slots
+{
+  AOnly,
+  BOnly,
+  AB,
+  Dynamic,
+};
+
+struct LayoutInfo
+{
+  Layout layout;
+  const char* name;
+};
+
+struct SlotsInfo
+{
+  Slots slots;
+  const char* name;
+};
+
+const LayoutInfo kLayouts[] = {
+    {Layout::Mono, "mono"},
+    {Layout::MonoToStereo, "mono_to_stereo"},
+    {Layout::Stereo, "stereo"},
+    {Layout::MonoSidechain, "mono_sidechain"},
+    {Layout::MonoToStereoSidechain, "mono_to_stereo_sidechain"},
+    {Layout::StereoSidechain, "stereo_sidechain"},
+};
+
+const SlotsInfo kSlots[] = {
+    {Slots::AOnly, "a_only"},
+    {Slots::BOnly, "b_only"},
+    {Slots::AB, "a_b"},
+    {Slots::Dynamic, "dynamic"},
+};
+
+bool hasSidechain(Layout layout)
+{
+  return layout == Layout::MonoSidechain || layout == Layout::MonoToStereoSidechain ||
+         layout == Layout::StereoSidechain;
+}
+
+bool writeWavStereo(const std::string& path, const std::vector<float>& interleaved)
+{
+  drwav_data_format format;
+  format.container = drwav_container_riff;
+  format.format = DR_WAVE_FORMAT_IEEE_FLOAT;
+  format.channels = 2;
+  format.sampleRate = static_cast<drwav_uint32>(kSampleRate);
+  format.bitsPerSample = 32;
+
+  drwav wav;
+  if (!drwav_init_file_write(&wav, path.c_str(), &format, nullptr))
+    return false;
+
+  drwav_write_pcm_frames(&wav, interleaved.size() / 2, interleaved.data());
+  drwav_uninit(&wav);
+  return true;
+}
+
+// Writes a stereo IR of the given length cut from the long hall recording in tests/data,
+// tagged at the benchmark rate so loading does not resample it. Longer IRs repeat the
+// recording at half gain; only the length matters for throughput. Slot B gets the
+// channels swapped so the two slots hold different IRs.
+bool makeIR(size_t taps, bool slotB, std::string& path)
+{
+  static std::vector<float> hall;
+  static unsigned int hallChannels = 0;
+  if (hall.empty() &&
+      !readWav(std::string(TEST_DATA_DIR) + "/INPUT_long_stereo_hall.wav", hall, hallChannels))
+    return false;
+
+  const size_t hallFrames = hall.size() / hallChannels;
+  std::vector<float> ir(taps * 2);
+  for (size_t i = 0; i < taps; ++i)
+  {
+    const size_t frame = i % hallFrames;
+    const float gain = i < hallFrames ? 1.0f : 0.5f;
+    const float left = hall[frame * hallChannels];
+    const float right = hall[frame * hallChannels + (hallChannels > 1 ? 1 : 0)];
+    ir[2 * i] = gain * (slotB ? right : left);
+    ir[2 * i + 1] = gain * (slotB ? left : right);
+  }
+
+  path = std::string(OCTOBIR_BENCH_IR_DIR) + "/hall_" + std::to_string(taps) +
+         (slotB ? "_b" : "_a") + ".wav";
+  return writeWavStereo(path, ir);
+}
+
+void process(IRProcessor& processor, Layout layout, LoopedSignal& signal, float* outL,
+             float* outR, FrameCount numFrames)
+{
+  const float* in = signal.at(0);
+  const float* inR = signal.at(signal.length / 2);
+  const float* side = signal.at(signal.length / 4);
+  const float* sideR = signal.at(3 * signal.length / 4);
+
+  switch (layout)
+  {
+    case Layout::Mono:
+      processor.processMono(in, outL, numFrames);
+      break;
+    case Layout::MonoToStereo:
+      processor.processMonoToStereo(in, outL, outR, numFrames);
+      break;
+    case Layout::Stereo:
+      processor.processStereo(in, inR, outL, outR, numFrames);
+      break;
+    case Layout::MonoSidechain:
+      processor.processMonoWithSidechain(in, side, outL, numFrames);
+      break;
+    case Layout::MonoToStereoSidechain:
+      processor.processMonoToStereoWithSidechain(in, side, outL, outR, numFrames);
+      break;
+    case Layout::StereoSidechain:
+      processor.processStereoWithSidechain(in, inR, side, sideR, outL, outR, numFrames);
+      break;
+  }
+  signal.advance(numFrames);
+}
+
+void runProcessor(benchmark::State& state, size_t taps, FrameCount blockSize, Layout layout,
+                  Slots slots)
+{
+  std::string pathA;
+  std::string pathB;
+  if (!makeIR(taps, false, pathA) || !makeIR(taps, true, pathB))
+  {
+    state.SkipWithError("could not write benchmark IRs from tests/data");
+    return;
+  }
+
+  // Guitar DI; the right channel and sidechain read it at offsets.
+  LoopedSignal signal;
+  if (!signal.load(std::string(TEST_DATA_DIR) + "/INPUT_amp_output_no_ir.wav", blockSize))
+  {
+    state.SkipWithError("could not read tests/data/INPUT_amp_output_no_ir.wav");
+    return;
+  }
+
+  IRProcessor processor;
+  processor.setSampleRate(kSampleRate);
+  processor.setMaxBlockSize(blockSize);
+  processor.setSidechainEnabled(hasSidechain(layout));
+  processor.setDynamicModeEnabled(slots == Slots::Dynamic);
+
+  std::string error;
+  const bool loaded = (slots == Slots::BOnly || processor.loadImpulseResponse1(pathA, error)) &&
+                      (slots == Slots::AOnly || processor.loadImpulseResponse2(pathB, error));
+  if (!loaded)
+  {
+    state.SkipWithError(error.c_str());
+    return;
+  }
+
+  std::vector<float> outL(blockSize);
+  std::vector<float> outR(blockSize);
+
+  // Pick up the new engines before timing. Partitioned convolution costs the same per
+  // block whether or not its history has filled.
+  const FrameCount warmupFrames = std::max<FrameCount>(8192, 4 * blockSize);
+  for (FrameCount done = 0; done < warmupFrames; done += blockSize)
+    process(processor, layout, signal, outL.data(), outR.data(), blockSize);
+
+  const ThroughputTimer timer;
+  for (auto _ : state)
+  {
+    process(processor, layout, signal, outL.data(), outR.data(), blockSize);
+    benchmark::DoNotOptimize(outL.data());
+    benchmark::DoNotOptimize(outR.data());
+    benchmark::ClobberMemory();
+  }
+
+  timer.report(state, blockSize, kSampleRate);
+}
+
+void registerBenchmarks()
+{
+  benchmark::RegisterBenchmark("IRLength",
+                               [](benchmark::State& state)
+                               {
+                                 runProcessor(state, static_cast<size_t>(state.range(0)),
+                                              static_cast<FrameCount>(state.range(1)),
+                                              Layout::Mono, Slots::AOnly);
+                               })
+      ->ArgNames({"taps", "block"})
+      ->ArgsProduct({kIRLengths, kBlockSizes})
+      ->Unit(benchmark::kMicrosecond);
+
+  for (const auto& layout : kLayouts)
+  {
+    for (const auto& slots : kSlots)
+    {
+      const std::string name = std::string("Layout/") + layout.name + "/" + slots.name;
+      const Layout layoutValue = layout.layout;
+      const Slots slotsValue = slots.slots;
+      benchmark::RegisterBenchmark(name.c_str(),
+                                   [layoutValue, slotsValue](benchmark::State& state)
+                                   {
+                                     runProcessor(state, kLayoutTaps, kLayoutBlockSize,
+                                                  layoutValue, slotsValue);
+                                   })
+          ->Unit(benchmark::kMicrosecond);
+    }
+  }
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv))
+    return 1;
+
+  benchmark::AddCustomContext("octobir_sample_rate", std::to_string(static_cast<int>(kSampleRate)));
+  benchmark::AddCustomContext("octobir_engine", "Auto");
+  registerBenchmarks();
+
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "ConvolutionEngine.hpp"
+
+namespace octob
+{
+
+// Measured cost of one stereo frame through each engine at a given IR length.
+struct ConvolutionCostPoint
+{
+  size_t irLength;
+  double directNs;
+  double fftNs;
+};
+
+// Chooses between the direct FIR and the WDL FFT engine for an IR length, from timings
+// taken on this machine at the host's block size rather than a fixed threshold.
+// Between measured points the direct cost is interpolated linearly in irLength and the
+// FFT cost linearly in log2(irLength). Outside them the direct cost scales with
+// irLength and the FFT cost holds at the nearest point.
+class ConvolutionCostModel
+{
+ public:
+  ConvolutionCostModel() = default;
+  explicit ConvolutionCostModel(std::vector<ConvolutionCostPoint> points);
+
+  // Times both engines on synthetic stereo IRs in blocks of blockSize. Results are
+  // cached per block size for the lifetime of the process. Takes a few milliseconds
+  // the first time; call from a non-realtime thread.
+  static ConvolutionCostModel measure(int blockSize);
+
+  // Direct where it is measured cheaper, otherwise Wdl. Wdl when nothing was measured.
+  ConvolutionEngineType choose(size_t irLength) const;
+  double estimateDirectNs(size_t irLength) const;
+  double estimateFftNs(size_t irLength) const;
+
+  bool isEmpty() const { return points_.empty(); }
+  const std::vector<ConvolutionCostPoint>& getPoints() const { return points_; }
+
+ private:
+  std::vector<ConvolutionCostPoint> points_;
+};
+
+}  // namespace octob
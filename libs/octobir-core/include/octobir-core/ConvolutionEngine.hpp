@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+#include "ConvolutionKernel.hpp"
+#include "Types.hpp"
+
+class WDL_ImpulseBuffer;  // NOLINT(readability-identifier-naming)
+
+namespace octob
+{
+
+enum class ConvolutionEngineType : uint8_t
+{
+  Wdl,     // WDL_ConvolutionEngine_Div: brute-force head, zero latency
+  Pffft,   // PffftConvolutionEngine: uniformly partitioned, one block of latency
+           // unless created zero-latency
+  Direct,  // DirectConvolutionEngine: time-domain FIR, zero latency, for short IRs
+  Auto,    // Resolved per IR by the owner (IRProcessor uses ConvolutionCostModel);
+           // create() falls back to Wdl
+};
+
+// Streaming convolution engine backing one IR slot. Follows the WDL engine contract:
+// add() queues input, avail() reports how many output frames are ready, get() exposes
+// them per channel and advance() consumes them. Input channel c is convolved with IR
+// channel min(c, irChannels - 1).
+class ConvolutionEngine
+{
+ public:
+  // Upper bound on the latency an engine may report. Owners size their alignment
+  // buffers for it up front.
+  static constexpr int MaxLatencySamples = 1024;
+
+  ConvolutionEngine() = default;
+  virtual ~ConvolutionEngine() = default;
+
+  ConvolutionEngine(const ConvolutionEngine&) = delete;
+  ConvolutionEngine& operator=(const ConvolutionEngine&) = delete;
+
+  // With zeroLatency, engines that would otherwise buffer a block run their first
+  // partition as a direct-form FIR instead. WDL is always zero-latency. With
+  // backgroundTail, partitioned engines convolve the late partitions of long IRs on a
+  // worker thread; the output is unchanged.
+  static std::unique_ptr<ConvolutionEngine> create(ConvolutionEngineType type,
+                                                   bool zeroLatency = false,
+                                                   bool backgroundTail = false);
+
+  // Returns the latency in samples, or a negative value on failure. Allocates; call
+  // from a non-realtime thread.
+  virtual int setImpulse(WDL_ImpulseBuffer& impulse) = 0;
+  // Like setImpulse(), but engines that convolve with a ConvolutionKernel use the given
+  // one, built from the same impulse and possibly shared with other instances, instead
+  // of building their own. Others ignore it.
+  virtual int setSharedImpulse(WDL_ImpulseBuffer& impulse,
+                               std::shared_ptr<const ConvolutionKernel> /*kernel*/)
+  {
+    return setImpulse(impulse);
+  }
+  virtual void add(const Sample* const* inputs, int numFrames, int numChannels) = 0;
+  virtual int avail(int wantFrames) = 0;
+  virtual Sample** get() = 0;
+  virtual void advance(int numFrames) = 0;
+  virtual void reset() = 0;
+  // True for engines that grow their buffers on first use rather than in setImpulse().
+  // Owners run some silence through those before handing them to the audio thread.
+  virtual bool growsOnFirstUse() const { return false; }
+  // True for engines that convolve with a ConvolutionKernel, and so skip what its
+  // KernelDiagnostics report as silent.
+  virtual bool usesKernel() const { return false; }
+};
+
+}  // namespace octob
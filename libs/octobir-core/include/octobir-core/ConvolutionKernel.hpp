@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "Types.hpp"
+
+class WDL_ImpulseBuffer;  // NOLINT(readability-identifier-naming)
+
+namespace octob
+{
+
+class IRLoader;
+
+// What a kernel's energy map lets convolvers skip.
+struct KernelDiagnostics
+{
+  int numChannels = 0;
+  int numPartitions = 0;  // Per channel
+  // Partitions below the silence floor, over all channels; their complex
+  // multiply-accumulate is skipped.
+  int numSilentPartitions = 0;
+  // Channels with every partition silent. They are not convolved at all.
+  int numSilentChannels = 0;
+  // A stereo kernel with one silent channel: engines run it at mono cost.
+  bool monoFallback = false;
+};
+
+// Immutable, frequency-domain copy of an impulse response split into uniform
+// partitions of blockSize samples. Each partition is stored as the pffft spectrum
+// (internal layout, 2 * blockSize floats, 64-byte aligned) of the zero-padded
+// segment, pre-scaled by 1 / fftSize so convolvers can skip normalization. The first
+// blockSize taps are also kept in the time domain for direct-form (zero-latency) heads.
+//
+// A kernel is built once per IR load and shared read-only by any number of
+// PartitionedConvolver instances (e.g. one per polyphonic voice).
+//
+// Each partition's energy is measured when the kernel is built. Partitions below
+// SilentPartitionDb of the whole kernel's energy (padding, gaps in room IRs, a stereo IR's
+// empty channel) are marked silent, and convolvers skip them.
+class ConvolutionKernel
+{
+ public:
+  static constexpr float SilentPartitionDb = -120.0f;
+
+  // blockSize must be a power of two >= 16. Returns nullptr for empty input.
+  static std::shared_ptr<const ConvolutionKernel> create(const Sample* const* channels,
+                                                         int numChannels, size_t length,
+                                                         int blockSize);
+
+  // Builds a kernel from the first numChannels channels of a WDL impulse buffer,
+  // as produced by IRLoader::resampleAndInitialize.
+  static std::shared_ptr<const ConvolutionKernel> create(WDL_ImpulseBuffer& impulse,
+                                                         int numChannels, int blockSize);
+
+  // Resamples a loaded IR to sampleRate and builds a mono or stereo kernel from it.
+  static std::shared_ptr<const ConvolutionKernel> create(IRLoader& loader, SampleRate sampleRate,
+                                                         int blockSize);
+
+  ~ConvolutionKernel();
+
+  ConvolutionKernel(const ConvolutionKernel&) = delete;
+  ConvolutionKernel& operator=(const ConvolutionKernel&) = delete;
+
+  int getBlockSize() const { return blockSize_; }
+  int getFftSize() const { return blockSize_ * 2; }
+  int getNumChannels() const { return numChannels_; }
+  int getNumPartitions() const { return numPartitions_; }
+  size_t getLength() const { return length_; }
+
+  const float* getPartition(int channel, int partition) const;
+  // Sum of squares of the partition's taps.
+  float getPartitionEnergy(int channel, int partition) const
+  {
+    return energy_[static_cast<size_t>(channel * numPartitions_ + partition)];
+  }
+  bool isPartitionSilent(int channel, int partition) const
+  {
+    return silent_[static_cast<size_t>(channel * numPartitions_ + partition)] != 0;
+  }
+  bool isChannelSilent(int channel) const
+  {
+    return silentChannels_[static_cast<size_t>(channel)] != 0;
+  }
+  const KernelDiagnostics& getDiagnostics() const { return diagnostics_; }
+
+  // First blockSize taps of a channel, unscaled and zero-padded if the IR is shorter.
+  const float* getHead(int channel) const;
+
+ private:
+  ConvolutionKernel(int numChannels, size_t length, int blockSize);
+  void buildEnergyMap();
+
+  int numChannels_;
+  size_t length_;
+  int blockSize_;
+  int numPartitions_;
+  float* spectra_ = nullptr;
+  float* head_ = nullptr;
+  std::vector<float> energy_;
+  std::vector<uint8_t> silent_;
+  std::vector<uint8_t> silentChannels_;
+  KernelDiagnostics diagnostics_;
+};
+
+}  // namespace octob
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+
+#include "Types.hpp"
+
+namespace octob
+{
+
+// Fixed-capacity ring of samples for delaying a signal by a whole number of frames, as
+// used to align paths with different latencies. The capacity is a power of two so
+// positions wrap with a mask, and blocks move as at most two contiguous copies. Storage
+// is 64-byte aligned. Nothing allocates after allocate().
+//
+// Each block is written first and then read back: read() and view() address the
+// numFrames frames that sit delaySamples behind the block just written, so a delay of 0
+// returns that block itself.
+class DelayLine
+{
+ public:
+  // numFrames consecutive frames as up to two contiguous spans of the line's storage:
+  // first[0, firstSize) then second[0, numFrames - firstSize). Valid until the next
+  // write() or clear().
+  struct View
+  {
+    const Sample* first;
+    FrameCount firstSize;
+    const Sample* second;
+  };
+
+  DelayLine() = default;
+  ~DelayLine();
+
+  DelayLine(const DelayLine&) = delete;
+  DelayLine& operator=(const DelayLine&) = delete;
+
+  // Room for delays of up to maxDelay behind blocks of up to maxBlockSize frames, rounded
+  // up to a power of two. Clears the line. Allocates; call from a non-realtime thread.
+  void allocate(size_t maxDelay, FrameCount maxBlockSize);
+  // 0 until allocated.
+  size_t getCapacity() const { return capacity_; }
+
+  // Realtime-safe once allocated. numFrames + delaySamples must not exceed the capacity.
+  void write(const Sample* input, FrameCount numFrames);
+  void read(Sample* output, FrameCount numFrames, size_t delaySamples) const;
+  View view(FrameCount numFrames, size_t delaySamples) const;
+
+  // Fills the line with silence and restarts it.
+  void clear();
+
+ private:
+  Sample* buffer_ = nullptr;
+  size_t capacity_ = 0;
+  size_t writePos_ = 0;
+};
+
+}  // namespace octob
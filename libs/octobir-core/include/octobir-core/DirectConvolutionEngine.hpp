@@ -0,0 +1,48 @@
+#pragma once
+
+#include <vector>
+
+#include "ConvolutionEngine.hpp"
+
+namespace octob
+{
+
+// Time-domain FIR for short IRs. Zero latency; cost grows linearly with IR length, so
+// IRProcessor only picks it where ConvolutionCostModel measures it beating the FFT.
+//
+// Each host block is computed tap by tap as out[0..n) += h[k] * x[-k..n-k), with both
+// stereo channels in the same pass. The inner loop is a contiguous multiply-add with
+// no reduction, which compilers vectorize (SSE/AVX/NEON) without reassociating.
+class DirectConvolutionEngine final : public ConvolutionEngine
+{
+ public:
+  static constexpr int MaxChannels = 2;
+
+  DirectConvolutionEngine() = default;
+
+  int setImpulse(WDL_ImpulseBuffer& impulse) override;
+  int setTaps(const Sample* const* channels, int numChannels, size_t length);
+
+  void add(const Sample* const* inputs, int numFrames, int numChannels) override;
+  int avail(int wantFrames) override;
+  Sample** get() override;
+  void advance(int numFrames) override;
+  void reset() override;
+
+ private:
+  void reserve(size_t numFrames);
+
+  size_t length_ = 0;
+  int kernelChannels_ = 0;
+  int numChannels_ = 1;
+  std::vector<Sample> taps_[MaxChannels];
+
+  // Per channel: the last length_ - 1 input samples followed by the current block.
+  std::vector<Sample> input_[MaxChannels];
+  std::vector<Sample> output_[MaxChannels];
+  size_t outputStart_ = 0;
+  size_t outputEnd_ = 0;
+  Sample* outputPtrs_[MaxChannels] = {};
+};
+
+}  // namespace octob
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "ConvolutionKernel.hpp"
+#include "PartitionedConvolver.hpp"
+#include "Types.hpp"
+
+namespace octob
+{
+
+// Zero-latency convolution of one input against a weighted pair of kernels (IR slots
+// A and B), used for the A/B blend.
+//
+// gainA * (x * a) + gainB * (x * b) is computed with one forward FFT per input block
+// shared by both kernels. The first block of taps runs as a direct-form FIR over each
+// kernel's head, so no latency is added. The tail products with each kernel are summed
+// in the frequency domain, one accumulator per kernel, and inverse-transformed when the
+// block's first sample is needed: while the gains are steady, the two accumulators are
+// weighted and finished with one inverse FFT per output; a block in which a gain moves
+// takes one per kernel and output instead, so the gains can move per sample.
+//
+// Channel routing matches the WDL engines IRProcessor drives: with two outputs,
+// output c convolves input min(c, numInputs - 1) with kernel channel
+// min(c, kernelChannels - 1). A single output averages all kernel channels.
+class DualKernelConvolver
+{
+ public:
+  static constexpr int MaxChannels = 2;
+
+  DualKernelConvolver() = default;
+
+  DualKernelConvolver(const DualKernelConvolver&) = delete;
+  DualKernelConvolver& operator=(const DualKernelConvolver&) = delete;
+
+  // Both kernels must share a block size. Allocates; call from a non-realtime thread.
+  bool prepare(std::shared_ptr<const ConvolutionKernel> kernelA,
+               std::shared_ptr<const ConvolutionKernel> kernelB);
+  bool isPrepared() const { return kernelA_ != nullptr; }
+  void reset();
+
+  // numInputs and numOutputs are 1 or 2. Outputs may alias inputs.
+  void process(const Sample* const* inputs, int numInputs, Sample* const* outputs,
+               int numOutputs, FrameCount numFrames, float gainA, float gainB)
+  {
+    process(inputs, numInputs, outputs, numOutputs, numFrames, gainA, gainA, gainB, gainB);
+  }
+  // Moves each gain linearly from its from value to its to value across the call:
+  // frame i is weighted by from + (to - from) * (i + 1) / numFrames, so the last frame
+  // lands on the target and the next call continues from there.
+  void process(const Sample* const* inputs, int numInputs, Sample* const* outputs,
+               int numOutputs, FrameCount numFrames, float fromA, float toA, float fromB,
+               float toB);
+
+  int getLatencySamples() const { return 0; }
+
+ private:
+  static constexpr int NumKernels = 2;
+
+  // How the current block's tail is held in tailOutput_: not yet inverse-transformed,
+  // summed with tailGainA_ and tailGainB_ applied (in tailOutput_[0]), or per kernel.
+  enum class TailState
+  {
+    Pending,
+    Summed,
+    Split
+  };
+
+  void updateHeadTaps(int numOutputs);
+  void runTail(int numInputs, int numOutputs);
+  void finishTail(bool steady, float gainA, float gainB);
+  static void accumulateKernel(PartitionedConvolver& convolver, const ConvolutionKernel& kernel,
+                               int accumulator, int output, int numOutputs);
+  int inputFor(int output, int numInputs) const;
+
+  std::shared_ptr<const ConvolutionKernel> kernelA_;
+  std::shared_ptr<const ConvolutionKernel> kernelB_;
+  int blockSize_ = 0;
+  int blockPos_ = 0;
+  int historyPos_ = 0;
+
+  PartitionedConvolver convolvers_[MaxChannels];
+  // Input history written twice (at pos and pos + blockSize) so the FIR window is
+  // always contiguous.
+  std::vector<Sample> history_[MaxChannels];
+  std::vector<Sample> blockInput_[MaxChannels];
+  // Per kernel and output, indexed [kernel][output]: the tail for the current block and
+  // the head taps, time-reversed for a forward dot product. The taps follow the channel
+  // routing for headOutputs_ outputs and are rebuilt when that changes.
+  std::vector<Sample> tailOutput_[NumKernels][MaxChannels];
+  std::vector<Sample> headTaps_[NumKernels][MaxChannels];
+  int headOutputs_ = 0;
+  TailState tailState_ = TailState::Split;
+  float tailGainA_ = 0.0f;
+  float tailGainB_ = 0.0f;
+  // Channel counts the pending tail was accumulated for.
+  int tailInputs_ = 1;
+  int tailOutputs_ = 1;
+};
+
+}  // namespace octob
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace octob
+{
+
+// One helper thread that runs a task alongside the calling thread, for splitting a block
+// of independent work in two: fork() hands the task over, the caller does its own share,
+// and join() waits for the task. Without a running thread fork() runs the task inline,
+// so results do not depend on whether the helper was started.
+//
+// fork() and join() take a lock and wait on a condition variable, so this is for
+// non-realtime rendering only.
+class ForkJoinWorker
+{
+ public:
+  using Task = void (*)(void* context);
+
+  ForkJoinWorker() = default;
+  ~ForkJoinWorker();
+
+  ForkJoinWorker(const ForkJoinWorker&) = delete;
+  ForkJoinWorker& operator=(const ForkJoinWorker&) = delete;
+
+  // Starts the helper thread unless it is running. Call from a non-realtime thread, never
+  // between fork() and join().
+  void start();
+  bool isRunning() const { return running_.load(std::memory_order_acquire); }
+
+  // Every fork() must be matched by a join() from the same thread before the next.
+  void fork(Task task, void* context);
+  void join();
+
+ private:
+  void run();
+
+  std::thread thread_;
+  std::atomic<bool> running_{false};
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  std::condition_variable done_;
+  Task task_ = nullptr;
+  void* context_ = nullptr;
+  bool pending_ = false;
+  bool stopping_ = false;
+};
+
+}  // namespace octob
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "IRCache.hpp"
+#include "MappedFile.hpp"
+#include "Types.hpp"
+
+namespace octob
+{
+
+// One IR to pack into a bank: the file to read and the name it is found under.
+struct IRBankSource
+{
+  std::string name;
+  std::string filepath;
+};
+
+// Processed samples of one bank entry, pointing into the bank's mapping. Planar: channel
+// ch starts at samples + ch * numSamples.
+struct IRBankSection
+{
+  IRCacheStage stage = IRCacheStage::MinimumPhase;
+  SampleRate sampleRate = 0.0;
+  int numChannels = 0;
+  size_t numSamples = 0;
+  const Sample* samples = nullptr;
+
+  const Sample* getChannel(int channel) const
+  {
+    return samples + static_cast<size_t>(channel) * numSamples;
+  }
+};
+
+// A pack of IRs in one file, already processed the way IRLoader processes a WAV, so
+// loading an entry reads mapped pages instead of decoding and converting a file.
+//
+// The file starts with an index (entry names sorted, each entry's content key and a
+// table of sections) followed by 64-byte aligned planar float data. Every entry has its
+// minimum-phase IR at the source file's rate and, optionally, what
+// IRLoader::resampleAndInitialize() produces at each of a set of common rates. Section
+// data is checksummed like IRCache entries and checked when it is read.
+//
+// Bank entries are addressed by path as "<bank file>#<entry name>", so they can be
+// loaded anywhere a file path is accepted.
+class IRBank
+{
+ public:
+  static constexpr char EntrySeparator = '#';
+  // Rates build() pre-resamples for when none are given.
+  static const std::vector<SampleRate>& getDefaultSampleRates();
+
+  // Maps a bank and validates its index. Returns nullptr with errorMessage set on
+  // failure.
+  static std::shared_ptr<const IRBank> open(const std::string& path, std::string& errorMessage);
+  // Like open(), but returns the already mapped bank while anyone still holds it, so
+  // stepping through a bank's entries maps it once.
+  static std::shared_ptr<const IRBank> openShared(const std::string& path,
+                                                  std::string& errorMessage);
+
+  // Splits "<bank>.oirb#<entry>" into its parts. False for any other path.
+  static bool splitEntryPath(const std::string& path, std::string& bankPath,
+                             std::string& entryName);
+  static std::string makeEntryPath(const std::string& bankPath, const std::string& entryName);
+
+  // Processes every source and writes the bank to path, replacing it in one step.
+  // Sources must have distinct names; they are stored sorted by name. Fails on the
+  // first source that does not load, naming it in errorMessage.
+  static bool build(std::vector<IRBankSource> sources, const std::vector<SampleRate>& sampleRates,
+                    const std::string& path, std::string& errorMessage);
+
+  IRBank(const IRBank&) = delete;
+  IRBank& operator=(const IRBank&) = delete;
+
+  const std::string& getPath() const { return path_; }
+  size_t getNumEntries() const { return numEntries_; }
+  std::string getEntryName(size_t index) const;
+  // Binary search over the sorted names.
+  bool findEntry(const std::string& name, size_t& index) const;
+  // The content key of the file the entry was built from.
+  IRCacheKey getEntryKey(size_t index) const;
+
+  // The entry's section for stage, at sampleRate for IRCacheStage::Resampled (matched to
+  // the nearest Hz). False if the bank has none or its checksum does not match.
+  bool getSection(size_t index, IRCacheStage stage, SampleRate sampleRate,
+                  IRBankSection& section) const;
+
+ private:
+  IRBank() = default;
+
+  MappedFile mapping_;
+  std::string path_;
+  // The index, in place in the mapping.
+  const char* entries_ = nullptr;
+  const char* sections_ = nullptr;
+  const char* names_ = nullptr;
+  size_t numEntries_ = 0;
+  size_t numSections_ = 0;
+};
+
+}  // namespace octob
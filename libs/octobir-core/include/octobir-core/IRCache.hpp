@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "MappedFile.hpp"
+#include "Types.hpp"
+
+namespace octob
+{
+
+// Identifies an IR file by content: a 64-bit FNV-1a hash of its bytes and its size.
+struct IRCacheKey
+{
+  uint64_t contentHash = 0;
+  uint64_t contentSize = 0;
+
+  bool isValid() const { return contentSize != 0; }
+};
+
+// Stages of IRLoader's processing that are cached.
+enum class IRCacheStage : uint8_t
+{
+  MinimumPhase,  // Compensated, minimum-phase IR at the file's rate and channel count
+  Resampled,     // What IRLoader writes to a WDL_ImpulseBuffer for a target rate
+};
+
+class IRCacheEntry;
+
+// Directory of preprocessed IRs, shared by every IRLoader that points at it.
+//
+// Entries are named after the content key, ProcessingVersion, stage and sample rate,
+// so an edited file or a change to the processing never matches an old entry. Each
+// entry carries its own key and a payload checksum; an entry that fails either check
+// (truncated, corrupt, written by another version) is deleted and reported as a miss.
+// Entries are written to a temporary file and renamed into place, so concurrent
+// writers and readers in other processes never see a partial entry.
+//
+// Channels are stored planar, one contiguous run of samples each, and read through a
+// read-only memory mapping.
+class IRCache
+{
+ public:
+  // Bump whenever IRLoader's processing (compensation gain, minimum phase, resampler
+  // settings) changes, so entries made by the old code are ignored.
+  static constexpr uint32_t ProcessingVersion = 1;
+
+  // The directory, and any missing parents, are created on the first store().
+  explicit IRCache(std::string directory);
+
+  const std::string& getDirectory() const { return directory_; }
+
+  static bool computeKey(const std::string& filepath, IRCacheKey& key);
+  // The 64-bit FNV-1a hash computeKey() and the entry checksums use; pass a previous
+  // result as hash to continue it over more data.
+  static constexpr uint64_t HashSeed = 14695981039346656037ULL;
+  static uint64_t hashBytes(const void* data, size_t size, uint64_t hash = HashSeed);
+
+  // Returns nullptr on a miss. sampleRate is ignored for IRCacheStage::MinimumPhase.
+  std::unique_ptr<IRCacheEntry> open(const IRCacheKey& key, IRCacheStage stage,
+                                     SampleRate sampleRate) const;
+  bool store(const IRCacheKey& key, IRCacheStage stage, SampleRate sampleRate,
+             const Sample* const* channels, int numChannels, size_t numSamples) const;
+
+  std::string getEntryPath(const IRCacheKey& key, IRCacheStage stage,
+                           SampleRate sampleRate) const;
+
+ private:
+  std::string directory_;
+};
+
+// A validated cache entry, mapped read-only for as long as it lives.
+class IRCacheEntry
+{
+ public:
+  ~IRCacheEntry();
+
+  IRCacheEntry(const IRCacheEntry&) = delete;
+  IRCacheEntry& operator=(const IRCacheEntry&) = delete;
+
+  int getNumChannels() const { return numChannels_; }
+  size_t getNumSamples() const { return numSamples_; }
+  SampleRate getSampleRate() const { return sampleRate_; }
+  const Sample* getChannel(int channel) const;
+
+ private:
+  friend class IRCache;
+  IRCacheEntry() = default;
+
+  MappedFile mapping_;
+  const Sample* samples_ = nullptr;
+  int numChannels_ = 0;
+  size_t numSamples_ = 0;
+  SampleRate sampleRate_ = 0.0;
+};
+
+}  // namespace octob
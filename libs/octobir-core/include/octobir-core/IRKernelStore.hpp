@@ -0,0 +1,90 @@
+#pragma once
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+
+#include "ConvolutionKernel.hpp"
+#include "IRCache.hpp"
+#include "IRLoader.hpp"
+#include "Types.hpp"
+
+class WDL_ImpulseBuffer;  // NOLINT(readability-identifier-naming)
+
+namespace octob
+{
+
+// One IR file, processed for one sample rate. Immutable once published: everything
+// here is shared read-only by every slot that loaded the same file content at the
+// same rate, and only the convolution state built from it is per instance.
+struct SharedIR
+{
+  SharedIR();
+  ~SharedIR();
+
+  SharedIR(const SharedIR&) = delete;
+  SharedIR& operator=(const SharedIR&) = delete;
+
+  IRCacheKey key;
+  SampleRate sampleRate = 0.0;
+  // Decoded, minimum-phase IR at the file's rate; shared by every rate of the file.
+  std::shared_ptr<const IRLoader> source;
+  // Resampled to sampleRate, two channels, as IRLoader::resampleAndInitialize() builds it.
+  // Not modified after publication; WDL's API just has no const accessors.
+  std::unique_ptr<WDL_ImpulseBuffer> impulse;
+  // The IR's own channels (at most two) in KernelBlockSize partitions.
+  std::shared_ptr<const ConvolutionKernel> kernel;
+};
+
+// Process-wide, reference-counted store of SharedIRs.
+//
+// Loads are matched by file content (IRCacheKey) and sample rate, so any number of
+// instances loading the same IR share one decoded source, one resampled buffer and one
+// kernel, and a duplicate load costs a file hash. Entries live exactly as long as some
+// caller holds them: the store itself keeps only weak references.
+class IRKernelStore
+{
+ public:
+  // Matches the 64-sample head of the WDL engines and PffftConvolutionEngine's default.
+  static constexpr int KernelBlockSize = 64;
+
+  static IRKernelStore& getInstance();
+
+  IRKernelStore() = default;
+  IRKernelStore(const IRKernelStore&) = delete;
+  IRKernelStore& operator=(const IRKernelStore&) = delete;
+
+  // Returns nullptr with errorMessage set on failure. Not real-time safe; callable
+  // from any thread. The cache, if any, is only used when the file must be processed.
+  // A negative tailFloorDb truncates the IR as IRLoader::setTailFloorDb() does; each
+  // floor is a separate entry.
+  std::shared_ptr<const SharedIR> load(const std::string& filepath, SampleRate sampleRate,
+                                       const std::shared_ptr<const IRCache>& cache,
+                                       std::string& errorMessage, float tailFloorDb = 0.0f);
+  // The same IR at another rate, reusing its decoded source.
+  std::shared_ptr<const SharedIR> resample(const SharedIR& ir, SampleRate sampleRate,
+                                           std::string& errorMessage);
+
+  // IRs currently held by at least one caller.
+  size_t getNumLiveEntries();
+
+ private:
+  using SourceKey = std::tuple<uint64_t, uint64_t>;
+  using EntryKey = std::tuple<uint64_t, uint64_t, SampleRate>;
+
+  std::shared_ptr<const SharedIR> acquire(const IRCacheKey& key,
+                                          std::shared_ptr<const IRLoader> source,
+                                          SampleRate sampleRate, std::string& errorMessage);
+  static std::shared_ptr<const SharedIR> build(const IRCacheKey& key,
+                                               std::shared_ptr<const IRLoader> source,
+                                               SampleRate sampleRate, std::string& errorMessage);
+  void pruneLocked();
+
+  std::mutex mutex_;
+  std::map<SourceKey, std::weak_ptr<const IRLoader>> sources_;
+  std::map<EntryKey, std::weak_ptr<const SharedIR>> entries_;
+};
+
+}  // namespace octob
@@ -0,0 +1,172 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "IRCache.hpp"
+#include "Types.hpp"
+
+namespace octob
+{
+
+enum class LibraryFileKind : uint8_t
+{
+  ImpulseResponse,  // .wav, .aif, .aiff: what IRLoader reads
+  NamModel,         // .nam
+};
+
+// One indexed file. The audio fields and the fingerprint are only filled for impulse
+// responses that decode; other files are still indexed so they can be navigated to.
+struct LibraryEntry
+{
+  static constexpr int FingerprintBands = 16;
+
+  std::string path;
+  LibraryFileKind kind = LibraryFileKind::ImpulseResponse;
+  // Modification time as reported by the file system and the file's content key, whose
+  // contentSize doubles as its size. Either changing marks the entry stale.
+  int64_t modifiedTime = 0;
+  IRCacheKey contentKey;
+  SampleRate sampleRate = 0.0;
+  uint64_t numSamples = 0;
+  uint32_t numChannels = 0;
+  // Energy of the IR's first IRLibrary::FingerprintLength samples in log-spaced bands from
+  // 40 Hz to 20 kHz, in dB relative to their mean, so level does not affect it. Nearby
+  // fingerprints sound alike.
+  float fingerprint[FingerprintBands] = {};
+};
+
+// Index of the IR and NAM model files under a set of folders, kept in memory so that
+// folder navigation, duplicate and "similar IR" lookups never touch the disk.
+//
+// Folders are scanned recursively once; later scans only reread files whose size or
+// modification time changed. On Linux the indexed folders can be watched with inotify
+// and changes are applied as they happen; elsewhere a background rescan of a folder
+// brings it up to date. The index can be saved to and restored from a compact binary
+// file, so a new session starts from the previous scan.
+//
+// Every method is thread-safe. Scanning and watching run on the library's own thread,
+// not the shared WorkerPool, so a large collection never holds up IR loads.
+class IRLibrary
+{
+ public:
+  // Samples of an IR, per channel, that its fingerprint is computed from.
+  static constexpr size_t FingerprintLength = 4096;
+
+  // Process-wide library shared by every plugin instance; watches its folders where the
+  // platform supports it.
+  static IRLibrary& getShared();
+
+  IRLibrary();
+  ~IRLibrary();
+
+  IRLibrary(const IRLibrary&) = delete;
+  IRLibrary& operator=(const IRLibrary&) = delete;
+
+  // Restores the index from path if it exists, and saves it there after every scan
+  // that changes it. Does nothing if path is already the index file.
+  void setIndexFile(const std::string& path);
+  bool save(const std::string& path) const;
+  // Adds the index saved at path; files already indexed keep their entries. Restored
+  // folders are answered from the index at once, then watched and rescanned in the
+  // background.
+  bool load(const std::string& path);
+
+  // Scans directory and its subfolders on the calling thread, adding new files,
+  // rereading changed ones and dropping deleted ones.
+  void addFolder(const std::string& directory);
+  // Queues addFolder() on the library's thread.
+  void addFolderInBackground(const std::string& directory);
+  // True once directory, or a folder above it, has been scanned or restored.
+  bool hasFolder(const std::string& directory) const;
+  // Blocks until queued scans and file changes have been applied.
+  void waitUntilIdle();
+
+  // Applies file system changes in the indexed folders as they happen. Returns false if
+  // the platform has no watcher; call addFolderInBackground() again to catch up instead.
+  bool startWatching();
+  void stopWatching();
+  bool isWatching() const;
+
+  size_t getNumEntries() const;
+  bool getEntry(const std::string& path, LibraryEntry& entry) const;
+  // The files of one kind directly in directory, sorted by path: what prev/next steps
+  // through. Empty if the folder has not been indexed.
+  std::vector<std::string> getFolderFiles(const std::string& directory,
+                                          LibraryFileKind kind) const;
+  // What prev/next steps through in directory, into files. Answered from the index once
+  // directory is indexed; until then it is listed directly and queued for indexing.
+  // Without a watcher, an indexed folder whose modification time has changed since it was
+  // scanned is rescanned in the background. False if directory is neither indexed nor
+  // readable.
+  bool listFolder(const std::string& directory, LibraryFileKind kind,
+                  std::vector<std::string>& files);
+  // Other files with the same content as path, anywhere in the library.
+  std::vector<std::string> findDuplicates(const std::string& path) const;
+  // Up to maxResults other IRs with the nearest fingerprints, nearest first. Copies of
+  // path itself are left out; see findDuplicates().
+  std::vector<std::string> findSimilar(const std::string& path, size_t maxResults) const;
+
+ private:
+  class Watcher;
+
+  struct Job
+  {
+    enum class Type
+    {
+      ScanFolder,
+      RefreshFile,
+      RemovePath
+    };
+    Type type;
+    std::string path;
+  };
+
+  void scanFolder(const std::string& root);
+  void refreshFile(const std::string& path, LibraryFileKind kind, int64_t modifiedTime,
+                   uint64_t size, bool force);
+  void removePath(const std::string& path);
+  void watch(const std::string& directory);
+  bool isCoveredLocked(const std::string& directory) const;
+  bool changedSinceScan(const std::string& directory) const;
+  void insertLocked(LibraryEntry entry);
+  void eraseLocked(std::map<std::string, LibraryEntry>::iterator it);
+  void saveIndex();
+
+  void enqueue(Job job);
+  void runJobs();
+  void applyJob(const Job& job);
+
+  mutable std::mutex mutex_;
+  std::map<std::string, LibraryEntry> entries_;
+  // Every scanned folder, with the paths of the entries directly in it, in order.
+  std::map<std::string, std::set<std::string>> folderFiles_;
+  // Modification time of every scanned folder as its last scan saw it.
+  std::map<std::string, int64_t> scannedTimes_;
+  // Folders added with addFolder(); everything below them is indexed.
+  std::set<std::string> roots_;
+  std::string indexFile_;
+  // Changed since the index file was last written.
+  bool dirty_ = false;
+
+  std::mutex jobsMutex_;
+  std::condition_variable jobsChanged_;
+  std::deque<Job> jobs_;
+  bool runningJob_ = false;
+  std::atomic<bool> stopping_{false};
+  std::thread jobThread_;
+
+  mutable std::mutex watcherMutex_;
+  std::unique_ptr<Watcher> watcher_;
+};
+
+}  // namespace octob
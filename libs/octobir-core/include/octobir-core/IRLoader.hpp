@@ -1,8 +1,12 @@
 #pragma once
 
+#include <algorithm>
+#include <memory>
 #include <string>
 #include <vector>
 
+#include "IRBank.hpp"
+#include "IRCache.hpp"
 #include "Types.hpp"
 
 class WDL_ImpulseBuffer;  // NOLINT(readability-identifier-naming)
@@ -17,6 +21,10 @@ struct IRLoadResult
   size_t numSamples = 0;
   int numChannels = 0;
   SampleRate sampleRate = 0.0;
+  // Length before tail truncation; numSamples when nothing was cut.
+  size_t originalNumSamples = 0;
+  // Estimated fraction of the per-sample convolution cost the truncation saves.
+  float convolutionCostSaved = 0.0f;
 };
 
 class IRLoader
@@ -25,22 +33,62 @@ class IRLoader
   IRLoader();
   ~IRLoader();
 
+  // With a cache, loads and resamples of a file whose content was seen before are read
+  // from it instead of recomputed, and new results are added to it.
+  void setCache(std::shared_ptr<const IRCache> cache) { cache_ = std::move(cache); }
+
+  // Cuts the minimum-phase IR where the energy still to come falls below floorDb of its
+  // total (e.g. -60), ending it with a short fade-out. 0, the default, keeps every
+  // sample. Applies to later loads.
+  void setTailFloorDb(float floorDb) { tailFloorDb_ = std::min(floorDb, 0.0f); }
+  float getTailFloorDb() const { return tailFloorDb_; }
+  // Identifies key's IR as truncated at tailFloorDb; key itself when truncation is off.
+  static IRCacheKey keyWithTailFloor(const IRCacheKey& key, float tailFloorDb);
+
+  // "<bank>.oirb#<entry>" paths load that bank entry; see loadFromBank().
   IRLoadResult loadFromFile(const std::string& filepath);
+  // Uses the entry's processed samples in place: the loader keeps the bank mapped
+  // instead of copying them, and takes resampled data for a rate the bank holds from it
+  // too.
+  IRLoadResult loadFromBank(std::shared_ptr<const IRBank> bank, size_t entryIndex);
 
-  bool resampleAndInitialize(WDL_ImpulseBuffer& impulseBuffer, SampleRate targetSampleRate);
+  bool resampleAndInitialize(WDL_ImpulseBuffer& impulseBuffer, SampleRate targetSampleRate) const;
 
   SampleRate getIRSampleRate() const { return irSampleRate_; }
   size_t getNumSamples() const { return numSamples_; }
   int getNumChannels() const { return numChannels_; }
+  size_t getOriginalNumSamples() const { return originalNumSamples_; }
+  float getConvolutionCostSaved() const;
+  // Writes one channel of the loaded minimum-phase IR, getNumSamples() samples.
+  void copyChannel(int channel, Sample* destination) const;
 
  private:
   // Converts a single-channel IR to minimum phase in-place using the cepstrum method.
   // fftSize must be a power of 2, >= 2 * samples.size(), and a multiple of 32.
   static void convertToMinimumPhase(std::vector<Sample>& samples, int fftSize);
 
+  bool loadFromCache();
+  void truncateTail();
+  IRLoadResult makeResult() const;
+  void storeInCache() const;
+  bool resample(WDL_ImpulseBuffer& impulseBuffer, SampleRate targetSampleRate) const;
+  bool copyFromBank(WDL_ImpulseBuffer& impulseBuffer, SampleRate targetSampleRate) const;
+  Sample getSample(size_t frame, int channel) const;
+
+  std::shared_ptr<const IRCache> cache_;
+  IRCacheKey cacheKey_;
+  // Key of the resampled IR: cacheKey_, or its keyWithTailFloor() when the tail was cut.
+  IRCacheKey resampledKey_;
+  float tailFloorDb_ = 0.0f;
   std::vector<Sample> irBuffer_;
+  // Set instead of irBuffer_ when loaded from a bank: the planar minimum-phase IR in the
+  // bank's mapping.
+  std::shared_ptr<const IRBank> bank_;
+  size_t bankEntry_ = 0;
+  const Sample* bankSamples_ = nullptr;
   SampleRate irSampleRate_ = 0.0;
   size_t numSamples_ = 0;
+  size_t originalNumSamples_ = 0;
   int numChannels_ = 0;
 };
 
@@ -1,20 +1,55 @@
 #pragma once
 
 #include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
 #include <memory>
 #include <mutex>
 #include <string>
 #include <vector>
 
+#include "ConvolutionCostModel.hpp"
+#include "ConvolutionEngine.hpp"
+#include "DelayLine.hpp"
+#include "ForkJoinWorker.hpp"
+#include "IRKernelStore.hpp"
 #include "IRLoader.hpp"
+#include "LevelDetector.hpp"
+#include "RealtimeHandoff.hpp"
+#include "SilenceDetector.hpp"
 #include "Types.hpp"
 
-class WDL_ImpulseBuffer;          // NOLINT(readability-identifier-naming)
-class WDL_ConvolutionEngine_Div;  // NOLINT(readability-identifier-naming)
+class WDL_ImpulseBuffer;  // NOLINT(readability-identifier-naming)
 
 namespace octob
 {
 
+class ConvolutionKernel;
+class DualKernelConvolver;
+
+// Identifies one IRProcessor::requestLoad() call. Tickets increase with every request,
+// load and clear of a processor; 0 is never issued.
+using IRLoadTicket = uint64_t;
+
+enum class IRLoadStatus
+{
+  Loaded,
+  Failed,
+  Cancelled
+};
+
+struct IRLoadCompletion
+{
+  IRLoadTicket ticket = 0;
+  int slot = 0;
+  IRLoadStatus status = IRLoadStatus::Cancelled;
+  std::string filepath;
+  std::string errorMessage;
+};
+
+using IRLoadCallback = std::function<void(const IRLoadCompletion&)>;
+
 class IRProcessor
 {
  public:
@@ -26,6 +61,37 @@ class IRProcessor
   void clearImpulseResponse1();
   void clearImpulseResponse2();
 
+  // Loads an IR into slot 1 or 2 on the shared WorkerPool and stages it like
+  // loadImpulseResponse1/2. A later request, load or clear of the slot, or a slot swap,
+  // supersedes it: the request stops at its next step and completes as Cancelled. The
+  // callback runs exactly once, on the worker thread, after a loaded IR has been staged.
+  // Returns 0 without calling back if slot is not 1 or 2.
+  IRLoadTicket requestLoad(int slot, const std::string& filepath, IRLoadCallback callback);
+  // Supersedes every outstanding request and waits for running ones to call back. Must
+  // not be called from a load callback.
+  void cancelPendingLoads();
+
+  // Prepares files for slot 1 or 2 on the shared WorkerPool, each into an engine ready
+  // to run, so a later load or requestLoad() of one of them is a swap with no file,
+  // resampling or FFT work. Pass the files most likely to be picked first, e.g. from
+  // neighboringFiles(): preparation stops at the prefetch budget. Replaces the slot's
+  // previous set; prepared files no longer listed are released. Preparations made under
+  // other settings than the load's are ignored, and the load runs as usual.
+  void prefetchImpulseResponses(int slot, const std::vector<std::string>& filepaths);
+  // Memory the prepared files of both slots may hold. Lowering it releases nothing until
+  // the next prefetch.
+  void setPrefetchBudget(size_t bytes);
+  size_t getPrefetchBudget() const;
+  size_t getPrefetchedBytes() const;
+  size_t getNumPrefetched(int slot) const;
+
+  // Up to radius files on either side of files[index] in a sorted folder listing, nearest
+  // first and alternating next/previous, wrapping around the ends as folder navigation
+  // does. Excludes files[index] itself.
+  static std::vector<std::string> neighboringFiles(const std::vector<std::string>& files,
+                                                   size_t index, int radius);
+  static constexpr size_t DefaultPrefetchBudget = 32 * 1024 * 1024;
+
   void setSampleRate(SampleRate sampleRate);
   void setMaxBlockSize(FrameCount maxBlockSize);
   void setBlend(float blend);
@@ -43,6 +109,38 @@ class IRProcessor
   void setOutputGain(float gainDb);
   void setIRATrimGain(float gainDb);
   void setIRBTrimGain(float gainDb);
+  // Selects the convolution engine per slot. The slot's IR is rebuilt on the new engine
+  // and swapped in like a load; latency compensation follows the engine's latency.
+  // Auto (the default) picks the direct FIR or WDL from the resampled IR length, using
+  // costs measured in setMaxBlockSize(). While both slots are active and both are Auto or
+  // Pffft, the blend runs through one shared-spectrum convolver instead of the slots'
+  // engines; pinning either slot to Wdl or Direct keeps both on their own engines.
+  void setIRAEngine(ConvolutionEngineType type);
+  void setIRBEngine(ConvolutionEngineType type);
+  // Runs every slot with zero latency: engines that partition in blocks convolve their
+  // first partition in the time domain. getLatencySamples() then reports 0 and the
+  // delay-alignment buffers are bypassed.
+  void setZeroLatencyMode(bool enabled);
+  // Convolves the late partitions of long IRs on a worker thread. This changes the
+  // engines: Auto slots use the zero-latency pffft engine for IRs long enough to split
+  // instead of the one the cost model picks, and the shared-spectrum blend path is
+  // disabled so both slots keep their worker. Output matches the realtime engines to
+  // within rounding.
+  void setBackgroundTailEnabled(bool enabled);
+  // Non-realtime rendering, e.g. a host's offline bounce. Slots that would run pffft use
+  // PffftConvolutionEngine::RenderBlockSize partitions, far cheaper per sample for long
+  // IRs at the cost of that much latency, and when both slots run their own engines
+  // slot B convolves on a helper thread alongside slot A. Zero-latency mode keeps the
+  // realtime engines. Engines are swapped in like a load; getLatencySamples() follows
+  // at the next process call, getStagedLatencySamples() right away.
+  void setRenderMode(bool enabled);
+  // Preprocessed IRs are read from and added to this cache on later loads. Instances
+  // can share one cache; pass nullptr to always process from the file.
+  void setIRCache(std::shared_ptr<const IRCache> cache);
+  // Later loads cut each IR's tail where its remaining energy falls below floorDb, as
+  // IRLoader::setTailFloorDb() does; 0, the default, keeps whole IRs. Loaded IRs keep
+  // their length until reloaded.
+  void setTailFloorDb(float floorDb);
 
   void processMono(const Sample* input, Sample* output, FrameCount numFrames);
   void processStereo(const Sample* inputL, const Sample* inputR, Sample* outputL, Sample* outputR,
@@ -59,15 +157,30 @@ class IRProcessor
                                   Sample* outputL, Sample* outputR, FrameCount numFrames);
   bool isIR1Loaded() const { return ir1Loaded_.load(); }
   bool isIR2Loaded() const { return ir2Loaded_.load(); }
-  std::string getCurrentIR1Path() const { return currentIR1Path_; }
-  std::string getCurrentIR2Path() const { return currentIR2Path_; }
+  std::string getCurrentIR1Path() const;
+  std::string getCurrentIR2Path() const;
   SampleRate getIR1SampleRate() const;
   SampleRate getIR2SampleRate() const;
   size_t getIR1NumSamples() const;
   size_t getIR2NumSamples() const;
+  // Lengths before tail truncation, for showing what setTailFloorDb() trimmed.
+  size_t getIR1OriginalNumSamples() const;
+  size_t getIR2OriginalNumSamples() const;
+  // Silent partitions and channels of each slot's kernel, which the pffft engines and the
+  // shared-spectrum blend skip. Empty while the slot has no IR or neither of those
+  // convolves it, e.g. when Auto picks the direct or WDL engine.
+  KernelDiagnostics getIR1KernelDiagnostics() const;
+  KernelDiagnostics getIR2KernelDiagnostics() const;
   int getNumIR1Channels() const;
   int getNumIR2Channels() const;
   int getLatencySamples() const;
+  // The latency getLatencySamples() will report once the engines staged so far are
+  // picked up, for reporting a change to the host before the next process call.
+  int getStagedLatencySamples() const;
+  // Samples of output that follow the last non-silent input: the longest loaded IR plus
+  // the latency. Once the input has been silent that long, process calls skip the
+  // engines and output silence until signal returns.
+  int getTailLengthSamples() const;
   float getBlend() const { return blend_; }
 
   float calculateDynamicBlend(float inputLevelDb) const;
@@ -85,6 +198,13 @@ class IRProcessor
   float getOutputGain() const { return outputGainDb_; }
   float getIRATrimGain() const { return irATrimGainDb_; }
   float getIRBTrimGain() const { return irBTrimGainDb_; }
+  ConvolutionEngineType getIRAEngine() const { return engineType1_; }
+  ConvolutionEngineType getIRBEngine() const { return engineType2_; }
+  bool getZeroLatencyMode() const { return zeroLatencyMode_; }
+  bool getBackgroundTailEnabled() const { return backgroundTail_; }
+  bool getRenderMode() const { return renderMode_; }
+  const std::shared_ptr<const IRCache>& getIRCache() const { return irCache_; }
+  float getTailFloorDb() const;
   float getCurrentInputLevel() const { return currentInputLevelDb_; }
   float getCurrentBlend() const { return currentBlend_; }
 
@@ -93,13 +213,14 @@ class IRProcessor
   void reset();
 
  private:
-  std::unique_ptr<WDL_ImpulseBuffer> impulseBuffer1_;
-  std::unique_ptr<WDL_ConvolutionEngine_Div> convolutionEngine1_;
-  std::unique_ptr<IRLoader> irLoader1_;
+  // Guards the loaded IRs, their paths and the engine settings, which the caller's
+  // thread and load workers both touch. Also serializes publication to the audio thread.
+  mutable std::mutex controlMutex_;
 
-  std::unique_ptr<WDL_ImpulseBuffer> impulseBuffer2_;
-  std::unique_ptr<WDL_ConvolutionEngine_Div> convolutionEngine2_;
-  std::unique_ptr<IRLoader> irLoader2_;
+  // Loaded IRs, shared read-only through IRKernelStore with every instance that loaded
+  // the same file at the same rate.
+  std::shared_ptr<const SharedIR> ir1_;
+  std::shared_ptr<const SharedIR> ir2_;
 
   SampleRate sampleRate_ = 44100.0;
   std::string currentIR1Path_;
@@ -108,19 +229,86 @@ class IRProcessor
   std::atomic<bool> ir2Loaded_{false};
   int latencySamples1_ = 0;
   int latencySamples2_ = 0;
+  int irLength1_ = 0;
+  int irLength2_ = 0;
+  SilenceDetector silence_;
+  ConvolutionEngineType engineType1_ = ConvolutionEngineType::Auto;
+  ConvolutionEngineType engineType2_ = ConvolutionEngineType::Auto;
+  ConvolutionCostModel costModel_;
+  int costModelBlockSize_ = 0;
+  bool zeroLatencyMode_ = false;
+  bool backgroundTail_ = false;
+  bool renderMode_ = false;
+  // Latency of each slot's most recently published engine.
+  int stagedLatency1_ = 0;
+  int stagedLatency2_ = 0;
+  int stagedLength1_ = 0;
+  int stagedLength2_ = 0;
+  // Whether each slot's most recently published engine convolves with the slot's kernel,
+  // and whether the most recently staged shared-spectrum engine is prepared.
+  bool stagedUsesKernel1_ = false;
+  bool stagedUsesKernel2_ = false;
+  bool stagedDual_ = false;
+  std::atomic<int> stagedTailSamples_{0};
+  std::shared_ptr<const IRCache> irCache_;
+  float tailFloorDb_ = 0.0f;
+  // Bumped whenever staged engines are rebuilt, so a load that built its engine with
+  // older settings rebuilds it before staging.
+  unsigned int engineGeneration_ = 0;
 
-  std::unique_ptr<WDL_ConvolutionEngine_Div> stagingEngine1_;
-  bool stagingLoaded1_ = false;
-  int stagingLatency1_ = 0;
+  // Latest ticket issued per slot; any other ticket for the slot is superseded.
+  std::atomic<IRLoadTicket> nextTicket_{0};
+  std::atomic<IRLoadTicket> latestTicket1_{0};
+  std::atomic<IRLoadTicket> latestTicket2_{0};
+  std::mutex loadsMutex_;
+  std::condition_variable loadsIdle_;
+  int loadsInFlight_ = 0;
+
+  // A prefetched file: its IR and an engine initialized with it under engineGeneration_
+  // generation, ready to commit while that generation, the IR's rate and its tail floor
+  // are current.
+  struct PreparedIR
+  {
+    std::string filepath;
+    std::shared_ptr<const SharedIR> ir;
+    std::unique_ptr<ConvolutionEngine> engine;
+    int latency = 0;
+    unsigned int generation = 0;
+    size_t bytes = 0;
+  };
 
-  std::unique_ptr<WDL_ConvolutionEngine_Div> stagingEngine2_;
-  bool stagingLoaded2_ = false;
-  int stagingLatency2_ = 0;
+  // Guarded by controlMutex_. A prefetch runs while its ticket is the slot's latest.
+  std::vector<std::unique_ptr<PreparedIR>> prepared1_;
+  std::vector<std::unique_ptr<PreparedIR>> prepared2_;
+  size_t prefetchBudget_ = DefaultPrefetchBudget;
+  size_t prefetchedBytes_ = 0;
+  std::atomic<IRLoadTicket> prefetchTicket1_{0};
+  std::atomic<IRLoadTicket> prefetchTicket2_{0};
 
-  std::mutex pendingMutex1_;
-  std::mutex pendingMutex2_;
-  std::atomic<bool> ir1Pending_{false};
-  std::atomic<bool> ir2Pending_{false};
+  // What the audio thread runs for one slot, published as a unit.
+  struct SlotEngine
+  {
+    std::unique_ptr<ConvolutionEngine> engine;
+    bool loaded = false;
+    int latency = 0;
+    int length = 0;  // IR length in samples at the processing rate
+  };
+
+  // Engines are built on the control side and published wait-free; the audio thread
+  // picks them up at the start of the next process call.
+  RealtimeHandoff<SlotEngine> slot1_;
+  RealtimeHandoff<SlotEngine> slot2_;
+  // Shared-input-spectrum engine for the A/B blend when both slots are active, built
+  // from the kernels of ir1_/ir2_. Unprepared when there is nothing to blend.
+  RealtimeHandoff<DualKernelConvolver> dual_;
+
+  // Audio-thread views of the current publications.
+  ConvolutionEngine* convolutionEngine1_ = nullptr;
+  ConvolutionEngine* convolutionEngine2_ = nullptr;
+  DualKernelConvolver* dualConvolver_ = nullptr;
+  // Render mode's helper thread for slot B, and whether the audio thread uses it.
+  ForkJoinWorker renderWorker_;
+  std::atomic<bool> parallelSlots_{false};
   float blend_ = 0.0f;
 
   bool irAEnabled_ = true;
@@ -131,10 +319,16 @@ class IRProcessor
   float rangeDb_ = 20.0f;
   float kneeWidthDb_ = 5.0f;
   int detectionMode_ = 0;
-  std::vector<float> rmsBuffer_;
-  size_t rmsBufferIndex_ = 0;
-  size_t rmsBufferSize_ = 0;
   static constexpr float RmsWindowMs = 10.0f;
+  // Holds the RMS window at sample rates up to 384 kHz; allocated once at construction.
+  // The audio thread takes up a new window length from rmsWindowTarget_.
+  static constexpr size_t RmsBufferCapacity = static_cast<size_t>(RmsWindowMs * 384.0f);
+  // Indexed by detection mode; the main-input and sidechain paths share them.
+  static constexpr int NumDetectionModes = 2;
+  PeakDetector peakDetector_;
+  RmsDetector rmsDetector_;
+  LevelDetector* const levelDetectors_[NumDetectionModes] = {&peakDetector_, &rmsDetector_};
+  std::atomic<size_t> rmsWindowTarget_{0};
   float attackTimeMs_ = 50.0f;
   float releaseTimeMs_ = 200.0f;
   float outputGainDb_ = 0.0f;
@@ -154,18 +348,13 @@ class IRProcessor
   std::vector<Sample> scratchL_;
   std::vector<Sample> scratchR_;
 
-  std::vector<Sample> dryDelayBufferL_;
-  std::vector<Sample> dryDelayBufferR_;
-  std::vector<Sample> ir1DelayBufferL_;
-  std::vector<Sample> ir1DelayBufferR_;
-  std::vector<Sample> ir2DelayBufferL_;
-  std::vector<Sample> ir2DelayBufferR_;
-  size_t dryDelayWritePosL_ = 0;
-  size_t dryDelayWritePosR_ = 0;
-  size_t ir1DelayWritePosL_ = 0;
-  size_t ir1DelayWritePosR_ = 0;
-  size_t ir2DelayWritePosL_ = 0;
-  size_t ir2DelayWritePosR_ = 0;
+  // Per-channel alignment delays, allocated in setMaxBlockSize() for
+  // ConvolutionEngine::MaxLatencySamples. alignedLatency_ is the slot latency they are
+  // running at, 0 while nothing needs aligning and they are bypassed.
+  DelayLine dryDelay_[2];
+  DelayLine ir1Delay_[2];
+  DelayLine ir2Delay_[2];
+  int alignedLatency_ = 0;
   std::atomic<int> maxLatencySamples_{0};
 
   struct BlendGains
@@ -174,20 +363,80 @@ class IRProcessor
     float gain2;
   };
 
+  // Gains resolved for the previous block, where this block's blend ramp starts, and the
+  // slot state they were resolved under. 0 after reset() and while nothing is loaded, so
+  // the first block starts steady.
+  BlendGains previousGains_ = {0.0f, 0.0f};
+  int previousGainLaw_ = 0;
+
+  enum class ChannelLayout
+  {
+    Mono,
+    Stereo,
+    MonoToStereo
+  };
+
+  // Which slots a block convolves. With one slot the other side of the blend is dry.
+  enum class SlotConfig
+  {
+    Both,
+    OnlyA,
+    OnlyB
+  };
+
+  // The engines a block ran through. Engines left out of a block miss its input, so one
+  // that is switched back to starts over from silence rather than replaying stale history.
+  enum class ProcessPath
+  {
+    Passthrough,
+    Dual,
+    OnlyA,
+    OnlyB,
+    Both
+  };
+  ProcessPath previousPath_ = ProcessPath::Passthrough;
+
   BlendGains resolveBlendGains(float inputLevelDb, FrameCount numFrames, bool applySmoothing,
                                bool hasIR1, bool hasIR2);
 
-  static float detectPeakLevel(const Sample* buffer, FrameCount numFrames);
-  float detectRMSLevel(const Sample* buffer, FrameCount numFrames);
+  float detectLevel(const Sample* buffer, FrameCount numFrames);
   void updateSmoothingCoefficients();
   void updateRMSBufferSize();
   void applyOutputGain(Sample* buffer, FrameCount numFrames) const;
-  void updateDelayBuffers();
-  static void writeToDelayBuffer(std::vector<Sample>& buffer, size_t& writePos, const Sample* input,
-                                 FrameCount numFrames);
-  static void readFromDelayBuffer(const std::vector<Sample>& buffer, size_t writePos,
-                                  Sample* output, FrameCount numFrames, int delaySamples);
+  void updateDelayLines();
+  void clearDelayLines();
+  template <ChannelLayout Layout, bool Sidechain>
+  void processBlock(const Sample* inputL, const Sample* inputR, const Sample* sidechainL,
+                    const Sample* sidechainR, Sample* outputL, Sample* outputR,
+                    FrameCount numFrames);
+  template <ChannelLayout Layout, SlotConfig Slots>
+  void mixSlots(const Sample* const* inputs, Sample* const* outputs, FrameCount numFrames,
+                const BlendGains& from, const BlendGains& to);
   void applyPendingIRUpdates();
+  void addToBothEngines(const Sample* const* inputs, FrameCount numFrames);
+  bool skipSilentBlock(const Sample* inputL, const Sample* inputR, FrameCount numFrames);
+  void switchPath(ProcessPath path);
+  bool loadSlot(int slot, const std::string& filepath, std::string& errorMessage);
+  IRLoadStatus loadSlotInBackground(int slot, IRLoadTicket ticket, const std::string& filepath,
+                                    std::string& errorMessage);
+  void commitSlot(int slot, std::shared_ptr<const SharedIR> ir,
+                  std::unique_ptr<ConvolutionEngine> engine, int latency,
+                  const std::string& filepath);
+  void publishSlot(int slot, std::unique_ptr<ConvolutionEngine> engine, bool loaded, int latency,
+                   int irLength);
+  IRLoadTicket supersedeLoads(int slot);
+  bool isSuperseded(int slot, IRLoadTicket ticket) const;
+  void prefetchInBackground(int slot, IRLoadTicket ticket,
+                            const std::vector<std::string>& filepaths);
+  bool isPrefetchSuperseded(int slot, IRLoadTicket ticket) const;
+  bool isCurrent(const PreparedIR& prepared) const;
+  std::unique_ptr<PreparedIR> takePrepared(int slot, const std::string& filepath);
+  std::unique_ptr<ConvolutionEngine> createEngine(ConvolutionEngineType type, int irLength) const;
+  void restageEngine1();
+  void restageEngine2();
+  void stageDualConvolver();
+  bool useDualConvolver(bool hasIR1, bool hasIR2) const;
+  bool isKernelInUse(int slot) const;
 };
 
 }  // namespace octob
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <vector>
+
+#include "Types.hpp"
+
+namespace octob
+{
+
+// Measures the level that drives IRProcessor's dynamic blend, from the main input or the
+// sidechain. process() takes one block and returns the level in dB as of its last
+// sample. Implementations cost O(1) per sample whatever the block size, never allocate
+// in process() or reset(), and keep whatever state they need between calls, so the
+// same detector serves one-sample and full-block callers alike.
+class LevelDetector
+{
+ public:
+  // Reported for silence and for anything below -120 dBFS.
+  static constexpr float FloorDb = -96.0f;
+
+  LevelDetector() = default;
+  virtual ~LevelDetector() = default;
+
+  LevelDetector(const LevelDetector&) = delete;
+  LevelDetector& operator=(const LevelDetector&) = delete;
+
+  virtual float process(const Sample* buffer, FrameCount numFrames) = 0;
+  virtual void reset() = 0;
+
+ protected:
+  // dB of a linear amplitude, FloorDb below 1e-6.
+  static float toDb(float amplitude);
+};
+
+// Largest magnitude in the block. Stateless.
+class PeakDetector : public LevelDetector
+{
+ public:
+  float process(const Sample* buffer, FrameCount numFrames) override;
+  void reset() override {}
+
+  // Largest magnitude in the buffer, reduced in independent lanes so it vectorizes.
+  static float findPeak(const Sample* buffer, FrameCount numFrames);
+};
+
+// RMS over a sliding window of the most recent samples. The sum of squares is kept
+// running in double precision and recomputed from the window each time the write
+// position wraps, so rounding cannot accumulate for more than one window.
+class RmsDetector : public LevelDetector
+{
+ public:
+  // Allocates room for windows of up to maxWindowLength samples.
+  explicit RmsDetector(size_t maxWindowLength);
+
+  // Clamped to [1, getMaxWindowLength()]. A new length restarts the window from
+  // silence; realtime-safe.
+  void setWindowLength(size_t length);
+  size_t getWindowLength() const { return windowLength_; }
+  size_t getMaxWindowLength() const { return squares_.size(); }
+
+  float process(const Sample* buffer, FrameCount numFrames) override;
+  void reset() override;
+
+ private:
+  std::vector<float> squares_;
+  size_t windowLength_ = 1;
+  size_t writePos_ = 0;
+  double sum_ = 0.0;
+};
+
+}  // namespace octob
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace octob
+{
+
+// Read-only memory mapping of a whole file, unmapped when closed or destroyed. Pages are
+// read on first access and shared through the page cache with every other mapping of
+// the file.
+class MappedFile
+{
+ public:
+  MappedFile() = default;
+  ~MappedFile();
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  // False if the file cannot be opened, is empty or cannot be mapped.
+  bool open(const std::string& path);
+  void close();
+
+  bool isOpen() const { return data_ != nullptr; }
+  const void* getData() const { return data_; }
+  size_t getSize() const { return size_; }
+
+ private:
+  void* data_ = nullptr;
+  size_t size_ = 0;
+};
+
+}  // namespace octob
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "ConvolutionKernel.hpp"
+#include "Types.hpp"
+
+struct PFFFT_Setup;  // NOLINT(readability-identifier-naming)
+
+namespace octob
+{
+
+// Uniformly partitioned overlap-save convolution for a single input channel.
+//
+// The spectrum of each input block is computed once and kept in a frequency-domain
+// delay line, so one input can be convolved with several kernels or kernel channels
+// (IR slots, stereo IR channels) for the cost of a single forward FFT. Products are
+// summed into per-output spectral accumulators, each finished with one inverse FFT.
+//
+// Processing is block based: pushBlock() takes exactly getBlockSize() samples and
+// finish() yields the matching getBlockSize() output samples. Driven from a FIFO this
+// gives one block of latency.
+class PartitionedConvolver
+{
+ public:
+  PartitionedConvolver();
+  ~PartitionedConvolver();
+
+  PartitionedConvolver(const PartitionedConvolver&) = delete;
+  PartitionedConvolver& operator=(const PartitionedConvolver&) = delete;
+
+  // Allocates history for kernels of up to maxPartitions partitions and numAccumulators
+  // independent outputs. Allocates; call from a non-realtime thread.
+  bool prepare(int blockSize, int maxPartitions, int numAccumulators);
+  void reset();
+
+  void pushBlock(const Sample* input);
+  // accumulator += gain * (input history (*) kernel channel), in the frequency domain.
+  // The kernel's silent partitions are skipped.
+  void accumulate(const ConvolutionKernel& kernel, int channel, float gain, int accumulator);
+  // Like accumulate(), but skips partition 0 and shifts the rest one block earlier:
+  // once finished, the accumulator holds the tail contribution for the block *after*
+  // the one just pushed. Pair with a direct-form head over the first getBlockSize()
+  // taps for zero latency. The history only needs maxPartitions = partitions - 1.
+  void accumulateTail(const ConvolutionKernel& kernel, int channel, float gain, int accumulator);
+  // General form of the two above: partitions from firstPartition on, each paired with
+  // the block pushed (k - firstPartition) blocks ago, giving the contribution to the
+  // block firstPartition blocks after the one just pushed. Lets the partitions of one
+  // kernel be split across convolvers (e.g. near on the audio thread, far elsewhere);
+  // each needs maxPartitions = partitions it covers.
+  void accumulateFrom(const ConvolutionKernel& kernel, int channel, float gain, int accumulator,
+                      int firstPartition);
+  // Inverse-transforms an accumulator into getBlockSize() samples and clears it.
+  void finish(int accumulator, Sample* output);
+  // Inverse-transforms gainA * accumulatorA + gainB * accumulatorB into getBlockSize()
+  // samples with one inverse FFT. Both accumulators are left as they are, to be
+  // finish()ed or clear()ed later.
+  void finishSum(int accumulatorA, float gainA, int accumulatorB, float gainB, Sample* output);
+  void clear(int accumulator);
+
+  int getBlockSize() const { return blockSize_; }
+  int getMaxPartitions() const { return maxPartitions_; }
+
+ private:
+  void release();
+
+  PFFFT_Setup* fft_ = nullptr;
+  int blockSize_ = 0;
+  int maxPartitions_ = 0;
+  int numAccumulators_ = 0;
+  int head_ = 0;
+  float* window_ = nullptr;
+  float* history_ = nullptr;
+  float* accumulators_ = nullptr;
+  float* scratch_ = nullptr;
+  float* work_ = nullptr;
+};
+
+}  // namespace octob
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "ConvolutionEngine.hpp"
+#include "ConvolutionKernel.hpp"
+#include "PartitionedConvolver.hpp"
+#include "TailWorker.hpp"
+
+namespace octob
+{
+
+// Uniformly partitioned convolution on pffft's SIMD real transforms (SSE / NEON).
+//
+// The IR is held as a ConvolutionKernel: per-partition spectra in pffft's interleaved
+// internal layout, 64-byte aligned, so the per-partition complex multiply-accumulate
+// runs vectorized without reordering.
+//
+// By default latency is one block; the output queue is primed with that many zeros so
+// avail() always covers the frames just added. In zero-latency mode the first block of
+// taps runs as a direct-form FIR per sample and only the remaining partitions go
+// through the FFT, one block ahead of when they are needed.
+//
+// For long IRs the partitions from BackgroundFirstPartition on can be handed to a
+// TailWorker thread, leaving only the near partitions on the audio thread.
+//
+// Silent partitions of the kernel are skipped, and an output whose kernel channel is
+// silent throughout is not convolved at all, so a stereo IR with an empty channel runs
+// at mono cost (see KernelDiagnostics).
+class PffftConvolutionEngine final : public ConvolutionEngine
+{
+ public:
+  static constexpr int DefaultBlockSize = 64;
+  static_assert(DefaultBlockSize <= MaxLatencySamples, "block latency exceeds the engine bound");
+  // Block size for non-realtime rendering: 16 times fewer partitions to multiply and
+  // accumulate per block than DefaultBlockSize, for as many samples of latency.
+  static constexpr int RenderBlockSize = 1024;
+  static_assert(RenderBlockSize <= MaxLatencySamples, "block latency exceeds the engine bound");
+  static constexpr int MaxChannels = 2;
+  // First partition convolved by the TailWorker. Also the worker's slack in blocks.
+  static constexpr int BackgroundFirstPartition = 16;
+
+  enum class TailMode : uint8_t
+  {
+    AudioThread,  // All partitions in add()
+    Background,   // Far partitions on a TailWorker thread
+    Inline,       // Same split as Background, run in add(); its single-threaded reference
+  };
+
+  explicit PffftConvolutionEngine(int blockSize = DefaultBlockSize, bool zeroLatency = false,
+                                  TailMode tailMode = TailMode::AudioThread);
+
+  int setImpulse(WDL_ImpulseBuffer& impulse) override;
+  // Uses the kernel when its block size matches the engine's.
+  int setSharedImpulse(WDL_ImpulseBuffer& impulse,
+                       std::shared_ptr<const ConvolutionKernel> kernel) override;
+  // Uses an already-built kernel, e.g. one shared with other engines. The kernel's
+  // block size replaces the engine's.
+  int setKernel(std::shared_ptr<const ConvolutionKernel> kernel);
+
+  void add(const Sample* const* inputs, int numFrames, int numChannels) override;
+  int avail(int wantFrames) override;
+  Sample** get() override;
+  void advance(int numFrames) override;
+  void reset() override;
+  bool usesKernel() const override { return true; }
+
+  int getBlockSize() const { return blockSize_; }
+  bool isZeroLatency() const { return zeroLatency_; }
+  TailMode getTailMode() const { return tailMode_; }
+  // Null unless the current kernel is long enough to split.
+  const TailWorker* getTailWorker() const { return tailWorker_.get(); }
+
+ private:
+  void addBlocked(const Sample* const* inputs, int numFrames, int numChannels);
+  void addZeroLatency(const Sample* const* inputs, int numFrames, int numChannels);
+  void processBlock(int numChannels);
+  void processTail(int numChannels);
+  void reserveQueue(size_t numFrames);
+
+  std::shared_ptr<const ConvolutionKernel> kernel_;
+  int blockSize_;
+  bool zeroLatency_;
+  TailMode tailMode_;
+  int blockPos_ = 0;
+  int historyPos_ = 0;
+  int numChannels_ = 1;
+  // Outputs whose kernel channel is silent; they output zeros.
+  bool silentOutputs_[MaxChannels] = {};
+
+  PartitionedConvolver convolvers_[MaxChannels];
+  std::unique_ptr<TailWorker> tailWorker_;
+  std::vector<Sample> blockInput_[MaxChannels];
+  std::vector<Sample> blockOutput_[MaxChannels];
+  // Zero-latency mode: input history written twice so the FIR window is contiguous,
+  // and the kernel's first block of taps, time-reversed.
+  std::vector<Sample> history_[MaxChannels];
+  std::vector<Sample> headTaps_[MaxChannels];
+
+  // Output queue, kept contiguous so get() can hand out plain pointers.
+  std::vector<Sample> queue_[MaxChannels];
+  size_t queueStart_ = 0;
+  size_t queueEnd_ = 0;
+  Sample* outputPtrs_[MaxChannels] = {};
+};
+
+}  // namespace octob
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+#include "SpscRing.hpp"
+
+namespace octob
+{
+
+// Hands objects built on a control thread to a single realtime reader without locks.
+// publish() exchanges the new object into a pending pointer; the reader takes it with
+// acquire() and parks the object it replaces in a preallocated retire ring, which the
+// control side frees on its next publish() or collect(). The reader never allocates,
+// frees or waits, and a publication is picked up on the reader's next acquire().
+//
+// Only the reader dereferences get(), so no grace period is needed: an object is
+// retired at the moment the reader stops using it. Publishers must be serialized by the
+// caller, and the reader must be stopped before the handoff is destroyed.
+template <typename T>
+class RealtimeHandoff
+{
+ public:
+  // The control side collects before every publish, so at most a couple of objects
+  // are ever parked. If the ring is full, acquire() leaves the object pending.
+  static constexpr size_t RetireCapacity = 4;
+
+  RealtimeHandoff() { retired_.prepare(RetireCapacity); }
+
+  ~RealtimeHandoff()
+  {
+    collect();
+    delete pending_.exchange(nullptr, std::memory_order_acquire);
+    delete current_;
+  }
+
+  RealtimeHandoff(const RealtimeHandoff&) = delete;
+  RealtimeHandoff& operator=(const RealtimeHandoff&) = delete;
+
+  // Control side. object must not be null. A publication the reader has not acquired
+  // yet is replaced and freed here.
+  void publish(std::unique_ptr<T> object)
+  {
+    collect();
+    delete pending_.exchange(object.release(), std::memory_order_acq_rel);
+  }
+
+  // Control side. Frees the objects the reader has retired.
+  void collect()
+  {
+    while (T** retired = retired_.beginRead())
+    {
+      delete *retired;
+      retired_.endRead();
+    }
+  }
+
+  // Reader side. Returns true when a newly published object became current.
+  bool acquire()
+  {
+    if (pending_.load(std::memory_order_relaxed) == nullptr)
+      return false;
+
+    T** retireSlot = retired_.beginWrite();
+    if (retireSlot == nullptr)
+      return false;
+
+    T* next = pending_.exchange(nullptr, std::memory_order_acq_rel);
+    if (next == nullptr)
+      return false;
+
+    *retireSlot = current_;
+    retired_.endWrite();
+    current_ = next;
+    return true;
+  }
+
+  // Reader side. Null until the first acquire().
+  T* get() const { return current_; }
+
+ private:
+  std::atomic<T*> pending_{nullptr};
+  T* current_ = nullptr;
+  SpscRing<T*> retired_;
+};
+
+}  // namespace octob
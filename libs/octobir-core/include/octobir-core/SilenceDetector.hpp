@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cmath>
+
+#include "Types.hpp"
+
+namespace octob
+{
+
+// Tracks how long a processor's input has been silent so it can stop running DSP once
+// everything it still had to output has been output. A block may be skipped, with
+// silence written in its place, when it is silent and the silence before it already
+// covers the processor's tail. Any block with a sample above the threshold is processed
+// in full, so the processor wakes on the first sample of returning signal.
+class SilenceDetector
+{
+ public:
+  // About -160 dBFS; well below dither, so only digital silence and decayed tails count.
+  static constexpr float Threshold = 1.0e-8f;
+
+  // True when no sample's magnitude exceeds Threshold. Compares and ORs in chunks so the
+  // inner loop vectorizes, and returns at the first chunk with signal.
+  static bool isSilent(const Sample* buffer, FrameCount numFrames)
+  {
+    constexpr FrameCount ChunkSize = 16;
+    FrameCount i = 0;
+    for (; i + ChunkSize <= numFrames; i += ChunkSize)
+    {
+      int loud = 0;
+      for (FrameCount j = 0; j < ChunkSize; ++j)
+        loud |= std::fabs(buffer[i + j]) > Threshold;
+      if (loud)
+        return false;
+    }
+    for (; i < numFrames; ++i)
+      if (std::fabs(buffer[i]) > Threshold)
+        return false;
+    return true;
+  }
+
+  // Frames of silent input after which the output is silent too.
+  void setTailSamples(FrameCount tailSamples) { tailSamples_ = tailSamples; }
+  FrameCount getTailSamples() const { return tailSamples_; }
+
+  // Records one block and returns true when it can be skipped.
+  bool skip(bool silent, FrameCount numFrames)
+  {
+    if (!silent)
+    {
+      silentFrames_ = 0;
+      idle_ = false;
+      return false;
+    }
+    if (silentFrames_ >= tailSamples_)
+    {
+      idle_ = true;
+      return true;
+    }
+    silentFrames_ += numFrames;
+    return false;
+  }
+
+  // True from the first skipped block until signal returns.
+  bool isIdle() const { return idle_; }
+
+  void reset()
+  {
+    silentFrames_ = 0;
+    idle_ = false;
+  }
+
+ private:
+  FrameCount tailSamples_ = 0;
+  FrameCount silentFrames_ = 0;
+  bool idle_ = false;
+};
+
+}  // namespace octob
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+namespace octob
+{
+
+// Lock-free single-producer single-consumer ring of preallocated slots. The producer
+// fills the slot from beginWrite() in place and publishes it with endWrite(); the
+// consumer reads beginRead() and releases it with endRead(). Nothing allocates after
+// prepare().
+template <typename T>
+class SpscRing
+{
+ public:
+  SpscRing() = default;
+
+  SpscRing(const SpscRing&) = delete;
+  SpscRing& operator=(const SpscRing&) = delete;
+
+  // Not thread-safe; call before either side runs. Returns the slots for setup.
+  std::vector<T>& prepare(size_t capacity)
+  {
+    slots_.assign(capacity + 1, T());
+    clear();
+    return slots_;
+  }
+
+  // Only while neither side is inside a begin/end pair.
+  void clear()
+  {
+    writeIndex_.store(0, std::memory_order_relaxed);
+    readIndex_.store(0, std::memory_order_release);
+  }
+
+  // Producer side. Returns nullptr when full.
+  T* beginWrite()
+  {
+    const size_t write = writeIndex_.load(std::memory_order_relaxed);
+    if (next(write) == readIndex_.load(std::memory_order_acquire))
+      return nullptr;
+    return &slots_[write];
+  }
+
+  void endWrite()
+  {
+    const size_t write = writeIndex_.load(std::memory_order_relaxed);
+    writeIndex_.store(next(write), std::memory_order_release);
+  }
+
+  // Consumer side. Returns nullptr when empty.
+  T* beginRead()
+  {
+    const size_t read = readIndex_.load(std::memory_order_relaxed);
+    if (read == writeIndex_.load(std::memory_order_acquire))
+      return nullptr;
+    return &slots_[read];
+  }
+
+  void endRead()
+  {
+    const size_t read = readIndex_.load(std::memory_order_relaxed);
+    readIndex_.store(next(read), std::memory_order_release);
+  }
+
+ private:
+  size_t next(size_t index) const { return index + 1 == slots_.size() ? 0 : index + 1; }
+
+  std::vector<T> slots_;
+  std::atomic<size_t> writeIndex_{0};
+  std::atomic<size_t> readIndex_{0};
+};
+
+}  // namespace octob
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "ConvolutionKernel.hpp"
+#include "PartitionedConvolver.hpp"
+#include "SpscRing.hpp"
+#include "Types.hpp"
+
+namespace octob
+{
+
+// Convolves the late partitions of a kernel, from firstPartition on, off the audio
+// thread.
+//
+// The audio thread push()es each input block and pop()s one block of tail output per
+// push. A far partition's contribution is not needed until firstPartition blocks after
+// its input arrives, so results are produced that far ahead: pop() returns zeros for
+// the first leadBlocks pushes and the worker has (leadBlocks - 1) blocks of slack per
+// job. Jobs run in submission order, which is also deadline order. When a result is
+// late, pop() runs the queued jobs itself rather than wait for the worker: it waits at
+// most for the one job the worker is in the middle of, and counts the miss in
+// getMissedDeadlines(). Either thread may run a job, one at a time.
+//
+// Without a thread, push() runs the job inline. All modes run the same code in the
+// same order, so their output is bit-identical, deadlines missed or not.
+class TailWorker
+{
+ public:
+  static constexpr int MaxChannels = 2;
+
+  TailWorker() = default;
+  ~TailWorker();
+
+  TailWorker(const TailWorker&) = delete;
+  TailWorker& operator=(const TailWorker&) = delete;
+
+  // Stops any running thread first. Allocates; call from a non-realtime thread.
+  bool prepare(std::shared_ptr<const ConvolutionKernel> kernel, int firstPartition,
+               int leadBlocks, bool threaded);
+  bool isPrepared() const { return kernel_ != nullptr; }
+  bool isThreaded() const { return thread_.joinable(); }
+  // Waits for queued jobs, then clears all history.
+  void reset();
+
+  // blocks[c] holds getBlockSize() samples of input channel c.
+  void push(const Sample* const* blocks, int numChannels);
+  // outputs[c] += tail for the block due now.
+  void pop(Sample* const* outputs, int numChannels);
+
+  long getMissedDeadlines() const { return missedDeadlines_.load(std::memory_order_relaxed); }
+
+ private:
+  struct Block
+  {
+    std::vector<Sample> samples[MaxChannels];
+    int numChannels = 0;
+  };
+
+  void run();
+  void processPending();
+  bool processNext();
+  void stop();
+
+  std::shared_ptr<const ConvolutionKernel> kernel_;
+  int firstPartition_ = 0;
+  int leadBlocks_ = 0;
+  int leadRemaining_ = 0;
+  PartitionedConvolver convolvers_[MaxChannels];
+
+  SpscRing<Block> jobs_;
+  SpscRing<Block> results_;
+  std::atomic<long> submitted_{0};
+  std::atomic<long> completed_{0};
+  std::atomic<long> missedDeadlines_{0};
+  // Held while a job runs, by the worker or by a late pop().
+  std::atomic<bool> busy_{false};
+
+  std::thread thread_;
+  std::mutex wakeMutex_;
+  std::condition_variable wake_;
+  std::atomic<bool> stopping_{false};
+};
+
+}  // namespace octob
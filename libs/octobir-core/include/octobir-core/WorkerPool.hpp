@@ -0,0 +1,43 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace octob
+{
+
+// Fixed set of threads running queued tasks, oldest first. Used for work that must stay
+// off the audio and UI threads, such as IR loads. Tasks still queued when the pool is
+// destroyed are run before its threads exit.
+class WorkerPool
+{
+ public:
+  static constexpr int DefaultNumThreads = 2;
+
+  explicit WorkerPool(int numThreads);
+  ~WorkerPool();
+
+  WorkerPool(const WorkerPool&) = delete;
+  WorkerPool& operator=(const WorkerPool&) = delete;
+
+  // Process-wide pool with DefaultNumThreads threads, started on first use.
+  static WorkerPool& getShared();
+
+  void submit(std::function<void()> task);
+  int getNumThreads() const { return static_cast<int>(threads_.size()); }
+
+ private:
+  void run();
+
+  std::vector<std::thread> threads_;
+  std::deque<std::function<void()>> tasks_;
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  bool stopping_ = false;
+};
+
+}  // namespace octob
@@ -0,0 +1,191 @@
+#include "octobir-core/ConvolutionCostModel.hpp"
+
+#include <convoengine.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+
+#include "octobir-core/DirectConvolutionEngine.hpp"
+
+namespace octob
+{
+
+namespace
+{
+
+constexpr size_t MeasuredLengths[] = {64, 256, 1024, 4096};
+constexpr size_t MeasuredFrames = 2048;
+constexpr int MeasuredRuns = 2;
+// Once the direct engine is this much slower, longer IRs are extrapolated, not timed.
+constexpr double DirectGiveUpRatio = 2.0;
+
+std::vector<Sample> noise(size_t length, uint32_t seed)
+{
+  std::vector<Sample> signal(length);
+  for (auto& s : signal)
+  {
+    seed = seed * 1664525u + 1013904223u;
+    s = static_cast<Sample>(seed >> 8) / static_cast<Sample>(1u << 24) - 0.5f;
+  }
+  return signal;
+}
+
+// Best-of-runs wall time per stereo frame, after one warm-up block.
+double timeEngine(ConvolutionEngine& engine, int blockSize, const std::vector<Sample>& left,
+                  const std::vector<Sample>& right)
+{
+  const int numBlocks = std::max(1, static_cast<int>(MeasuredFrames) / blockSize);
+  const auto block = static_cast<size_t>(blockSize);
+
+  auto runBlock = [&](int b)
+  {
+    const size_t offset = (static_cast<size_t>(b) * block) % (left.size() - block + 1);
+    const Sample* inputs[] = {left.data() + offset, right.data() + offset};
+    engine.add(inputs, blockSize, 2);
+    if (engine.avail(blockSize) >= blockSize)
+      engine.advance(blockSize);
+  };
+
+  runBlock(0);
+  double best = 0.0;
+  for (int run = 0; run < MeasuredRuns; ++run)
+  {
+    const auto start = std::chrono::steady_clock::now();
+    for (int b = 0; b < numBlocks; ++b)
+      runBlock(b);
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    const double ns =
+        static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) /
+        static_cast<double>(static_cast<size_t>(numBlocks) * block);
+    best = run == 0 ? ns : std::min(best, ns);
+  }
+  return best;
+}
+
+ConvolutionCostModel measureUncached(int blockSize)
+{
+  const auto block = static_cast<size_t>(blockSize);
+  const auto left = noise(std::max(MeasuredFrames, block), 1);
+  const auto right = noise(std::max(MeasuredFrames, block), 2);
+
+  std::vector<ConvolutionCostPoint> points;
+  bool directGaveUp = false;
+  for (size_t length : MeasuredLengths)
+  {
+    WDL_ImpulseBuffer impulse;
+    impulse.SetNumChannels(2);
+    impulse.SetLength(static_cast<int>(length));
+    for (int ch = 0; ch < 2; ++ch)
+    {
+      const auto taps = noise(length, 3 + static_cast<uint32_t>(ch));
+      std::copy(taps.begin(), taps.end(), impulse.impulses[ch].Get());
+    }
+
+    auto fft = ConvolutionEngine::create(ConvolutionEngineType::Wdl);
+    if (fft->setImpulse(impulse) < 0)
+      break;
+    const double fftNs = timeEngine(*fft, blockSize, left, right);
+
+    double directNs = 0.0;
+    if (directGaveUp)
+    {
+      const ConvolutionCostPoint& previous = points.back();
+      directNs = previous.directNs * static_cast<double>(length) /
+                 static_cast<double>(previous.irLength);
+    }
+    else
+    {
+      DirectConvolutionEngine direct;
+      direct.setImpulse(impulse);
+      directNs = timeEngine(direct, blockSize, left, right);
+      directGaveUp = directNs > DirectGiveUpRatio * fftNs;
+    }
+
+    points.push_back({length, directNs, fftNs});
+  }
+
+  return ConvolutionCostModel(std::move(points));
+}
+
+}  // namespace
+
+ConvolutionCostModel::ConvolutionCostModel(std::vector<ConvolutionCostPoint> points)
+    : points_(std::move(points))
+{
+  std::sort(points_.begin(), points_.end(),
+            [](const ConvolutionCostPoint& a, const ConvolutionCostPoint& b)
+            { return a.irLength < b.irLength; });
+}
+
+ConvolutionCostModel ConvolutionCostModel::measure(int blockSize)
+{
+  if (blockSize <= 0)
+    return ConvolutionCostModel();
+
+  static std::mutex cacheMutex;
+  static std::map<int, ConvolutionCostModel> cache;
+
+  std::lock_guard<std::mutex> lock(cacheMutex);
+  auto it = cache.find(blockSize);
+  if (it == cache.end())
+    it = cache.emplace(blockSize, measureUncached(blockSize)).first;
+  return it->second;
+}
+
+double ConvolutionCostModel::estimateDirectNs(size_t irLength) const
+{
+  if (points_.empty())
+    return 0.0;
+
+  const auto length = static_cast<double>(irLength);
+  const ConvolutionCostPoint& first = points_.front();
+  const ConvolutionCostPoint& last = points_.back();
+  if (irLength <= first.irLength)
+    return first.directNs * length / static_cast<double>(first.irLength);
+  if (irLength >= last.irLength)
+    return last.directNs * length / static_cast<double>(last.irLength);
+
+  auto upper = std::lower_bound(points_.begin(), points_.end(), irLength,
+                                [](const ConvolutionCostPoint& p, size_t value)
+                                { return p.irLength < value; });
+  auto lower = upper - 1;
+  const double t = (length - static_cast<double>(lower->irLength)) /
+                   static_cast<double>(upper->irLength - lower->irLength);
+  return lower->directNs + t * (upper->directNs - lower->directNs);
+}
+
+double ConvolutionCostModel::estimateFftNs(size_t irLength) const
+{
+  if (points_.empty())
+    return 0.0;
+
+  if (irLength <= points_.front().irLength)
+    return points_.front().fftNs;
+  if (irLength >= points_.back().irLength)
+    return points_.back().fftNs;
+
+  auto upper = std::lower_bound(points_.begin(), points_.end(), irLength,
+                                [](const ConvolutionCostPoint& p, size_t value)
+                                { return p.irLength < value; });
+  auto lower = upper - 1;
+  const double t = std::log2(static_cast<double>(irLength) / static_cast<double>(lower->irLength)) /
+                   std::log2(static_cast<double>(upper->irLength) /
+                             static_cast<double>(lower->irLength));
+  return lower->fftNs + t * (upper->fftNs - lower->fftNs);
+}
+
+ConvolutionEngineType ConvolutionCostModel::choose(size_t irLength) const
+{
+  if (points_.empty() || irLength == 0)
+    return ConvolutionEngineType::Wdl;
+
+  return estimateDirectNs(irLength) < estimateFftNs(irLength) ? ConvolutionEngineType::Direct
+                                                               : ConvolutionEngineType::Wdl;
+}
+
+}  // namespace octob
@@ -0,0 +1,71 @@
+#include "octobir-core/ConvolutionEngine.hpp"
+
+#include <convoengine.h>
+
+#include <algorithm>
+#include <type_traits>
+
+#include "octobir-core/DirectConvolutionEngine.hpp"
+#include "octobir-core/PffftConvolutionEngine.hpp"
+
+namespace octob
+{
+
+namespace
+{
+
+static_assert(std::is_same<WDL_FFT_REAL, Sample>::value,
+              "WDL must be built with single-precision WDL_FFT_REAL");
+
+// WDL_ConvolutionEngine_Div with the 64-sample brute-force head IRProcessor has always
+// used. WDL collapses identical input channels for mono IRs and takes non-const input
+// pointers, though it never writes through them.
+class WdlConvolutionEngine final : public ConvolutionEngine
+{
+ public:
+  int setImpulse(WDL_ImpulseBuffer& impulse) override
+  {
+    return engine_.SetImpulse(&impulse, 64, 0, 0, 0);
+  }
+
+  void add(const Sample* const* inputs, int numFrames, int numChannels) override
+  {
+    numChannels = std::max(1, std::min(numChannels, 2));
+    WDL_FFT_REAL* channels[2] = {};
+    for (int c = 0; c < numChannels; ++c)
+      channels[c] = const_cast<WDL_FFT_REAL*>(inputs[c]);
+    engine_.Add(channels, numFrames, numChannels);
+  }
+
+  int avail(int wantFrames) override { return engine_.Avail(wantFrames); }
+  Sample** get() override { return engine_.Get(); }
+  void advance(int numFrames) override { engine_.Advance(numFrames); }
+  void reset() override { engine_.Reset(); }
+  bool growsOnFirstUse() const override { return true; }
+
+ private:
+  WDL_ConvolutionEngine_Div engine_;
+};
+
+}  // namespace
+
+std::unique_ptr<ConvolutionEngine> ConvolutionEngine::create(ConvolutionEngineType type,
+                                                             bool zeroLatency, bool backgroundTail)
+{
+  switch (type)
+  {
+    case ConvolutionEngineType::Pffft:
+      return std::unique_ptr<ConvolutionEngine>(new PffftConvolutionEngine(
+          PffftConvolutionEngine::DefaultBlockSize, zeroLatency,
+          backgroundTail ? PffftConvolutionEngine::TailMode::Background
+                         : PffftConvolutionEngine::TailMode::AudioThread));
+    case ConvolutionEngineType::Direct:
+      return std::unique_ptr<ConvolutionEngine>(new DirectConvolutionEngine());
+    case ConvolutionEngineType::Wdl:
+    case ConvolutionEngineType::Auto:
+    default:
+      return std::unique_ptr<ConvolutionEngine>(new WdlConvolutionEngine());
+  }
+}
+
+}  // namespace octob
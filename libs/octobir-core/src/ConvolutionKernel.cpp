@@ -0,0 +1,181 @@
+#include "octobir-core/ConvolutionKernel.hpp"
+
+#include <convoengine.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "octobir-core/IRLoader.hpp"
+#include "pffft.h"
+
+namespace octob
+{
+
+constexpr float ConvolutionKernel::SilentPartitionDb;
+
+namespace
+{
+
+bool isValidBlockSize(int blockSize)
+{
+  // pffft real transforms need a size that is a multiple of 32.
+  return blockSize >= 16 && (blockSize & (blockSize - 1)) == 0;
+}
+
+}  // namespace
+
+ConvolutionKernel::ConvolutionKernel(int numChannels, size_t length, int blockSize)
+    : numChannels_(numChannels),
+      length_(length),
+      blockSize_(blockSize),
+      numPartitions_(static_cast<int>((length + static_cast<size_t>(blockSize) - 1) /
+                                      static_cast<size_t>(blockSize)))
+{
+  const size_t numFloats = static_cast<size_t>(numChannels_) *
+                           static_cast<size_t>(numPartitions_) *
+                           static_cast<size_t>(getFftSize());
+  spectra_ = static_cast<float*>(pffft_aligned_malloc(numFloats * sizeof(float)));
+  head_ = static_cast<float*>(pffft_aligned_malloc(static_cast<size_t>(numChannels_) *
+                                                   static_cast<size_t>(blockSize_) *
+                                                   sizeof(float)));
+  energy_.assign(static_cast<size_t>(numChannels_) * static_cast<size_t>(numPartitions_), 0.0f);
+}
+
+ConvolutionKernel::~ConvolutionKernel()
+{
+  pffft_aligned_free(head_);
+  pffft_aligned_free(spectra_);
+}
+
+const float* ConvolutionKernel::getPartition(int channel, int partition) const
+{
+  const size_t index = static_cast<size_t>(channel) * static_cast<size_t>(numPartitions_) +
+                       static_cast<size_t>(partition);
+  return spectra_ + index * static_cast<size_t>(getFftSize());
+}
+
+const float* ConvolutionKernel::getHead(int channel) const
+{
+  return head_ + static_cast<size_t>(channel) * static_cast<size_t>(blockSize_);
+}
+
+std::shared_ptr<const ConvolutionKernel> ConvolutionKernel::create(const Sample* const* channels,
+                                                                   int numChannels, size_t length,
+                                                                   int blockSize)
+{
+  if (channels == nullptr || numChannels <= 0 || length == 0 || !isValidBlockSize(blockSize))
+    return nullptr;
+
+  std::shared_ptr<ConvolutionKernel> kernel(new ConvolutionKernel(numChannels, length, blockSize));
+  if (kernel->spectra_ == nullptr || kernel->head_ == nullptr)
+    return nullptr;
+
+  const int fftSize = kernel->getFftSize();
+  PFFFT_Setup* fft = pffft_new_setup(fftSize, PFFFT_REAL);
+  if (fft == nullptr)
+    return nullptr;
+
+  auto* segment = static_cast<float*>(pffft_aligned_malloc(sizeof(float) * fftSize));
+  auto* work = static_cast<float*>(pffft_aligned_malloc(sizeof(float) * fftSize));
+  const float scale = 1.0f / static_cast<float>(fftSize);
+  const auto block = static_cast<size_t>(blockSize);
+
+  for (int ch = 0; ch < numChannels; ++ch)
+  {
+    auto* head = const_cast<float*>(kernel->getHead(ch));
+    const size_t headCount = std::min(block, length);
+    std::copy(channels[ch], channels[ch] + headCount, head);
+    std::fill(head + headCount, head + block, 0.0f);
+
+    for (int p = 0; p < kernel->numPartitions_; ++p)
+    {
+      const size_t offset = static_cast<size_t>(p) * block;
+      const size_t count = std::min(block, length - offset);
+
+      std::fill(segment, segment + fftSize, 0.0f);
+      double energy = 0.0;
+      for (size_t i = 0; i < count; ++i)
+      {
+        const double tap = channels[ch][offset + i];
+        energy += tap * tap;
+        segment[i] = channels[ch][offset + i] * scale;
+      }
+      kernel->energy_[static_cast<size_t>(ch * kernel->numPartitions_ + p)] =
+          static_cast<float>(energy);
+
+      auto* spectrum = const_cast<float*>(kernel->getPartition(ch, p));
+      pffft_transform(fft, segment, spectrum, work, PFFFT_FORWARD);
+    }
+  }
+
+  pffft_aligned_free(work);
+  pffft_aligned_free(segment);
+  pffft_destroy_setup(fft);
+  kernel->buildEnergyMap();
+  return kernel;
+}
+
+void ConvolutionKernel::buildEnergyMap()
+{
+  double totalEnergy = 0.0;
+  for (float energy : energy_)
+    totalEnergy += energy;
+  // Skipping a partition leaves out at most its share of the output energy.
+  const double floor = totalEnergy * std::pow(10.0, SilentPartitionDb / 10.0);
+
+  silent_.assign(energy_.size(), 0);
+  silentChannels_.assign(static_cast<size_t>(numChannels_), 0);
+  diagnostics_ = KernelDiagnostics();
+  diagnostics_.numChannels = numChannels_;
+  diagnostics_.numPartitions = numPartitions_;
+  for (int ch = 0; ch < numChannels_; ++ch)
+  {
+    int numSilent = 0;
+    for (int p = 0; p < numPartitions_; ++p)
+    {
+      const auto index = static_cast<size_t>(ch * numPartitions_ + p);
+      if (energy_[index] <= floor)
+      {
+        silent_[index] = 1;
+        ++numSilent;
+      }
+    }
+    diagnostics_.numSilentPartitions += numSilent;
+    if (numSilent == numPartitions_)
+    {
+      silentChannels_[static_cast<size_t>(ch)] = 1;
+      ++diagnostics_.numSilentChannels;
+    }
+  }
+  diagnostics_.monoFallback = numChannels_ == 2 && diagnostics_.numSilentChannels == 1;
+}
+
+std::shared_ptr<const ConvolutionKernel> ConvolutionKernel::create(WDL_ImpulseBuffer& impulse,
+                                                                   int numChannels, int blockSize)
+{
+  const int length = impulse.GetLength();
+  const int available = impulse.GetNumChannels();
+  if (length <= 0 || available <= 0)
+    return nullptr;
+
+  numChannels = std::max(1, std::min(numChannels, available));
+  std::vector<const Sample*> channels(static_cast<size_t>(numChannels));
+  for (int ch = 0; ch < numChannels; ++ch)
+    channels[static_cast<size_t>(ch)] = impulse.impulses[ch].Get();
+
+  return create(channels.data(), numChannels, static_cast<size_t>(length), blockSize);
+}
+
+std::shared_ptr<const ConvolutionKernel> ConvolutionKernel::create(IRLoader& loader,
+                                                                   SampleRate sampleRate,
+                                                                   int blockSize)
+{
+  WDL_ImpulseBuffer impulse;
+  if (!loader.resampleAndInitialize(impulse, sampleRate))
+    return nullptr;
+
+  return create(impulse, loader.getNumChannels() >= 2 ? 2 : 1, blockSize);
+}
+
+}  // namespace octob
@@ -0,0 +1,62 @@
+#include "octobir-core/DelayLine.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#include "pffft.h"
+
+namespace octob
+{
+
+DelayLine::~DelayLine()
+{
+  pffft_aligned_free(buffer_);
+}
+
+void DelayLine::allocate(size_t maxDelay, FrameCount maxBlockSize)
+{
+  const size_t required = maxDelay + std::max(maxBlockSize, static_cast<FrameCount>(1));
+  size_t capacity = 1;
+  while (capacity < required)
+    capacity <<= 1;
+
+  if (capacity != capacity_)
+  {
+    pffft_aligned_free(buffer_);
+    buffer_ = static_cast<Sample*>(pffft_aligned_malloc(capacity * sizeof(Sample)));
+    capacity_ = capacity;
+  }
+  clear();
+}
+
+void DelayLine::write(const Sample* input, FrameCount numFrames)
+{
+  const FrameCount firstSize = std::min(numFrames, capacity_ - writePos_);
+  std::memcpy(buffer_ + writePos_, input, firstSize * sizeof(Sample));
+  std::memcpy(buffer_, input + firstSize, (numFrames - firstSize) * sizeof(Sample));
+  writePos_ = (writePos_ + numFrames) & (capacity_ - 1);
+}
+
+DelayLine::View DelayLine::view(FrameCount numFrames, size_t delaySamples) const
+{
+  // Unsigned wraparound is harmless: the capacity divides 2^N, so the mask still
+  // yields the position modulo the capacity.
+  const size_t start = (writePos_ - numFrames - delaySamples) & (capacity_ - 1);
+  return {buffer_ + start, std::min(numFrames, capacity_ - start), buffer_};
+}
+
+void DelayLine::read(Sample* output, FrameCount numFrames, size_t delaySamples) const
+{
+  const View delayed = view(numFrames, delaySamples);
+  std::memcpy(output, delayed.first, delayed.firstSize * sizeof(Sample));
+  std::memcpy(output + delayed.firstSize, delayed.second,
+              (numFrames - delayed.firstSize) * sizeof(Sample));
+}
+
+void DelayLine::clear()
+{
+  std::fill(buffer_, buffer_ + capacity_, 0.0f);
+  writePos_ = 0;
+}
+
+}  // namespace octob
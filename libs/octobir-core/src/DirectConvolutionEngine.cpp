@@ -0,0 +1,195 @@
+#include "octobir-core/DirectConvolutionEngine.hpp"
+
+#include <convoengine.h>
+
+#include <algorithm>
+#include <cstddef>
+
+namespace octob
+{
+
+constexpr int DirectConvolutionEngine::MaxChannels;
+
+namespace
+{
+
+// Block capacity reserved up front, so hosts with blocks of up to this many frames
+// never grow the buffers on the audio thread.
+constexpr size_t InitialBlockFrames = 4096;
+
+// Output frames computed per pass over the taps: two SSE/NEON registers, or one AVX.
+constexpr size_t ChunkFrames = 8;
+
+}  // namespace
+
+int DirectConvolutionEngine::setImpulse(WDL_ImpulseBuffer& impulse)
+{
+  const int length = impulse.GetLength();
+  const int available = impulse.GetNumChannels();
+  if (length <= 0 || available <= 0)
+    return -1;
+
+  const int numChannels = std::min(available, MaxChannels);
+  const Sample* channels[MaxChannels] = {};
+  for (int ch = 0; ch < numChannels; ++ch)
+    channels[ch] = impulse.impulses[ch].Get();
+  return setTaps(channels, numChannels, static_cast<size_t>(length));
+}
+
+int DirectConvolutionEngine::setTaps(const Sample* const* channels, int numChannels,
+                                     size_t length)
+{
+  length_ = 0;
+  if (channels == nullptr || numChannels <= 0 || length == 0)
+    return -1;
+
+  kernelChannels_ = std::min(numChannels, MaxChannels);
+  for (int c = 0; c < MaxChannels; ++c)
+  {
+    const Sample* source = channels[std::min(c, kernelChannels_ - 1)];
+    taps_[c].assign(source, source + length);
+    input_[c].assign(length - 1 + InitialBlockFrames, 0.0f);
+    output_[c].assign(InitialBlockFrames, 0.0f);
+  }
+
+  length_ = length;
+  reset();
+  return 0;
+}
+
+void DirectConvolutionEngine::reset()
+{
+  for (int c = 0; c < MaxChannels; ++c)
+    std::fill(input_[c].begin(), input_[c].end(), 0.0f);
+  outputStart_ = 0;
+  outputEnd_ = 0;
+}
+
+void DirectConvolutionEngine::reserve(size_t numFrames)
+{
+  if (outputEnd_ + numFrames > output_[0].size())
+  {
+    const size_t queued = outputEnd_ - outputStart_;
+    for (int c = 0; c < MaxChannels; ++c)
+    {
+      std::copy(output_[c].begin() + static_cast<std::ptrdiff_t>(outputStart_),
+                output_[c].begin() + static_cast<std::ptrdiff_t>(outputEnd_), output_[c].begin());
+      if (queued + numFrames > output_[c].size())
+        output_[c].resize(2 * (queued + numFrames), 0.0f);
+    }
+    outputStart_ = 0;
+    outputEnd_ = queued;
+  }
+
+  const size_t inputSize = length_ - 1 + numFrames;
+  for (int c = 0; c < MaxChannels; ++c)
+    if (input_[c].size() < inputSize)
+      input_[c].resize(inputSize, 0.0f);
+}
+
+void DirectConvolutionEngine::add(const Sample* const* inputs, int numFrames, int numChannels)
+{
+  if (length_ == 0 || numFrames <= 0)
+    return;
+
+  numChannels = std::max(1, std::min(numChannels, MaxChannels));
+  // Identical inputs through a mono IR give identical outputs: convolve once and
+  // expose the same buffer for both channels, as WDL does.
+  if (numChannels == 2 && inputs[0] == inputs[1] && kernelChannels_ == 1)
+    numChannels = 1;
+  numChannels_ = numChannels;
+
+  const auto frames = static_cast<size_t>(numFrames);
+  reserve(frames);
+
+  const size_t history = length_ - 1;
+  for (int c = 0; c < numChannels; ++c)
+    std::copy(inputs[c], inputs[c] + frames, input_[c].data() + history);
+
+  // x[history + i] is the current sample i, so tap k reads from x + history - k.
+  // Outputs are built in chunks held in local accumulators, which cannot alias the
+  // buffers, so the per-tap multiply-add vectorizes across the chunk.
+  const Sample* xL = input_[0].data() + history;
+  const Sample* xR = input_[numChannels - 1].data() + history;
+  Sample* outL = output_[0].data() + outputEnd_;
+  Sample* outR = output_[numChannels - 1].data() + outputEnd_;
+  const Sample* hL = taps_[0].data();
+  const Sample* hR = taps_[1].data();
+
+  size_t i = 0;
+  for (; i + ChunkFrames <= frames; i += ChunkFrames)
+  {
+    Sample accL[ChunkFrames] = {};
+    Sample accR[ChunkFrames] = {};
+    if (numChannels == 2)
+    {
+      for (size_t k = 0; k < length_; ++k)
+      {
+        const Sample* windowL = xL + i - k;
+        const Sample* windowR = xR + i - k;
+        for (size_t j = 0; j < ChunkFrames; ++j)
+        {
+          accL[j] += hL[k] * windowL[j];
+          accR[j] += hR[k] * windowR[j];
+        }
+      }
+      std::copy(accR, accR + ChunkFrames, outR + i);
+    }
+    else
+    {
+      for (size_t k = 0; k < length_; ++k)
+      {
+        const Sample* windowL = xL + i - k;
+        for (size_t j = 0; j < ChunkFrames; ++j)
+          accL[j] += hL[k] * windowL[j];
+      }
+    }
+    std::copy(accL, accL + ChunkFrames, outL + i);
+  }
+
+  for (; i < frames; ++i)
+  {
+    Sample accL = 0.0f;
+    Sample accR = 0.0f;
+    for (size_t k = 0; k < length_; ++k)
+    {
+      accL += hL[k] * *(xL + i - k);
+      accR += hR[k] * *(xR + i - k);
+    }
+    outL[i] = accL;
+    if (numChannels == 2)
+      outR[i] = accR;
+  }
+
+  // Keep the last length_ - 1 samples as history for the next block.
+  for (int c = 0; c < numChannels; ++c)
+    std::copy(input_[c].begin() + static_cast<std::ptrdiff_t>(frames),
+              input_[c].begin() + static_cast<std::ptrdiff_t>(frames + history),
+              input_[c].begin());
+
+  outputEnd_ += frames;
+}
+
+int DirectConvolutionEngine::avail(int /*wantFrames*/)
+{
+  return static_cast<int>(outputEnd_ - outputStart_);
+}
+
+Sample** DirectConvolutionEngine::get()
+{
+  outputPtrs_[0] = output_[0].data() + outputStart_;
+  outputPtrs_[1] = numChannels_ == 2 ? output_[1].data() + outputStart_ : outputPtrs_[0];
+  return outputPtrs_;
+}
+
+void DirectConvolutionEngine::advance(int numFrames)
+{
+  if (numFrames <= 0)
+    return;
+
+  outputStart_ = std::min(outputEnd_, outputStart_ + static_cast<size_t>(numFrames));
+  if (outputStart_ == outputEnd_)
+    outputStart_ = outputEnd_ = 0;
+}
+
+}  // namespace octob
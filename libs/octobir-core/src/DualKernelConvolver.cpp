@@ -0,0 +1,257 @@
+#include "octobir-core/DualKernelConvolver.hpp"
+
+#include <algorithm>
+
+namespace octob
+{
+
+constexpr int DualKernelConvolver::MaxChannels;
+constexpr int DualKernelConvolver::NumKernels;
+
+namespace
+{
+
+// Kernel channels feeding an output. A single output averages all channels.
+void kernelChannels(const ConvolutionKernel& kernel, int output, int numOutputs, int& first,
+                    int& last)
+{
+  const int numChannels = kernel.getNumChannels();
+  first = numOutputs == 1 ? 0 : std::min(output, numChannels - 1);
+  last = numOutputs == 1 ? numChannels - 1 : first;
+}
+
+}  // namespace
+
+bool DualKernelConvolver::prepare(std::shared_ptr<const ConvolutionKernel> kernelA,
+                                  std::shared_ptr<const ConvolutionKernel> kernelB)
+{
+  kernelA_.reset();
+  kernelB_.reset();
+
+  if (!kernelA || !kernelB || kernelA->getBlockSize() != kernelB->getBlockSize())
+    return false;
+
+  const int blockSize = kernelA->getBlockSize();
+  const int tailPartitions =
+      std::max(1, std::max(kernelA->getNumPartitions(), kernelB->getNumPartitions()) - 1);
+  const auto block = static_cast<size_t>(blockSize);
+
+  for (int c = 0; c < MaxChannels; ++c)
+  {
+    if (!convolvers_[c].prepare(blockSize, tailPartitions, NumKernels * MaxChannels))
+      return false;
+
+    history_[c].assign(2 * block, 0.0f);
+    blockInput_[c].assign(block, 0.0f);
+    for (int k = 0; k < NumKernels; ++k)
+    {
+      tailOutput_[k][c].assign(block, 0.0f);
+      headTaps_[k][c].assign(block, 0.0f);
+    }
+  }
+
+  kernelA_ = std::move(kernelA);
+  kernelB_ = std::move(kernelB);
+  blockSize_ = blockSize;
+  blockPos_ = 0;
+  historyPos_ = 0;
+  headOutputs_ = 0;
+  tailState_ = TailState::Split;
+  return true;
+}
+
+void DualKernelConvolver::reset()
+{
+  for (int c = 0; c < MaxChannels; ++c)
+  {
+    convolvers_[c].reset();
+    std::fill(history_[c].begin(), history_[c].end(), 0.0f);
+    std::fill(blockInput_[c].begin(), blockInput_[c].end(), 0.0f);
+    for (auto& tail : tailOutput_)
+      std::fill(tail[c].begin(), tail[c].end(), 0.0f);
+  }
+  blockPos_ = 0;
+  historyPos_ = 0;
+  tailState_ = TailState::Split;
+}
+
+int DualKernelConvolver::inputFor(int output, int numInputs) const
+{
+  return std::min(output, numInputs - 1);
+}
+
+void DualKernelConvolver::updateHeadTaps(int numOutputs)
+{
+  if (numOutputs == headOutputs_)
+    return;
+
+  const auto block = static_cast<size_t>(blockSize_);
+  const ConvolutionKernel* kernels[] = {kernelA_.get(), kernelB_.get()};
+  for (int k = 0; k < NumKernels; ++k)
+  {
+    for (int o = 0; o < numOutputs; ++o)
+    {
+      Sample* taps = headTaps_[k][o].data();
+      std::fill(taps, taps + block, 0.0f);
+
+      int first = 0;
+      int last = 0;
+      kernelChannels(*kernels[k], o, numOutputs, first, last);
+      const float weight = 1.0f / static_cast<float>(last - first + 1);
+      for (int ch = first; ch <= last; ++ch)
+      {
+        const Sample* head = kernels[k]->getHead(ch);
+        for (size_t j = 0; j < block; ++j)
+          taps[j] += weight * head[block - 1 - j];
+      }
+    }
+  }
+  headOutputs_ = numOutputs;
+}
+
+void DualKernelConvolver::accumulateKernel(PartitionedConvolver& convolver,
+                                           const ConvolutionKernel& kernel, int accumulator,
+                                           int output, int numOutputs)
+{
+  int first = 0;
+  int last = 0;
+  kernelChannels(kernel, output, numOutputs, first, last);
+  const float weight = 1.0f / static_cast<float>(last - first + 1);
+  for (int ch = first; ch <= last; ++ch)
+    convolver.accumulateTail(kernel, ch, weight, accumulator);
+}
+
+void DualKernelConvolver::runTail(int numInputs, int numOutputs)
+{
+  // A summed tail leaves its accumulators in place in case the gains moved later on.
+  if (tailState_ != TailState::Split)
+    for (auto& convolver : convolvers_)
+      for (int accumulator = 0; accumulator < NumKernels * MaxChannels; ++accumulator)
+        convolver.clear(accumulator);
+
+  for (int c = 0; c < numInputs; ++c)
+    convolvers_[c].pushBlock(blockInput_[c].data());
+
+  // The tail is computed a block ahead of the gains it will be weighted with, so each
+  // kernel is accumulated on its own; finishTail() combines them once the gains are
+  // known. Outputs sharing an input (mono in, stereo out) use separate accumulators on
+  // the same convolver.
+  const ConvolutionKernel* kernels[] = {kernelA_.get(), kernelB_.get()};
+  for (int o = 0; o < numOutputs; ++o)
+  {
+    PartitionedConvolver& convolver = convolvers_[inputFor(o, numInputs)];
+    for (int k = 0; k < NumKernels; ++k)
+      accumulateKernel(convolver, *kernels[k], k * MaxChannels + o, o, numOutputs);
+  }
+  tailInputs_ = numInputs;
+  tailOutputs_ = numOutputs;
+  tailState_ = TailState::Pending;
+}
+
+// A summed tail is only valid for the gains it was summed with; if they move before the
+// block is over, the rest of the block is finished per kernel from the same accumulators.
+void DualKernelConvolver::finishTail(bool steady, float gainA, float gainB)
+{
+  const bool sum = steady && tailState_ == TailState::Pending;
+  for (int o = 0; o < tailOutputs_; ++o)
+  {
+    PartitionedConvolver& convolver = convolvers_[inputFor(o, tailInputs_)];
+    if (sum)
+    {
+      convolver.finishSum(o, gainA, MaxChannels + o, gainB, tailOutput_[0][o].data());
+      continue;
+    }
+    for (int k = 0; k < NumKernels; ++k)
+      convolver.finish(k * MaxChannels + o, tailOutput_[k][o].data());
+  }
+  tailState_ = sum ? TailState::Summed : TailState::Split;
+  tailGainA_ = gainA;
+  tailGainB_ = gainB;
+}
+
+void DualKernelConvolver::process(const Sample* const* inputs, int numInputs,
+                                  Sample* const* outputs, int numOutputs, FrameCount numFrames,
+                                  float fromA, float toA, float fromB, float toB)
+{
+  numInputs = std::max(1, std::min(MaxChannels, numInputs));
+  numOutputs = std::max(1, std::min(MaxChannels, numOutputs));
+
+  if (!isPrepared())
+  {
+    for (int o = 0; o < numOutputs; ++o)
+      std::fill(outputs[o], outputs[o] + numFrames, 0.0f);
+    return;
+  }
+
+  // Mono input through two mono kernels gives identical stereo outputs: compute one.
+  const bool duplicateOutput = numOutputs == 2 && numInputs == 1 &&
+                               kernelA_->getNumChannels() == 1 &&
+                               kernelB_->getNumChannels() == 1;
+  const int numComputed = duplicateOutput ? 1 : numOutputs;
+
+  updateHeadTaps(numComputed);
+
+  const bool steady = fromA == toA && fromB == toB;
+  const float stepA = (toA - fromA) / static_cast<float>(numFrames);
+  const float stepB = (toB - fromB) / static_cast<float>(numFrames);
+  const auto block = static_cast<size_t>(blockSize_);
+  for (FrameCount i = 0; i < numFrames; ++i)
+  {
+    // Read every input before writing any output so in-place processing is safe.
+    for (int c = 0; c < numInputs; ++c)
+    {
+      const Sample x = inputs[c][i];
+      history_[c][static_cast<size_t>(historyPos_)] = x;
+      history_[c][static_cast<size_t>(historyPos_) + block] = x;
+      blockInput_[c][static_cast<size_t>(blockPos_)] = x;
+    }
+
+    if (tailState_ == TailState::Pending ||
+        (tailState_ == TailState::Summed && !(steady && toA == tailGainA_ && toB == tailGainB_)))
+      finishTail(steady, toA, toB);
+    const bool summed = tailState_ == TailState::Summed;
+
+    const float frame = static_cast<float>(i + 1);
+    const float gainA = fromA + stepA * frame;
+    const float gainB = fromB + stepB * frame;
+    const auto pos = static_cast<size_t>(blockPos_);
+    for (int o = 0; o < numComputed; ++o)
+    {
+      const Sample* window =
+          history_[inputFor(o, numInputs)].data() + static_cast<size_t>(historyPos_) + 1;
+      const Sample* tapsA = headTaps_[0][o].data();
+      const Sample* tapsB = headTaps_[1][o].data();
+
+      // Two partial sums per kernel break the dependency chains; block is a multiple
+      // of 16.
+      Sample accA0 = 0.0f;
+      Sample accA1 = 0.0f;
+      Sample accB0 = 0.0f;
+      Sample accB1 = 0.0f;
+      for (size_t j = 0; j < block; j += 2)
+      {
+        accA0 += tapsA[j] * window[j];
+        accA1 += tapsA[j + 1] * window[j + 1];
+        accB0 += tapsB[j] * window[j];
+        accB1 += tapsB[j + 1] * window[j + 1];
+      }
+
+      const Sample head = gainA * (accA0 + accA1) + gainB * (accB0 + accB1);
+      outputs[o][i] = summed ? head + tailOutput_[0][o][pos]
+                             : head + gainA * tailOutput_[0][o][pos] +
+                                   gainB * tailOutput_[1][o][pos];
+    }
+
+    if (duplicateOutput)
+      outputs[1][i] = outputs[0][i];
+
+    historyPos_ = (historyPos_ + 1 == blockSize_) ? 0 : historyPos_ + 1;
+    if (++blockPos_ == blockSize_)
+    {
+      runTail(numInputs, numComputed);
+      blockPos_ = 0;
+    }
+  }
+}
+
+}  // namespace octob
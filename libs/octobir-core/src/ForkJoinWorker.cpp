@@ -0,0 +1,72 @@
+#include "octobir-core/ForkJoinWorker.hpp"
+
+namespace octob
+{
+
+ForkJoinWorker::~ForkJoinWorker()
+{
+  if (!thread_.joinable())
+    return;
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  wake_.notify_one();
+  thread_.join();
+}
+
+void ForkJoinWorker::start()
+{
+  if (thread_.joinable())
+    return;
+
+  thread_ = std::thread(&ForkJoinWorker::run, this);
+  running_.store(true, std::memory_order_release);
+}
+
+void ForkJoinWorker::fork(Task task, void* context)
+{
+  if (!isRunning())
+  {
+    task(context);
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    task_ = task;
+    context_ = context;
+    pending_ = true;
+  }
+  wake_.notify_one();
+}
+
+void ForkJoinWorker::join()
+{
+  if (!isRunning())
+    return;
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  done_.wait(lock, [this] { return !pending_; });
+}
+
+void ForkJoinWorker::run()
+{
+  std::unique_lock<std::mutex> lock(mutex_);
+  for (;;)
+  {
+    wake_.wait(lock, [this] { return pending_ || stopping_; });
+    if (stopping_)
+      return;
+
+    lock.unlock();
+    task_(context_);
+    lock.lock();
+
+    pending_ = false;
+    done_.notify_one();
+  }
+}
+
+}  // namespace octob
@@ -0,0 +1,451 @@
+#include "octobir-core/IRBank.hpp"
+
+#include <convoengine.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <mutex>
+
+#include "octobir-core/IRLoader.hpp"
+
+namespace octob
+{
+
+constexpr char IRBank::EntrySeparator;
+
+namespace
+{
+
+constexpr char BankMagic[8] = {'O', 'C', 'T', 'B', 'I', 'R', 'B', '1'};
+constexpr uint32_t BankFormatVersion = 1;
+constexpr const char* BankExtension = ".oirb";
+constexpr uint64_t DataAlignment = 64;
+
+// Fixed-size records, so the tables can be read in place from the mapping.
+struct EntryRecord
+{
+  uint64_t nameOffset;
+  uint32_t nameLength;
+  uint32_t numSections;
+  uint64_t firstSection;
+  uint64_t contentHash;
+  uint64_t contentSize;
+  uint64_t reserved;
+};
+
+struct SectionRecord
+{
+  uint32_t stage;
+  uint32_t numChannels;
+  double sampleRate;
+  uint64_t numSamples;
+  uint64_t dataOffset;
+  uint64_t payloadHash;
+  uint64_t reserved;
+};
+
+static_assert(sizeof(EntryRecord) == 48, "IR bank entry layout changed");
+static_assert(sizeof(SectionRecord) == 48, "IR bank section layout changed");
+
+const EntryRecord& entryAt(const char* entries, size_t index)
+{
+  return reinterpret_cast<const EntryRecord*>(entries)[index];
+}
+
+const SectionRecord& sectionAt(const char* sections, size_t index)
+{
+  return reinterpret_cast<const SectionRecord*>(sections)[index];
+}
+
+// Fixed 64-byte header. The entry table follows it, then the section table and the
+// names; the tables and names are covered by tableHash.
+struct BankHeader
+{
+  char magic[8];
+  uint32_t formatVersion;
+  uint32_t processingVersion;
+  uint64_t numEntries;
+  uint64_t numSections;
+  uint64_t namesOffset;
+  uint64_t namesSize;
+  uint64_t tableHash;
+  uint64_t reserved;
+};
+
+static_assert(sizeof(BankHeader) == 64, "IR bank header layout changed");
+
+uint64_t alignUp(uint64_t offset)
+{
+  return (offset + DataAlignment - 1) / DataAlignment * DataAlignment;
+}
+
+bool writeZeros(FILE* file, uint64_t count)
+{
+  static const char zeros[DataAlignment] = {};
+  while (count > 0)
+  {
+    const auto chunk = static_cast<size_t>(std::min(count, DataAlignment));
+    if (std::fwrite(zeros, 1, chunk, file) != chunk)
+      return false;
+    count -= chunk;
+  }
+  return true;
+}
+
+std::string toLower(std::string text)
+{
+  for (char& c : text)
+    c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+  return text;
+}
+
+// Appends a planar section to file at offset, padding it to the data alignment.
+bool writeSection(FILE* file, uint64_t& offset, IRCacheStage stage, SampleRate sampleRate,
+                  const Sample* const* channels, int numChannels, size_t numSamples,
+                  std::vector<SectionRecord>& sections)
+{
+  SectionRecord record;
+  std::memset(&record, 0, sizeof(record));
+  record.stage = static_cast<uint32_t>(stage);
+  record.numChannels = static_cast<uint32_t>(numChannels);
+  record.sampleRate = sampleRate;
+  record.numSamples = numSamples;
+  record.dataOffset = offset;
+  record.payloadHash = IRCache::HashSeed;
+
+  for (int ch = 0; ch < numChannels; ++ch)
+  {
+    if (std::fwrite(channels[ch], sizeof(Sample), numSamples, file) != numSamples)
+      return false;
+    record.payloadHash =
+        IRCache::hashBytes(channels[ch], numSamples * sizeof(Sample), record.payloadHash);
+  }
+
+  const uint64_t end = offset + static_cast<uint64_t>(numChannels) * numSamples * sizeof(Sample);
+  if (!writeZeros(file, alignUp(end) - end))
+    return false;
+  offset = alignUp(end);
+  sections.push_back(record);
+  return true;
+}
+
+}  // namespace
+
+const std::vector<SampleRate>& IRBank::getDefaultSampleRates()
+{
+  static const std::vector<SampleRate> rates = {44100.0, 48000.0, 88200.0, 96000.0};
+  return rates;
+}
+
+std::shared_ptr<const IRBank> IRBank::open(const std::string& path, std::string& errorMessage)
+{
+  std::shared_ptr<IRBank> bank(new IRBank());
+  if (!bank->mapping_.open(path))
+  {
+    errorMessage = "Failed to open IR bank";
+    return nullptr;
+  }
+
+  const auto* data = static_cast<const char*>(bank->mapping_.getData());
+  const uint64_t size = bank->mapping_.getSize();
+  BankHeader header;
+  if (size < sizeof(header) || std::memcmp(data, BankMagic, sizeof(BankMagic)) != 0)
+  {
+    errorMessage = "Not an IR bank";
+    return nullptr;
+  }
+  std::memcpy(&header, data, sizeof(header));
+  if (header.formatVersion != BankFormatVersion ||
+      header.processingVersion != IRCache::ProcessingVersion)
+  {
+    errorMessage = "IR bank was built by another version; rebuild it";
+    return nullptr;
+  }
+
+  // Every count and offset is checked against the file size before it is used, so a
+  // corrupt index cannot point outside the mapping.
+  const uint64_t maxRecords = size / sizeof(EntryRecord);
+  const uint64_t sectionsOffset = sizeof(header) + header.numEntries * sizeof(EntryRecord);
+  bool valid = header.numEntries <= maxRecords && header.numSections <= maxRecords &&
+               header.namesOffset ==
+                   sectionsOffset + header.numSections * sizeof(SectionRecord) &&
+               header.namesSize <= size && header.namesOffset <= size - header.namesSize;
+  if (valid)
+  {
+    const uint64_t tableSize = header.namesOffset + header.namesSize - sizeof(header);
+    valid = IRCache::hashBytes(data + sizeof(header), tableSize) == header.tableHash;
+  }
+
+  bank->entries_ = data + sizeof(header);
+  bank->sections_ = data + sectionsOffset;
+  bank->names_ = data + header.namesOffset;
+  bank->numEntries_ = valid ? static_cast<size_t>(header.numEntries) : 0;
+  bank->numSections_ = valid ? static_cast<size_t>(header.numSections) : 0;
+
+  for (size_t i = 0; valid && i < bank->numEntries_; ++i)
+  {
+    const EntryRecord& entry = entryAt(bank->entries_, i);
+    valid = entry.nameOffset <= header.namesSize &&
+            entry.nameLength <= header.namesSize - entry.nameOffset &&
+            entry.firstSection <= bank->numSections_ &&
+            entry.numSections <= bank->numSections_ - entry.firstSection;
+  }
+  for (size_t i = 0; valid && i < bank->numSections_; ++i)
+  {
+    const SectionRecord& section = sectionAt(bank->sections_, i);
+    valid = (section.numChannels == 1 || section.numChannels == 2) && section.numSamples > 0 &&
+            section.numSamples <= size / sizeof(Sample) && section.dataOffset <= size &&
+            section.dataOffset % DataAlignment == 0 &&
+            section.numChannels * section.numSamples * sizeof(Sample) <=
+                size - section.dataOffset;
+  }
+
+  if (!valid)
+  {
+    errorMessage = "IR bank is corrupt";
+    return nullptr;
+  }
+  bank->path_ = path;
+  return bank;
+}
+
+std::shared_ptr<const IRBank> IRBank::openShared(const std::string& path,
+                                                 std::string& errorMessage)
+{
+  static std::mutex mutex;
+  static std::map<std::string, std::weak_ptr<const IRBank>> banks;
+
+  std::lock_guard<std::mutex> lock(mutex);
+  for (auto it = banks.begin(); it != banks.end();)
+    it = it->second.expired() ? banks.erase(it) : std::next(it);
+
+  auto& slot = banks[path];
+  auto bank = slot.lock();
+  if (bank)
+    return bank;
+  bank = open(path, errorMessage);
+  if (bank)
+    slot = bank;
+  else
+    banks.erase(path);
+  return bank;
+}
+
+bool IRBank::splitEntryPath(const std::string& path, std::string& bankPath,
+                            std::string& entryName)
+{
+  // The first ".oirb#" ends the bank path, so entry names may contain '#' themselves.
+  const std::string marker = std::string(BankExtension) + EntrySeparator;
+  const size_t pos = toLower(path).find(marker);
+  if (pos == std::string::npos || pos + marker.size() == path.size())
+    return false;
+  bankPath = path.substr(0, pos + marker.size() - 1);
+  entryName = path.substr(pos + marker.size());
+  return true;
+}
+
+std::string IRBank::makeEntryPath(const std::string& bankPath, const std::string& entryName)
+{
+  return bankPath + EntrySeparator + entryName;
+}
+
+bool IRBank::build(std::vector<IRBankSource> sources, const std::vector<SampleRate>& sampleRates,
+                   const std::string& path, std::string& errorMessage)
+{
+  std::sort(sources.begin(), sources.end(), [](const IRBankSource& a, const IRBankSource& b)
+            { return a.name < b.name; });
+  for (size_t i = 0; i < sources.size(); ++i)
+  {
+    if (sources[i].name.empty() || (i > 0 && sources[i].name == sources[i - 1].name))
+    {
+      errorMessage = "Entry names must be distinct and not empty: \"" + sources[i].name + "\"";
+      return false;
+    }
+  }
+
+  // The index's size is known up front, so the data is streamed after space reserved for
+  // it and the index is written last.
+  const uint64_t numEntries = sources.size();
+  const uint64_t numSections = numEntries * (1 + sampleRates.size());
+  std::string names;
+  std::vector<EntryRecord> entries(sources.size());
+  for (size_t i = 0; i < sources.size(); ++i)
+  {
+    std::memset(&entries[i], 0, sizeof(EntryRecord));
+    entries[i].nameOffset = names.size();
+    entries[i].nameLength = static_cast<uint32_t>(sources[i].name.size());
+    names += sources[i].name;
+  }
+
+  BankHeader header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.magic, BankMagic, sizeof(BankMagic));
+  header.formatVersion = BankFormatVersion;
+  header.processingVersion = IRCache::ProcessingVersion;
+  header.numEntries = numEntries;
+  header.numSections = numSections;
+  header.namesOffset =
+      sizeof(header) + numEntries * sizeof(EntryRecord) + numSections * sizeof(SectionRecord);
+  header.namesSize = names.size();
+
+  const std::string temporary = path + ".tmp";
+  FILE* file = std::fopen(temporary.c_str(), "wb");
+  if (file == nullptr)
+  {
+    errorMessage = "Failed to create " + temporary;
+    return false;
+  }
+
+  uint64_t offset = alignUp(header.namesOffset + header.namesSize);
+  bool ok = writeZeros(file, header.namesOffset) &&
+            std::fwrite(names.data(), 1, names.size(), file) == names.size() &&
+            writeZeros(file, offset - header.namesOffset - header.namesSize);
+
+  std::vector<SectionRecord> sections;
+  std::vector<Sample> planar;
+  for (size_t i = 0; ok && i < sources.size(); ++i)
+  {
+    const IRBankSource& source = sources[i];
+    IRCacheKey key;
+    IRLoader loader;
+    const IRLoadResult result = loader.loadFromFile(source.filepath);
+    if (!IRCache::computeKey(source.filepath, key) || !result.success ||
+        result.numChannels > 2)
+    {
+      errorMessage = source.filepath + ": " +
+                     (result.success ? "only mono and stereo IRs can be banked"
+                                     : result.errorMessage);
+      ok = false;
+      break;
+    }
+    entries[i].firstSection = sections.size();
+    entries[i].numSections = static_cast<uint32_t>(1 + sampleRates.size());
+    entries[i].contentHash = key.contentHash;
+    entries[i].contentSize = key.contentSize;
+
+    planar.resize(result.numSamples * static_cast<size_t>(result.numChannels));
+    const Sample* channels[2] = {planar.data(), planar.data() + result.numSamples};
+    for (int ch = 0; ch < result.numChannels; ++ch)
+      loader.copyChannel(ch, planar.data() + static_cast<size_t>(ch) * result.numSamples);
+    ok = writeSection(file, offset, IRCacheStage::MinimumPhase, result.sampleRate, channels,
+                      result.numChannels, result.numSamples, sections);
+
+    for (size_t r = 0; ok && r < sampleRates.size(); ++r)
+    {
+      WDL_ImpulseBuffer impulse;
+      if (!loader.resampleAndInitialize(impulse, sampleRates[r]))
+      {
+        errorMessage = source.filepath + ": failed to resample";
+        ok = false;
+        break;
+      }
+      const Sample* resampled[2] = {impulse.impulses[0].Get(), impulse.impulses[1].Get()};
+      ok = writeSection(file, offset, IRCacheStage::Resampled, sampleRates[r], resampled, 2,
+                        static_cast<size_t>(impulse.GetLength()), sections);
+    }
+  }
+
+  if (ok)
+  {
+    header.tableHash = IRCache::hashBytes(entries.data(), entries.size() * sizeof(EntryRecord));
+    header.tableHash = IRCache::hashBytes(
+        sections.data(), sections.size() * sizeof(SectionRecord), header.tableHash);
+    header.tableHash = IRCache::hashBytes(names.data(), names.size(), header.tableHash);
+    ok = std::fseek(file, 0, SEEK_SET) == 0 &&
+         std::fwrite(&header, sizeof(header), 1, file) == 1 &&
+         std::fwrite(entries.data(), sizeof(EntryRecord), entries.size(), file) ==
+             entries.size() &&
+         std::fwrite(sections.data(), sizeof(SectionRecord), sections.size(), file) ==
+             sections.size();
+    if (!ok)
+      errorMessage = "Failed to write " + temporary;
+  }
+  ok = std::fclose(file) == 0 && ok;
+
+  // Replaced in one step on POSIX; Windows' rename() will not overwrite.
+#ifdef _WIN32
+  if (ok)
+    std::remove(path.c_str());
+#endif
+  if (!ok || std::rename(temporary.c_str(), path.c_str()) != 0)
+  {
+    if (errorMessage.empty())
+      errorMessage = "Failed to write " + path;
+    std::remove(temporary.c_str());
+    return false;
+  }
+  return true;
+}
+
+std::string IRBank::getEntryName(size_t index) const
+{
+  const EntryRecord& entry = entryAt(entries_, index);
+  return std::string(names_ + entry.nameOffset, entry.nameLength);
+}
+
+bool IRBank::findEntry(const std::string& name, size_t& index) const
+{
+  size_t low = 0;
+  size_t high = numEntries_;
+  while (low < high)
+  {
+    const size_t mid = low + (high - low) / 2;
+    const EntryRecord& entry = entryAt(entries_, mid);
+    const int order = name.compare(0, std::string::npos, names_ + entry.nameOffset,
+                                   entry.nameLength);
+    if (order == 0)
+    {
+      index = mid;
+      return true;
+    }
+    if (order > 0)
+      low = mid + 1;
+    else
+      high = mid;
+  }
+  return false;
+}
+
+IRCacheKey IRBank::getEntryKey(size_t index) const
+{
+  const EntryRecord& entry = entryAt(entries_, index);
+  IRCacheKey key;
+  key.contentHash = entry.contentHash;
+  key.contentSize = entry.contentSize;
+  return key;
+}
+
+bool IRBank::getSection(size_t index, IRCacheStage stage, SampleRate sampleRate,
+                        IRBankSection& section) const
+{
+  const EntryRecord& entry = entryAt(entries_, index);
+  for (uint64_t i = entry.firstSection; i < entry.firstSection + entry.numSections; ++i)
+  {
+    const SectionRecord& record = sectionAt(sections_, static_cast<size_t>(i));
+    if (record.stage != static_cast<uint32_t>(stage) ||
+        (stage == IRCacheStage::Resampled &&
+         std::llround(record.sampleRate) != std::llround(sampleRate)))
+      continue;
+
+    const auto* samples = reinterpret_cast<const Sample*>(
+        static_cast<const char*>(mapping_.getData()) + record.dataOffset);
+    const size_t numSamples = static_cast<size_t>(record.numSamples);
+    if (IRCache::hashBytes(samples, record.numChannels * numSamples * sizeof(Sample)) !=
+        record.payloadHash)
+      return false;
+
+    section.stage = stage;
+    section.sampleRate = record.sampleRate;
+    section.numChannels = static_cast<int>(record.numChannels);
+    section.numSamples = numSamples;
+    section.samples = samples;
+    return true;
+  }
+  return false;
+}
+
+}  // namespace octob
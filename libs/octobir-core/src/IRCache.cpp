@@ -0,0 +1,237 @@
+#include "octobir-core/IRCache.hpp"
+
+#ifdef _WIN32
+#include <direct.h>
+#include <process.h>
+#else
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace octob
+{
+
+namespace
+{
+
+constexpr char EntryMagic[8] = {'O', 'C', 'T', 'B', 'I', 'R', 'C', '1'};
+
+// Fixed 64-byte header, so the samples after it stay aligned in the mapping.
+struct EntryHeader
+{
+  char magic[8];
+  uint32_t processingVersion;
+  uint32_t stage;
+  uint64_t contentHash;
+  uint64_t contentSize;
+  double sampleRate;
+  uint32_t numChannels;
+  uint32_t reserved;
+  uint64_t numSamples;
+  uint64_t payloadHash;
+};
+
+static_assert(sizeof(EntryHeader) == 64, "IR cache header layout changed");
+
+constexpr uint64_t FnvPrime = 1099511628211ULL;
+
+// Entries at the file's own rate are named after the stage, resampled ones after the
+// rate rounded to the nearest Hz.
+std::string rateTag(IRCacheStage stage, SampleRate sampleRate)
+{
+  if (stage == IRCacheStage::MinimumPhase)
+    return "minphase";
+  return std::to_string(static_cast<long long>(std::llround(sampleRate)));
+}
+
+bool makeDirectory(const std::string& path)
+{
+#ifdef _WIN32
+  return _mkdir(path.c_str()) == 0 || errno == EEXIST;
+#else
+  return mkdir(path.c_str(), 0755) == 0 || errno == EEXIST;
+#endif
+}
+
+bool makeDirectories(const std::string& path)
+{
+  for (size_t pos = path.find_first_of("/\\", 1); pos != std::string::npos;
+       pos = path.find_first_of("/\\", pos + 1))
+    makeDirectory(path.substr(0, pos));
+  return makeDirectory(path);
+}
+
+// Unique per process and call, so concurrent writers never share a temporary file.
+std::string temporarySuffix()
+{
+  static std::atomic<unsigned> counter{0};
+#ifdef _WIN32
+  const long long pid = _getpid();
+#else
+  const long long pid = getpid();
+#endif
+  const auto ticks = std::chrono::steady_clock::now().time_since_epoch().count();
+  return ".tmp." + std::to_string(pid) + "." + std::to_string(ticks) + "." +
+         std::to_string(counter.fetch_add(1));
+}
+
+}  // namespace
+
+constexpr uint64_t IRCache::HashSeed;
+
+IRCache::IRCache(std::string directory) : directory_(std::move(directory)) {}
+
+uint64_t IRCache::hashBytes(const void* data, size_t size, uint64_t hash)
+{
+  const auto* bytes = static_cast<const unsigned char*>(data);
+  for (size_t i = 0; i < size; ++i)
+  {
+    hash ^= bytes[i];
+    hash *= FnvPrime;
+  }
+  return hash;
+}
+
+bool IRCache::computeKey(const std::string& filepath, IRCacheKey& key)
+{
+  key = IRCacheKey();
+
+  FILE* file = std::fopen(filepath.c_str(), "rb");
+  if (file == nullptr)
+    return false;
+
+  std::vector<unsigned char> chunk(1 << 16);
+  uint64_t hash = HashSeed;
+  uint64_t size = 0;
+  size_t read = 0;
+  while ((read = std::fread(chunk.data(), 1, chunk.size(), file)) > 0)
+  {
+    hash = hashBytes(chunk.data(), read, hash);
+    size += read;
+  }
+  const bool ok = std::ferror(file) == 0 && size > 0;
+  std::fclose(file);
+
+  if (!ok)
+    return false;
+  key.contentHash = hash;
+  key.contentSize = size;
+  return true;
+}
+
+std::string IRCache::getEntryPath(const IRCacheKey& key, IRCacheStage stage,
+                                  SampleRate sampleRate) const
+{
+  char hash[17];
+  std::snprintf(hash, sizeof(hash), "%016llx", static_cast<unsigned long long>(key.contentHash));
+  return directory_ + "/" + hash + "-" + std::to_string(key.contentSize) + "-v" +
+         std::to_string(ProcessingVersion) + "-" + rateTag(stage, sampleRate) + ".oirc";
+}
+
+std::unique_ptr<IRCacheEntry> IRCache::open(const IRCacheKey& key, IRCacheStage stage,
+                                            SampleRate sampleRate) const
+{
+  if (!key.isValid())
+    return nullptr;
+
+  const std::string path = getEntryPath(key, stage, sampleRate);
+  std::unique_ptr<IRCacheEntry> entry(new IRCacheEntry());
+  if (!entry->mapping_.open(path))
+    return nullptr;
+
+  const auto* data = static_cast<const char*>(entry->mapping_.getData());
+  const size_t size = entry->mapping_.getSize();
+  EntryHeader header;
+  bool valid = size >= sizeof(header);
+  if (valid)
+  {
+    std::memcpy(&header, data, sizeof(header));
+    const uint64_t payloadSize = size - sizeof(header);
+    valid = std::memcmp(header.magic, EntryMagic, sizeof(EntryMagic)) == 0 &&
+            header.processingVersion == ProcessingVersion &&
+            header.stage == static_cast<uint32_t>(stage) &&
+            header.contentHash == key.contentHash && header.contentSize == key.contentSize &&
+            header.numChannels > 0 && header.numSamples > 0 &&
+            payloadSize == static_cast<uint64_t>(header.numChannels) * header.numSamples *
+                               sizeof(Sample);
+  }
+
+  if (valid)
+  {
+    entry->samples_ = reinterpret_cast<const Sample*>(data + sizeof(header));
+    valid = hashBytes(entry->samples_, size - sizeof(header)) == header.payloadHash;
+  }
+
+  if (!valid)
+  {
+    // Unmap before removing; Windows refuses to delete a mapped file.
+    entry.reset();
+    std::remove(path.c_str());
+    return nullptr;
+  }
+
+  entry->numChannels_ = static_cast<int>(header.numChannels);
+  entry->numSamples_ = static_cast<size_t>(header.numSamples);
+  entry->sampleRate_ = header.sampleRate;
+  return entry;
+}
+
+bool IRCache::store(const IRCacheKey& key, IRCacheStage stage, SampleRate sampleRate,
+                    const Sample* const* channels, int numChannels, size_t numSamples) const
+{
+  if (!key.isValid() || channels == nullptr || numChannels <= 0 || numSamples == 0 ||
+      !makeDirectories(directory_))
+    return false;
+
+  EntryHeader header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.magic, EntryMagic, sizeof(EntryMagic));
+  header.processingVersion = ProcessingVersion;
+  header.stage = static_cast<uint32_t>(stage);
+  header.contentHash = key.contentHash;
+  header.contentSize = key.contentSize;
+  header.sampleRate = sampleRate;
+  header.numChannels = static_cast<uint32_t>(numChannels);
+  header.numSamples = numSamples;
+  header.payloadHash = HashSeed;
+  for (int ch = 0; ch < numChannels; ++ch)
+    header.payloadHash =
+        hashBytes(channels[ch], numSamples * sizeof(Sample), header.payloadHash);
+
+  const std::string path = getEntryPath(key, stage, sampleRate);
+  const std::string temporary = path + temporarySuffix();
+  FILE* file = std::fopen(temporary.c_str(), "wb");
+  if (file == nullptr)
+    return false;
+
+  bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1;
+  for (int ch = 0; ok && ch < numChannels; ++ch)
+    ok = std::fwrite(channels[ch], sizeof(Sample), numSamples, file) == numSamples;
+  ok = std::fclose(file) == 0 && ok;
+
+  // rename() replaces atomically on POSIX. On Windows it fails if another writer got
+  // there first, which leaves an equally valid entry in place.
+  if (!ok || std::rename(temporary.c_str(), path.c_str()) != 0)
+  {
+    std::remove(temporary.c_str());
+    return false;
+  }
+  return true;
+}
+
+IRCacheEntry::~IRCacheEntry() = default;
+
+const Sample* IRCacheEntry::getChannel(int channel) const
+{
+  return samples_ + static_cast<size_t>(channel) * numSamples_;
+}
+
+}  // namespace octob
@@ -0,0 +1,163 @@
+#include "octobir-core/IRKernelStore.hpp"
+
+#include <convoengine.h>
+
+#include <algorithm>
+#include <iterator>
+
+namespace octob
+{
+
+SharedIR::SharedIR() = default;
+SharedIR::~SharedIR() = default;
+
+IRKernelStore& IRKernelStore::getInstance()
+{
+  static IRKernelStore store;
+  return store;
+}
+
+std::shared_ptr<const SharedIR> IRKernelStore::load(const std::string& filepath,
+                                                    SampleRate sampleRate,
+                                                    const std::shared_ptr<const IRCache>& cache,
+                                                    std::string& errorMessage,
+                                                    float tailFloorDb)
+{
+  // An unreadable file gets no key; the loader below reports why. Bank entries are keyed
+  // by the file they were built from, so they share entries with it.
+  IRCacheKey key;
+  std::string bankPath;
+  std::string entryName;
+  if (IRBank::splitEntryPath(filepath, bankPath, entryName))
+  {
+    std::string bankError;
+    const auto bank = IRBank::openShared(bankPath, bankError);
+    size_t index = 0;
+    if (bank && bank->findEntry(entryName, index))
+      key = bank->getEntryKey(index);
+  }
+  else
+    IRCache::computeKey(filepath, key);
+  key = IRLoader::keyWithTailFloor(key, tailFloorDb);
+
+  std::shared_ptr<const IRLoader> source;
+  if (key.isValid())
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto entry = entries_.find(EntryKey(key.contentHash, key.contentSize, sampleRate));
+    if (entry != entries_.end())
+    {
+      auto ir = entry->second.lock();
+      if (ir)
+        return ir;
+    }
+
+    auto found = sources_.find(SourceKey(key.contentHash, key.contentSize));
+    if (found != sources_.end())
+      source = found->second.lock();
+  }
+
+  if (!source)
+  {
+    std::shared_ptr<IRLoader> loader(new IRLoader());
+    loader->setCache(cache);
+    loader->setTailFloorDb(tailFloorDb);
+    const IRLoadResult result = loader->loadFromFile(filepath);
+    if (!result.success)
+    {
+      errorMessage = result.errorMessage;
+      return nullptr;
+    }
+    source = std::move(loader);
+  }
+
+  return acquire(key, std::move(source), sampleRate, errorMessage);
+}
+
+std::shared_ptr<const SharedIR> IRKernelStore::resample(const SharedIR& ir,
+                                                        SampleRate sampleRate,
+                                                        std::string& errorMessage)
+{
+  if (ir.key.isValid())
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto entry = entries_.find(EntryKey(ir.key.contentHash, ir.key.contentSize, sampleRate));
+    if (entry != entries_.end())
+    {
+      auto shared = entry->second.lock();
+      if (shared)
+        return shared;
+    }
+  }
+  return acquire(ir.key, ir.source, sampleRate, errorMessage);
+}
+
+std::shared_ptr<const SharedIR> IRKernelStore::acquire(const IRCacheKey& key,
+                                                       std::shared_ptr<const IRLoader> source,
+                                                       SampleRate sampleRate,
+                                                       std::string& errorMessage)
+{
+  // Built without the lock held, so loads of different IRs run in parallel.
+  auto ir = build(key, std::move(source), sampleRate, errorMessage);
+  if (!ir || !key.isValid())
+    return ir;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  pruneLocked();
+
+  // Another thread may have published the same IR meanwhile; keep a single copy.
+  auto& entry = entries_[EntryKey(key.contentHash, key.contentSize, sampleRate)];
+  auto existing = entry.lock();
+  if (existing)
+    return existing;
+
+  entry = ir;
+  auto& sourceEntry = sources_[SourceKey(key.contentHash, key.contentSize)];
+  if (sourceEntry.expired())
+    sourceEntry = ir->source;
+  return ir;
+}
+
+std::shared_ptr<const SharedIR> IRKernelStore::build(const IRCacheKey& key,
+                                                     std::shared_ptr<const IRLoader> source,
+                                                     SampleRate sampleRate,
+                                                     std::string& errorMessage)
+{
+  std::shared_ptr<SharedIR> ir(new SharedIR());
+  ir->impulse.reset(new WDL_ImpulseBuffer());
+  if (!source || !source->resampleAndInitialize(*ir->impulse, sampleRate))
+  {
+    errorMessage = "Failed to resample IR to target sample rate";
+    return nullptr;
+  }
+
+  ir->kernel = ConvolutionKernel::create(*ir->impulse, std::min(source->getNumChannels(), 2),
+                                         KernelBlockSize);
+  if (!ir->kernel)
+  {
+    errorMessage = "Failed to build convolution kernel";
+    return nullptr;
+  }
+
+  ir->key = key;
+  ir->sampleRate = sampleRate;
+  ir->source = std::move(source);
+  return ir;
+}
+
+void IRKernelStore::pruneLocked()
+{
+  for (auto it = entries_.begin(); it != entries_.end();)
+    it = it->second.expired() ? entries_.erase(it) : std::next(it);
+  for (auto it = sources_.begin(); it != sources_.end();)
+    it = it->second.expired() ? sources_.erase(it) : std::next(it);
+}
+
+size_t IRKernelStore::getNumLiveEntries()
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  pruneLocked();
+  return entries_.size();
+}
+
+}  // namespace octob
@@ -0,0 +1,1014 @@
+#include "octobir-core/IRLibrary.hpp"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <dirent.h>
+#include <sys/stat.h>
+#endif
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <utility>
+
+#include "dr_wav.h"
+#include "pffft.h"
+
+namespace octob
+{
+
+constexpr int LibraryEntry::FingerprintBands;
+constexpr size_t IRLibrary::FingerprintLength;
+
+namespace
+{
+
+#ifdef _WIN32
+constexpr char PathSeparator = '\\';
+#else
+constexpr char PathSeparator = '/';
+#endif
+
+constexpr char IndexMagic[8] = {'O', 'C', 'T', 'B', 'L', 'I', 'B', '1'};
+constexpr uint32_t IndexVersion = 1;
+constexpr float FingerprintLowHz = 40.0f;
+constexpr float FingerprintHighHz = 20000.0f;
+
+bool isSeparator(char c)
+{
+  return c == '/' || c == '\\';
+}
+
+// Strips trailing separators, so "dir/" and "dir" name the same folder.
+std::string normalizeFolder(std::string directory)
+{
+  while (directory.size() > 1 && isSeparator(directory.back()))
+    directory.pop_back();
+  return directory;
+}
+
+std::string joinPath(const std::string& directory, const std::string& name)
+{
+  if (!directory.empty() && isSeparator(directory.back()))
+    return directory + name;
+  return directory + PathSeparator + name;
+}
+
+std::string parentOf(const std::string& path)
+{
+  const size_t pos = path.find_last_of("/\\");
+  return pos == std::string::npos ? std::string() : path.substr(0, pos);
+}
+
+// True if path lies below directory.
+bool isBelow(const std::string& path, const std::string& directory)
+{
+  return path.size() > directory.size() + 1 && path.compare(0, directory.size(), directory) == 0 &&
+         isSeparator(path[directory.size()]);
+}
+
+bool kindOf(const std::string& path, LibraryFileKind& kind)
+{
+  const size_t dot = path.rfind('.');
+  if (dot == std::string::npos || path.find_first_of("/\\", dot) != std::string::npos)
+    return false;
+  std::string ext = path.substr(dot);
+  for (char& c : ext)
+    c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+  if (ext == ".wav" || ext == ".aif" || ext == ".aiff")
+    kind = LibraryFileKind::ImpulseResponse;
+  else if (ext == ".nam")
+    kind = LibraryFileKind::NamModel;
+  else
+    return false;
+  return true;
+}
+
+struct DirectoryItem
+{
+  std::string name;
+  bool isDirectory = false;
+  int64_t modifiedTime = 0;
+  uint64_t size = 0;
+};
+
+// Regular files and folders only. Links to folders are skipped, so a link back up the
+// tree cannot make a scan recurse forever.
+bool statPath(const std::string& path, DirectoryItem& item)
+{
+#ifdef _WIN32
+  WIN32_FILE_ATTRIBUTE_DATA data;
+  if (!GetFileAttributesExA(path.c_str(), GetFileExInfoStandard, &data))
+    return false;
+  item.isDirectory = (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
+  if (item.isDirectory && (data.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT) != 0)
+    return false;
+  item.modifiedTime = static_cast<int64_t>(
+      (static_cast<uint64_t>(data.ftLastWriteTime.dwHighDateTime) << 32) |
+      data.ftLastWriteTime.dwLowDateTime);
+  item.size = (static_cast<uint64_t>(data.nFileSizeHigh) << 32) | data.nFileSizeLow;
+  return true;
+#else
+  struct stat info;
+  if (lstat(path.c_str(), &info) != 0)
+    return false;
+  if (S_ISLNK(info.st_mode) && (stat(path.c_str(), &info) != 0 || S_ISDIR(info.st_mode)))
+    return false;
+  item.isDirectory = S_ISDIR(info.st_mode);
+  if (!item.isDirectory && !S_ISREG(info.st_mode))
+    return false;
+  item.modifiedTime = static_cast<int64_t>(info.st_mtime);
+  item.size = static_cast<uint64_t>(info.st_size);
+  return true;
+#endif
+}
+
+// Hidden entries are skipped, as the plugins' file browsers do.
+bool listDirectory(const std::string& directory, std::vector<DirectoryItem>& items)
+{
+#ifdef _WIN32
+  WIN32_FIND_DATAA data;
+  HANDLE find = FindFirstFileA(joinPath(directory, "*").c_str(), &data);
+  if (find == INVALID_HANDLE_VALUE)
+    return false;
+  do
+  {
+    DirectoryItem item;
+    item.name = data.cFileName;
+    if (item.name.empty() || item.name[0] == '.' ||
+        (data.dwFileAttributes & FILE_ATTRIBUTE_HIDDEN) != 0)
+      continue;
+    if (statPath(joinPath(directory, item.name), item))
+      items.push_back(item);
+  } while (FindNextFileA(find, &data));
+  FindClose(find);
+  return true;
+#else
+  DIR* dp = opendir(directory.c_str());
+  if (dp == nullptr)
+    return false;
+  struct dirent* ep = nullptr;
+  while ((ep = readdir(dp)) != nullptr)
+  {
+    DirectoryItem item;
+    item.name = ep->d_name;
+    if (item.name.empty() || item.name[0] == '.')
+      continue;
+    if (statPath(joinPath(directory, item.name), item))
+      items.push_back(item);
+  }
+  closedir(dp);
+  return true;
+#endif
+}
+
+// Band energies of the channel average of numFrames interleaved frames, zero-padded to
+// FingerprintLength; see LibraryEntry::fingerprint.
+void computeFingerprint(const float* interleaved, size_t numFrames, uint32_t numChannels,
+                        SampleRate sampleRate, float* fingerprint)
+{
+  constexpr int Bands = LibraryEntry::FingerprintBands;
+  const auto fftSize = static_cast<int>(IRLibrary::FingerprintLength);
+  PFFFT_Setup* fft = pffft_new_setup(fftSize, PFFFT_REAL);
+  auto* in = static_cast<float*>(pffft_aligned_malloc(3 * fftSize * sizeof(float)));
+  if (fft == nullptr || in == nullptr)
+  {
+    if (fft != nullptr)
+      pffft_destroy_setup(fft);
+    pffft_aligned_free(in);
+    return;
+  }
+  float* out = in + fftSize;
+  float* work = out + fftSize;
+
+  std::fill(in, in + fftSize, 0.0f);
+  const float channelScale = 1.0f / static_cast<float>(numChannels);
+  for (size_t i = 0; i < numFrames; ++i)
+    for (uint32_t ch = 0; ch < numChannels; ++ch)
+      in[i] += interleaved[i * numChannels + ch] * channelScale;
+  pffft_transform_ordered(fft, in, out, work, PFFFT_FORWARD);
+
+  // Bins 1 .. fftSize/2 - 1 hold (re, im) pairs in ordered output.
+  const int lastBin = fftSize / 2 - 1;
+  const auto binOf = [&](float hz)
+  {
+    const auto bin = static_cast<int>(std::floor(hz / static_cast<float>(sampleRate) * fftSize));
+    return std::max(1, std::min(lastBin, bin));
+  };
+
+  float mean = 0.0f;
+  for (int band = 0; band < Bands; ++band)
+  {
+    const float ratio = FingerprintHighHz / FingerprintLowHz;
+    const int first = binOf(FingerprintLowHz * std::pow(ratio, static_cast<float>(band) / Bands));
+    const int last = std::max(
+        first, binOf(FingerprintLowHz * std::pow(ratio, static_cast<float>(band + 1) / Bands)) - 1);
+    double energy = 0.0;
+    for (int bin = first; bin <= last; ++bin)
+      energy += static_cast<double>(out[2 * bin]) * out[2 * bin] +
+                static_cast<double>(out[2 * bin + 1]) * out[2 * bin + 1];
+    energy /= static_cast<double>(last - first + 1);
+    fingerprint[band] = static_cast<float>(10.0 * std::log10(energy + 1e-20));
+    mean += fingerprint[band];
+  }
+  mean /= static_cast<float>(Bands);
+  for (int band = 0; band < Bands; ++band)
+    fingerprint[band] -= mean;
+
+  pffft_aligned_free(in);
+  pffft_destroy_setup(fft);
+}
+
+// Fills everything but the modification time. False if the file cannot be read; an IR
+// that does not decode is still indexed, without its audio fields.
+bool readEntry(const std::string& path, LibraryFileKind kind, LibraryEntry& entry)
+{
+  entry.path = path;
+  entry.kind = kind;
+  if (!IRCache::computeKey(path, entry.contentKey))
+    return false;
+  if (kind != LibraryFileKind::ImpulseResponse)
+    return true;
+
+  drwav wav;
+  if (!drwav_init_file(&wav, path.c_str(), nullptr))
+    return true;
+  if (wav.channels > 0 && wav.sampleRate > 0)
+  {
+    entry.sampleRate = static_cast<SampleRate>(wav.sampleRate);
+    entry.numSamples = static_cast<uint64_t>(wav.totalPCMFrameCount);
+    entry.numChannels = wav.channels;
+
+    const auto frames = static_cast<size_t>(
+        std::min(static_cast<uint64_t>(IRLibrary::FingerprintLength), entry.numSamples));
+    std::vector<float> interleaved(frames * wav.channels);
+    const auto read =
+        static_cast<size_t>(drwav_read_pcm_frames_f32(&wav, frames, interleaved.data()));
+    computeFingerprint(interleaved.data(), read, wav.channels, entry.sampleRate,
+                       entry.fingerprint);
+  }
+  drwav_uninit(&wav);
+  return true;
+}
+
+template <typename T>
+bool writeValue(FILE* file, const T& value)
+{
+  return std::fwrite(&value, sizeof(T), 1, file) == 1;
+}
+
+template <typename T>
+bool readValue(FILE* file, T& value)
+{
+  return std::fread(&value, sizeof(T), 1, file) == 1;
+}
+
+bool writeString(FILE* file, const std::string& value)
+{
+  const auto length = static_cast<uint32_t>(value.size());
+  return writeValue(file, length) && std::fwrite(value.data(), 1, length, file) == length;
+}
+
+bool readString(FILE* file, std::string& value)
+{
+  uint32_t length = 0;
+  if (!readValue(file, length) || length > (1u << 16))
+    return false;
+  value.resize(length);
+  return length == 0 || std::fread(&value[0], 1, length, file) == length;
+}
+
+}  // namespace
+
+#ifdef __linux__
+// inotify watches on every indexed folder. Events become jobs for the library's thread,
+// which does all the file reading.
+class IRLibrary::Watcher
+{
+ public:
+  explicit Watcher(IRLibrary& library) : library_(library) {}
+  ~Watcher() { stop(); }
+
+  bool start()
+  {
+    fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd_ < 0)
+      return false;
+    if (pipe(wakePipe_) != 0)
+    {
+      close(fd_);
+      fd_ = -1;
+      return false;
+    }
+    thread_ = std::thread(&Watcher::run, this);
+    return true;
+  }
+
+  void stop()
+  {
+    if (thread_.joinable())
+    {
+      const char wake = 0;
+      while (write(wakePipe_[1], &wake, 1) < 0 && errno == EINTR)
+      {
+      }
+      thread_.join();
+    }
+    for (int fd : {fd_, wakePipe_[0], wakePipe_[1]})
+      if (fd >= 0)
+        close(fd);
+    fd_ = wakePipe_[0] = wakePipe_[1] = -1;
+  }
+
+  void watch(const std::string& directory)
+  {
+    const int wd = inotify_add_watch(
+        fd_, directory.c_str(),
+        IN_CLOSE_WRITE | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_ONLYDIR);
+    if (wd < 0)
+      return;
+    std::lock_guard<std::mutex> lock(mutex_);
+    directories_[wd] = directory;
+  }
+
+ private:
+  void run()
+  {
+    alignas(struct inotify_event) char buffer[16384];
+    pollfd fds[2] = {{fd_, POLLIN, 0}, {wakePipe_[0], POLLIN, 0}};
+    for (;;)
+    {
+      if (poll(fds, 2, -1) < 0)
+      {
+        if (errno == EINTR)
+          continue;
+        return;
+      }
+      if (fds[1].revents != 0)
+        return;
+
+      const ssize_t length = read(fd_, buffer, sizeof(buffer));
+      for (ssize_t offset = 0; length > 0 && offset < length;)
+      {
+        const auto* event = reinterpret_cast<const struct inotify_event*>(buffer + offset);
+        handle(*event);
+        offset += static_cast<ssize_t>(sizeof(struct inotify_event) + event->len);
+      }
+    }
+  }
+
+  void handle(const struct inotify_event& event)
+  {
+    std::string directory;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      const auto it = directories_.find(event.wd);
+      if (it == directories_.end())
+        return;
+      if ((event.mask & IN_IGNORED) != 0)
+      {
+        directories_.erase(it);
+        return;
+      }
+      directory = it->second;
+    }
+    if (event.len == 0)
+      return;
+
+    const std::string path = joinPath(directory, event.name);
+    if ((event.mask & (IN_DELETE | IN_MOVED_FROM)) != 0)
+      library_.enqueue({Job::Type::RemovePath, path});
+    else if ((event.mask & IN_ISDIR) != 0)
+      library_.enqueue({Job::Type::ScanFolder, path});
+    else if ((event.mask & (IN_CLOSE_WRITE | IN_MOVED_TO)) != 0)
+      library_.enqueue({Job::Type::RefreshFile, path});
+  }
+
+  IRLibrary& library_;
+  int fd_ = -1;
+  int wakePipe_[2] = {-1, -1};
+  std::thread thread_;
+  std::mutex mutex_;
+  std::map<int, std::string> directories_;
+};
+#else
+class IRLibrary::Watcher
+{
+ public:
+  void watch(const std::string&) {}
+};
+#endif
+
+IRLibrary& IRLibrary::getShared()
+{
+  static IRLibrary library;
+  static std::once_flag watching;
+  std::call_once(watching, [] { library.startWatching(); });
+  return library;
+}
+
+IRLibrary::IRLibrary() = default;
+
+IRLibrary::~IRLibrary()
+{
+  stopWatching();
+  {
+    std::lock_guard<std::mutex> lock(jobsMutex_);
+    stopping_ = true;
+  }
+  jobsChanged_.notify_all();
+  if (jobThread_.joinable())
+    jobThread_.join();
+}
+
+void IRLibrary::setIndexFile(const std::string& path)
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (path == indexFile_)
+      return;
+    indexFile_ = path;
+  }
+  load(path);
+}
+
+bool IRLibrary::save(const std::string& path) const
+{
+  const std::string temporary = path + ".tmp";
+  FILE* file = std::fopen(temporary.c_str(), "wb");
+  if (file == nullptr)
+    return false;
+
+  bool ok = true;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ok = std::fwrite(IndexMagic, sizeof(IndexMagic), 1, file) == 1 &&
+         writeValue(file, IndexVersion) &&
+         writeValue(file, static_cast<uint32_t>(LibraryEntry::FingerprintBands)) &&
+         writeValue(file, static_cast<uint64_t>(roots_.size())) &&
+         writeValue(file, static_cast<uint64_t>(folderFiles_.size())) &&
+         writeValue(file, static_cast<uint64_t>(entries_.size()));
+    for (const auto& root : roots_)
+      ok = ok && writeString(file, root);
+    for (const auto& folder : folderFiles_)
+      ok = ok && writeString(file, folder.first);
+    for (const auto& item : entries_)
+    {
+      const LibraryEntry& entry = item.second;
+      ok = ok && writeString(file, entry.path) &&
+           writeValue(file, static_cast<uint8_t>(entry.kind)) &&
+           writeValue(file, entry.modifiedTime) && writeValue(file, entry.contentKey.contentHash) &&
+           writeValue(file, entry.contentKey.contentSize) && writeValue(file, entry.sampleRate) &&
+           writeValue(file, entry.numSamples) && writeValue(file, entry.numChannels) &&
+           writeValue(file, entry.fingerprint);
+    }
+  }
+  ok = std::fclose(file) == 0 && ok;
+
+  // Replaced in one step on POSIX; Windows' rename() will not overwrite.
+#ifdef _WIN32
+  if (ok)
+    std::remove(path.c_str());
+#endif
+  if (!ok || std::rename(temporary.c_str(), path.c_str()) != 0)
+  {
+    std::remove(temporary.c_str());
+    return false;
+  }
+  return true;
+}
+
+bool IRLibrary::load(const std::string& path)
+{
+  FILE* file = std::fopen(path.c_str(), "rb");
+  if (file == nullptr)
+    return false;
+
+  char magic[sizeof(IndexMagic)] = {};
+  uint32_t version = 0;
+  uint32_t bands = 0;
+  uint64_t numRoots = 0;
+  uint64_t numFolders = 0;
+  uint64_t numEntries = 0;
+  bool ok = std::fread(magic, sizeof(magic), 1, file) == 1 &&
+            std::memcmp(magic, IndexMagic, sizeof(magic)) == 0 && readValue(file, version) &&
+            version == IndexVersion && readValue(file, bands) &&
+            bands == static_cast<uint32_t>(LibraryEntry::FingerprintBands) &&
+            readValue(file, numRoots) && readValue(file, numFolders) &&
+            readValue(file, numEntries);
+
+  std::vector<std::string> roots;
+  std::vector<std::string> folders;
+  std::vector<LibraryEntry> entries;
+  for (uint64_t i = 0; ok && i < numRoots; ++i)
+  {
+    roots.emplace_back();
+    ok = readString(file, roots.back());
+  }
+  for (uint64_t i = 0; ok && i < numFolders; ++i)
+  {
+    folders.emplace_back();
+    ok = readString(file, folders.back());
+  }
+  for (uint64_t i = 0; ok && i < numEntries; ++i)
+  {
+    LibraryEntry entry;
+    uint8_t kind = 0;
+    ok = readString(file, entry.path) && readValue(file, kind) &&
+         kind <= static_cast<uint8_t>(LibraryFileKind::NamModel) &&
+         readValue(file, entry.modifiedTime) && readValue(file, entry.contentKey.contentHash) &&
+         readValue(file, entry.contentKey.contentSize) && readValue(file, entry.sampleRate) &&
+         readValue(file, entry.numSamples) && readValue(file, entry.numChannels) &&
+         readValue(file, entry.fingerprint);
+    entry.kind = static_cast<LibraryFileKind>(kind);
+    entries.push_back(std::move(entry));
+  }
+  std::fclose(file);
+  if (!ok)
+    return false;
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& root : roots)
+      if (!isCoveredLocked(root))
+        roots_.insert(root);
+    for (const auto& folder : folders)
+      folderFiles_[folder];
+    for (auto& entry : entries)
+      if (entries_.find(entry.path) == entries_.end())
+        insertLocked(std::move(entry));
+  }
+
+  // Files may have changed while nothing was watching, so the restored folders are
+  // watched from now on and rescanned to catch up.
+  for (const auto& folder : folders)
+    watch(folder);
+  for (const auto& root : roots)
+    addFolderInBackground(root);
+  return true;
+}
+
+void IRLibrary::addFolder(const std::string& directory)
+{
+  scanFolder(normalizeFolder(directory));
+  saveIndex();
+}
+
+void IRLibrary::addFolderInBackground(const std::string& directory)
+{
+  enqueue({Job::Type::ScanFolder, normalizeFolder(directory)});
+}
+
+bool IRLibrary::hasFolder(const std::string& directory) const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return isCoveredLocked(normalizeFolder(directory));
+}
+
+void IRLibrary::waitUntilIdle()
+{
+  std::unique_lock<std::mutex> lock(jobsMutex_);
+  jobsChanged_.wait(lock, [this] { return stopping_ || (jobs_.empty() && !runningJob_); });
+}
+
+bool IRLibrary::startWatching()
+{
+#ifdef __linux__
+  {
+    std::lock_guard<std::mutex> lock(watcherMutex_);
+    if (watcher_)
+      return true;
+    std::unique_ptr<Watcher> watcher(new Watcher(*this));
+    if (!watcher->start())
+      return false;
+    watcher_ = std::move(watcher);
+  }
+
+  std::vector<std::string> folders;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& folder : folderFiles_)
+      folders.push_back(folder.first);
+  }
+  for (const auto& folder : folders)
+    watch(folder);
+  return true;
+#else
+  return false;
+#endif
+}
+
+void IRLibrary::stopWatching()
+{
+  std::unique_ptr<Watcher> watcher;
+  {
+    std::lock_guard<std::mutex> lock(watcherMutex_);
+    watcher = std::move(watcher_);
+  }
+}
+
+bool IRLibrary::isWatching() const
+{
+  std::lock_guard<std::mutex> lock(watcherMutex_);
+  return watcher_ != nullptr;
+}
+
+size_t IRLibrary::getNumEntries() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return entries_.size();
+}
+
+bool IRLibrary::getEntry(const std::string& path, LibraryEntry& entry) const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  const auto it = entries_.find(path);
+  if (it == entries_.end())
+    return false;
+  entry = it->second;
+  return true;
+}
+
+std::vector<std::string> IRLibrary::getFolderFiles(const std::string& directory,
+                                                   LibraryFileKind kind) const
+{
+  std::vector<std::string> files;
+  std::lock_guard<std::mutex> lock(mutex_);
+  const auto folder = folderFiles_.find(normalizeFolder(directory));
+  if (folder == folderFiles_.end())
+    return files;
+  for (const auto& path : folder->second)
+  {
+    const auto it = entries_.find(path);
+    if (it != entries_.end() && it->second.kind == kind)
+      files.push_back(path);
+  }
+  return files;
+}
+
+bool IRLibrary::listFolder(const std::string& directory, LibraryFileKind kind,
+                           std::vector<std::string>& files)
+{
+  const std::string folder = normalizeFolder(directory);
+  if (hasFolder(folder))
+  {
+    if (!isWatching() && changedSinceScan(folder))
+      addFolderInBackground(folder);
+    files = getFolderFiles(folder, kind);
+    return true;
+  }
+
+  addFolderInBackground(folder);
+  std::vector<DirectoryItem> items;
+  if (!listDirectory(folder, items))
+    return false;
+  files.clear();
+  for (const auto& item : items)
+  {
+    LibraryFileKind itemKind;
+    if (!item.isDirectory && kindOf(item.name, itemKind) && itemKind == kind)
+      files.push_back(joinPath(folder, item.name));
+  }
+  std::sort(files.begin(), files.end());
+  return true;
+}
+
+std::vector<std::string> IRLibrary::findDuplicates(const std::string& path) const
+{
+  std::vector<std::string> duplicates;
+  std::lock_guard<std::mutex> lock(mutex_);
+  const auto target = entries_.find(path);
+  if (target == entries_.end())
+    return duplicates;
+
+  const IRCacheKey& key = target->second.contentKey;
+  for (const auto& item : entries_)
+    if (item.first != path && item.second.contentKey.contentHash == key.contentHash &&
+        item.second.contentKey.contentSize == key.contentSize)
+      duplicates.push_back(item.first);
+  return duplicates;
+}
+
+std::vector<std::string> IRLibrary::findSimilar(const std::string& path, size_t maxResults) const
+{
+  std::vector<std::pair<float, std::string>> candidates;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto target = entries_.find(path);
+    if (target == entries_.end() || target->second.sampleRate <= 0.0)
+      return std::vector<std::string>();
+
+    const LibraryEntry& reference = target->second;
+    for (const auto& item : entries_)
+    {
+      const LibraryEntry& entry = item.second;
+      if (entry.kind != LibraryFileKind::ImpulseResponse || entry.sampleRate <= 0.0 ||
+          (entry.contentKey.contentHash == reference.contentKey.contentHash &&
+           entry.contentKey.contentSize == reference.contentKey.contentSize))
+        continue;
+      float distance = 0.0f;
+      for (int band = 0; band < LibraryEntry::FingerprintBands; ++band)
+      {
+        const float difference = entry.fingerprint[band] - reference.fingerprint[band];
+        distance += difference * difference;
+      }
+      candidates.emplace_back(distance, item.first);
+    }
+  }
+
+  const size_t count = std::min(maxResults, candidates.size());
+  std::partial_sort(candidates.begin(), candidates.begin() + static_cast<std::ptrdiff_t>(count),
+                    candidates.end());
+  std::vector<std::string> similar;
+  for (size_t i = 0; i < count; ++i)
+    similar.push_back(std::move(candidates[i].second));
+  return similar;
+}
+
+// Walks root breadth-first without holding mutex_ while reading files, so queries keep
+// answering from the index as it was.
+void IRLibrary::scanFolder(const std::string& root)
+{
+  std::vector<std::string> pending(1, root);
+  std::set<std::string> visited;
+  while (!pending.empty())
+  {
+    if (stopping_)
+      return;
+    const std::string directory = pending.back();
+    pending.pop_back();
+
+    // Watched and stat'ed before it is listed, so a file written in between is not
+    // missed.
+    watch(directory);
+    DirectoryItem folder;
+    const bool stated = statPath(directory, folder);
+    std::vector<DirectoryItem> items;
+    if (!listDirectory(directory, items))
+      continue;
+    visited.insert(directory);
+
+    std::set<std::string> present;
+    for (const auto& item : items)
+    {
+      const std::string path = joinPath(directory, item.name);
+      LibraryFileKind kind;
+      if (item.isDirectory)
+        pending.push_back(path);
+      else if (kindOf(item.name, kind))
+      {
+        present.insert(path);
+        refreshFile(path, kind, item.modifiedTime, item.size, false);
+      }
+    }
+
+    // Files deleted since the folder was last scanned.
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (stated)
+      scannedTimes_[directory] = folder.modifiedTime;
+    auto& files = folderFiles_[directory];
+    for (auto it = files.begin(); it != files.end();)
+    {
+      const std::string path = *it++;
+      const auto entry = entries_.find(path);
+      if (present.count(path) == 0 && entry != entries_.end())
+        eraseLocked(entry);
+    }
+  }
+
+  if (visited.count(root) == 0)
+  {
+    removePath(root);
+    return;
+  }
+
+  // Folders under root that no longer exist.
+  std::vector<std::string> gone;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto it = folderFiles_.lower_bound(root); it != folderFiles_.end(); ++it)
+    {
+      if (it->first != root && !isBelow(it->first, root))
+        break;
+      if (visited.count(it->first) == 0)
+        gone.push_back(it->first);
+    }
+  }
+  for (const auto& directory : gone)
+    removePath(directory);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (isCoveredLocked(root))
+    return;
+  for (auto it = roots_.begin(); it != roots_.end();)
+  {
+    if (isBelow(*it, root))
+      it = roots_.erase(it);
+    else
+      ++it;
+  }
+  roots_.insert(root);
+  dirty_ = true;
+}
+
+// Rereads the file unless its entry matches modifiedTime and size; force rereads anyway,
+// for writes that change neither.
+void IRLibrary::refreshFile(const std::string& path, LibraryFileKind kind, int64_t modifiedTime,
+                            uint64_t size, bool force)
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it = entries_.find(path);
+    if (!force && it != entries_.end() && it->second.kind == kind &&
+        it->second.modifiedTime == modifiedTime && it->second.contentKey.contentSize == size)
+      return;
+  }
+
+  LibraryEntry entry;
+  const bool readable = readEntry(path, kind, entry);
+  entry.modifiedTime = modifiedTime;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (readable)
+  {
+    insertLocked(std::move(entry));
+    return;
+  }
+  const auto it = entries_.find(path);
+  if (it != entries_.end())
+    eraseLocked(it);
+}
+
+// Drops a file, or a folder and everything below it.
+void IRLibrary::removePath(const std::string& path)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  const auto file = entries_.find(path);
+  if (file != entries_.end())
+    eraseLocked(file);
+
+  for (auto it = entries_.lower_bound(path); it != entries_.end();)
+  {
+    if (!isBelow(it->first, path))
+    {
+      if (it->first.compare(0, path.size(), path) != 0)
+        break;
+      ++it;
+      continue;
+    }
+    eraseLocked(it++);
+  }
+  for (auto it = folderFiles_.lower_bound(path); it != folderFiles_.end();)
+  {
+    if (it->first != path && !isBelow(it->first, path))
+    {
+      if (it->first.compare(0, path.size(), path) != 0)
+        break;
+      ++it;
+      continue;
+    }
+    scannedTimes_.erase(it->first);
+    it = folderFiles_.erase(it);
+    dirty_ = true;
+  }
+}
+
+void IRLibrary::watch(const std::string& directory)
+{
+  std::lock_guard<std::mutex> lock(watcherMutex_);
+  if (watcher_)
+    watcher_->watch(directory);
+}
+
+// Must be called with mutex_ held.
+bool IRLibrary::isCoveredLocked(const std::string& directory) const
+{
+  for (const auto& root : roots_)
+    if (directory == root || isBelow(directory, root))
+      return true;
+  return false;
+}
+
+// True unless directory's modification time is the one its last scan saw. Adding,
+// removing or renaming a file changes it; rewriting one in place does not.
+bool IRLibrary::changedSinceScan(const std::string& directory) const
+{
+  DirectoryItem item;
+  if (!statPath(directory, item))
+    return true;
+  std::lock_guard<std::mutex> lock(mutex_);
+  const auto it = scannedTimes_.find(directory);
+  return it == scannedTimes_.end() || it->second != item.modifiedTime;
+}
+
+// Must be called with mutex_ held.
+void IRLibrary::insertLocked(LibraryEntry entry)
+{
+  const std::string path = entry.path;
+  folderFiles_[parentOf(path)].insert(path);
+  entries_[path] = std::move(entry);
+  dirty_ = true;
+}
+
+// Must be called with mutex_ held.
+void IRLibrary::eraseLocked(std::map<std::string, LibraryEntry>::iterator it)
+{
+  const auto folder = folderFiles_.find(parentOf(it->first));
+  if (folder != folderFiles_.end())
+    folder->second.erase(it->first);
+  entries_.erase(it);
+  dirty_ = true;
+}
+
+void IRLibrary::saveIndex()
+{
+  std::string path;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!dirty_ || indexFile_.empty())
+      return;
+    dirty_ = false;
+    path = indexFile_;
+  }
+  save(path);
+}
+
+void IRLibrary::enqueue(Job job)
+{
+  {
+    std::lock_guard<std::mutex> lock(jobsMutex_);
+    if (stopping_)
+      return;
+    // A scan reads the folder as it is when it runs, so repeated requests for one folder,
+    // e.g. from rapid navigation, only need to run once.
+    for (const auto& queued : jobs_)
+      if (job.type == Job::Type::ScanFolder && queued.type == job.type && queued.path == job.path)
+        return;
+    jobs_.push_back(std::move(job));
+    if (!jobThread_.joinable())
+      jobThread_ = std::thread(&IRLibrary::runJobs, this);
+  }
+  jobsChanged_.notify_all();
+}
+
+// Saves the index whenever the queue runs dry rather than after every job, so a burst of
+// file changes is written once.
+void IRLibrary::runJobs()
+{
+  std::unique_lock<std::mutex> lock(jobsMutex_);
+  for (;;)
+  {
+    jobsChanged_.wait(lock, [this] { return stopping_ || !jobs_.empty(); });
+    if (stopping_)
+      return;
+    const Job job = std::move(jobs_.front());
+    jobs_.pop_front();
+    runningJob_ = true;
+    lock.unlock();
+
+    applyJob(job);
+
+    lock.lock();
+    if (jobs_.empty())
+    {
+      lock.unlock();
+      saveIndex();
+      lock.lock();
+    }
+    runningJob_ = false;
+    jobsChanged_.notify_all();
+  }
+}
+
+void IRLibrary::applyJob(const Job& job)
+{
+  switch (job.type)
+  {
+    case Job::Type::ScanFolder:
+      scanFolder(job.path);
+      break;
+    case Job::Type::RefreshFile:
+    {
+      DirectoryItem item;
+      LibraryFileKind kind;
+      if (kindOf(job.path, kind) && statPath(job.path, item) && !item.isDirectory)
+        refreshFile(job.path, kind, item.modifiedTime, item.size, true);
+      break;
+    }
+    case Job::Type::RemovePath:
+      removePath(job.path);
+      break;
+  }
+}
+
+}  // namespace octob
@@ -1,5 +1,6 @@
 #include "octobir-core/IRLoader.hpp"
 
+#include <algorithm>
 #include <cmath>
 #include <cstddef>
 #include <cstdint>
@@ -27,6 +28,18 @@ int nextPow2(int n)
   return p;
 }
 
+constexpr double Pi = 3.14159265358979323846;
+
+// Length of the fade that ends a truncated IR.
+constexpr float TailFadeMs = 5.0f;
+// Partition size of the engines IRProcessor runs, for the cost estimate.
+constexpr size_t CostPartitionSize = 64;
+
+size_t numPartitions(size_t numSamples)
+{
+  return (numSamples + CostPartitionSize - 1) / CostPartitionSize;
+}
+
 }  // namespace
 
 IRLoader::IRLoader() = default;
@@ -120,10 +133,164 @@ void IRLoader::convertToMinimumPhase(std::vector<Sample>& samples, int fftSize)
   pffft_destroy_setup(fft);
 }
 
+bool IRLoader::loadFromCache()
+{
+  auto entry = cache_->open(cacheKey_, IRCacheStage::MinimumPhase, 0.0);
+  if (!entry)
+    return false;
+
+  // irBuffer_ is interleaved; the cache is planar.
+  const auto channels = static_cast<size_t>(entry->getNumChannels());
+  const size_t length = entry->getNumSamples();
+  irBuffer_.resize(length * channels);
+  for (size_t ch = 0; ch < channels; ++ch)
+  {
+    const Sample* source = entry->getChannel(static_cast<int>(ch));
+    for (size_t i = 0; i < length; ++i)
+      irBuffer_[i * channels + ch] = source[i];
+  }
+
+  bank_.reset();
+  bankSamples_ = nullptr;
+  irSampleRate_ = entry->getSampleRate();
+  numSamples_ = length;
+  numChannels_ = entry->getNumChannels();
+  truncateTail();
+  return true;
+}
+
+// The cut is the start of the shortest tail, summed over channels so they stay aligned,
+// whose backward-integrated energy is below the floor.
+void IRLoader::truncateTail()
+{
+  originalNumSamples_ = numSamples_;
+  resampledKey_ = cacheKey_;
+  if (tailFloorDb_ >= 0.0f || numSamples_ == 0)
+    return;
+
+  auto frameEnergy = [this](size_t frame)
+  {
+    double energy = 0.0;
+    for (int ch = 0; ch < numChannels_; ++ch)
+    {
+      const double sample = getSample(frame, ch);
+      energy += sample * sample;
+    }
+    return energy;
+  };
+
+  double totalEnergy = 0.0;
+  for (size_t i = 0; i < numSamples_; ++i)
+    totalEnergy += frameEnergy(i);
+  if (totalEnergy <= 0.0)
+    return;
+
+  const double floorEnergy = totalEnergy * std::pow(10.0, tailFloorDb_ / 10.0);
+  double tailEnergy = 0.0;
+  size_t length = numSamples_;
+  while (length > 1)
+  {
+    const double energy = frameEnergy(length - 1);
+    if (tailEnergy + energy >= floorEnergy)
+      break;
+    tailEnergy += energy;
+    --length;
+  }
+  if (length == numSamples_)
+    return;
+
+  // Interleaved, so an IR read from a bank is copied out of it here.
+  const auto channels = static_cast<size_t>(numChannels_);
+  std::vector<Sample> truncated(length * channels);
+  for (size_t i = 0; i < length; ++i)
+    for (size_t ch = 0; ch < channels; ++ch)
+      truncated[i * channels + ch] = getSample(i, static_cast<int>(ch));
+
+  const auto fadeLength =
+      std::min(static_cast<size_t>(irSampleRate_ * TailFadeMs / 1000.0f), length / 2);
+  for (size_t i = 0; i < fadeLength; ++i)
+  {
+    // Raised cosine from 1 down to just above 0 at the last kept sample.
+    const double phase = static_cast<double>(i + 1) / static_cast<double>(fadeLength + 1);
+    const auto gain = static_cast<Sample>(0.5 * (1.0 + std::cos(phase * Pi)));
+    Sample* frame = truncated.data() + (length - fadeLength + i) * channels;
+    for (size_t ch = 0; ch < channels; ++ch)
+      frame[ch] *= gain;
+  }
+
+  irBuffer_.swap(truncated);
+  bank_.reset();
+  bankSamples_ = nullptr;
+  numSamples_ = length;
+  resampledKey_ = keyWithTailFloor(cacheKey_, tailFloorDb_);
+}
+
+IRCacheKey IRLoader::keyWithTailFloor(const IRCacheKey& key, float tailFloorDb)
+{
+  IRCacheKey truncated = key;
+  if (key.isValid() && tailFloorDb < 0.0f)
+    truncated.contentHash = IRCache::hashBytes(&tailFloorDb, sizeof(tailFloorDb), key.contentHash);
+  return truncated;
+}
+
+float IRLoader::getConvolutionCostSaved() const
+{
+  if (originalNumSamples_ == 0)
+    return 0.0f;
+  // Partitioned convolution costs per sample grow with the number of partitions.
+  return 1.0f - static_cast<float>(numPartitions(numSamples_)) /
+                    static_cast<float>(numPartitions(originalNumSamples_));
+}
+
+IRLoadResult IRLoader::makeResult() const
+{
+  IRLoadResult result;
+  result.success = true;
+  result.numSamples = numSamples_;
+  result.numChannels = numChannels_;
+  result.sampleRate = irSampleRate_;
+  result.originalNumSamples = originalNumSamples_;
+  result.convolutionCostSaved = getConvolutionCostSaved();
+  return result;
+}
+
+void IRLoader::storeInCache() const
+{
+  const auto channels = static_cast<size_t>(numChannels_);
+  std::vector<Sample> planar(irBuffer_.size());
+  std::vector<const Sample*> pointers(channels);
+  for (size_t ch = 0; ch < channels; ++ch)
+  {
+    Sample* dest = planar.data() + ch * numSamples_;
+    for (size_t i = 0; i < numSamples_; ++i)
+      dest[i] = irBuffer_[i * channels + ch];
+    pointers[ch] = dest;
+  }
+  cache_->store(cacheKey_, IRCacheStage::MinimumPhase, irSampleRate_, pointers.data(),
+                numChannels_, numSamples_);
+}
+
 IRLoadResult IRLoader::loadFromFile(const std::string& filepath)
 {
   IRLoadResult result;
 
+  std::string bankPath;
+  std::string entryName;
+  if (IRBank::splitEntryPath(filepath, bankPath, entryName))
+  {
+    auto bank = IRBank::openShared(bankPath, result.errorMessage);
+    size_t index = 0;
+    if (bank && bank->findEntry(entryName, index))
+      return loadFromBank(std::move(bank), index);
+    if (bank)
+      result.errorMessage = "IR bank has no entry named " + entryName;
+    return result;
+  }
+
+  cacheKey_ = IRCacheKey();
+  if (cache_ && IRCache::computeKey(filepath, cacheKey_) && loadFromCache())
+    return makeResult();
+
   uint32_t channels = 0;
   uint32_t sampleRate = 0;
   drwav_uint64 totalPCMFrameCount = 0;
@@ -151,6 +318,8 @@ IRLoadResult IRLoader::loadFromFile(const std::string& filepath)
   }
 
   irBuffer_.clear();
+  bank_.reset();
+  bankSamples_ = nullptr;
 
   if (channels == 1)
   {
@@ -210,21 +379,119 @@ IRLoadResult IRLoader::loadFromFile(const std::string& filepath)
   numSamples_ = irLength;
   numChannels_ = static_cast<int>(channels);
 
-  result.success = true;
-  result.numSamples = numSamples_;
-  result.numChannels = numChannels_;
-  result.sampleRate = irSampleRate_;
+  // The cache holds the whole IR, so entries serve every tail floor.
+  if (cache_ && cacheKey_.isValid())
+    storeInCache();
 
-  return result;
+  truncateTail();
+  return makeResult();
+}
+
+IRLoadResult IRLoader::loadFromBank(std::shared_ptr<const IRBank> bank, size_t entryIndex)
+{
+  IRLoadResult result;
+  IRBankSection section;
+  if (!bank || entryIndex >= bank->getNumEntries() ||
+      !bank->getSection(entryIndex, IRCacheStage::MinimumPhase, 0.0, section))
+  {
+    result.errorMessage = "IR bank entry is missing or corrupt";
+    return result;
+  }
+
+  irBuffer_.clear();
+  irBuffer_.shrink_to_fit();
+  bank_ = std::move(bank);
+  bankEntry_ = entryIndex;
+  bankSamples_ = section.samples;
+  // Keyed by the file the entry was built from, so an IRCache still serves rates the bank
+  // was not built for.
+  cacheKey_ = bank_->getEntryKey(entryIndex);
+  irSampleRate_ = section.sampleRate;
+  numSamples_ = section.numSamples;
+  numChannels_ = section.numChannels;
+
+  truncateTail();
+  return makeResult();
+}
+
+void IRLoader::copyChannel(int channel, Sample* destination) const
+{
+  for (size_t i = 0; i < numSamples_; ++i)
+    destination[i] = getSample(i, channel);
+}
+
+Sample IRLoader::getSample(size_t frame, int channel) const
+{
+  if (bankSamples_ != nullptr)
+    return bankSamples_[static_cast<size_t>(channel) * numSamples_ + frame];
+  return irBuffer_[frame * static_cast<size_t>(numChannels_) + static_cast<size_t>(channel)];
 }
 
-bool IRLoader::resampleAndInitialize(WDL_ImpulseBuffer& impulseBuffer, SampleRate targetSampleRate)
+bool IRLoader::copyFromBank(WDL_ImpulseBuffer& impulseBuffer, SampleRate targetSampleRate) const
 {
-  if (irBuffer_.empty())
+  IRBankSection section;
+  if (!bank_->getSection(bankEntry_, IRCacheStage::Resampled, targetSampleRate, section) ||
+      section.numChannels != 2)
+    return false;
+
+  const int length = static_cast<int>(section.numSamples);
+  const bool sized = impulseBuffer.SetLength(length) == length;
+  impulseBuffer.SetNumChannels(2);
+  if (!sized || impulseBuffer.GetNumChannels() != 2)
+    return false;
+
+  impulseBuffer.samplerate = targetSampleRate;
+  for (int ch = 0; ch < 2; ++ch)
+    std::copy(section.getChannel(ch), section.getChannel(ch) + length,
+              impulseBuffer.impulses[ch].Get());
+  return true;
+}
+
+bool IRLoader::resampleAndInitialize(WDL_ImpulseBuffer& impulseBuffer,
+                                     SampleRate targetSampleRate) const
+{
+  if (numSamples_ == 0)
+  {
+    return false;
+  }
+
+  if (bank_ && copyFromBank(impulseBuffer, targetSampleRate))
+    return true;
+
+  const bool useCache = cache_ && resampledKey_.isValid();
+  if (useCache)
   {
+    auto entry = cache_->open(resampledKey_, IRCacheStage::Resampled, targetSampleRate);
+    if (entry && entry->getNumChannels() == 2)
+    {
+      const int length = static_cast<int>(entry->getNumSamples());
+      const bool sized = impulseBuffer.SetLength(length) == length;
+      impulseBuffer.SetNumChannels(2);
+      if (sized && impulseBuffer.GetNumChannels() == 2)
+      {
+        impulseBuffer.samplerate = targetSampleRate;
+        for (int ch = 0; ch < 2; ++ch)
+          std::copy(entry->getChannel(ch), entry->getChannel(ch) + length,
+                    impulseBuffer.impulses[ch].Get());
+        return true;
+      }
+    }
+  }
+
+  if (!resample(impulseBuffer, targetSampleRate))
     return false;
+
+  if (useCache)
+  {
+    const Sample* channels[] = {impulseBuffer.impulses[0].Get(), impulseBuffer.impulses[1].Get()};
+    cache_->store(resampledKey_, IRCacheStage::Resampled, targetSampleRate, channels, 2,
+                  static_cast<size_t>(impulseBuffer.GetLength()));
   }
+  return true;
+}
 
+bool IRLoader::resample(WDL_ImpulseBuffer& impulseBuffer, SampleRate targetSampleRate) const
+{
   const int outputChannels = 2;
 
   constexpr float KReferenceSampleRate = 48000.0f;
@@ -271,9 +538,7 @@ bool IRLoader::resampleAndInitialize(WDL_ImpulseBuffer& impulseBuffer, SampleRat
         if (i < static_cast<int>(numSamples_))
         {
           const int srcCh = (numChannels_ == 1) ? 0 : ch;
-          const size_t srcIdx = static_cast<size_t>(i) * static_cast<size_t>(numChannels_) +
-                                static_cast<size_t>(srcCh);
-          rsinbuf[i] = irBuffer_[srcIdx];
+          rsinbuf[i] = getSample(static_cast<size_t>(i), srcCh);
         }
         else
         {
@@ -328,8 +593,8 @@ bool IRLoader::resampleAndInitialize(WDL_ImpulseBuffer& impulseBuffer, SampleRat
       if (i < static_cast<int>(numSamples_))
       {
         const int srcCh = (numChannels_ == 1) ? 0 : ch;
-        const size_t srcIdx = (i * numChannels_) + srcCh;
-        irBufferPtr[i] = static_cast<WDL_FFT_REAL>(irBuffer_[srcIdx] * sampleRateScaling);
+        irBufferPtr[i] =
+            static_cast<WDL_FFT_REAL>(getSample(static_cast<size_t>(i), srcCh) * sampleRateScaling);
       }
       else
       {
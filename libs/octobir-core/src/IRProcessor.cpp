@@ -3,216 +3,666 @@
 #include <convoengine.h>
 
 #include <algorithm>
-#include <array>
 #include <cmath>
+#include <initializer_list>
 #include <string>
+#include <vector>
+
+#include "octobir-core/ConvolutionCostModel.hpp"
+#include "octobir-core/ConvolutionEngine.hpp"
+#include "octobir-core/ConvolutionKernel.hpp"
+#include "octobir-core/DelayLine.hpp"
+#include "octobir-core/DualKernelConvolver.hpp"
+#include "octobir-core/ForkJoinWorker.hpp"
+#include "octobir-core/IRKernelStore.hpp"
+#include "octobir-core/LevelDetector.hpp"
+#include "octobir-core/PffftConvolutionEngine.hpp"
+#include "octobir-core/SilenceDetector.hpp"
+#include "octobir-core/WorkerPool.hpp"
 
 namespace octob
 {
 
-IRProcessor::IRProcessor()
-    : impulseBuffer1_(new WDL_ImpulseBuffer()),
-      convolutionEngine1_(new WDL_ConvolutionEngine_Div()),
-      irLoader1_(new IRLoader()),
-      impulseBuffer2_(new WDL_ImpulseBuffer()),
-      convolutionEngine2_(new WDL_ConvolutionEngine_Div()),
-      irLoader2_(new IRLoader())
+constexpr size_t IRProcessor::DefaultPrefetchBudget;
+
+namespace
 {
-}
 
-IRProcessor::~IRProcessor() = default;
+const char* slotLabel(int slot)
+{
+  return slot == 1 ? "IR" : "IR2";
+}
 
-bool IRProcessor::loadImpulseResponse1(const std::string& filepath, std::string& errorMessage)
+bool validateImpulse(WDL_ImpulseBuffer& impulse, const std::string& label,
+                     std::string& errorMessage)
 {
-  auto stagingBuffer = std::unique_ptr<WDL_ImpulseBuffer>(new WDL_ImpulseBuffer());
-  auto stagingEngine = std::unique_ptr<WDL_ConvolutionEngine_Div>(new WDL_ConvolutionEngine_Div());
-  auto stagingLoader = std::unique_ptr<IRLoader>(new IRLoader());
+  const int irLength = impulse.GetLength();
+  const int irChannels = impulse.GetNumChannels();
+  const double irSampleRate = impulse.samplerate;
 
-  const IRLoadResult result = stagingLoader->loadFromFile(filepath);
-  if (!result.success)
+  if (irLength <= 0)
   {
-    errorMessage = result.errorMessage;
+    errorMessage = label + " buffer length is invalid: " + std::to_string(irLength);
     return false;
   }
 
-  if (!stagingLoader->resampleAndInitialize(*stagingBuffer, sampleRate_))
+  if (irChannels <= 0)
   {
-    errorMessage = "Failed to resample IR to target sample rate";
+    errorMessage = label + " buffer channels is invalid: " + std::to_string(irChannels);
     return false;
   }
 
-  const int irLength = stagingBuffer->GetLength();
-  const int irChannels = stagingBuffer->GetNumChannels();
-  const double irSampleRate = stagingBuffer->samplerate;
-
-  if (irLength <= 0)
+  if (irSampleRate <= 0)
   {
-    errorMessage = "IR buffer length is invalid: " + std::to_string(irLength);
+    errorMessage = label + " sample rate is invalid: " + std::to_string(irSampleRate);
     return false;
   }
 
-  if (irChannels <= 0)
+  return true;
+}
+
+// Runs blocks of silence through a new engine on the control thread, then clears it, so
+// engines that size their queues on first use, WDL's among them, reach the audio thread
+// with every buffer already grown to the host block size. Every partition up to the
+// engine latency bound has run once by then; the cost does not grow with the IR.
+void warmEngine(ConvolutionEngine& engine, int blockSize)
+{
+  if (blockSize <= 0 || !engine.growsOnFirstUse())
+    return;
+
+  const std::vector<Sample> silence(static_cast<size_t>(blockSize), 0.0f);
+  const Sample* const inputs[] = {silence.data(), silence.data()};
+  for (int frames = 0; frames < ConvolutionEngine::MaxLatencySamples + blockSize;
+       frames += blockSize)
   {
-    errorMessage = "IR buffer channels is invalid: " + std::to_string(irChannels);
-    return false;
+    engine.add(inputs, blockSize, 2);
+    const int available = engine.avail(blockSize);
+    engine.get();
+    engine.advance(available);
   }
+  engine.reset();
+}
 
-  if (irSampleRate <= 0)
+// Returns the engine latency, or -1 with errorMessage set. blockSize is the host block
+// size the engine is warmed at, 0 before setMaxBlockSize().
+int initializeEngine(ConvolutionEngine& engine, const SharedIR& ir, int blockSize,
+                     const std::string& label, std::string& errorMessage)
+{
+  WDL_ImpulseBuffer& impulse = *ir.impulse;
+  const int latency = engine.setSharedImpulse(impulse, ir.kernel);
+  if (latency < 0)
   {
-    errorMessage = "IR sample rate is invalid: " + std::to_string(irSampleRate);
-    return false;
+    errorMessage = "Failed to initialize convolution engine with " + label + " (returned " +
+                   std::to_string(latency) + "). " + label + ": " +
+                   std::to_string(impulse.GetLength()) + " samples, " +
+                   std::to_string(impulse.GetNumChannels()) + " channels, " +
+                   std::to_string(impulse.samplerate) + " Hz";
+    return -1;
+  }
+  if (latency > ConvolutionEngine::MaxLatencySamples)
+  {
+    errorMessage = "Convolution engine latency for " + label + " exceeds " +
+                   std::to_string(ConvolutionEngine::MaxLatencySamples) + " samples (reported " +
+                   std::to_string(latency) + ")";
+    return -1;
   }
+  warmEngine(engine, blockSize);
+  return latency;
+}
 
-  const int latency = stagingEngine->SetImpulse(stagingBuffer.get(), 64, 0, 0, 0);
-  if (latency < 0)
+// Rough memory a prepared IR holds: the resampled impulse, its kernel spectra at twice
+// the taps, and about as much again in the engine's own partitions.
+size_t estimatePreparedBytes(const SharedIR& ir)
+{
+  const auto taps = static_cast<size_t>(ir.impulse->GetLength()) *
+                    static_cast<size_t>(ir.impulse->GetNumChannels());
+  return taps * sizeof(Sample) * 4;
+}
+
+// A gain moving linearly across one block: start + step * (i + 1) at frame i, so the
+// last frame lands on the block's target and the next block continues from there.
+struct GainRamp
+{
+  float start;
+  float step;
+};
+
+GainRamp makeRamp(float from, float to, float scale, int numFrames)
+{
+  return {from * scale, (to - from) * scale / static_cast<float>(numFrames)};
+}
+
+// output = a * rampA + b * rampB over one contiguous run. Both loops are free of
+// loop-carried state so they vectorize; steady gains take the plain multiply-add.
+void mixRun(const Sample* a, const Sample* b, Sample* output, int numFrames, GainRamp rampA,
+            GainRamp rampB)
+{
+  if (rampA.step == 0.0f && rampB.step == 0.0f)
   {
-    errorMessage = "Failed to initialize convolution engine with IR (returned " +
-                   std::to_string(latency) + "). IR: " + std::to_string(irLength) + " samples, " +
-                   std::to_string(irChannels) + " channels, " + std::to_string(irSampleRate) +
-                   " Hz";
-    return false;
+    const float gainA = rampA.start;
+    const float gainB = rampB.start;
+    for (int i = 0; i < numFrames; ++i)
+      output[i] = gainA * a[i] + gainB * b[i];
+    return;
   }
 
+  for (int i = 0; i < numFrames; ++i)
   {
-    std::lock_guard<std::mutex> lock(pendingMutex1_);
-    stagingEngine1_ = std::move(stagingEngine);
-    stagingLoaded1_ = true;
-    stagingLatency1_ = latency;
-    ir1Pending_.store(true, std::memory_order_release);
+    const float frame = static_cast<float>(i + 1);
+    output[i] =
+        (rampA.start + rampA.step * frame) * a[i] + (rampB.start + rampB.step * frame) * b[i];
   }
+}
 
-  impulseBuffer1_ = std::move(stagingBuffer);
-  irLoader1_ = std::move(stagingLoader);
-  currentIR1Path_ = filepath;
-  errorMessage.clear();
-  return true;
+DelayLine::View contiguous(const Sample* samples, FrameCount numFrames)
+{
+  return {samples, numFrames, nullptr};
+}
+
+// Mixes a block from two sources that may each wrap around a delay line, one contiguous
+// run at a time. Runs end wherever either source wraps, so there are at most three.
+void mixRamped(const DelayLine::View& a, const DelayLine::View& b, Sample* output,
+               FrameCount numFrames, GainRamp rampA, GainRamp rampB)
+{
+  const FrameCount ends[] = {std::min(a.firstSize, b.firstSize),
+                             std::max(a.firstSize, b.firstSize), numFrames};
+  FrameCount begin = 0;
+  for (FrameCount end : ends)
+  {
+    if (end <= begin)
+      continue;
+    const Sample* runA = begin < a.firstSize ? a.first + begin : a.second + (begin - a.firstSize);
+    const Sample* runB = begin < b.firstSize ? b.first + begin : b.second + (begin - b.firstSize);
+    const float offset = static_cast<float>(begin);
+    mixRun(runA, runB, output + begin, static_cast<int>(end - begin),
+           {rampA.start + rampA.step * offset, rampA.step},
+           {rampB.start + rampB.step * offset, rampB.step});
+    begin = end;
+  }
+}
+
+// Folds an engine's stereo output into its left channel. For mono IRs the engines hand
+// back the same buffer for both channels, which is already mono.
+void downmixToMono(Sample* const* channels, int numFrames)
+{
+  if (channels[0] == channels[1])
+    return;
+  for (int i = 0; i < numFrames; ++i)
+    channels[0][i] = (channels[0][i] + channels[1][i]) * 0.5f;
+}
+
+}  // namespace
+
+IRProcessor::IRProcessor() : rmsDetector_(RmsBufferCapacity)
+{
+  updateRMSBufferSize();
+}
+
+IRProcessor::~IRProcessor()
+{
+  cancelPendingLoads();
+}
+
+bool IRProcessor::loadImpulseResponse1(const std::string& filepath, std::string& errorMessage)
+{
+  return loadSlot(1, filepath, errorMessage);
 }
 
 bool IRProcessor::loadImpulseResponse2(const std::string& filepath, std::string& errorMessage)
 {
-  auto stagingBuffer = std::unique_ptr<WDL_ImpulseBuffer>(new WDL_ImpulseBuffer());
-  auto stagingEngine = std::unique_ptr<WDL_ConvolutionEngine_Div>(new WDL_ConvolutionEngine_Div());
-  auto stagingLoader = std::unique_ptr<IRLoader>(new IRLoader());
+  return loadSlot(2, filepath, errorMessage);
+}
+
+bool IRProcessor::loadSlot(int slot, const std::string& filepath, std::string& errorMessage)
+{
+  std::lock_guard<std::mutex> lock(controlMutex_);
+  supersedeLoads(slot);
 
-  const IRLoadResult result = stagingLoader->loadFromFile(filepath);
-  if (!result.success)
+  if (auto prepared = takePrepared(slot, filepath))
   {
-    errorMessage = result.errorMessage;
-    return false;
+    commitSlot(slot, std::move(prepared->ir), std::move(prepared->engine), prepared->latency,
+               filepath);
+    errorMessage.clear();
+    return true;
   }
 
-  if (!stagingLoader->resampleAndInitialize(*stagingBuffer, sampleRate_))
-  {
-    errorMessage = "Failed to resample IR2 to target sample rate";
+  auto ir = IRKernelStore::getInstance().load(filepath, sampleRate_, irCache_, errorMessage,
+                                              tailFloorDb_);
+  if (!ir || !validateImpulse(*ir->impulse, slotLabel(slot), errorMessage))
+    return false;
+
+  const ConvolutionEngineType type = slot == 1 ? engineType1_ : engineType2_;
+  auto engine = createEngine(type, ir->impulse->GetLength());
+  const int latency =
+      initializeEngine(*engine, *ir, costModelBlockSize_, slotLabel(slot), errorMessage);
+  if (latency < 0)
     return false;
+
+  commitSlot(slot, std::move(ir), std::move(engine), latency, filepath);
+  errorMessage.clear();
+  return true;
+}
+
+void IRProcessor::commitSlot(int slot, std::shared_ptr<const SharedIR> ir,
+                             std::unique_ptr<ConvolutionEngine> engine, int latency,
+                             const std::string& filepath)
+{
+  publishSlot(slot, std::move(engine), true, latency, static_cast<int>(ir->impulse->GetLength()));
+  if (slot == 1)
+  {
+    ir1_ = std::move(ir);
+    currentIR1Path_ = filepath;
+  }
+  else
+  {
+    ir2_ = std::move(ir);
+    currentIR2Path_ = filepath;
   }
 
-  const int irLength = stagingBuffer->GetLength();
-  const int irChannels = stagingBuffer->GetNumChannels();
-  const double irSampleRate = stagingBuffer->samplerate;
+  stageDualConvolver();
+}
 
-  if (irLength <= 0)
+// Must be called with controlMutex_ held.
+void IRProcessor::publishSlot(int slot, std::unique_ptr<ConvolutionEngine> engine, bool loaded,
+                              int latency, int irLength)
+{
+  std::unique_ptr<SlotEngine> state(new SlotEngine());
+  state->engine = std::move(engine);
+  state->loaded = loaded && state->engine != nullptr;
+  state->latency = state->loaded ? latency : 0;
+  state->length = state->loaded ? irLength : 0;
+  (slot == 1 ? stagedLatency1_ : stagedLatency2_) = state->latency;
+  (slot == 1 ? stagedLength1_ : stagedLength2_) = state->length;
+  (slot == 1 ? stagedUsesKernel1_ : stagedUsesKernel2_) =
+      state->loaded && state->engine->usesKernel();
+  stagedTailSamples_.store(std::max(stagedLength1_, stagedLength2_) +
+                               std::max(0, std::max(stagedLatency1_, stagedLatency2_)),
+                           std::memory_order_relaxed);
+  (slot == 1 ? slot1_ : slot2_).publish(std::move(state));
+}
+
+IRLoadTicket IRProcessor::supersedeLoads(int slot)
+{
+  const IRLoadTicket ticket = nextTicket_.fetch_add(1, std::memory_order_relaxed) + 1;
+  (slot == 1 ? latestTicket1_ : latestTicket2_).store(ticket, std::memory_order_release);
+  return ticket;
+}
+
+bool IRProcessor::isSuperseded(int slot, IRLoadTicket ticket) const
+{
+  return (slot == 1 ? latestTicket1_ : latestTicket2_).load(std::memory_order_acquire) != ticket;
+}
+
+IRLoadTicket IRProcessor::requestLoad(int slot, const std::string& filepath,
+                                      IRLoadCallback callback)
+{
+  if (slot != 1 && slot != 2)
+    return 0;
+
+  // A prefetched file is staged right here; the worker is then only left to call back.
+  IRLoadTicket ticket = 0;
+  bool staged = false;
   {
-    errorMessage = "IR2 buffer length is invalid: " + std::to_string(irLength);
-    return false;
+    std::lock_guard<std::mutex> lock(controlMutex_);
+    ticket = supersedeLoads(slot);
+    if (auto prepared = takePrepared(slot, filepath))
+    {
+      commitSlot(slot, std::move(prepared->ir), std::move(prepared->engine), prepared->latency,
+                 filepath);
+      staged = true;
+    }
+  }
+  {
+    std::lock_guard<std::mutex> lock(loadsMutex_);
+    ++loadsInFlight_;
   }
 
-  if (irChannels <= 0)
+  WorkerPool::getShared().submit(
+      [this, slot, ticket, filepath, callback, staged]()
+      {
+        IRLoadCompletion completion;
+        completion.ticket = ticket;
+        completion.slot = slot;
+        completion.filepath = filepath;
+        completion.status = staged ? IRLoadStatus::Loaded
+                                   : loadSlotInBackground(slot, ticket, filepath,
+                                                          completion.errorMessage);
+        if (completion.status != IRLoadStatus::Failed)
+          completion.errorMessage.clear();
+
+        if (callback)
+          callback(completion);
+
+        std::lock_guard<std::mutex> lock(loadsMutex_);
+        if (--loadsInFlight_ == 0)
+          loadsIdle_.notify_all();
+      });
+  return ticket;
+}
+
+// Decoding, resampling and the engine's impulse setup run without controlMutex_, so the
+// caller's thread is only held up while the result is staged. Settings that change in
+// the meantime are caught before staging and the affected step is redone.
+IRLoadStatus IRProcessor::loadSlotInBackground(int slot, IRLoadTicket ticket,
+                                               const std::string& filepath,
+                                               std::string& errorMessage)
+{
+  SampleRate sampleRate = 0.0;
+  std::shared_ptr<const IRCache> cache;
+  float tailFloorDb = 0.0f;
   {
-    errorMessage = "IR2 buffer channels is invalid: " + std::to_string(irChannels);
-    return false;
+    std::lock_guard<std::mutex> lock(controlMutex_);
+    if (isSuperseded(slot, ticket))
+      return IRLoadStatus::Cancelled;
+    sampleRate = sampleRate_;
+    cache = irCache_;
+    tailFloorDb = tailFloorDb_;
   }
 
-  if (irSampleRate <= 0)
+  auto ir =
+      IRKernelStore::getInstance().load(filepath, sampleRate, cache, errorMessage, tailFloorDb);
+  if (!ir || !validateImpulse(*ir->impulse, slotLabel(slot), errorMessage))
+    return IRLoadStatus::Failed;
+
+  for (;;)
   {
-    errorMessage = "IR2 sample rate is invalid: " + std::to_string(irSampleRate);
-    return false;
+    std::unique_ptr<ConvolutionEngine> engine;
+    unsigned int generation = 0;
+    int blockSize = 0;
+    {
+      std::lock_guard<std::mutex> lock(controlMutex_);
+      if (isSuperseded(slot, ticket))
+        return IRLoadStatus::Cancelled;
+
+      sampleRate = sampleRate_;
+      generation = engineGeneration_;
+      blockSize = costModelBlockSize_;
+      if (ir->sampleRate == sampleRate)
+        engine = createEngine(slot == 1 ? engineType1_ : engineType2_, ir->impulse->GetLength());
+    }
+
+    if (!engine)
+    {
+      ir = IRKernelStore::getInstance().resample(*ir, sampleRate, errorMessage);
+      if (!ir)
+        return IRLoadStatus::Failed;
+      continue;
+    }
+
+    const int latency = initializeEngine(*engine, *ir, blockSize, slotLabel(slot), errorMessage);
+    if (latency < 0)
+      return IRLoadStatus::Failed;
+
+    std::lock_guard<std::mutex> lock(controlMutex_);
+    if (isSuperseded(slot, ticket))
+      return IRLoadStatus::Cancelled;
+    if (generation != engineGeneration_)
+      continue;
+
+    commitSlot(slot, std::move(ir), std::move(engine), latency, filepath);
+    return IRLoadStatus::Loaded;
   }
+}
 
-  const int latency = stagingEngine->SetImpulse(stagingBuffer.get(), 64, 0, 0, 0);
-  if (latency < 0)
+void IRProcessor::cancelPendingLoads()
+{
+  supersedeLoads(1);
+  supersedeLoads(2);
+  prefetchTicket1_.store(nextTicket_.fetch_add(1, std::memory_order_relaxed) + 1,
+                         std::memory_order_release);
+  prefetchTicket2_.store(nextTicket_.fetch_add(1, std::memory_order_relaxed) + 1,
+                         std::memory_order_release);
+
+  std::unique_lock<std::mutex> lock(loadsMutex_);
+  loadsIdle_.wait(lock, [this] { return loadsInFlight_ == 0; });
+}
+
+void IRProcessor::prefetchImpulseResponses(int slot, const std::vector<std::string>& filepaths)
+{
+  if (slot != 1 && slot != 2)
+    return;
+
+  const IRLoadTicket ticket = nextTicket_.fetch_add(1, std::memory_order_relaxed) + 1;
+  std::vector<std::unique_ptr<PreparedIR>> released;
   {
-    errorMessage = "Failed to initialize convolution engine with IR2 (returned " +
-                   std::to_string(latency) + "). IR2: " + std::to_string(irLength) + " samples, " +
-                   std::to_string(irChannels) + " channels, " + std::to_string(irSampleRate) +
-                   " Hz";
-    return false;
+    std::lock_guard<std::mutex> lock(controlMutex_);
+    (slot == 1 ? prefetchTicket1_ : prefetchTicket2_).store(ticket, std::memory_order_release);
+
+    auto& prepared = slot == 1 ? prepared1_ : prepared2_;
+    std::vector<std::unique_ptr<PreparedIR>> kept;
+    for (auto& entry : prepared)
+    {
+      const bool listed =
+          std::find(filepaths.begin(), filepaths.end(), entry->filepath) != filepaths.end();
+      if (!listed)
+        prefetchedBytes_ -= entry->bytes;
+      (listed ? kept : released).push_back(std::move(entry));
+    }
+    prepared.swap(kept);
   }
+  // Engines are destroyed here, outside controlMutex_.
+  released.clear();
 
   {
-    std::lock_guard<std::mutex> lock(pendingMutex2_);
-    stagingEngine2_ = std::move(stagingEngine);
-    stagingLoaded2_ = true;
-    stagingLatency2_ = latency;
-    ir2Pending_.store(true, std::memory_order_release);
+    std::lock_guard<std::mutex> lock(loadsMutex_);
+    ++loadsInFlight_;
+  }
+  WorkerPool::getShared().submit(
+      [this, slot, ticket, filepaths]()
+      {
+        prefetchInBackground(slot, ticket, filepaths);
+
+        std::lock_guard<std::mutex> lock(loadsMutex_);
+        if (--loadsInFlight_ == 0)
+          loadsIdle_.notify_all();
+      });
+}
+
+// Prepares the files in order like loadSlotInBackground(), holding controlMutex_ only to
+// read the settings and to store each result. Files that fail are skipped; their load
+// reports the error if they are picked.
+void IRProcessor::prefetchInBackground(int slot, IRLoadTicket ticket,
+                                       const std::vector<std::string>& filepaths)
+{
+  auto& prepared = slot == 1 ? prepared1_ : prepared2_;
+  for (const auto& filepath : filepaths)
+  {
+    SampleRate sampleRate = 0.0;
+    std::shared_ptr<const IRCache> cache;
+    float tailFloorDb = 0.0f;
+    int blockSize = 0;
+    std::unique_ptr<PreparedIR> stale;
+    {
+      std::lock_guard<std::mutex> lock(controlMutex_);
+      if (isPrefetchSuperseded(slot, ticket) || prefetchedBytes_ >= prefetchBudget_)
+        return;
+
+      const auto it = std::find_if(prepared.begin(), prepared.end(),
+                                   [&filepath](const std::unique_ptr<PreparedIR>& entry)
+                                   { return entry->filepath == filepath; });
+      if (it != prepared.end())
+      {
+        if (isCurrent(**it))
+          continue;
+        prefetchedBytes_ -= (*it)->bytes;
+        stale = std::move(*it);
+        prepared.erase(it);
+      }
+      sampleRate = sampleRate_;
+      cache = irCache_;
+      tailFloorDb = tailFloorDb_;
+    }
+    stale.reset();
+
+    std::string error;
+    std::unique_ptr<PreparedIR> entry(new PreparedIR());
+    entry->filepath = filepath;
+    entry->ir =
+        IRKernelStore::getInstance().load(filepath, sampleRate, cache, error, tailFloorDb);
+    if (!entry->ir || !validateImpulse(*entry->ir->impulse, slotLabel(slot), error))
+      continue;
+
+    {
+      std::lock_guard<std::mutex> lock(controlMutex_);
+      if (isPrefetchSuperseded(slot, ticket))
+        return;
+      if (entry->ir->sampleRate != sampleRate_)
+        continue;
+      entry->generation = engineGeneration_;
+      entry->engine = createEngine(slot == 1 ? engineType1_ : engineType2_,
+                                   entry->ir->impulse->GetLength());
+      blockSize = costModelBlockSize_;
+    }
+
+    entry->latency =
+        initializeEngine(*entry->engine, *entry->ir, blockSize, slotLabel(slot), error);
+    if (entry->latency < 0)
+      continue;
+    entry->bytes = estimatePreparedBytes(*entry->ir);
+
+    // Declared after entry so an unused preparation is destroyed once the lock is released.
+    std::lock_guard<std::mutex> lock(controlMutex_);
+    if (isPrefetchSuperseded(slot, ticket) || prefetchedBytes_ + entry->bytes > prefetchBudget_)
+      return;
+    if (!isCurrent(*entry))
+      continue;
+    prefetchedBytes_ += entry->bytes;
+    prepared.push_back(std::move(entry));
   }
+}
 
-  impulseBuffer2_ = std::move(stagingBuffer);
-  irLoader2_ = std::move(stagingLoader);
-  currentIR2Path_ = filepath;
-  errorMessage.clear();
-  return true;
+bool IRProcessor::isPrefetchSuperseded(int slot, IRLoadTicket ticket) const
+{
+  return (slot == 1 ? prefetchTicket1_ : prefetchTicket2_).load(std::memory_order_acquire) !=
+         ticket;
 }
 
-void IRProcessor::clearImpulseResponse1()
+// Must be called with controlMutex_ held.
+bool IRProcessor::isCurrent(const PreparedIR& prepared) const
+{
+  return prepared.generation == engineGeneration_ && prepared.ir->sampleRate == sampleRate_ &&
+         prepared.ir->source->getTailFloorDb() == tailFloorDb_;
+}
+
+// Removes the slot's preparation of filepath. Returns it if it can be committed as is.
+// Must be called with controlMutex_ held.
+std::unique_ptr<IRProcessor::PreparedIR> IRProcessor::takePrepared(int slot,
+                                                                   const std::string& filepath)
+{
+  auto& prepared = slot == 1 ? prepared1_ : prepared2_;
+  for (auto it = prepared.begin(); it != prepared.end(); ++it)
+  {
+    if ((*it)->filepath != filepath)
+      continue;
+    std::unique_ptr<PreparedIR> entry = std::move(*it);
+    prepared.erase(it);
+    prefetchedBytes_ -= entry->bytes;
+    if (!isCurrent(*entry))
+      return nullptr;
+    return entry;
+  }
+  return nullptr;
+}
+
+void IRProcessor::setPrefetchBudget(size_t bytes)
+{
+  std::lock_guard<std::mutex> lock(controlMutex_);
+  prefetchBudget_ = bytes;
+}
+
+size_t IRProcessor::getPrefetchBudget() const
+{
+  std::lock_guard<std::mutex> lock(controlMutex_);
+  return prefetchBudget_;
+}
+
+size_t IRProcessor::getPrefetchedBytes() const
+{
+  std::lock_guard<std::mutex> lock(controlMutex_);
+  return prefetchedBytes_;
+}
+
+size_t IRProcessor::getNumPrefetched(int slot) const
+{
+  std::lock_guard<std::mutex> lock(controlMutex_);
+  return (slot == 1 ? prepared1_ : prepared2_).size();
+}
+
+std::vector<std::string> IRProcessor::neighboringFiles(const std::vector<std::string>& files,
+                                                       size_t index, int radius)
 {
+  std::vector<std::string> neighbors;
+  if (index >= files.size())
+    return neighbors;
+
+  const auto count = static_cast<long>(files.size());
+  for (int distance = 1; distance <= radius; ++distance)
   {
-    std::lock_guard<std::mutex> lock(pendingMutex1_);
-    stagingEngine1_ = std::unique_ptr<WDL_ConvolutionEngine_Div>(new WDL_ConvolutionEngine_Div());
-    stagingLoaded1_ = false;
-    stagingLatency1_ = 0;
-    ir1Pending_.store(true, std::memory_order_release);
+    for (int direction : {1, -1})
+    {
+      const long position = (static_cast<long>(index) + direction * distance) % count;
+      const auto neighbor = static_cast<size_t>(position < 0 ? position + count : position);
+      if (neighbor == index ||
+          std::find(neighbors.begin(), neighbors.end(), files[neighbor]) != neighbors.end())
+        continue;
+      neighbors.push_back(files[neighbor]);
+    }
   }
+  return neighbors;
+}
+
+void IRProcessor::clearImpulseResponse1()
+{
+  std::lock_guard<std::mutex> control(controlMutex_);
+  supersedeLoads(1);
+  publishSlot(1, nullptr, false, 0, 0);
+  ir1_.reset();
+  stageDualConvolver();
   currentIR1Path_.clear();
 }
 
 void IRProcessor::clearImpulseResponse2()
 {
-  {
-    std::lock_guard<std::mutex> lock(pendingMutex2_);
-    stagingEngine2_ = std::unique_ptr<WDL_ConvolutionEngine_Div>(new WDL_ConvolutionEngine_Div());
-    stagingLoaded2_ = false;
-    stagingLatency2_ = 0;
-    ir2Pending_.store(true, std::memory_order_release);
-  }
+  std::lock_guard<std::mutex> control(controlMutex_);
+  supersedeLoads(2);
+  publishSlot(2, nullptr, false, 0, 0);
+  ir2_.reset();
+  stageDualConvolver();
   currentIR2Path_.clear();
 }
 
 void IRProcessor::setSampleRate(SampleRate sampleRate)
 {
+  std::lock_guard<std::mutex> lock(controlMutex_);
   if (sampleRate_ != sampleRate)
   {
     sampleRate_ = sampleRate;
     updateSmoothingCoefficients();
     updateRMSBufferSize();
 
-    if (ir1Loaded_.load(std::memory_order_relaxed) && impulseBuffer1_->GetLength() > 0)
+    // Shared IRs are immutable: fetch the IR at the new rate and rebuild the engine.
+    std::string error;
+    if (ir1_)
     {
-      irLoader1_->resampleAndInitialize(*impulseBuffer1_, sampleRate_);
-      auto stagingEngine =
-          std::unique_ptr<WDL_ConvolutionEngine_Div>(new WDL_ConvolutionEngine_Div());
-      const int latency = stagingEngine->SetImpulse(impulseBuffer1_.get(), 64, 0, 0, 0);
-
-      std::lock_guard<std::mutex> lock(pendingMutex1_);
-      stagingEngine1_ = std::move(stagingEngine);
-      stagingLoaded1_ = true;
-      stagingLatency1_ = latency >= 0 ? latency : 0;
-      ir1Pending_.store(true, std::memory_order_release);
+      auto resampled = IRKernelStore::getInstance().resample(*ir1_, sampleRate_, error);
+      if (resampled)
+      {
+        ir1_ = std::move(resampled);
+        restageEngine1();
+      }
     }
 
-    if (ir2Loaded_.load(std::memory_order_relaxed) && impulseBuffer2_->GetLength() > 0)
+    if (ir2_)
     {
-      irLoader2_->resampleAndInitialize(*impulseBuffer2_, sampleRate_);
-      auto stagingEngine =
-          std::unique_ptr<WDL_ConvolutionEngine_Div>(new WDL_ConvolutionEngine_Div());
-      const int latency = stagingEngine->SetImpulse(impulseBuffer2_.get(), 64, 0, 0, 0);
-
-      std::lock_guard<std::mutex> lock(pendingMutex2_);
-      stagingEngine2_ = std::move(stagingEngine);
-      stagingLoaded2_ = true;
-      stagingLatency2_ = latency >= 0 ? latency : 0;
-      ir2Pending_.store(true, std::memory_order_release);
+      auto resampled = IRKernelStore::getInstance().resample(*ir2_, sampleRate_, error);
+      if (resampled)
+      {
+        ir2_ = std::move(resampled);
+        restageEngine2();
+      }
     }
+
+    stageDualConvolver();
   }
 }
 
@@ -220,6 +670,29 @@ void IRProcessor::setMaxBlockSize(FrameCount maxBlockSize)
 {
   scratchL_.resize(maxBlockSize);
   scratchR_.resize(maxBlockSize);
+
+  // Sized for the largest latency any engine can report plus one host block, which is
+  // written before it is read back, so a latency change never reallocates.
+  for (int c = 0; c < 2; ++c)
+  {
+    dryDelay_[c].allocate(ConvolutionEngine::MaxLatencySamples, maxBlockSize);
+    ir1Delay_[c].allocate(ConvolutionEngine::MaxLatencySamples, maxBlockSize);
+    ir2Delay_[c].allocate(ConvolutionEngine::MaxLatencySamples, maxBlockSize);
+  }
+  alignedLatency_ = 0;
+  updateDelayLines();
+
+  // Auto slots pick their engine from costs measured at this block size, and every
+  // engine is warmed up at it.
+  std::lock_guard<std::mutex> lock(controlMutex_);
+  const int blockSize = static_cast<int>(maxBlockSize);
+  if (blockSize != costModelBlockSize_)
+  {
+    costModelBlockSize_ = blockSize;
+    costModel_ = ConvolutionCostModel::measure(blockSize);
+    restageEngine1();
+    restageEngine2();
+  }
 }
 
 void IRProcessor::setBlend(float blend)
@@ -262,8 +735,7 @@ void IRProcessor::setKneeWidthDb(float kneeDb)
 
 void IRProcessor::setDetectionMode(int mode)
 {
-  detectionMode_ = std::max(0, std::min(1, mode));
-  updateRMSBufferSize();
+  detectionMode_ = std::max(0, std::min(NumDetectionModes - 1, mode));
 }
 
 void IRProcessor::updateRMSBufferSize()
@@ -273,13 +745,9 @@ void IRProcessor::updateRMSBufferSize()
     return;
   }
 
-  size_t newSize = static_cast<size_t>((RmsWindowMs / 1000.0f) * sampleRate_);
-  if (newSize != rmsBufferSize_)
-  {
-    rmsBufferSize_ = std::max(static_cast<size_t>(1), newSize);
-    rmsBuffer_.resize(rmsBufferSize_, 0.0f);
-    rmsBufferIndex_ = 0;
-  }
+  const size_t newSize = static_cast<size_t>((RmsWindowMs / 1000.0f) * sampleRate_);
+  rmsWindowTarget_.store(
+      std::max(static_cast<size_t>(1), std::min(newSize, rmsDetector_.getMaxWindowLength())));
 }
 
 void IRProcessor::setAttackTime(float attackTimeMs)
@@ -332,6 +800,147 @@ void IRProcessor::setIRBTrimGain(float gainDb)
   }
 }
 
+void IRProcessor::setIRAEngine(ConvolutionEngineType type)
+{
+  std::lock_guard<std::mutex> lock(controlMutex_);
+  if (type == engineType1_)
+    return;
+
+  engineType1_ = type;
+  restageEngine1();
+  stageDualConvolver();
+}
+
+void IRProcessor::restageEngine1()
+{
+  ++engineGeneration_;
+  const bool loaded = ir1_ != nullptr;
+  auto stagingEngine = createEngine(engineType1_, loaded ? ir1_->impulse->GetLength() : 0);
+  const int latency = loaded ? stagingEngine->setSharedImpulse(*ir1_->impulse, ir1_->kernel) : 0;
+  if (loaded && latency >= 0)
+    warmEngine(*stagingEngine, costModelBlockSize_);
+  publishSlot(1, std::move(stagingEngine),
+              loaded && latency >= 0 && latency <= ConvolutionEngine::MaxLatencySamples, latency,
+              loaded ? static_cast<int>(ir1_->impulse->GetLength()) : 0);
+}
+
+void IRProcessor::setIRBEngine(ConvolutionEngineType type)
+{
+  std::lock_guard<std::mutex> lock(controlMutex_);
+  if (type == engineType2_)
+    return;
+
+  engineType2_ = type;
+  restageEngine2();
+  stageDualConvolver();
+}
+
+void IRProcessor::restageEngine2()
+{
+  ++engineGeneration_;
+  const bool loaded = ir2_ != nullptr;
+  auto stagingEngine = createEngine(engineType2_, loaded ? ir2_->impulse->GetLength() : 0);
+  const int latency = loaded ? stagingEngine->setSharedImpulse(*ir2_->impulse, ir2_->kernel) : 0;
+  if (loaded && latency >= 0)
+    warmEngine(*stagingEngine, costModelBlockSize_);
+  publishSlot(2, std::move(stagingEngine),
+              loaded && latency >= 0 && latency <= ConvolutionEngine::MaxLatencySamples, latency,
+              loaded ? static_cast<int>(ir2_->impulse->GetLength()) : 0);
+}
+
+std::unique_ptr<ConvolutionEngine> IRProcessor::createEngine(ConvolutionEngineType type,
+                                                             int irLength) const
+{
+  const bool largePartitions = renderMode_ && !zeroLatencyMode_;
+  if (type == ConvolutionEngineType::Auto)
+  {
+    const auto length = static_cast<size_t>(std::max(0, irLength));
+    const auto splitLength = static_cast<size_t>(PffftConvolutionEngine::BackgroundFirstPartition *
+                                                 PffftConvolutionEngine::DefaultBlockSize);
+    // Outside render mode Auto only picks zero-latency engines, whatever the zero-latency
+    // mode. Rendering trades a block of latency for large partitions, except for IRs
+    // short enough that the direct FIR is cheaper.
+    if (largePartitions)
+      type = costModel_.choose(length) == ConvolutionEngineType::Direct
+                 ? ConvolutionEngineType::Direct
+                 : ConvolutionEngineType::Pffft;
+    else if (backgroundTail_ && length > splitLength)
+      return ConvolutionEngine::create(ConvolutionEngineType::Pffft, true, true);
+    else
+      type = costModel_.choose(length);
+  }
+  if (largePartitions && type == ConvolutionEngineType::Pffft)
+    return std::unique_ptr<ConvolutionEngine>(
+        new PffftConvolutionEngine(PffftConvolutionEngine::RenderBlockSize));
+  return ConvolutionEngine::create(type, zeroLatencyMode_, backgroundTail_);
+}
+
+void IRProcessor::setZeroLatencyMode(bool enabled)
+{
+  std::lock_guard<std::mutex> lock(controlMutex_);
+  if (enabled == zeroLatencyMode_)
+    return;
+
+  zeroLatencyMode_ = enabled;
+  restageEngine1();
+  restageEngine2();
+}
+
+void IRProcessor::setBackgroundTailEnabled(bool enabled)
+{
+  std::lock_guard<std::mutex> lock(controlMutex_);
+  if (enabled == backgroundTail_)
+    return;
+
+  backgroundTail_ = enabled;
+  restageEngine1();
+  restageEngine2();
+  stageDualConvolver();
+}
+
+void IRProcessor::setRenderMode(bool enabled)
+{
+  std::lock_guard<std::mutex> lock(controlMutex_);
+  if (enabled == renderMode_)
+    return;
+
+  renderMode_ = enabled;
+  if (enabled)
+    renderWorker_.start();
+  parallelSlots_.store(enabled, std::memory_order_relaxed);
+  restageEngine1();
+  restageEngine2();
+}
+
+int IRProcessor::getTailLengthSamples() const
+{
+  return stagedTailSamples_.load(std::memory_order_relaxed);
+}
+
+int IRProcessor::getStagedLatencySamples() const
+{
+  std::lock_guard<std::mutex> lock(controlMutex_);
+  return std::max(0, std::max(stagedLatency1_, stagedLatency2_));
+}
+
+void IRProcessor::setIRCache(std::shared_ptr<const IRCache> cache)
+{
+  std::lock_guard<std::mutex> lock(controlMutex_);
+  irCache_ = std::move(cache);
+}
+
+void IRProcessor::setTailFloorDb(float floorDb)
+{
+  std::lock_guard<std::mutex> lock(controlMutex_);
+  tailFloorDb_ = std::min(floorDb, 0.0f);
+}
+
+float IRProcessor::getTailFloorDb() const
+{
+  std::lock_guard<std::mutex> lock(controlMutex_);
+  return tailFloorDb_;
+}
+
 void IRProcessor::setIRAEnabled(bool enabled)
 {
   irAEnabled_ = enabled;
@@ -409,8 +1018,18 @@ IRProcessor::BlendGains IRProcessor::resolveBlendGains(float inputLevelDb, Frame
   return gains;
 }
 
-void IRProcessor::processMono(const Sample* input, Sample* output, FrameCount numFrames)
+// All six public process calls run through here, specialized at compile time on the
+// channel layout and on whether the blend follows a sidechain. Mono layouts pass the
+// input as both inputL and inputR, and Mono ignores outputR.
+template <IRProcessor::ChannelLayout Layout, bool Sidechain>
+void IRProcessor::processBlock(const Sample* inputL, const Sample* inputR,
+                               const Sample* sidechainL, const Sample* sidechainR,
+                               Sample* outputL, Sample* outputR, FrameCount numFrames)
 {
+  constexpr int NumOutputs = Layout == ChannelLayout::Mono ? 1 : 2;
+  const Sample* const inputs[] = {inputL, inputR};
+  Sample* const outputs[] = {outputL, outputR};
+
   applyPendingIRUpdates();
 
   bool hasIR1 = ir1Loaded_.load(std::memory_order_relaxed) && irAEnabled_;
@@ -418,1154 +1037,458 @@ void IRProcessor::processMono(const Sample* input, Sample* output, FrameCount nu
 
   if (!hasIR1 && !hasIR2)
   {
-    std::copy(input, input + numFrames, output);
-    applyOutputGain(output, numFrames);
+    for (int c = 0; c < NumOutputs; ++c)
+    {
+      std::copy(inputs[c], inputs[c] + numFrames, outputs[c]);
+      applyOutputGain(outputs[c], numFrames);
+    }
+    previousGainLaw_ = 0;
+    previousPath_ = ProcessPath::Passthrough;
     return;
   }
 
-  currentInputLevelDb_ =
-      (detectionMode_ == 0) ? detectPeakLevel(input, numFrames) : detectRMSLevel(input, numFrames);
-
-  const BlendGains gains =
-      resolveBlendGains(currentInputLevelDb_, numFrames, !sidechainEnabled_, hasIR1, hasIR2);
-  const float gain1 = gains.gain1;
-  const float gain2 = gains.gain2;
+  const Sample* const levelL = Sidechain ? sidechainL : inputL;
+  const Sample* const levelR = Sidechain ? sidechainR : inputR;
+  if (Layout == ChannelLayout::Stereo)
+    currentInputLevelDb_ =
+        std::max(detectLevel(levelL, numFrames), detectLevel(levelR, numFrames));
+  else
+    currentInputLevelDb_ = detectLevel(levelL, numFrames);
+
+  const BlendGains gains = resolveBlendGains(
+      currentInputLevelDb_, numFrames, Sidechain ? sidechainEnabled_ : !sidechainEnabled_, hasIR1,
+      hasIR2);
+  // The blend moves from the previous block's gains to these across the block rather
+  // than stepping at the boundary. Loading, clearing or toggling a slot changes the gain
+  // law itself, and the new law starts steady.
+  const int gainLaw = (hasIR1 ? 1 : 0) | (hasIR2 ? 2 : 0) | (irAEnabled_ ? 4 : 0) |
+                      (irBEnabled_ ? 8 : 0);
+  const BlendGains previous = gainLaw == previousGainLaw_ ? previousGains_ : gains;
+  previousGains_ = gains;
+  previousGainLaw_ = gainLaw;
+
+  const bool dual = useDualConvolver(hasIR1, hasIR2);
+  if (dual)
+    switchPath(ProcessPath::Dual);
+  else if (hasIR1 && hasIR2)
+    switchPath(ProcessPath::Both);
+  else
+    switchPath(hasIR1 ? ProcessPath::OnlyA : ProcessPath::OnlyB);
 
-  // Feed mono input as stereo (duplicated to both channels) so that stereo IRs
-  // produce output from both L and R IR channels for downmixing. For mono IRs,
-  // WDL collapses identical channels internally — no extra cost.
-  WDL_FFT_REAL* inputPtr = const_cast<WDL_FFT_REAL*>(input);
-  std::array<WDL_FFT_REAL*, 2> stereoInput = {inputPtr, inputPtr};
+  if (skipSilentBlock(inputL, inputR, numFrames))
+  {
+    for (int c = 0; c < NumOutputs; ++c)
+      std::fill(outputs[c], outputs[c] + numFrames, 0.0f);
+    return;
+  }
 
-  if (hasIR1 && hasIR2)
+  if (dual)
   {
-    convolutionEngine1_->Add(stereoInput.data(), static_cast<int>(numFrames), 2);
-    convolutionEngine2_->Add(stereoInput.data(), static_cast<int>(numFrames), 2);
+    // The shared-spectrum engine ramps its kernel weights per sample like mixSlots(),
+    // with the trims and the output gain folded in.
+    const float scale1 = irATrimGainLinear_ * outputGainLinear_;
+    const float scale2 = irBTrimGainLinear_ * outputGainLinear_;
+    dualConvolver_->process(inputs, Layout == ChannelLayout::Stereo ? 2 : 1, outputs, NumOutputs,
+                            numFrames, previous.gain1 * scale1, gains.gain1 * scale1,
+                            previous.gain2 * scale2, gains.gain2 * scale2);
+  }
+  else if (hasIR1 && hasIR2)
+    mixSlots<Layout, SlotConfig::Both>(inputs, outputs, numFrames, previous, gains);
+  else if (hasIR1)
+    mixSlots<Layout, SlotConfig::OnlyA>(inputs, outputs, numFrames, previous, gains);
+  else
+    mixSlots<Layout, SlotConfig::OnlyB>(inputs, outputs, numFrames, previous, gains);
+}
 
-    int available1 = convolutionEngine1_->Avail(static_cast<int>(numFrames));
-    int available2 = convolutionEngine2_->Avail(static_cast<int>(numFrames));
+// Convolves one block through the slots in use and mixes them, or the one slot and the
+// dry signal, into the outputs. Latency differences are aligned through the delay lines,
+// which are mixed from in place; trims and the output gain are folded into the blend
+// ramps.
+template <IRProcessor::ChannelLayout Layout, IRProcessor::SlotConfig Slots>
+void IRProcessor::mixSlots(const Sample* const* inputs, Sample* const* outputs,
+                           FrameCount numFrames, const BlendGains& from, const BlendGains& to)
+{
+  constexpr int NumOutputs = Layout == ChannelLayout::Mono ? 1 : 2;
+  constexpr bool UsesA = Slots != SlotConfig::OnlyB;
+  constexpr bool UsesB = Slots != SlotConfig::OnlyA;
+  const int frames = static_cast<int>(numFrames);
+
+  if (Slots != SlotConfig::Both && alignedLatency_ > 0)
+    for (int c = 0; c < NumOutputs; ++c)
+      dryDelay_[c].write(inputs[c], numFrames);
+
+  // Mono input goes to both engine channels so that stereo IRs produce output from both
+  // IR channels for downmixing. For mono IRs the engines collapse identical channels
+  // internally at no extra cost.
+  if (Slots == SlotConfig::Both)
+    addToBothEngines(inputs, numFrames);
+  else
+    (UsesA ? convolutionEngine1_ : convolutionEngine2_)->add(inputs, frames, 2);
 
-    if (available1 >= static_cast<int>(numFrames) && available2 >= static_cast<int>(numFrames))
-    {
-      WDL_FFT_REAL** output1Ptr = convolutionEngine1_->Get();
-      WDL_FFT_REAL** output2Ptr = convolutionEngine2_->Get();
-
-      // Downmix stereo convolution output to mono in-place. When L and R point
-      // to the same buffer (mono IR collapsed by WDL), the check skips the loop.
-      if (output1Ptr[0] != output1Ptr[1])
-        for (FrameCount i = 0; i < numFrames; ++i)
-          output1Ptr[0][i] = (output1Ptr[0][i] + output1Ptr[1][i]) * 0.5f;
-      if (output2Ptr[0] != output2Ptr[1])
-        for (FrameCount i = 0; i < numFrames; ++i)
-          output2Ptr[0][i] = (output2Ptr[0][i] + output2Ptr[1][i]) * 0.5f;
-
-      const int latencyDiff = latencySamples1_ - latencySamples2_;
-
-      if (latencyDiff > 0)
-      {
-        writeToDelayBuffer(ir1DelayBufferL_, ir1DelayWritePosL_, output1Ptr[0], numFrames);
-        readFromDelayBuffer(ir1DelayBufferL_, ir1DelayWritePosL_, scratchL_.data(), numFrames,
-                            latencyDiff);
-
-        for (FrameCount i = 0; i < numFrames; ++i)
-        {
-          output[i] = gain1 * irATrimGainLinear_ * scratchL_[i] +
-                      gain2 * irBTrimGainLinear_ * output2Ptr[0][i];
-        }
-      }
-      else if (latencyDiff < 0)
-      {
-        writeToDelayBuffer(ir2DelayBufferL_, ir2DelayWritePosL_, output2Ptr[0], numFrames);
-        readFromDelayBuffer(ir2DelayBufferL_, ir2DelayWritePosL_, scratchL_.data(), numFrames,
-                            -latencyDiff);
-
-        for (FrameCount i = 0; i < numFrames; ++i)
-        {
-          output[i] = gain1 * irATrimGainLinear_ * output1Ptr[0][i] +
-                      gain2 * irBTrimGainLinear_ * scratchL_[i];
-        }
-      }
-      else
-      {
-        for (FrameCount i = 0; i < numFrames; ++i)
-        {
-          output[i] = gain1 * irATrimGainLinear_ * output1Ptr[0][i] +
-                      gain2 * irBTrimGainLinear_ * output2Ptr[0][i];
-        }
-      }
-
-      convolutionEngine1_->Advance(static_cast<int>(numFrames));
-      convolutionEngine2_->Advance(static_cast<int>(numFrames));
-    }
-    else
-    {
-      std::fill(output, output + numFrames, 0.0f);
-    }
-  }
-  else if (hasIR1)
-  {
-    writeToDelayBuffer(dryDelayBufferL_, dryDelayWritePosL_, input, numFrames);
-
-    convolutionEngine1_->Add(stereoInput.data(), static_cast<int>(numFrames), 2);
-
-    int available = convolutionEngine1_->Avail(static_cast<int>(numFrames));
-    if (available >= static_cast<int>(numFrames))
-    {
-      WDL_FFT_REAL** outputPtr = convolutionEngine1_->Get();
-
-      if (outputPtr[0] != outputPtr[1])
-        for (FrameCount i = 0; i < numFrames; ++i)
-          outputPtr[0][i] = (outputPtr[0][i] + outputPtr[1][i]) * 0.5f;
-
-      if (latencySamples1_ > 0)
-        readFromDelayBuffer(dryDelayBufferL_, dryDelayWritePosL_, scratchL_.data(), numFrames,
-                            latencySamples1_);
-      else
-        std::copy(input, input + numFrames, scratchL_.data());
-
-      for (FrameCount i = 0; i < numFrames; ++i)
-      {
-        output[i] = gain1 * irATrimGainLinear_ * outputPtr[0][i] + gain2 * scratchL_[i];
-      }
-      convolutionEngine1_->Advance(static_cast<int>(numFrames));
-    }
-    else
-    {
-      std::fill(output, output + numFrames, 0.0f);
-    }
-  }
-  else
-  {
-    writeToDelayBuffer(dryDelayBufferL_, dryDelayWritePosL_, input, numFrames);
-
-    convolutionEngine2_->Add(stereoInput.data(), static_cast<int>(numFrames), 2);
-
-    int available = convolutionEngine2_->Avail(static_cast<int>(numFrames));
-    if (available >= static_cast<int>(numFrames))
-    {
-      WDL_FFT_REAL** outputPtr = convolutionEngine2_->Get();
-
-      if (outputPtr[0] != outputPtr[1])
-        for (FrameCount i = 0; i < numFrames; ++i)
-          outputPtr[0][i] = (outputPtr[0][i] + outputPtr[1][i]) * 0.5f;
-
-      if (latencySamples2_ > 0)
-        readFromDelayBuffer(dryDelayBufferL_, dryDelayWritePosL_, scratchL_.data(), numFrames,
-                            latencySamples2_);
-      else
-        std::copy(input, input + numFrames, scratchL_.data());
-
-      for (FrameCount i = 0; i < numFrames; ++i)
-      {
-        output[i] = gain1 * scratchL_[i] + gain2 * irBTrimGainLinear_ * outputPtr[0][i];
-      }
-      convolutionEngine2_->Advance(static_cast<int>(numFrames));
-    }
-    else
-    {
-      std::fill(output, output + numFrames, 0.0f);
-    }
-  }
-
-  applyOutputGain(output, numFrames);
-}
-
-void IRProcessor::applyPendingIRUpdates()
-{
-  bool delayBuffersNeedUpdate = false;
-
-  if (ir1Pending_.load(std::memory_order_acquire))
-  {
-    std::unique_lock<std::mutex> lock(pendingMutex1_, std::try_to_lock);
-    if (lock.owns_lock())
-    {
-      std::swap(convolutionEngine1_, stagingEngine1_);
-      ir1Loaded_.store(stagingLoaded1_, std::memory_order_relaxed);
-      latencySamples1_ = stagingLatency1_;
-      ir1Pending_.store(false, std::memory_order_relaxed);
-      delayBuffersNeedUpdate = true;
-    }
-  }
-
-  if (ir2Pending_.load(std::memory_order_acquire))
-  {
-    std::unique_lock<std::mutex> lock(pendingMutex2_, std::try_to_lock);
-    if (lock.owns_lock())
-    {
-      std::swap(convolutionEngine2_, stagingEngine2_);
-      ir2Loaded_.store(stagingLoaded2_, std::memory_order_relaxed);
-      latencySamples2_ = stagingLatency2_;
-      ir2Pending_.store(false, std::memory_order_relaxed);
-      delayBuffersNeedUpdate = true;
-    }
-  }
-
-  if (delayBuffersNeedUpdate)
-  {
-    updateDelayBuffers();
-  }
-}
-
-void IRProcessor::swapIRSlots()
-{
-  std::lock(pendingMutex1_, pendingMutex2_);
-  std::lock_guard<std::mutex> lock1(pendingMutex1_, std::adopt_lock);
-  std::lock_guard<std::mutex> lock2(pendingMutex2_, std::adopt_lock);
-
-  std::swap(impulseBuffer1_, impulseBuffer2_);
-  std::swap(convolutionEngine1_, convolutionEngine2_);
-  std::swap(irLoader1_, irLoader2_);
-  std::swap(currentIR1Path_, currentIR2Path_);
-  std::swap(latencySamples1_, latencySamples2_);
-
-  std::swap(stagingEngine1_, stagingEngine2_);
-  std::swap(stagingLoaded1_, stagingLoaded2_);
-  std::swap(stagingLatency1_, stagingLatency2_);
-
-  bool loaded1 = ir1Loaded_.load(std::memory_order_relaxed);
-  bool loaded2 = ir2Loaded_.load(std::memory_order_relaxed);
-  ir1Loaded_.store(loaded2, std::memory_order_relaxed);
-  ir2Loaded_.store(loaded1, std::memory_order_relaxed);
-
-  bool pending1 = ir1Pending_.load(std::memory_order_relaxed);
-  bool pending2 = ir2Pending_.load(std::memory_order_relaxed);
-  ir1Pending_.store(pending2, std::memory_order_relaxed);
-  ir2Pending_.store(pending1, std::memory_order_relaxed);
-
-  std::swap(ir1DelayBufferL_, ir2DelayBufferL_);
-  std::swap(ir1DelayBufferR_, ir2DelayBufferR_);
-  std::swap(ir1DelayWritePosL_, ir2DelayWritePosL_);
-  std::swap(ir1DelayWritePosR_, ir2DelayWritePosR_);
-}
-
-void IRProcessor::reset()
-{
-  if (convolutionEngine1_)
-  {
-    convolutionEngine1_->Reset();
-  }
-  if (convolutionEngine2_)
-  {
-    convolutionEngine2_->Reset();
-  }
-}
-
-SampleRate IRProcessor::getIR1SampleRate() const
-{
-  return irLoader1_ ? irLoader1_->getIRSampleRate() : 0.0;
-}
-
-SampleRate IRProcessor::getIR2SampleRate() const
-{
-  return irLoader2_ ? irLoader2_->getIRSampleRate() : 0.0;
-}
-
-size_t IRProcessor::getIR1NumSamples() const
-{
-  return irLoader1_ ? irLoader1_->getNumSamples() : 0;
-}
-
-size_t IRProcessor::getIR2NumSamples() const
-{
-  return irLoader2_ ? irLoader2_->getNumSamples() : 0;
-}
-
-int IRProcessor::getNumIR1Channels() const
-{
-  return irLoader1_ ? irLoader1_->getNumChannels() : 0;
-}
-
-int IRProcessor::getNumIR2Channels() const
-{
-  return irLoader2_ ? irLoader2_->getNumChannels() : 0;
-}
-
-int IRProcessor::getLatencySamples() const
-{
-  return maxLatencySamples_.load();
-}
-
-void IRProcessor::processStereo(const Sample* inputL, const Sample* inputR, Sample* outputL,
-                                Sample* outputR, FrameCount numFrames)
-{
-  applyPendingIRUpdates();
-
-  bool hasIR1 = ir1Loaded_.load(std::memory_order_relaxed) && irAEnabled_;
-  bool hasIR2 = ir2Loaded_.load(std::memory_order_relaxed) && irBEnabled_;
-
-  if (!hasIR1 && !hasIR2)
-  {
-    std::copy(inputL, inputL + numFrames, outputL);
-    std::copy(inputR, inputR + numFrames, outputR);
-    applyOutputGain(outputL, numFrames);
-    applyOutputGain(outputR, numFrames);
-    return;
-  }
-
-  {
-    float levelL = (detectionMode_ == 0) ? detectPeakLevel(inputL, numFrames)
-                                         : detectRMSLevel(inputL, numFrames);
-    float levelR = (detectionMode_ == 0) ? detectPeakLevel(inputR, numFrames)
-                                         : detectRMSLevel(inputR, numFrames);
-    currentInputLevelDb_ = std::max(levelL, levelR);
-  }
-
-  const BlendGains gains =
-      resolveBlendGains(currentInputLevelDb_, numFrames, !sidechainEnabled_, hasIR1, hasIR2);
-  const float gain1 = gains.gain1;
-  const float gain2 = gains.gain2;
-
-  std::array<WDL_FFT_REAL*, 2> inputPtrs = {const_cast<WDL_FFT_REAL*>(inputL),
-                                            const_cast<WDL_FFT_REAL*>(inputR)};
-
-  if (hasIR1 && hasIR2)
-  {
-    convolutionEngine1_->Add(inputPtrs.data(), static_cast<int>(numFrames), 2);
-    convolutionEngine2_->Add(inputPtrs.data(), static_cast<int>(numFrames), 2);
-
-    int available1 = convolutionEngine1_->Avail(static_cast<int>(numFrames));
-    int available2 = convolutionEngine2_->Avail(static_cast<int>(numFrames));
-
-    if (available1 >= static_cast<int>(numFrames) && available2 >= static_cast<int>(numFrames))
-    {
-      WDL_FFT_REAL** output1Ptr = convolutionEngine1_->Get();
-      WDL_FFT_REAL** output2Ptr = convolutionEngine2_->Get();
-
-      const int latencyDiff = latencySamples1_ - latencySamples2_;
-
-      if (latencyDiff > 0)
-      {
-        writeToDelayBuffer(ir1DelayBufferL_, ir1DelayWritePosL_, output1Ptr[0], numFrames);
-        writeToDelayBuffer(ir1DelayBufferR_, ir1DelayWritePosR_, output1Ptr[1], numFrames);
-        readFromDelayBuffer(ir1DelayBufferL_, ir1DelayWritePosL_, scratchL_.data(), numFrames,
-                            latencyDiff);
-        readFromDelayBuffer(ir1DelayBufferR_, ir1DelayWritePosR_, scratchR_.data(), numFrames,
-                            latencyDiff);
-
-        for (FrameCount i = 0; i < numFrames; ++i)
-        {
-          outputL[i] = gain1 * irATrimGainLinear_ * scratchL_[i] +
-                       gain2 * irBTrimGainLinear_ * output2Ptr[0][i];
-          outputR[i] = gain1 * irATrimGainLinear_ * scratchR_[i] +
-                       gain2 * irBTrimGainLinear_ * output2Ptr[1][i];
-        }
-      }
-      else if (latencyDiff < 0)
-      {
-        writeToDelayBuffer(ir2DelayBufferL_, ir2DelayWritePosL_, output2Ptr[0], numFrames);
-        writeToDelayBuffer(ir2DelayBufferR_, ir2DelayWritePosR_, output2Ptr[1], numFrames);
-        readFromDelayBuffer(ir2DelayBufferL_, ir2DelayWritePosL_, scratchL_.data(), numFrames,
-                            -latencyDiff);
-        readFromDelayBuffer(ir2DelayBufferR_, ir2DelayWritePosR_, scratchR_.data(), numFrames,
-                            -latencyDiff);
-
-        for (FrameCount i = 0; i < numFrames; ++i)
-        {
-          outputL[i] = gain1 * irATrimGainLinear_ * output1Ptr[0][i] +
-                       gain2 * irBTrimGainLinear_ * scratchL_[i];
-          outputR[i] = gain1 * irATrimGainLinear_ * output1Ptr[1][i] +
-                       gain2 * irBTrimGainLinear_ * scratchR_[i];
-        }
-      }
-      else
-      {
-        for (FrameCount i = 0; i < numFrames; ++i)
-        {
-          outputL[i] = gain1 * irATrimGainLinear_ * output1Ptr[0][i] +
-                       gain2 * irBTrimGainLinear_ * output2Ptr[0][i];
-          outputR[i] = gain1 * irATrimGainLinear_ * output1Ptr[1][i] +
-                       gain2 * irBTrimGainLinear_ * output2Ptr[1][i];
-        }
-      }
-
-      convolutionEngine1_->Advance(static_cast<int>(numFrames));
-      convolutionEngine2_->Advance(static_cast<int>(numFrames));
-    }
-    else
-    {
-      std::fill(outputL, outputL + numFrames, 0.0f);
-      std::fill(outputR, outputR + numFrames, 0.0f);
-    }
-  }
-  else if (hasIR1)
-  {
-    writeToDelayBuffer(dryDelayBufferL_, dryDelayWritePosL_, inputL, numFrames);
-    writeToDelayBuffer(dryDelayBufferR_, dryDelayWritePosR_, inputR, numFrames);
-
-    convolutionEngine1_->Add(inputPtrs.data(), static_cast<int>(numFrames), 2);
-
-    int available = convolutionEngine1_->Avail(static_cast<int>(numFrames));
-    if (available >= static_cast<int>(numFrames))
-    {
-      WDL_FFT_REAL** outputPtr = convolutionEngine1_->Get();
-
-      if (latencySamples1_ > 0)
-      {
-        readFromDelayBuffer(dryDelayBufferL_, dryDelayWritePosL_, scratchL_.data(), numFrames,
-                            latencySamples1_);
-        readFromDelayBuffer(dryDelayBufferR_, dryDelayWritePosR_, scratchR_.data(), numFrames,
-                            latencySamples1_);
-      }
-      else
-      {
-        std::copy(inputL, inputL + numFrames, scratchL_.data());
-        std::copy(inputR, inputR + numFrames, scratchR_.data());
-      }
-
-      for (FrameCount i = 0; i < numFrames; ++i)
-      {
-        outputL[i] = gain1 * irATrimGainLinear_ * outputPtr[0][i] + gain2 * scratchL_[i];
-        outputR[i] = gain1 * irATrimGainLinear_ * outputPtr[1][i] + gain2 * scratchR_[i];
-      }
-      convolutionEngine1_->Advance(static_cast<int>(numFrames));
-    }
-    else
-    {
-      std::fill(outputL, outputL + numFrames, 0.0f);
-      std::fill(outputR, outputR + numFrames, 0.0f);
-    }
-  }
-  else
-  {
-    writeToDelayBuffer(dryDelayBufferL_, dryDelayWritePosL_, inputL, numFrames);
-    writeToDelayBuffer(dryDelayBufferR_, dryDelayWritePosR_, inputR, numFrames);
-
-    convolutionEngine2_->Add(inputPtrs.data(), static_cast<int>(numFrames), 2);
-
-    int available = convolutionEngine2_->Avail(static_cast<int>(numFrames));
-    if (available >= static_cast<int>(numFrames))
-    {
-      WDL_FFT_REAL** outputPtr = convolutionEngine2_->Get();
-
-      if (latencySamples2_ > 0)
-      {
-        readFromDelayBuffer(dryDelayBufferL_, dryDelayWritePosL_, scratchL_.data(), numFrames,
-                            latencySamples2_);
-        readFromDelayBuffer(dryDelayBufferR_, dryDelayWritePosR_, scratchR_.data(), numFrames,
-                            latencySamples2_);
-      }
-      else
-      {
-        std::copy(inputL, inputL + numFrames, scratchL_.data());
-        std::copy(inputR, inputR + numFrames, scratchR_.data());
-      }
-
-      for (FrameCount i = 0; i < numFrames; ++i)
-      {
-        outputL[i] = gain1 * scratchL_[i] + gain2 * irBTrimGainLinear_ * outputPtr[0][i];
-        outputR[i] = gain1 * scratchR_[i] + gain2 * irBTrimGainLinear_ * outputPtr[1][i];
-      }
-      convolutionEngine2_->Advance(static_cast<int>(numFrames));
-    }
-    else
-    {
-      std::fill(outputL, outputL + numFrames, 0.0f);
-      std::fill(outputR, outputR + numFrames, 0.0f);
-    }
-  }
-
-  applyOutputGain(outputL, numFrames);
-  applyOutputGain(outputR, numFrames);
-}
-
-void IRProcessor::processMonoToStereo(const Sample* input, Sample* outputL, Sample* outputR,
-                                      FrameCount numFrames)
-{
-  applyPendingIRUpdates();
-
-  bool hasIR1 = ir1Loaded_.load(std::memory_order_relaxed) && irAEnabled_;
-  bool hasIR2 = ir2Loaded_.load(std::memory_order_relaxed) && irBEnabled_;
-
-  if (!hasIR1 && !hasIR2)
-  {
-    std::copy(input, input + numFrames, outputL);
-    std::copy(input, input + numFrames, outputR);
-    applyOutputGain(outputL, numFrames);
-    applyOutputGain(outputR, numFrames);
-    return;
-  }
-
-  currentInputLevelDb_ =
-      (detectionMode_ == 0) ? detectPeakLevel(input, numFrames) : detectRMSLevel(input, numFrames);
-
-  const BlendGains gains =
-      resolveBlendGains(currentInputLevelDb_, numFrames, !sidechainEnabled_, hasIR1, hasIR2);
-  const float gain1 = gains.gain1;
-  const float gain2 = gains.gain2;
-
-  WDL_FFT_REAL* inputPtr = const_cast<WDL_FFT_REAL*>(input);
-  std::array<WDL_FFT_REAL*, 2> stereoInput = {inputPtr, inputPtr};
-
-  if (hasIR1 && hasIR2)
-  {
-    convolutionEngine1_->Add(stereoInput.data(), static_cast<int>(numFrames), 2);
-    convolutionEngine2_->Add(stereoInput.data(), static_cast<int>(numFrames), 2);
-
-    int available1 = convolutionEngine1_->Avail(static_cast<int>(numFrames));
-    int available2 = convolutionEngine2_->Avail(static_cast<int>(numFrames));
-
-    if (available1 >= static_cast<int>(numFrames) && available2 >= static_cast<int>(numFrames))
-    {
-      WDL_FFT_REAL** output1Ptr = convolutionEngine1_->Get();
-      WDL_FFT_REAL** output2Ptr = convolutionEngine2_->Get();
-
-      const int latencyDiff = latencySamples1_ - latencySamples2_;
-
-      if (latencyDiff > 0)
-      {
-        writeToDelayBuffer(ir1DelayBufferL_, ir1DelayWritePosL_, output1Ptr[0], numFrames);
-        writeToDelayBuffer(ir1DelayBufferR_, ir1DelayWritePosR_, output1Ptr[1], numFrames);
-        readFromDelayBuffer(ir1DelayBufferL_, ir1DelayWritePosL_, scratchL_.data(), numFrames,
-                            latencyDiff);
-        readFromDelayBuffer(ir1DelayBufferR_, ir1DelayWritePosR_, scratchR_.data(), numFrames,
-                            latencyDiff);
-
-        for (FrameCount i = 0; i < numFrames; ++i)
-        {
-          outputL[i] = gain1 * irATrimGainLinear_ * scratchL_[i] +
-                       gain2 * irBTrimGainLinear_ * output2Ptr[0][i];
-          outputR[i] = gain1 * irATrimGainLinear_ * scratchR_[i] +
-                       gain2 * irBTrimGainLinear_ * output2Ptr[1][i];
-        }
-      }
-      else if (latencyDiff < 0)
-      {
-        writeToDelayBuffer(ir2DelayBufferL_, ir2DelayWritePosL_, output2Ptr[0], numFrames);
-        writeToDelayBuffer(ir2DelayBufferR_, ir2DelayWritePosR_, output2Ptr[1], numFrames);
-        readFromDelayBuffer(ir2DelayBufferL_, ir2DelayWritePosL_, scratchL_.data(), numFrames,
-                            -latencyDiff);
-        readFromDelayBuffer(ir2DelayBufferR_, ir2DelayWritePosR_, scratchR_.data(), numFrames,
-                            -latencyDiff);
-
-        for (FrameCount i = 0; i < numFrames; ++i)
-        {
-          outputL[i] = gain1 * irATrimGainLinear_ * output1Ptr[0][i] +
-                       gain2 * irBTrimGainLinear_ * scratchL_[i];
-          outputR[i] = gain1 * irATrimGainLinear_ * output1Ptr[1][i] +
-                       gain2 * irBTrimGainLinear_ * scratchR_[i];
-        }
-      }
-      else
-      {
-        for (FrameCount i = 0; i < numFrames; ++i)
-        {
-          outputL[i] = gain1 * irATrimGainLinear_ * output1Ptr[0][i] +
-                       gain2 * irBTrimGainLinear_ * output2Ptr[0][i];
-          outputR[i] = gain1 * irATrimGainLinear_ * output1Ptr[1][i] +
-                       gain2 * irBTrimGainLinear_ * output2Ptr[1][i];
-        }
-      }
-
-      convolutionEngine1_->Advance(static_cast<int>(numFrames));
-      convolutionEngine2_->Advance(static_cast<int>(numFrames));
-    }
-    else
-    {
-      std::fill(outputL, outputL + numFrames, 0.0f);
-      std::fill(outputR, outputR + numFrames, 0.0f);
-    }
-  }
-  else if (hasIR1)
-  {
-    writeToDelayBuffer(dryDelayBufferL_, dryDelayWritePosL_, input, numFrames);
-    writeToDelayBuffer(dryDelayBufferR_, dryDelayWritePosR_, input, numFrames);
-
-    convolutionEngine1_->Add(stereoInput.data(), static_cast<int>(numFrames), 2);
-
-    int available = convolutionEngine1_->Avail(static_cast<int>(numFrames));
-    if (available >= static_cast<int>(numFrames))
-    {
-      WDL_FFT_REAL** outputPtr = convolutionEngine1_->Get();
-
-      if (latencySamples1_ > 0)
-      {
-        readFromDelayBuffer(dryDelayBufferL_, dryDelayWritePosL_, scratchL_.data(), numFrames,
-                            latencySamples1_);
-        readFromDelayBuffer(dryDelayBufferR_, dryDelayWritePosR_, scratchR_.data(), numFrames,
-                            latencySamples1_);
-      }
-      else
-      {
-        std::copy(input, input + numFrames, scratchL_.data());
-        std::copy(input, input + numFrames, scratchR_.data());
-      }
-
-      for (FrameCount i = 0; i < numFrames; ++i)
-      {
-        outputL[i] = gain1 * irATrimGainLinear_ * outputPtr[0][i] + gain2 * scratchL_[i];
-        outputR[i] = gain1 * irATrimGainLinear_ * outputPtr[1][i] + gain2 * scratchR_[i];
-      }
-      convolutionEngine1_->Advance(static_cast<int>(numFrames));
-    }
-    else
-    {
-      std::fill(outputL, outputL + numFrames, 0.0f);
-      std::fill(outputR, outputR + numFrames, 0.0f);
-    }
-  }
-  else
-  {
-    writeToDelayBuffer(dryDelayBufferL_, dryDelayWritePosL_, input, numFrames);
-    writeToDelayBuffer(dryDelayBufferR_, dryDelayWritePosR_, input, numFrames);
-
-    convolutionEngine2_->Add(stereoInput.data(), static_cast<int>(numFrames), 2);
-
-    int available = convolutionEngine2_->Avail(static_cast<int>(numFrames));
-    if (available >= static_cast<int>(numFrames))
-    {
-      WDL_FFT_REAL** outputPtr = convolutionEngine2_->Get();
-
-      if (latencySamples2_ > 0)
-      {
-        readFromDelayBuffer(dryDelayBufferL_, dryDelayWritePosL_, scratchL_.data(), numFrames,
-                            latencySamples2_);
-        readFromDelayBuffer(dryDelayBufferR_, dryDelayWritePosR_, scratchR_.data(), numFrames,
-                            latencySamples2_);
-      }
-      else
-      {
-        std::copy(input, input + numFrames, scratchL_.data());
-        std::copy(input, input + numFrames, scratchR_.data());
-      }
-
-      for (FrameCount i = 0; i < numFrames; ++i)
-      {
-        outputL[i] = gain1 * scratchL_[i] + gain2 * irBTrimGainLinear_ * outputPtr[0][i];
-        outputR[i] = gain1 * scratchR_[i] + gain2 * irBTrimGainLinear_ * outputPtr[1][i];
-      }
-      convolutionEngine2_->Advance(static_cast<int>(numFrames));
-    }
-    else
-    {
-      std::fill(outputL, outputL + numFrames, 0.0f);
-      std::fill(outputR, outputR + numFrames, 0.0f);
-    }
-  }
-
-  applyOutputGain(outputL, numFrames);
-  applyOutputGain(outputR, numFrames);
-}
-
-void IRProcessor::processMonoWithSidechain(const Sample* input, const Sample* sidechain,
-                                           Sample* output, FrameCount numFrames)
-{
-  applyPendingIRUpdates();
-
-  bool hasIR1 = ir1Loaded_.load(std::memory_order_relaxed) && irAEnabled_;
-  bool hasIR2 = ir2Loaded_.load(std::memory_order_relaxed) && irBEnabled_;
-
-  if (!hasIR1 && !hasIR2)
-  {
-    std::copy(input, input + numFrames, output);
-    applyOutputGain(output, numFrames);
-    return;
-  }
-
-  currentInputLevelDb_ = (detectionMode_ == 0) ? detectPeakLevel(sidechain, numFrames)
-                                               : detectRMSLevel(sidechain, numFrames);
-
-  const BlendGains gains =
-      resolveBlendGains(currentInputLevelDb_, numFrames, sidechainEnabled_, hasIR1, hasIR2);
-  const float gain1 = gains.gain1;
-  const float gain2 = gains.gain2;
-
-  WDL_FFT_REAL* inputPtr = const_cast<WDL_FFT_REAL*>(input);
-  std::array<WDL_FFT_REAL*, 2> stereoInput = {inputPtr, inputPtr};
-
-  if (hasIR1 && hasIR2)
-  {
-    convolutionEngine1_->Add(stereoInput.data(), static_cast<int>(numFrames), 2);
-    convolutionEngine2_->Add(stereoInput.data(), static_cast<int>(numFrames), 2);
-
-    int available1 = convolutionEngine1_->Avail(static_cast<int>(numFrames));
-    int available2 = convolutionEngine2_->Avail(static_cast<int>(numFrames));
-
-    if (available1 >= static_cast<int>(numFrames) && available2 >= static_cast<int>(numFrames))
-    {
-      WDL_FFT_REAL** output1Ptr = convolutionEngine1_->Get();
-      WDL_FFT_REAL** output2Ptr = convolutionEngine2_->Get();
-
-      if (output1Ptr[0] != output1Ptr[1])
-        for (FrameCount i = 0; i < numFrames; ++i)
-          output1Ptr[0][i] = (output1Ptr[0][i] + output1Ptr[1][i]) * 0.5f;
-      if (output2Ptr[0] != output2Ptr[1])
-        for (FrameCount i = 0; i < numFrames; ++i)
-          output2Ptr[0][i] = (output2Ptr[0][i] + output2Ptr[1][i]) * 0.5f;
-
-      const int latencyDiff = latencySamples1_ - latencySamples2_;
-
-      if (latencyDiff > 0)
-      {
-        writeToDelayBuffer(ir1DelayBufferL_, ir1DelayWritePosL_, output1Ptr[0], numFrames);
-        readFromDelayBuffer(ir1DelayBufferL_, ir1DelayWritePosL_, scratchL_.data(), numFrames,
-                            latencyDiff);
-
-        for (FrameCount i = 0; i < numFrames; ++i)
-        {
-          output[i] = gain1 * irATrimGainLinear_ * scratchL_[i] +
-                      gain2 * irBTrimGainLinear_ * output2Ptr[0][i];
-        }
-      }
-      else if (latencyDiff < 0)
-      {
-        writeToDelayBuffer(ir2DelayBufferL_, ir2DelayWritePosL_, output2Ptr[0], numFrames);
-        readFromDelayBuffer(ir2DelayBufferL_, ir2DelayWritePosL_, scratchL_.data(), numFrames,
-                            -latencyDiff);
-
-        for (FrameCount i = 0; i < numFrames; ++i)
-        {
-          output[i] = gain1 * irATrimGainLinear_ * output1Ptr[0][i] +
-                      gain2 * irBTrimGainLinear_ * scratchL_[i];
-        }
-      }
-      else
-      {
-        for (FrameCount i = 0; i < numFrames; ++i)
-        {
-          output[i] = gain1 * irATrimGainLinear_ * output1Ptr[0][i] +
-                      gain2 * irBTrimGainLinear_ * output2Ptr[0][i];
-        }
-      }
-
-      convolutionEngine1_->Advance(static_cast<int>(numFrames));
-      convolutionEngine2_->Advance(static_cast<int>(numFrames));
-    }
-    else
-    {
-      std::fill(output, output + numFrames, 0.0f);
-    }
-  }
-  else if (hasIR1)
-  {
-    writeToDelayBuffer(dryDelayBufferL_, dryDelayWritePosL_, input, numFrames);
-
-    convolutionEngine1_->Add(stereoInput.data(), static_cast<int>(numFrames), 2);
-
-    int available = convolutionEngine1_->Avail(static_cast<int>(numFrames));
-    if (available >= static_cast<int>(numFrames))
-    {
-      WDL_FFT_REAL** outputPtr = convolutionEngine1_->Get();
-
-      if (outputPtr[0] != outputPtr[1])
-        for (FrameCount i = 0; i < numFrames; ++i)
-          outputPtr[0][i] = (outputPtr[0][i] + outputPtr[1][i]) * 0.5f;
-
-      if (latencySamples1_ > 0)
-        readFromDelayBuffer(dryDelayBufferL_, dryDelayWritePosL_, scratchL_.data(), numFrames,
-                            latencySamples1_);
-      else
-        std::copy(input, input + numFrames, scratchL_.data());
-
-      for (FrameCount i = 0; i < numFrames; ++i)
-      {
-        output[i] = gain1 * irATrimGainLinear_ * outputPtr[0][i] + gain2 * scratchL_[i];
-      }
-      convolutionEngine1_->Advance(static_cast<int>(numFrames));
-    }
-    else
-    {
-      std::fill(output, output + numFrames, 0.0f);
-    }
-  }
-  else
-  {
-    writeToDelayBuffer(dryDelayBufferL_, dryDelayWritePosL_, input, numFrames);
-
-    convolutionEngine2_->Add(stereoInput.data(), static_cast<int>(numFrames), 2);
-
-    int available = convolutionEngine2_->Avail(static_cast<int>(numFrames));
-    if (available >= static_cast<int>(numFrames))
-    {
-      WDL_FFT_REAL** outputPtr = convolutionEngine2_->Get();
-
-      if (outputPtr[0] != outputPtr[1])
-        for (FrameCount i = 0; i < numFrames; ++i)
-          outputPtr[0][i] = (outputPtr[0][i] + outputPtr[1][i]) * 0.5f;
-
-      if (latencySamples2_ > 0)
-        readFromDelayBuffer(dryDelayBufferL_, dryDelayWritePosL_, scratchL_.data(), numFrames,
-                            latencySamples2_);
-      else
-        std::copy(input, input + numFrames, scratchL_.data());
-
-      for (FrameCount i = 0; i < numFrames; ++i)
-      {
-        output[i] = gain1 * scratchL_[i] + gain2 * irBTrimGainLinear_ * outputPtr[0][i];
-      }
-      convolutionEngine2_->Advance(static_cast<int>(numFrames));
-    }
-    else
-    {
-      std::fill(output, output + numFrames, 0.0f);
-    }
-  }
-
-  applyOutputGain(output, numFrames);
-}
-
-void IRProcessor::processMonoToStereoWithSidechain(const Sample* input, const Sample* sidechain,
-                                                   Sample* outputL, Sample* outputR,
-                                                   FrameCount numFrames)
-{
-  applyPendingIRUpdates();
-
-  bool hasIR1 = ir1Loaded_.load(std::memory_order_relaxed) && irAEnabled_;
-  bool hasIR2 = ir2Loaded_.load(std::memory_order_relaxed) && irBEnabled_;
-
-  if (!hasIR1 && !hasIR2)
+  if ((UsesA && convolutionEngine1_->avail(frames) < frames) ||
+      (UsesB && convolutionEngine2_->avail(frames) < frames))
   {
-    std::copy(input, input + numFrames, outputL);
-    std::copy(input, input + numFrames, outputR);
-    applyOutputGain(outputL, numFrames);
-    applyOutputGain(outputR, numFrames);
+    for (int c = 0; c < NumOutputs; ++c)
+      std::fill(outputs[c], outputs[c] + numFrames, 0.0f);
     return;
   }
 
-  currentInputLevelDb_ = (detectionMode_ == 0) ? detectPeakLevel(sidechain, numFrames)
-                                               : detectRMSLevel(sidechain, numFrames);
-
-  const BlendGains gains =
-      resolveBlendGains(currentInputLevelDb_, numFrames, sidechainEnabled_, hasIR1, hasIR2);
-  const float gain1 = gains.gain1;
-  const float gain2 = gains.gain2;
-
-  WDL_FFT_REAL* inputPtr = const_cast<WDL_FFT_REAL*>(input);
-  std::array<WDL_FFT_REAL*, 2> stereoInput = {inputPtr, inputPtr};
-
-  if (hasIR1 && hasIR2)
+  Sample** const wet1 = UsesA ? convolutionEngine1_->get() : nullptr;
+  Sample** const wet2 = UsesB ? convolutionEngine2_->get() : nullptr;
+  if (Layout == ChannelLayout::Mono)
   {
-    convolutionEngine1_->Add(stereoInput.data(), static_cast<int>(numFrames), 2);
-    convolutionEngine2_->Add(stereoInput.data(), static_cast<int>(numFrames), 2);
-
-    int available1 = convolutionEngine1_->Avail(static_cast<int>(numFrames));
-    int available2 = convolutionEngine2_->Avail(static_cast<int>(numFrames));
+    if (UsesA)
+      downmixToMono(wet1, frames);
+    if (UsesB)
+      downmixToMono(wet2, frames);
+  }
 
-    if (available1 >= static_cast<int>(numFrames) && available2 >= static_cast<int>(numFrames))
+  // Every source is staged before any output is written, since the host may process
+  // in place and mono-to-stereo reads the one input for both channels.
+  Sample* const scratch[] = {scratchL_.data(), scratchR_.data()};
+  const int latencyDiff = latencySamples2_ - latencySamples1_;
+  DelayLine::View sources1[NumOutputs];
+  DelayLine::View sources2[NumOutputs];
+  for (int c = 0; c < NumOutputs; ++c)
+  {
+    if (Slots == SlotConfig::Both)
     {
-      WDL_FFT_REAL** output1Ptr = convolutionEngine1_->Get();
-      WDL_FFT_REAL** output2Ptr = convolutionEngine2_->Get();
-
-      const int latencyDiff = latencySamples1_ - latencySamples2_;
-
+      sources1[c] = contiguous(wet1[c], numFrames);
+      sources2[c] = contiguous(wet2[c], numFrames);
+      // The earlier slot is held back by the difference.
       if (latencyDiff > 0)
       {
-        writeToDelayBuffer(ir1DelayBufferL_, ir1DelayWritePosL_, output1Ptr[0], numFrames);
-        writeToDelayBuffer(ir1DelayBufferR_, ir1DelayWritePosR_, output1Ptr[1], numFrames);
-        readFromDelayBuffer(ir1DelayBufferL_, ir1DelayWritePosL_, scratchL_.data(), numFrames,
-                            latencyDiff);
-        readFromDelayBuffer(ir1DelayBufferR_, ir1DelayWritePosR_, scratchR_.data(), numFrames,
-                            latencyDiff);
-
-        for (FrameCount i = 0; i < numFrames; ++i)
-        {
-          outputL[i] = gain1 * irATrimGainLinear_ * scratchL_[i] +
-                       gain2 * irBTrimGainLinear_ * output2Ptr[0][i];
-          outputR[i] = gain1 * irATrimGainLinear_ * scratchR_[i] +
-                       gain2 * irBTrimGainLinear_ * output2Ptr[1][i];
-        }
+        ir1Delay_[c].write(wet1[c], numFrames);
+        sources1[c] = ir1Delay_[c].view(numFrames, static_cast<size_t>(latencyDiff));
       }
       else if (latencyDiff < 0)
       {
-        writeToDelayBuffer(ir2DelayBufferL_, ir2DelayWritePosL_, output2Ptr[0], numFrames);
-        writeToDelayBuffer(ir2DelayBufferR_, ir2DelayWritePosR_, output2Ptr[1], numFrames);
-        readFromDelayBuffer(ir2DelayBufferL_, ir2DelayWritePosL_, scratchL_.data(), numFrames,
-                            -latencyDiff);
-        readFromDelayBuffer(ir2DelayBufferR_, ir2DelayWritePosR_, scratchR_.data(), numFrames,
-                            -latencyDiff);
-
-        for (FrameCount i = 0; i < numFrames; ++i)
-        {
-          outputL[i] = gain1 * irATrimGainLinear_ * output1Ptr[0][i] +
-                       gain2 * irBTrimGainLinear_ * scratchL_[i];
-          outputR[i] = gain1 * irATrimGainLinear_ * output1Ptr[1][i] +
-                       gain2 * irBTrimGainLinear_ * scratchR_[i];
-        }
-      }
-      else
-      {
-        for (FrameCount i = 0; i < numFrames; ++i)
-        {
-          outputL[i] = gain1 * irATrimGainLinear_ * output1Ptr[0][i] +
-                       gain2 * irBTrimGainLinear_ * output2Ptr[0][i];
-          outputR[i] = gain1 * irATrimGainLinear_ * output1Ptr[1][i] +
-                       gain2 * irBTrimGainLinear_ * output2Ptr[1][i];
-        }
+        ir2Delay_[c].write(wet2[c], numFrames);
+        sources2[c] = ir2Delay_[c].view(numFrames, static_cast<size_t>(-latencyDiff));
       }
-
-      convolutionEngine1_->Advance(static_cast<int>(numFrames));
-      convolutionEngine2_->Advance(static_cast<int>(numFrames));
     }
     else
     {
-      std::fill(outputL, outputL + numFrames, 0.0f);
-      std::fill(outputR, outputR + numFrames, 0.0f);
-    }
-  }
-  else if (hasIR1)
-  {
-    writeToDelayBuffer(dryDelayBufferL_, dryDelayWritePosL_, input, numFrames);
-    writeToDelayBuffer(dryDelayBufferR_, dryDelayWritePosR_, input, numFrames);
-
-    convolutionEngine1_->Add(stereoInput.data(), static_cast<int>(numFrames), 2);
-
-    int available = convolutionEngine1_->Avail(static_cast<int>(numFrames));
-    if (available >= static_cast<int>(numFrames))
-    {
-      WDL_FFT_REAL** outputPtr = convolutionEngine1_->Get();
-
-      if (latencySamples1_ > 0)
-      {
-        readFromDelayBuffer(dryDelayBufferL_, dryDelayWritePosL_, scratchL_.data(), numFrames,
-                            latencySamples1_);
-        readFromDelayBuffer(dryDelayBufferR_, dryDelayWritePosR_, scratchR_.data(), numFrames,
-                            latencySamples1_);
-      }
+      const int latency = UsesA ? latencySamples1_ : latencySamples2_;
+      DelayLine::View dry;
+      if (latency > 0)
+        dry = dryDelay_[c].view(numFrames, static_cast<size_t>(latency));
       else
       {
-        std::copy(input, input + numFrames, scratchL_.data());
-        std::copy(input, input + numFrames, scratchR_.data());
-      }
-
-      for (FrameCount i = 0; i < numFrames; ++i)
-      {
-        outputL[i] = gain1 * irATrimGainLinear_ * outputPtr[0][i] + gain2 * scratchL_[i];
-        outputR[i] = gain1 * irATrimGainLinear_ * outputPtr[1][i] + gain2 * scratchR_[i];
+        std::copy(inputs[c], inputs[c] + numFrames, scratch[c]);
+        dry = contiguous(scratch[c], numFrames);
       }
-      convolutionEngine1_->Advance(static_cast<int>(numFrames));
-    }
-    else
-    {
-      std::fill(outputL, outputL + numFrames, 0.0f);
-      std::fill(outputR, outputR + numFrames, 0.0f);
+      sources1[c] = UsesA ? contiguous(wet1[c], numFrames) : dry;
+      sources2[c] = UsesB ? contiguous(wet2[c], numFrames) : dry;
     }
   }
-  else
-  {
-    writeToDelayBuffer(dryDelayBufferL_, dryDelayWritePosL_, input, numFrames);
-    writeToDelayBuffer(dryDelayBufferR_, dryDelayWritePosR_, input, numFrames);
 
-    convolutionEngine2_->Add(stereoInput.data(), static_cast<int>(numFrames), 2);
+  const float scale1 = (UsesA ? irATrimGainLinear_ : 1.0f) * outputGainLinear_;
+  const float scale2 = (UsesB ? irBTrimGainLinear_ : 1.0f) * outputGainLinear_;
+  const GainRamp ramp1 = makeRamp(from.gain1, to.gain1, scale1, frames);
+  const GainRamp ramp2 = makeRamp(from.gain2, to.gain2, scale2, frames);
+  for (int c = 0; c < NumOutputs; ++c)
+    mixRamped(sources1[c], sources2[c], outputs[c], numFrames, ramp1, ramp2);
 
-    int available = convolutionEngine2_->Avail(static_cast<int>(numFrames));
-    if (available >= static_cast<int>(numFrames))
-    {
-      WDL_FFT_REAL** outputPtr = convolutionEngine2_->Get();
+  if (UsesA)
+    convolutionEngine1_->advance(frames);
+  if (UsesB)
+    convolutionEngine2_->advance(frames);
+}
 
-      if (latencySamples2_ > 0)
-      {
-        readFromDelayBuffer(dryDelayBufferL_, dryDelayWritePosL_, scratchL_.data(), numFrames,
-                            latencySamples2_);
-        readFromDelayBuffer(dryDelayBufferR_, dryDelayWritePosR_, scratchR_.data(), numFrames,
-                            latencySamples2_);
-      }
-      else
-      {
-        std::copy(input, input + numFrames, scratchL_.data());
-        std::copy(input, input + numFrames, scratchR_.data());
-      }
+void IRProcessor::processMono(const Sample* input, Sample* output, FrameCount numFrames)
+{
+  processBlock<ChannelLayout::Mono, false>(input, input, nullptr, nullptr, output, nullptr,
+                                           numFrames);
+}
 
-      for (FrameCount i = 0; i < numFrames; ++i)
-      {
-        outputL[i] = gain1 * scratchL_[i] + gain2 * irBTrimGainLinear_ * outputPtr[0][i];
-        outputR[i] = gain1 * scratchR_[i] + gain2 * irBTrimGainLinear_ * outputPtr[1][i];
-      }
-      convolutionEngine2_->Advance(static_cast<int>(numFrames));
-    }
-    else
-    {
-      std::fill(outputL, outputL + numFrames, 0.0f);
-      std::fill(outputR, outputR + numFrames, 0.0f);
-    }
-  }
+void IRProcessor::processStereo(const Sample* inputL, const Sample* inputR, Sample* outputL,
+                                Sample* outputR, FrameCount numFrames)
+{
+  processBlock<ChannelLayout::Stereo, false>(inputL, inputR, nullptr, nullptr, outputL, outputR,
+                                             numFrames);
+}
+
+void IRProcessor::processMonoToStereo(const Sample* input, Sample* outputL, Sample* outputR,
+                                      FrameCount numFrames)
+{
+  processBlock<ChannelLayout::MonoToStereo, false>(input, input, nullptr, nullptr, outputL,
+                                                   outputR, numFrames);
+}
+
+void IRProcessor::processMonoWithSidechain(const Sample* input, const Sample* sidechain,
+                                           Sample* output, FrameCount numFrames)
+{
+  processBlock<ChannelLayout::Mono, true>(input, input, sidechain, sidechain, output, nullptr,
+                                          numFrames);
+}
 
-  applyOutputGain(outputL, numFrames);
-  applyOutputGain(outputR, numFrames);
+void IRProcessor::processMonoToStereoWithSidechain(const Sample* input, const Sample* sidechain,
+                                                   Sample* outputL, Sample* outputR,
+                                                   FrameCount numFrames)
+{
+  processBlock<ChannelLayout::MonoToStereo, true>(input, input, sidechain, sidechain, outputL,
+                                                  outputR, numFrames);
 }
 
 void IRProcessor::processStereoWithSidechain(const Sample* inputL, const Sample* inputR,
                                              const Sample* sidechainL, const Sample* sidechainR,
                                              Sample* outputL, Sample* outputR, FrameCount numFrames)
 {
-  applyPendingIRUpdates();
-
-  bool hasIR1 = ir1Loaded_.load(std::memory_order_relaxed) && irAEnabled_;
-  bool hasIR2 = ir2Loaded_.load(std::memory_order_relaxed) && irBEnabled_;
+  processBlock<ChannelLayout::Stereo, true>(inputL, inputR, sidechainL, sidechainR, outputL,
+                                            outputR, numFrames);
+}
 
-  if (!hasIR1 && !hasIR2)
+// Both slots take the same input. In render mode slot 2 convolves on the helper thread
+// while slot 1 runs on the caller's.
+void IRProcessor::addToBothEngines(const Sample* const* inputs, FrameCount numFrames)
+{
+  if (!parallelSlots_.load(std::memory_order_relaxed))
   {
-    std::copy(inputL, inputL + numFrames, outputL);
-    std::copy(inputR, inputR + numFrames, outputR);
-    applyOutputGain(outputL, numFrames);
-    applyOutputGain(outputR, numFrames);
+    convolutionEngine1_->add(inputs, static_cast<int>(numFrames), 2);
+    convolutionEngine2_->add(inputs, static_cast<int>(numFrames), 2);
     return;
   }
 
+  struct AddJob
+  {
+    ConvolutionEngine* engine;
+    const Sample* const* inputs;
+    int numFrames;
+  };
+  AddJob job = {convolutionEngine2_, inputs, static_cast<int>(numFrames)};
+  renderWorker_.fork(
+      [](void* context)
+      {
+        const AddJob& add = *static_cast<const AddJob*>(context);
+        add.engine->add(add.inputs, add.numFrames, 2);
+      },
+      &job);
+  convolutionEngine1_->add(inputs, static_cast<int>(numFrames), 2);
+  renderWorker_.join();
+}
+
+void IRProcessor::applyPendingIRUpdates()
+{
+  bool delayBuffersNeedUpdate = false;
+
+  if (slot1_.acquire())
   {
-    float levelL = (detectionMode_ == 0) ? detectPeakLevel(sidechainL, numFrames)
-                                         : detectRMSLevel(sidechainL, numFrames);
-    float levelR = (detectionMode_ == 0) ? detectPeakLevel(sidechainR, numFrames)
-                                         : detectRMSLevel(sidechainR, numFrames);
-    currentInputLevelDb_ = std::max(levelL, levelR);
+    const SlotEngine& state = *slot1_.get();
+    convolutionEngine1_ = state.engine.get();
+    ir1Loaded_.store(state.loaded, std::memory_order_relaxed);
+    latencySamples1_ = state.latency;
+    irLength1_ = state.length;
+    delayBuffersNeedUpdate = true;
   }
 
-  const BlendGains gains =
-      resolveBlendGains(currentInputLevelDb_, numFrames, sidechainEnabled_, hasIR1, hasIR2);
-  const float gain1 = gains.gain1;
-  const float gain2 = gains.gain2;
+  if (slot2_.acquire())
+  {
+    const SlotEngine& state = *slot2_.get();
+    convolutionEngine2_ = state.engine.get();
+    ir2Loaded_.store(state.loaded, std::memory_order_relaxed);
+    latencySamples2_ = state.latency;
+    irLength2_ = state.length;
+    delayBuffersNeedUpdate = true;
+  }
 
-  std::array<WDL_FFT_REAL*, 2> inputPtrs = {const_cast<WDL_FFT_REAL*>(inputL),
-                                            const_cast<WDL_FFT_REAL*>(inputR)};
+  if (dual_.acquire())
+    dualConvolver_ = dual_.get();
 
-  if (hasIR1 && hasIR2)
+  if (delayBuffersNeedUpdate)
   {
-    convolutionEngine1_->Add(inputPtrs.data(), static_cast<int>(numFrames), 2);
-    convolutionEngine2_->Add(inputPtrs.data(), static_cast<int>(numFrames), 2);
+    updateDelayLines();
+    silence_.setTailSamples(static_cast<FrameCount>(
+        std::max(irLength1_, irLength2_) + maxLatencySamples_.load(std::memory_order_relaxed)));
+  }
+}
 
-    int available1 = convolutionEngine1_->Avail(static_cast<int>(numFrames));
-    int available2 = convolutionEngine2_->Avail(static_cast<int>(numFrames));
+// Once the input has been silent for longer than the IRs and alignment delays, the
+// engines hold nothing but silence; the block is output as silence without running them.
+// Level detection and blend smoothing have already run, so they follow the input as if
+// the block had been processed.
+bool IRProcessor::skipSilentBlock(const Sample* inputL, const Sample* inputR,
+                                  FrameCount numFrames)
+{
+  const bool silent = SilenceDetector::isSilent(inputL, numFrames) &&
+                      (inputR == inputL || SilenceDetector::isSilent(inputR, numFrames));
+  return silence_.skip(silent, numFrames);
+}
 
-    if (available1 >= static_cast<int>(numFrames) && available2 >= static_cast<int>(numFrames))
-    {
-      WDL_FFT_REAL** output1Ptr = convolutionEngine1_->Get();
-      WDL_FFT_REAL** output2Ptr = convolutionEngine2_->Get();
+// Runs on the audio thread. An engine that is switched to has not seen the input since
+// it was last used, so its history is cleared instead of being played out late. The
+// alignment delays were written for the previous path and start over too.
+void IRProcessor::switchPath(ProcessPath path)
+{
+  if (path == previousPath_)
+    return;
 
-      const int latencyDiff = latencySamples1_ - latencySamples2_;
+  const auto usesEngine1 = [](ProcessPath p)
+  { return p == ProcessPath::OnlyA || p == ProcessPath::Both; };
+  const auto usesEngine2 = [](ProcessPath p)
+  { return p == ProcessPath::OnlyB || p == ProcessPath::Both; };
+
+  if (path == ProcessPath::Dual && dualConvolver_)
+    dualConvolver_->reset();
+  if (usesEngine1(path) && !usesEngine1(previousPath_) && convolutionEngine1_)
+    convolutionEngine1_->reset();
+  if (usesEngine2(path) && !usesEngine2(previousPath_) && convolutionEngine2_)
+    convolutionEngine2_->reset();
+  clearDelayLines();
+  previousPath_ = path;
+}
 
-      if (latencyDiff > 0)
-      {
-        writeToDelayBuffer(ir1DelayBufferL_, ir1DelayWritePosL_, output1Ptr[0], numFrames);
-        writeToDelayBuffer(ir1DelayBufferR_, ir1DelayWritePosR_, output1Ptr[1], numFrames);
-        readFromDelayBuffer(ir1DelayBufferL_, ir1DelayWritePosL_, scratchL_.data(), numFrames,
-                            latencyDiff);
-        readFromDelayBuffer(ir1DelayBufferR_, ir1DelayWritePosR_, scratchR_.data(), numFrames,
-                            latencyDiff);
-
-        for (FrameCount i = 0; i < numFrames; ++i)
-        {
-          outputL[i] = gain1 * irATrimGainLinear_ * scratchL_[i] +
-                       gain2 * irBTrimGainLinear_ * output2Ptr[0][i];
-          outputR[i] = gain1 * irATrimGainLinear_ * scratchR_[i] +
-                       gain2 * irBTrimGainLinear_ * output2Ptr[1][i];
-        }
-      }
-      else if (latencyDiff < 0)
-      {
-        writeToDelayBuffer(ir2DelayBufferL_, ir2DelayWritePosL_, output2Ptr[0], numFrames);
-        writeToDelayBuffer(ir2DelayBufferR_, ir2DelayWritePosR_, output2Ptr[1], numFrames);
-        readFromDelayBuffer(ir2DelayBufferL_, ir2DelayWritePosL_, scratchL_.data(), numFrames,
-                            -latencyDiff);
-        readFromDelayBuffer(ir2DelayBufferR_, ir2DelayWritePosR_, scratchR_.data(), numFrames,
-                            -latencyDiff);
-
-        for (FrameCount i = 0; i < numFrames; ++i)
-        {
-          outputL[i] = gain1 * irATrimGainLinear_ * output1Ptr[0][i] +
-                       gain2 * irBTrimGainLinear_ * scratchL_[i];
-          outputR[i] = gain1 * irATrimGainLinear_ * output1Ptr[1][i] +
-                       gain2 * irBTrimGainLinear_ * scratchR_[i];
-        }
-      }
-      else
-      {
-        for (FrameCount i = 0; i < numFrames; ++i)
-        {
-          outputL[i] = gain1 * irATrimGainLinear_ * output1Ptr[0][i] +
-                       gain2 * irBTrimGainLinear_ * output2Ptr[0][i];
-          outputR[i] = gain1 * irATrimGainLinear_ * output1Ptr[1][i] +
-                       gain2 * irBTrimGainLinear_ * output2Ptr[1][i];
-        }
-      }
+void IRProcessor::stageDualConvolver()
+{
+  // The shared-spectrum engine is a uniformly partitioned FFT convolver, so it only
+  // stands in for slots left on Auto or pinned to Pffft. It runs its whole tail in
+  // process(); with background tails the slots' own engines are used instead.
+  const auto sharesSpectrum = [](ConvolutionEngineType type)
+  { return type == ConvolutionEngineType::Auto || type == ConvolutionEngineType::Pffft; };
+  std::unique_ptr<DualKernelConvolver> convolver(new DualKernelConvolver());
+  if (ir1_ && ir2_ && !backgroundTail_ && sharesSpectrum(engineType1_) &&
+      sharesSpectrum(engineType2_))
+    convolver->prepare(ir1_->kernel, ir2_->kernel);
+  stagedDual_ = convolver->isPrepared();
+  dual_.publish(std::move(convolver));
+}
 
-      convolutionEngine1_->Advance(static_cast<int>(numFrames));
-      convolutionEngine2_->Advance(static_cast<int>(numFrames));
-    }
-    else
-    {
-      std::fill(outputL, outputL + numFrames, 0.0f);
-      std::fill(outputR, outputR + numFrames, 0.0f);
-    }
-  }
-  else if (hasIR1)
-  {
-    writeToDelayBuffer(dryDelayBufferL_, dryDelayWritePosL_, inputL, numFrames);
-    writeToDelayBuffer(dryDelayBufferR_, dryDelayWritePosR_, inputR, numFrames);
+bool IRProcessor::useDualConvolver(bool hasIR1, bool hasIR2) const
+{
+  // The shared-spectrum engine has no latency. Only use it while the per-slot engines
+  // report none either, so switching between paths never shifts the output in time.
+  return hasIR1 && hasIR2 && dualConvolver_ && dualConvolver_->isPrepared() &&
+         maxLatencySamples_.load(std::memory_order_relaxed) == 0;
+}
 
-    convolutionEngine1_->Add(inputPtrs.data(), static_cast<int>(numFrames), 2);
+// Must be called with controlMutex_ held. Mirrors useDualConvolver() for the staged
+// engines.
+bool IRProcessor::isKernelInUse(int slot) const
+{
+  return (slot == 1 ? stagedUsesKernel1_ : stagedUsesKernel2_) ||
+         (stagedDual_ && std::max(stagedLatency1_, stagedLatency2_) == 0);
+}
 
-    int available = convolutionEngine1_->Avail(static_cast<int>(numFrames));
-    if (available >= static_cast<int>(numFrames))
-    {
-      WDL_FFT_REAL** outputPtr = convolutionEngine1_->Get();
+void IRProcessor::swapIRSlots()
+{
+  std::lock_guard<std::mutex> control(controlMutex_);
+  supersedeLoads(1);
+  supersedeLoads(2);
 
-      if (latencySamples1_ > 0)
-      {
-        readFromDelayBuffer(dryDelayBufferL_, dryDelayWritePosL_, scratchL_.data(), numFrames,
-                            latencySamples1_);
-        readFromDelayBuffer(dryDelayBufferR_, dryDelayWritePosR_, scratchR_.data(), numFrames,
-                            latencySamples1_);
-      }
-      else
-      {
-        std::copy(inputL, inputL + numFrames, scratchL_.data());
-        std::copy(inputR, inputR + numFrames, scratchR_.data());
-      }
+  // The audio thread owns the running engines, so each slot gets a fresh engine for
+  // its new IR and both are published like a load.
+  std::swap(ir1_, ir2_);
+  std::swap(currentIR1Path_, currentIR2Path_);
+  std::swap(engineType1_, engineType2_);
+  restageEngine1();
+  restageEngine2();
+  stageDualConvolver();
+}
 
-      for (FrameCount i = 0; i < numFrames; ++i)
-      {
-        outputL[i] = gain1 * irATrimGainLinear_ * outputPtr[0][i] + gain2 * scratchL_[i];
-        outputR[i] = gain1 * irATrimGainLinear_ * outputPtr[1][i] + gain2 * scratchR_[i];
-      }
-      convolutionEngine1_->Advance(static_cast<int>(numFrames));
-    }
-    else
-    {
-      std::fill(outputL, outputL + numFrames, 0.0f);
-      std::fill(outputR, outputR + numFrames, 0.0f);
-    }
+void IRProcessor::reset()
+{
+  if (convolutionEngine1_)
+  {
+    convolutionEngine1_->reset();
   }
-  else
+  if (convolutionEngine2_)
+  {
+    convolutionEngine2_->reset();
+  }
+  if (dualConvolver_)
   {
-    writeToDelayBuffer(dryDelayBufferL_, dryDelayWritePosL_, inputL, numFrames);
-    writeToDelayBuffer(dryDelayBufferR_, dryDelayWritePosR_, inputR, numFrames);
+    dualConvolver_->reset();
+  }
 
-    convolutionEngine2_->Add(inputPtrs.data(), static_cast<int>(numFrames), 2);
+  // Envelope, blend smoothing and alignment delays start over as in a new processor, so
+  // a reset processor renders a file exactly as a fresh one would.
+  currentInputLevelDb_ = -96.0f;
+  currentBlend_ = 0.0f;
+  smoothedBlend_ = 0.0f;
+  for (auto* detector : levelDetectors_)
+    detector->reset();
+  clearDelayLines();
+  silence_.reset();
+  previousGainLaw_ = 0;
+  previousPath_ = ProcessPath::Passthrough;
+}
 
-    int available = convolutionEngine2_->Avail(static_cast<int>(numFrames));
-    if (available >= static_cast<int>(numFrames))
-    {
-      WDL_FFT_REAL** outputPtr = convolutionEngine2_->Get();
+std::string IRProcessor::getCurrentIR1Path() const
+{
+  std::lock_guard<std::mutex> lock(controlMutex_);
+  return currentIR1Path_;
+}
 
-      if (latencySamples2_ > 0)
-      {
-        readFromDelayBuffer(dryDelayBufferL_, dryDelayWritePosL_, scratchL_.data(), numFrames,
-                            latencySamples2_);
-        readFromDelayBuffer(dryDelayBufferR_, dryDelayWritePosR_, scratchR_.data(), numFrames,
-                            latencySamples2_);
-      }
-      else
-      {
-        std::copy(inputL, inputL + numFrames, scratchL_.data());
-        std::copy(inputR, inputR + numFrames, scratchR_.data());
-      }
+std::string IRProcessor::getCurrentIR2Path() const
+{
+  std::lock_guard<std::mutex> lock(controlMutex_);
+  return currentIR2Path_;
+}
 
-      for (FrameCount i = 0; i < numFrames; ++i)
-      {
-        outputL[i] = gain1 * scratchL_[i] + gain2 * irBTrimGainLinear_ * outputPtr[0][i];
-        outputR[i] = gain1 * scratchR_[i] + gain2 * irBTrimGainLinear_ * outputPtr[1][i];
-      }
-      convolutionEngine2_->Advance(static_cast<int>(numFrames));
-    }
-    else
-    {
-      std::fill(outputL, outputL + numFrames, 0.0f);
-      std::fill(outputR, outputR + numFrames, 0.0f);
-    }
-  }
+SampleRate IRProcessor::getIR1SampleRate() const
+{
+  std::lock_guard<std::mutex> lock(controlMutex_);
+  return ir1_ ? ir1_->source->getIRSampleRate() : 0.0;
+}
+
+SampleRate IRProcessor::getIR2SampleRate() const
+{
+  std::lock_guard<std::mutex> lock(controlMutex_);
+  return ir2_ ? ir2_->source->getIRSampleRate() : 0.0;
+}
+
+size_t IRProcessor::getIR1NumSamples() const
+{
+  std::lock_guard<std::mutex> lock(controlMutex_);
+  return ir1_ ? ir1_->source->getNumSamples() : 0;
+}
+
+size_t IRProcessor::getIR2NumSamples() const
+{
+  std::lock_guard<std::mutex> lock(controlMutex_);
+  return ir2_ ? ir2_->source->getNumSamples() : 0;
+}
+
+size_t IRProcessor::getIR1OriginalNumSamples() const
+{
+  std::lock_guard<std::mutex> lock(controlMutex_);
+  return ir1_ ? ir1_->source->getOriginalNumSamples() : 0;
+}
+
+size_t IRProcessor::getIR2OriginalNumSamples() const
+{
+  std::lock_guard<std::mutex> lock(controlMutex_);
+  return ir2_ ? ir2_->source->getOriginalNumSamples() : 0;
+}
+
+KernelDiagnostics IRProcessor::getIR1KernelDiagnostics() const
+{
+  std::lock_guard<std::mutex> lock(controlMutex_);
+  return ir1_ && isKernelInUse(1) ? ir1_->kernel->getDiagnostics() : KernelDiagnostics();
+}
+
+KernelDiagnostics IRProcessor::getIR2KernelDiagnostics() const
+{
+  std::lock_guard<std::mutex> lock(controlMutex_);
+  return ir2_ && isKernelInUse(2) ? ir2_->kernel->getDiagnostics() : KernelDiagnostics();
+}
+
+int IRProcessor::getNumIR1Channels() const
+{
+  std::lock_guard<std::mutex> lock(controlMutex_);
+  return ir1_ ? ir1_->source->getNumChannels() : 0;
+}
 
-  applyOutputGain(outputL, numFrames);
-  applyOutputGain(outputR, numFrames);
+int IRProcessor::getNumIR2Channels() const
+{
+  std::lock_guard<std::mutex> lock(controlMutex_);
+  return ir2_ ? ir2_->source->getNumChannels() : 0;
 }
 
+int IRProcessor::getLatencySamples() const
+{
+  return maxLatencySamples_.load();
+}
 float IRProcessor::calculateDynamicBlend(float inputLevelDb) const
 {
   float kneeStart = thresholdDb_ - (kneeWidthDb_ / 2.0f);
@@ -1599,55 +1522,14 @@ float IRProcessor::calculateDynamicBlend(float inputLevelDb) const
   return -1.0f + 2.0f * blendPosition;
 }
 
-float IRProcessor::detectPeakLevel(const Sample* buffer, FrameCount numFrames)
-{
-  if (numFrames == 0)
-  {
-    return -96.0f;
-  }
-
-  float peak = 0.0f;
-  for (FrameCount i = 0; i < numFrames; ++i)
-  {
-    float absSample = std::abs(buffer[i]);
-    peak = std::max(peak, absSample);
-  }
-
-  if (peak < 1e-6f)
-  {
-    return -96.0f;
-  }
-
-  return 20.0f * std::log10(peak);
-}
-
-float IRProcessor::detectRMSLevel(const Sample* buffer, FrameCount numFrames)
+float IRProcessor::detectLevel(const Sample* buffer, FrameCount numFrames)
 {
-  if (numFrames == 0 || rmsBufferSize_ == 0)
-  {
-    return -96.0f;
-  }
+  // A sample rate change restarts the RMS window here rather than reallocating.
+  const size_t window = rmsWindowTarget_.load();
+  if (window != rmsDetector_.getWindowLength())
+    rmsDetector_.setWindowLength(window);
 
-  for (FrameCount i = 0; i < numFrames; ++i)
-  {
-    float sample = buffer[i];
-    rmsBuffer_[rmsBufferIndex_] = sample * sample;
-    rmsBufferIndex_ = (rmsBufferIndex_ + 1) % rmsBufferSize_;
-  }
-
-  float sumSquares = 0.0f;
-  for (size_t i = 0; i < rmsBufferSize_; ++i)
-  {
-    sumSquares += rmsBuffer_[i];
-  }
-  float rms = std::sqrt(sumSquares / static_cast<float>(rmsBufferSize_));
-
-  if (rms < 1e-6f)
-  {
-    return -96.0f;
-  }
-
-  return 20.0f * std::log10(rms);
+  return levelDetectors_[detectionMode_]->process(buffer, numFrames);
 }
 
 void IRProcessor::updateSmoothingCoefficients()
@@ -1701,66 +1583,29 @@ void IRProcessor::applyOutputGain(Sample* buffer, FrameCount numFrames) const
   }
 }
 
-void IRProcessor::updateDelayBuffers()
-{
-  const int maxLatency = std::max(latencySamples1_, latencySamples2_);
-  maxLatencySamples_.store(maxLatency <= 0 ? 0 : maxLatency);
-
-  if (maxLatency <= 0)
-    return;
-
-  const size_t bufferSize = static_cast<size_t>(maxLatency);
-
-  if (dryDelayBufferL_.size() != bufferSize)
-  {
-    dryDelayBufferL_.resize(bufferSize, 0.0f);
-    dryDelayBufferR_.resize(bufferSize, 0.0f);
-    ir1DelayBufferL_.resize(bufferSize, 0.0f);
-    ir1DelayBufferR_.resize(bufferSize, 0.0f);
-    ir2DelayBufferL_.resize(bufferSize, 0.0f);
-    ir2DelayBufferR_.resize(bufferSize, 0.0f);
-    dryDelayWritePosL_ = 0;
-    dryDelayWritePosR_ = 0;
-    ir1DelayWritePosL_ = 0;
-    ir1DelayWritePosR_ = 0;
-    ir2DelayWritePosL_ = 0;
-    ir2DelayWritePosR_ = 0;
-  }
-}
-
-void IRProcessor::writeToDelayBuffer(std::vector<Sample>& buffer, size_t& writePos,
-                                     const Sample* input, FrameCount numFrames)
+// Runs on the audio thread. Delayed samples from before a latency change would play back
+// misaligned, so the lines start over from silence.
+void IRProcessor::updateDelayLines()
 {
-  if (buffer.empty())
-  {
-    return;
-  }
+  const int maxLatency = std::max(0, std::max(latencySamples1_, latencySamples2_));
+  maxLatencySamples_.store(maxLatency);
 
-  const size_t bufferSize = buffer.size();
-
-  for (FrameCount i = 0; i < numFrames; ++i)
+  // With no latency every alignment path is a straight copy and the lines are bypassed,
+  // as they are until setMaxBlockSize() allocates them.
+  const int latency = dryDelay_[0].getCapacity() > 0 ? maxLatency : 0;
+  if (latency != alignedLatency_)
   {
-    buffer[writePos] = input[i];
-    writePos = (writePos + 1) % bufferSize;
+    alignedLatency_ = latency;
+    clearDelayLines();
   }
 }
 
-void IRProcessor::readFromDelayBuffer(const std::vector<Sample>& buffer, size_t writePos,
-                                      Sample* output, FrameCount numFrames, int delaySamples)
+void IRProcessor::clearDelayLines()
 {
-  if (buffer.empty() || delaySamples <= 0)
-  {
-    return;
-  }
-
-  const size_t bufferSize = buffer.size();
-  const int clampedDelay = std::min(delaySamples, static_cast<int>(bufferSize));
-
-  for (FrameCount i = 0; i < numFrames; ++i)
-  {
-    const size_t readPos = (writePos + bufferSize - clampedDelay + i) % bufferSize;
-    output[i] = buffer[readPos];
-  }
+  for (int c = 0; c < 2; ++c)
+    for (auto* line : {&dryDelay_[c], &ir1Delay_[c], &ir2Delay_[c]})
+      if (line->getCapacity() > 0)
+        line->clear();
 }
 
 }  // namespace octob
@@ -0,0 +1,83 @@
+#include "octobir-core/LevelDetector.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+namespace octob
+{
+
+constexpr float LevelDetector::FloorDb;
+
+float LevelDetector::toDb(float amplitude)
+{
+  if (amplitude < 1e-6f)
+    return FloorDb;
+  return 20.0f * std::log10(amplitude);
+}
+
+float PeakDetector::process(const Sample* buffer, FrameCount numFrames)
+{
+  return toDb(findPeak(buffer, numFrames));
+}
+
+float PeakDetector::findPeak(const Sample* buffer, FrameCount numFrames)
+{
+  // A single running max is a serial dependency the compiler may not reorder; eight
+  // independent lanes map onto vector max instructions.
+  constexpr FrameCount Lanes = 8;
+  float lanes[Lanes] = {};
+  FrameCount i = 0;
+  for (; i + Lanes <= numFrames; i += Lanes)
+    for (FrameCount j = 0; j < Lanes; ++j)
+      lanes[j] = std::max(lanes[j], std::fabs(buffer[i + j]));
+
+  float peak = 0.0f;
+  for (; i < numFrames; ++i)
+    peak = std::max(peak, std::fabs(buffer[i]));
+  for (FrameCount j = 0; j < Lanes; ++j)
+    peak = std::max(peak, lanes[j]);
+  return peak;
+}
+
+RmsDetector::RmsDetector(size_t maxWindowLength)
+    : squares_(std::max(maxWindowLength, static_cast<size_t>(1)), 0.0f)
+{
+}
+
+void RmsDetector::setWindowLength(size_t length)
+{
+  windowLength_ = std::max(static_cast<size_t>(1), std::min(length, squares_.size()));
+  reset();
+}
+
+float RmsDetector::process(const Sample* buffer, FrameCount numFrames)
+{
+  for (FrameCount i = 0; i < numFrames; ++i)
+  {
+    const float square = buffer[i] * buffer[i];
+    sum_ += static_cast<double>(square) - static_cast<double>(squares_[writePos_]);
+    squares_[writePos_] = square;
+    if (++writePos_ == windowLength_)
+    {
+      // Once per window, so still O(1) per sample: drop the accumulated rounding.
+      writePos_ = 0;
+      double exact = 0.0;
+      for (size_t j = 0; j < windowLength_; ++j)
+        exact += squares_[j];
+      sum_ = exact;
+    }
+  }
+
+  const double meanSquare = std::max(0.0, sum_) / static_cast<double>(windowLength_);
+  return toDb(static_cast<float>(std::sqrt(meanSquare)));
+}
+
+void RmsDetector::reset()
+{
+  std::fill(squares_.begin(), squares_.begin() + static_cast<std::ptrdiff_t>(windowLength_), 0.0f);
+  writePos_ = 0;
+  sum_ = 0.0;
+}
+
+}  // namespace octob
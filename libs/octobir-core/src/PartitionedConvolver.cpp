@@ -0,0 +1,182 @@
+#include "octobir-core/PartitionedConvolver.hpp"
+
+#include <algorithm>
+
+#include "pffft.h"
+
+namespace octob
+{
+
+namespace
+{
+
+float* allocateZeroed(size_t numFloats)
+{
+  auto* buffer = static_cast<float*>(pffft_aligned_malloc(numFloats * sizeof(float)));
+  if (buffer != nullptr)
+    std::fill(buffer, buffer + numFloats, 0.0f);
+  return buffer;
+}
+
+}  // namespace
+
+PartitionedConvolver::PartitionedConvolver() = default;
+
+PartitionedConvolver::~PartitionedConvolver()
+{
+  release();
+}
+
+void PartitionedConvolver::release()
+{
+  pffft_aligned_free(window_);
+  pffft_aligned_free(history_);
+  pffft_aligned_free(accumulators_);
+  pffft_aligned_free(scratch_);
+  pffft_aligned_free(work_);
+  if (fft_ != nullptr)
+    pffft_destroy_setup(fft_);
+
+  fft_ = nullptr;
+  window_ = nullptr;
+  history_ = nullptr;
+  accumulators_ = nullptr;
+  scratch_ = nullptr;
+  work_ = nullptr;
+  blockSize_ = 0;
+  maxPartitions_ = 0;
+  numAccumulators_ = 0;
+  head_ = 0;
+}
+
+bool PartitionedConvolver::prepare(int blockSize, int maxPartitions, int numAccumulators)
+{
+  release();
+
+  if (blockSize < 16 || (blockSize & (blockSize - 1)) != 0 || maxPartitions <= 0 ||
+      numAccumulators <= 0)
+    return false;
+
+  const auto fftSize = static_cast<size_t>(blockSize) * 2;
+  fft_ = pffft_new_setup(static_cast<int>(fftSize), PFFFT_REAL);
+  window_ = allocateZeroed(fftSize);
+  history_ = allocateZeroed(fftSize * static_cast<size_t>(maxPartitions));
+  accumulators_ = allocateZeroed(fftSize * static_cast<size_t>(numAccumulators));
+  scratch_ = allocateZeroed(fftSize);
+  work_ = allocateZeroed(fftSize);
+
+  if (fft_ == nullptr || window_ == nullptr || history_ == nullptr || accumulators_ == nullptr ||
+      scratch_ == nullptr || work_ == nullptr)
+  {
+    release();
+    return false;
+  }
+
+  blockSize_ = blockSize;
+  maxPartitions_ = maxPartitions;
+  numAccumulators_ = numAccumulators;
+  return true;
+}
+
+void PartitionedConvolver::reset()
+{
+  if (fft_ == nullptr)
+    return;
+
+  const auto fftSize = static_cast<size_t>(blockSize_) * 2;
+  std::fill(window_, window_ + fftSize, 0.0f);
+  std::fill(history_, history_ + fftSize * static_cast<size_t>(maxPartitions_), 0.0f);
+  std::fill(accumulators_, accumulators_ + fftSize * static_cast<size_t>(numAccumulators_), 0.0f);
+  head_ = 0;
+}
+
+void PartitionedConvolver::pushBlock(const Sample* input)
+{
+  if (fft_ == nullptr)
+    return;
+
+  // Overlap-save window: [previous block | current block].
+  const auto block = static_cast<size_t>(blockSize_);
+  std::copy(window_ + block, window_ + 2 * block, window_);
+  std::copy(input, input + block, window_ + block);
+
+  head_ = (head_ + 1 == maxPartitions_) ? 0 : head_ + 1;
+  float* spectrum = history_ + static_cast<size_t>(head_) * 2 * block;
+  pffft_transform(fft_, window_, spectrum, work_, PFFFT_FORWARD);
+}
+
+void PartitionedConvolver::accumulate(const ConvolutionKernel& kernel, int channel, float gain,
+                                      int accumulator)
+{
+  accumulateFrom(kernel, channel, gain, accumulator, 0);
+}
+
+void PartitionedConvolver::accumulateTail(const ConvolutionKernel& kernel, int channel,
+                                          float gain, int accumulator)
+{
+  accumulateFrom(kernel, channel, gain, accumulator, 1);
+}
+
+void PartitionedConvolver::accumulateFrom(const ConvolutionKernel& kernel, int channel,
+                                          float gain, int accumulator, int firstPartition)
+{
+  if (fft_ == nullptr || kernel.getBlockSize() != blockSize_ || accumulator < 0 ||
+      accumulator >= numAccumulators_ || channel < 0 || channel >= kernel.getNumChannels())
+    return;
+
+  const auto fftSize = static_cast<size_t>(blockSize_) * 2;
+  float* acc = accumulators_ + static_cast<size_t>(accumulator) * fftSize;
+  const int endPartition = std::min(kernel.getNumPartitions(), maxPartitions_ + firstPartition);
+
+  // Partition k pairs with the input block pushed (k - firstPartition) blocks ago, so
+  // walk the history ring backwards from head_. Silent partitions add nothing.
+  int slot = head_;
+  for (int k = firstPartition; k < endPartition; ++k)
+  {
+    if (!kernel.isPartitionSilent(channel, k))
+      pffft_zconvolve_accumulate(fft_, history_ + static_cast<size_t>(slot) * fftSize,
+                                 kernel.getPartition(channel, k), acc, gain);
+    slot = (slot == 0) ? maxPartitions_ - 1 : slot - 1;
+  }
+}
+
+void PartitionedConvolver::finish(int accumulator, Sample* output)
+{
+  if (fft_ == nullptr || accumulator < 0 || accumulator >= numAccumulators_)
+    return;
+
+  const auto block = static_cast<size_t>(blockSize_);
+  float* acc = accumulators_ + static_cast<size_t>(accumulator) * 2 * block;
+  pffft_transform(fft_, acc, scratch_, work_, PFFFT_BACKWARD);
+  std::copy(scratch_ + block, scratch_ + 2 * block, output);
+  std::fill(acc, acc + 2 * block, 0.0f);
+}
+
+void PartitionedConvolver::finishSum(int accumulatorA, float gainA, int accumulatorB, float gainB,
+                                     Sample* output)
+{
+  if (fft_ == nullptr || accumulatorA < 0 || accumulatorA >= numAccumulators_ ||
+      accumulatorB < 0 || accumulatorB >= numAccumulators_)
+    return;
+
+  const auto fftSize = static_cast<size_t>(blockSize_) * 2;
+  const float* accA = accumulators_ + static_cast<size_t>(accumulatorA) * fftSize;
+  const float* accB = accumulators_ + static_cast<size_t>(accumulatorB) * fftSize;
+  for (size_t j = 0; j < fftSize; ++j)
+    scratch_[j] = gainA * accA[j] + gainB * accB[j];
+  // pffft transforms may run in place.
+  pffft_transform(fft_, scratch_, scratch_, work_, PFFFT_BACKWARD);
+  std::copy(scratch_ + fftSize / 2, scratch_ + fftSize, output);
+}
+
+void PartitionedConvolver::clear(int accumulator)
+{
+  if (fft_ == nullptr || accumulator < 0 || accumulator >= numAccumulators_)
+    return;
+
+  const auto fftSize = static_cast<size_t>(blockSize_) * 2;
+  float* acc = accumulators_ + static_cast<size_t>(accumulator) * fftSize;
+  std::fill(acc, acc + fftSize, 0.0f);
+}
+
+}  // namespace octob
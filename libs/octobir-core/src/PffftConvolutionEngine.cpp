@@ -0,0 +1,301 @@
+#include "octobir-core/PffftConvolutionEngine.hpp"
+
+#include <algorithm>
+#include <cstddef>
+
+namespace octob
+{
+
+constexpr int PffftConvolutionEngine::MaxChannels;
+constexpr int PffftConvolutionEngine::RenderBlockSize;
+
+namespace
+{
+
+// Output queue capacity reserved up front, so hosts with blocks of up to this many
+// frames never grow it on the audio thread.
+constexpr size_t InitialQueueFrames = 8192;
+
+}  // namespace
+
+PffftConvolutionEngine::PffftConvolutionEngine(int blockSize, bool zeroLatency,
+                                               TailMode tailMode)
+    : blockSize_(blockSize), zeroLatency_(zeroLatency), tailMode_(tailMode)
+{
+}
+
+int PffftConvolutionEngine::setImpulse(WDL_ImpulseBuffer& impulse)
+{
+  return setKernel(ConvolutionKernel::create(impulse, MaxChannels, blockSize_));
+}
+
+int PffftConvolutionEngine::setSharedImpulse(WDL_ImpulseBuffer& impulse,
+                                             std::shared_ptr<const ConvolutionKernel> kernel)
+{
+  if (!kernel || kernel->getBlockSize() != blockSize_)
+    return setImpulse(impulse);
+  return setKernel(std::move(kernel));
+}
+
+int PffftConvolutionEngine::setKernel(std::shared_ptr<const ConvolutionKernel> kernel)
+{
+  kernel_.reset();
+  tailWorker_.reset();
+  if (!kernel)
+    return -1;
+
+  const int blockSize = kernel->getBlockSize();
+  const auto block = static_cast<size_t>(blockSize);
+  // The direct-form head covers partition 0, so the FFT only sees the tail.
+  const int firstPartition = zeroLatency_ ? 1 : 0;
+  int partitions = std::max(1, kernel->getNumPartitions() - firstPartition);
+
+  if (tailMode_ != TailMode::AudioThread &&
+      kernel->getNumPartitions() > BackgroundFirstPartition)
+  {
+    // The near convolvers stop where the worker starts. Its results are due
+    // (BackgroundFirstPartition - firstPartition) blocks after their input.
+    tailWorker_.reset(new TailWorker());
+    if (!tailWorker_->prepare(kernel, BackgroundFirstPartition,
+                              BackgroundFirstPartition - firstPartition,
+                              tailMode_ == TailMode::Background))
+      return -1;
+    partitions = BackgroundFirstPartition - firstPartition;
+  }
+
+  for (int c = 0; c < MaxChannels; ++c)
+  {
+    if (!convolvers_[c].prepare(blockSize, partitions, 1))
+      return -1;
+
+    blockInput_[c].assign(block, 0.0f);
+    blockOutput_[c].assign(block, 0.0f);
+    queue_[c].assign(std::max(InitialQueueFrames, 4 * block), 0.0f);
+
+    const int kernelChannel = std::min(c, kernel->getNumChannels() - 1);
+    silentOutputs_[c] = kernel->isChannelSilent(kernelChannel);
+    if (zeroLatency_)
+    {
+      const Sample* head = kernel->getHead(kernelChannel);
+      history_[c].assign(2 * block, 0.0f);
+      headTaps_[c].assign(head, head + block);
+      std::reverse(headTaps_[c].begin(), headTaps_[c].end());
+    }
+  }
+
+  kernel_ = std::move(kernel);
+  blockSize_ = blockSize;
+  reset();
+  return zeroLatency_ ? 0 : blockSize_;
+}
+
+void PffftConvolutionEngine::reset()
+{
+  for (int c = 0; c < MaxChannels; ++c)
+  {
+    convolvers_[c].reset();
+    std::fill(blockInput_[c].begin(), blockInput_[c].end(), 0.0f);
+    std::fill(blockOutput_[c].begin(), blockOutput_[c].end(), 0.0f);
+    std::fill(history_[c].begin(), history_[c].end(), 0.0f);
+    std::fill(queue_[c].begin(), queue_[c].end(), 0.0f);
+  }
+  if (tailWorker_)
+    tailWorker_->reset();
+  blockPos_ = 0;
+  historyPos_ = 0;
+
+  // In block mode, prime the queue with one block of silence: the latency that lets
+  // every add() be answered in full by the following avail().
+  queueStart_ = 0;
+  queueEnd_ = kernel_ && !zeroLatency_ ? static_cast<size_t>(blockSize_) : 0;
+}
+
+void PffftConvolutionEngine::add(const Sample* const* inputs, int numFrames, int numChannels)
+{
+  if (!kernel_ || numFrames <= 0)
+    return;
+
+  numChannels = std::max(1, std::min(numChannels, MaxChannels));
+  // Identical inputs through a mono IR give identical outputs: convolve once and
+  // expose the same buffer for both channels, as WDL does.
+  if (numChannels == 2 && inputs[0] == inputs[1] && kernel_->getNumChannels() == 1)
+    numChannels = 1;
+  numChannels_ = numChannels;
+
+  if (zeroLatency_)
+    addZeroLatency(inputs, numFrames, numChannels);
+  else
+    addBlocked(inputs, numFrames, numChannels);
+}
+
+void PffftConvolutionEngine::addBlocked(const Sample* const* inputs, int numFrames,
+                                        int numChannels)
+{
+  int offset = 0;
+  while (offset < numFrames)
+  {
+    const int count = std::min(numFrames - offset, blockSize_ - blockPos_);
+    for (int c = 0; c < numChannels; ++c)
+      std::copy(inputs[c] + offset, inputs[c] + offset + count,
+                blockInput_[c].data() + blockPos_);
+
+    offset += count;
+    blockPos_ += count;
+    if (blockPos_ == blockSize_)
+    {
+      processBlock(numChannels);
+      blockPos_ = 0;
+    }
+  }
+}
+
+void PffftConvolutionEngine::addZeroLatency(const Sample* const* inputs, int numFrames,
+                                            int numChannels)
+{
+  reserveQueue(static_cast<size_t>(numFrames));
+
+  const auto block = static_cast<size_t>(blockSize_);
+  for (int i = 0; i < numFrames; ++i)
+  {
+    const auto pos = static_cast<size_t>(blockPos_);
+    const auto historyPos = static_cast<size_t>(historyPos_);
+    for (int c = 0; c < numChannels; ++c)
+    {
+      if (silentOutputs_[c])
+      {
+        queue_[c][queueEnd_ + static_cast<size_t>(i)] = 0.0f;
+        continue;
+      }
+
+      const Sample x = inputs[c][i];
+      history_[c][historyPos] = x;
+      history_[c][historyPos + block] = x;
+      blockInput_[c][pos] = x;
+
+      const Sample* window = history_[c].data() + historyPos + 1;
+      const Sample* taps = headTaps_[c].data();
+
+      // Four partial sums break the dependency chain; block is a multiple of 16.
+      Sample acc0 = 0.0f;
+      Sample acc1 = 0.0f;
+      Sample acc2 = 0.0f;
+      Sample acc3 = 0.0f;
+      for (size_t j = 0; j < block; j += 4)
+      {
+        acc0 += taps[j] * window[j];
+        acc1 += taps[j + 1] * window[j + 1];
+        acc2 += taps[j + 2] * window[j + 2];
+        acc3 += taps[j + 3] * window[j + 3];
+      }
+
+      queue_[c][queueEnd_ + static_cast<size_t>(i)] =
+          (acc0 + acc1) + (acc2 + acc3) + blockOutput_[c][pos];
+    }
+
+    historyPos_ = (historyPos_ + 1 == blockSize_) ? 0 : historyPos_ + 1;
+    if (++blockPos_ == blockSize_)
+    {
+      processTail(numChannels);
+      blockPos_ = 0;
+    }
+  }
+
+  queueEnd_ += static_cast<size_t>(numFrames);
+}
+
+void PffftConvolutionEngine::processBlock(int numChannels)
+{
+  const int kernelChannels = kernel_->getNumChannels();
+  const auto block = static_cast<size_t>(blockSize_);
+  reserveQueue(block);
+
+  for (int c = 0; c < numChannels; ++c)
+  {
+    Sample* output = queue_[c].data() + queueEnd_;
+    if (silentOutputs_[c])
+    {
+      std::fill(output, output + block, 0.0f);
+      continue;
+    }
+
+    PartitionedConvolver& convolver = convolvers_[c];
+    convolver.pushBlock(blockInput_[c].data());
+    convolver.accumulate(*kernel_, std::min(c, kernelChannels - 1), 1.0f, 0);
+    convolver.finish(0, output);
+  }
+
+  if (tailWorker_)
+  {
+    const Sample* inputs[MaxChannels] = {blockInput_[0].data(), blockInput_[1].data()};
+    Sample* outputs[MaxChannels] = {queue_[0].data() + queueEnd_, queue_[1].data() + queueEnd_};
+    tailWorker_->push(inputs, numChannels);
+    tailWorker_->pop(outputs, numChannels);
+  }
+  queueEnd_ += block;
+}
+
+void PffftConvolutionEngine::processTail(int numChannels)
+{
+  // blockOutput_ receives the tail for the next block, added to the head per sample.
+  const int kernelChannels = kernel_->getNumChannels();
+  for (int c = 0; c < numChannels; ++c)
+  {
+    if (silentOutputs_[c])
+      continue;
+
+    PartitionedConvolver& convolver = convolvers_[c];
+    convolver.pushBlock(blockInput_[c].data());
+    convolver.accumulateTail(*kernel_, std::min(c, kernelChannels - 1), 1.0f, 0);
+    convolver.finish(0, blockOutput_[c].data());
+  }
+
+  if (tailWorker_)
+  {
+    const Sample* inputs[MaxChannels] = {blockInput_[0].data(), blockInput_[1].data()};
+    Sample* outputs[MaxChannels] = {blockOutput_[0].data(), blockOutput_[1].data()};
+    tailWorker_->push(inputs, numChannels);
+    tailWorker_->pop(outputs, numChannels);
+  }
+}
+
+void PffftConvolutionEngine::reserveQueue(size_t numFrames)
+{
+  if (queueEnd_ + numFrames <= queue_[0].size())
+    return;
+
+  // Compact first; only grow if the host consumes less than it adds.
+  const size_t queued = queueEnd_ - queueStart_;
+  for (int c = 0; c < MaxChannels; ++c)
+  {
+    std::copy(queue_[c].begin() + static_cast<std::ptrdiff_t>(queueStart_),
+              queue_[c].begin() + static_cast<std::ptrdiff_t>(queueEnd_), queue_[c].begin());
+    if (queued + numFrames > queue_[c].size())
+      queue_[c].resize(2 * (queued + numFrames), 0.0f);
+  }
+  queueStart_ = 0;
+  queueEnd_ = queued;
+}
+
+int PffftConvolutionEngine::avail(int /*wantFrames*/)
+{
+  return static_cast<int>(queueEnd_ - queueStart_);
+}
+
+Sample** PffftConvolutionEngine::get()
+{
+  outputPtrs_[0] = queue_[0].data() + queueStart_;
+  outputPtrs_[1] = numChannels_ == 2 ? queue_[1].data() + queueStart_ : outputPtrs_[0];
+  return outputPtrs_;
+}
+
+void PffftConvolutionEngine::advance(int numFrames)
+{
+  if (numFrames <= 0)
+    return;
+
+  queueStart_ = std::min(queueEnd_, queueStart_ + static_cast<size_t>(numFrames));
+  if (queueStart_ == queueEnd_)
+    queueStart_ = queueEnd_ = 0;
+}
+
+}  // namespace octob
@@ -0,0 +1,217 @@
+#include "octobir-core/TailWorker.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+namespace octob
+{
+
+constexpr int TailWorker::MaxChannels;
+
+namespace
+{
+
+// Upper bound on how long the worker sleeps between checks. push() notifies without
+// taking the lock, so a wakeup can be missed; this caps the cost of one.
+constexpr std::chrono::milliseconds WakeInterval(1);
+
+}  // namespace
+
+TailWorker::~TailWorker()
+{
+  stop();
+}
+
+bool TailWorker::prepare(std::shared_ptr<const ConvolutionKernel> kernel, int firstPartition,
+                         int leadBlocks, bool threaded)
+{
+  stop();
+  kernel_.reset();
+
+  if (!kernel || firstPartition <= 0 || firstPartition >= kernel->getNumPartitions() ||
+      leadBlocks <= 0)
+    return false;
+
+  const int blockSize = kernel->getBlockSize();
+  const int partitions = kernel->getNumPartitions() - firstPartition;
+  for (int c = 0; c < MaxChannels; ++c)
+    if (!convolvers_[c].prepare(blockSize, partitions, 1))
+      return false;
+
+  // At most leadBlocks jobs are ever outstanding: each push is followed by a pop.
+  const auto capacity = static_cast<size_t>(leadBlocks) + 1;
+  const auto block = static_cast<size_t>(blockSize);
+  for (SpscRing<Block>* ring : {&jobs_, &results_})
+    for (Block& slot : ring->prepare(capacity))
+      for (auto& samples : slot.samples)
+        samples.assign(block, 0.0f);
+
+  kernel_ = std::move(kernel);
+  firstPartition_ = firstPartition;
+  leadBlocks_ = leadBlocks;
+  leadRemaining_ = leadBlocks;
+  submitted_.store(0, std::memory_order_relaxed);
+  completed_.store(0, std::memory_order_relaxed);
+  missedDeadlines_.store(0, std::memory_order_relaxed);
+
+  if (threaded)
+  {
+    stopping_.store(false, std::memory_order_relaxed);
+    thread_ = std::thread(&TailWorker::run, this);
+  }
+  return true;
+}
+
+void TailWorker::stop()
+{
+  if (!thread_.joinable())
+    return;
+
+  stopping_.store(true, std::memory_order_release);
+  wake_.notify_one();
+  thread_.join();
+}
+
+void TailWorker::reset()
+{
+  if (!isPrepared())
+    return;
+
+  // Drain the job ring, helping the worker along; it then only polls the empty ring
+  // until the next push.
+  while (completed_.load(std::memory_order_acquire) != submitted_.load(std::memory_order_relaxed))
+  {
+    processPending();
+    std::this_thread::yield();
+  }
+
+  while (results_.beginRead() != nullptr)
+    results_.endRead();
+  for (auto& convolver : convolvers_)
+    convolver.reset();
+  leadRemaining_ = leadBlocks_;
+}
+
+void TailWorker::push(const Sample* const* blocks, int numChannels)
+{
+  Block* job = jobs_.beginWrite();
+  if (job == nullptr)
+    return;
+
+  const auto block = static_cast<size_t>(kernel_->getBlockSize());
+  job->numChannels = numChannels;
+  for (int c = 0; c < numChannels; ++c)
+    std::copy(blocks[c], blocks[c] + block, job->samples[c].begin());
+  jobs_.endWrite();
+  submitted_.fetch_add(1, std::memory_order_relaxed);
+
+  if (thread_.joinable())
+    wake_.notify_one();
+  else
+    processPending();
+}
+
+void TailWorker::pop(Sample* const* outputs, int numChannels)
+{
+  if (leadRemaining_ > 0)
+  {
+    --leadRemaining_;
+    return;
+  }
+
+  Block* result = results_.beginRead();
+  if (result == nullptr)
+  {
+    // Late: the due job is the oldest outstanding one, so it is either queued, and run
+    // here, or the job the worker is running, and waited for.
+    missedDeadlines_.fetch_add(1, std::memory_order_relaxed);
+    while ((result = results_.beginRead()) == nullptr)
+    {
+      if (busy_.exchange(true, std::memory_order_acquire))
+      {
+        std::this_thread::yield();
+        continue;
+      }
+      const bool ran = processNext();
+      busy_.store(false, std::memory_order_release);
+      // Nothing queued and nothing running: the job was never submitted.
+      if (!ran && (result = results_.beginRead()) == nullptr)
+        return;
+    }
+  }
+
+  const auto block = static_cast<size_t>(kernel_->getBlockSize());
+  for (int c = 0; c < std::min(numChannels, result->numChannels); ++c)
+  {
+    const Sample* tail = result->samples[c].data();
+    for (size_t i = 0; i < block; ++i)
+      outputs[c][i] += tail[i];
+  }
+  results_.endRead();
+}
+
+void TailWorker::run()
+{
+  while (!stopping_.load(std::memory_order_acquire))
+  {
+    processPending();
+
+    std::unique_lock<std::mutex> lock(wakeMutex_);
+    wake_.wait_for(lock, WakeInterval,
+                   [this]
+                   {
+                     return stopping_.load(std::memory_order_acquire) ||
+                            completed_.load(std::memory_order_relaxed) !=
+                                submitted_.load(std::memory_order_relaxed);
+                   });
+  }
+}
+
+// Runs queued jobs until the ring is empty. The claim is taken per job, so a late pop()
+// can step in between two of them; while pop() holds it, this returns.
+void TailWorker::processPending()
+{
+  while (!busy_.exchange(true, std::memory_order_acquire))
+  {
+    const bool ran = processNext();
+    busy_.store(false, std::memory_order_release);
+    if (!ran)
+      return;
+  }
+}
+
+// Runs the oldest queued job. The caller holds busy_. Returns false if there was none.
+bool TailWorker::processNext()
+{
+  Block* job = jobs_.beginRead();
+  if (job == nullptr)
+    return false;
+
+  // Never full while every push() is paired with a pop(); otherwise the job stays queued.
+  Block* result = results_.beginWrite();
+  if (result == nullptr)
+    return false;
+
+  const int kernelChannels = kernel_->getNumChannels();
+  result->numChannels = job->numChannels;
+  for (int c = 0; c < job->numChannels; ++c)
+  {
+    const int kernelChannel = std::min(c, kernelChannels - 1);
+    if (kernel_->isChannelSilent(kernelChannel))
+    {
+      std::fill(result->samples[c].begin(), result->samples[c].end(), 0.0f);
+      continue;
+    }
+
+    PartitionedConvolver& convolver = convolvers_[c];
+    convolver.pushBlock(job->samples[c].data());
+    convolver.accumulateFrom(*kernel_, kernelChannel, 1.0f, 0, firstPartition_);
+    convolver.finish(0, result->samples[c].data());
+  }
+  jobs_.endRead();
+  results_.endWrite();
+  completed_.fetch_add(1, std::memory_order_release);
+  return true;
+}
+
+}  // namespace octob
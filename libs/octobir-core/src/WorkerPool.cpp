@@ -0,0 +1,61 @@
+#include "octobir-core/WorkerPool.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace octob
+{
+
+WorkerPool::WorkerPool(int numThreads)
+{
+  numThreads = std::max(1, numThreads);
+  threads_.reserve(static_cast<size_t>(numThreads));
+  for (int i = 0; i < numThreads; ++i)
+    threads_.emplace_back(&WorkerPool::run, this);
+}
+
+WorkerPool::~WorkerPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  wake_.notify_all();
+  for (auto& thread : threads_)
+    thread.join();
+}
+
+WorkerPool& WorkerPool::getShared()
+{
+  static WorkerPool pool(DefaultNumThreads);
+  return pool;
+}
+
+void WorkerPool::submit(std::function<void()> task)
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    tasks_.push_back(std::move(task));
+  }
+  wake_.notify_one();
+}
+
+void WorkerPool::run()
+{
+  for (;;)
+  {
+    std::function<void()> task;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      wake_.wait(lock, [this] { return stopping_ || !tasks_.empty(); });
+      if (tasks_.empty())
+        return;
+
+      task = std::move(tasks_.front());
+      tasks_.pop_front();
+    }
+    task();
+  }
+}
+
+}  // namespace octob
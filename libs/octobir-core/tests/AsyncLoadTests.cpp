@@ -0,0 +1,347 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "octobir-core/IRProcessor.hpp"
+#include "octobir-core/WorkerPool.hpp"
+
+using namespace octob;
+
+static const std::string kIrAPath = std::string(TEST_DATA_DIR) + "/INPUT_ir_a.wav";
+static const std::string kIrBPath = std::string(TEST_DATA_DIR) + "/INPUT_ir_b.wav";
+
+namespace
+{
+
+// Collects load completions from worker threads.
+class CompletionLog
+{
+ public:
+  IRLoadCallback callback()
+  {
+    return [this](const IRLoadCompletion& completion)
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      completions_.push_back(completion);
+      changed_.notify_all();
+    };
+  }
+
+  bool waitFor(size_t count)
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return changed_.wait_for(lock, std::chrono::seconds(30),
+                             [&] { return completions_.size() >= count; });
+  }
+
+  std::vector<IRLoadCompletion> get()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return completions_;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable changed_;
+  std::vector<IRLoadCompletion> completions_;
+};
+
+// Occupies every shared worker until released, so requests queue up behind it.
+class PoolGate
+{
+ public:
+  PoolGate() : numTasks_(WorkerPool::getShared().getNumThreads())
+  {
+    for (int i = 0; i < numTasks_; ++i)
+      WorkerPool::getShared().submit(
+          [this]
+          {
+            std::unique_lock<std::mutex> lock(mutex_);
+            opened_.wait(lock, [this] { return open_; });
+            ++finished_;
+            opened_.notify_all();
+          });
+  }
+
+  // Waits for the blocking tasks, which may not have started yet, to leave the gate.
+  ~PoolGate()
+  {
+    release();
+    std::unique_lock<std::mutex> lock(mutex_);
+    opened_.wait(lock, [this] { return finished_ == numTasks_; });
+  }
+
+  void release()
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      open_ = true;
+    }
+    opened_.notify_all();
+  }
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable opened_;
+  bool open_ = false;
+  int numTasks_;
+  int finished_ = 0;
+};
+
+// Prefetches report nothing back; poll for the slot to hold count prepared files.
+bool waitForPrefetched(const IRProcessor& processor, int slot, size_t count)
+{
+  for (int i = 0; i < 3000 && processor.getNumPrefetched(slot) < count; ++i)
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  return processor.getNumPrefetched(slot) >= count;
+}
+
+}  // namespace
+
+class AsyncLoadTest : public ::testing::Test
+{
+ protected:
+  void SetUp() override
+  {
+    processor.setSampleRate(48000.0);
+    processor.setMaxBlockSize(kBlockSize);
+  }
+
+  std::vector<Sample> renderImpulse(IRProcessor& target)
+  {
+    std::vector<Sample> input(kBlockSize * 16, 0.0f);
+    input[0] = 1.0f;
+    std::vector<Sample> output(input.size(), 0.0f);
+    for (size_t offset = 0; offset < input.size(); offset += kBlockSize)
+      target.processMono(input.data() + offset, output.data() + offset, kBlockSize);
+    return output;
+  }
+
+  static constexpr int kBlockSize = 256;
+  IRProcessor processor;
+};
+
+TEST_F(AsyncLoadTest, RequestStagesIRLikeSynchronousLoad)
+{
+  CompletionLog log;
+  const IRLoadTicket ticket = processor.requestLoad(1, kIrAPath, log.callback());
+  EXPECT_NE(ticket, 0u);
+  ASSERT_TRUE(log.waitFor(1));
+
+  const auto completion = log.get()[0];
+  EXPECT_EQ(completion.ticket, ticket);
+  EXPECT_EQ(completion.slot, 1);
+  EXPECT_EQ(completion.status, IRLoadStatus::Loaded);
+  EXPECT_EQ(completion.filepath, kIrAPath);
+  EXPECT_TRUE(completion.errorMessage.empty());
+  EXPECT_EQ(processor.getCurrentIR1Path(), kIrAPath);
+
+  IRProcessor reference;
+  reference.setSampleRate(48000.0);
+  reference.setMaxBlockSize(kBlockSize);
+  std::string error;
+  ASSERT_TRUE(reference.loadImpulseResponse1(kIrAPath, error)) << error;
+
+  EXPECT_EQ(renderImpulse(processor), renderImpulse(reference));
+  EXPECT_TRUE(processor.isIR1Loaded());
+}
+
+TEST_F(AsyncLoadTest, FailedRequestReportsErrorAndKeepsSlot)
+{
+  std::string error;
+  ASSERT_TRUE(processor.loadImpulseResponse2(kIrBPath, error)) << error;
+
+  CompletionLog log;
+  processor.requestLoad(2, "/nonexistent/file.wav", log.callback());
+  ASSERT_TRUE(log.waitFor(1));
+
+  EXPECT_EQ(log.get()[0].status, IRLoadStatus::Failed);
+  EXPECT_FALSE(log.get()[0].errorMessage.empty());
+  EXPECT_EQ(processor.getCurrentIR2Path(), kIrBPath);
+}
+
+TEST_F(AsyncLoadTest, InvalidSlotIsRejected)
+{
+  CompletionLog log;
+  EXPECT_EQ(processor.requestLoad(3, kIrAPath, log.callback()), 0u);
+  EXPECT_EQ(processor.requestLoad(0, kIrAPath, log.callback()), 0u);
+  processor.cancelPendingLoads();
+  EXPECT_TRUE(log.get().empty());
+}
+
+// Rapid "next" clicks: only the last request for a slot is staged.
+TEST_F(AsyncLoadTest, LaterRequestSupersedesQueuedOnes)
+{
+  CompletionLog log;
+  const std::vector<std::string> paths = {kIrAPath, kIrBPath, kIrAPath, kIrBPath};
+  IRLoadTicket last = 0;
+  {
+    PoolGate gate;
+    for (const auto& path : paths)
+      last = processor.requestLoad(1, path, log.callback());
+  }
+  ASSERT_TRUE(log.waitFor(paths.size()));
+
+  for (const auto& completion : log.get())
+  {
+    if (completion.ticket == last)
+      EXPECT_EQ(completion.status, IRLoadStatus::Loaded);
+    else
+      EXPECT_EQ(completion.status, IRLoadStatus::Cancelled);
+  }
+  EXPECT_EQ(processor.getCurrentIR1Path(), kIrBPath);
+}
+
+TEST_F(AsyncLoadTest, ClearAndSynchronousLoadSupersedeRequests)
+{
+  CompletionLog log;
+  {
+    PoolGate gate;
+    processor.requestLoad(1, kIrAPath, log.callback());
+    processor.clearImpulseResponse1();
+
+    processor.requestLoad(2, kIrAPath, log.callback());
+    std::string error;
+    ASSERT_TRUE(processor.loadImpulseResponse2(kIrBPath, error)) << error;
+  }
+  ASSERT_TRUE(log.waitFor(2));
+
+  for (const auto& completion : log.get())
+    EXPECT_EQ(completion.status, IRLoadStatus::Cancelled);
+  EXPECT_TRUE(processor.getCurrentIR1Path().empty());
+  EXPECT_EQ(processor.getCurrentIR2Path(), kIrBPath);
+}
+
+// A request queued before a sample-rate change loads the IR at the new rate.
+TEST_F(AsyncLoadTest, RequestFollowsSampleRateChange)
+{
+  CompletionLog log;
+  {
+    PoolGate gate;
+    processor.requestLoad(1, kIrAPath, log.callback());
+    processor.setSampleRate(96000.0);
+  }
+  ASSERT_TRUE(log.waitFor(1));
+  ASSERT_EQ(log.get()[0].status, IRLoadStatus::Loaded);
+
+  IRProcessor reference;
+  reference.setSampleRate(96000.0);
+  reference.setMaxBlockSize(kBlockSize);
+  std::string error;
+  ASSERT_TRUE(reference.loadImpulseResponse1(kIrAPath, error)) << error;
+
+  EXPECT_EQ(renderImpulse(processor), renderImpulse(reference));
+}
+
+// Destroying a processor cancels its queued requests and returns once they have
+// called back.
+TEST_F(AsyncLoadTest, DestructionCancelsAndWaitsForRequests)
+{
+  CompletionLog log;
+  {
+    PoolGate gate;
+    std::unique_ptr<IRProcessor> transient(new IRProcessor());
+    transient->requestLoad(1, kIrAPath, log.callback());
+    transient->requestLoad(2, kIrBPath, log.callback());
+
+    std::thread opener(
+        [&gate]
+        {
+          std::this_thread::sleep_for(std::chrono::milliseconds(50));
+          gate.release();
+        });
+    transient.reset();
+    opener.join();
+    EXPECT_EQ(log.get().size(), 2u);
+  }
+
+  for (const auto& completion : log.get())
+    EXPECT_EQ(completion.status, IRLoadStatus::Cancelled);
+}
+
+// A prefetched file is staged on the requesting thread, with the same result as a cold load.
+TEST_F(AsyncLoadTest, RequestSwapsInPrefetchedIR)
+{
+  processor.prefetchImpulseResponses(1, {kIrAPath, kIrBPath});
+  ASSERT_TRUE(waitForPrefetched(processor, 1, 2));
+  EXPECT_GT(processor.getPrefetchedBytes(), 0u);
+
+  CompletionLog log;
+  {
+    PoolGate gate;
+    processor.requestLoad(1, kIrBPath, log.callback());
+    EXPECT_EQ(processor.getCurrentIR1Path(), kIrBPath);
+  }
+  ASSERT_TRUE(log.waitFor(1));
+  EXPECT_EQ(log.get()[0].status, IRLoadStatus::Loaded);
+  EXPECT_EQ(processor.getNumPrefetched(1), 1u);
+
+  IRProcessor reference;
+  reference.setSampleRate(48000.0);
+  reference.setMaxBlockSize(kBlockSize);
+  std::string error;
+  ASSERT_TRUE(reference.loadImpulseResponse1(kIrBPath, error)) << error;
+
+  EXPECT_EQ(renderImpulse(processor), renderImpulse(reference));
+}
+
+// Preparations made before an engine change are not swapped in; the load runs cold.
+TEST_F(AsyncLoadTest, PrefetchIsIgnoredAfterEngineChange)
+{
+  processor.prefetchImpulseResponses(1, {kIrAPath});
+  ASSERT_TRUE(waitForPrefetched(processor, 1, 1));
+  processor.setIRAEngine(ConvolutionEngineType::Pffft);
+
+  std::string error;
+  ASSERT_TRUE(processor.loadImpulseResponse1(kIrAPath, error)) << error;
+  EXPECT_EQ(processor.getNumPrefetched(1), 0u);
+  EXPECT_EQ(processor.getPrefetchedBytes(), 0u);
+
+  IRProcessor reference;
+  reference.setSampleRate(48000.0);
+  reference.setMaxBlockSize(kBlockSize);
+  reference.setIRAEngine(ConvolutionEngineType::Pffft);
+  ASSERT_TRUE(reference.loadImpulseResponse1(kIrAPath, error)) << error;
+
+  EXPECT_EQ(processor.getStagedLatencySamples(), reference.getStagedLatencySamples());
+  EXPECT_EQ(renderImpulse(processor), renderImpulse(reference));
+}
+
+TEST_F(AsyncLoadTest, PrefetchStaysWithinBudget)
+{
+  IRProcessor unlimited;
+  unlimited.setSampleRate(48000.0);
+  unlimited.prefetchImpulseResponses(1, {kIrAPath});
+  ASSERT_TRUE(waitForPrefetched(unlimited, 1, 1));
+  const size_t bytesA = unlimited.getPrefetchedBytes();
+
+  processor.setPrefetchBudget(bytesA);
+  processor.prefetchImpulseResponses(1, {kIrAPath, kIrBPath});
+  ASSERT_TRUE(waitForPrefetched(processor, 1, 1));
+  processor.cancelPendingLoads();
+  EXPECT_EQ(processor.getNumPrefetched(1), 1u);
+  EXPECT_EQ(processor.getPrefetchedBytes(), bytesA);
+
+  // An empty set releases everything the slot holds.
+  processor.prefetchImpulseResponses(1, {});
+  EXPECT_EQ(processor.getNumPrefetched(1), 0u);
+  EXPECT_EQ(processor.getPrefetchedBytes(), 0u);
+}
+
+TEST(NeighboringFilesTest, NearestFirstAndWrapping)
+{
+  const std::vector<std::string> files = {"a", "b", "c", "d", "e"};
+  EXPECT_EQ(IRProcessor::neighboringFiles(files, 0, 2),
+            (std::vector<std::string>{"b", "e", "c", "d"}));
+  EXPECT_EQ(IRProcessor::neighboringFiles(files, 2, 1), (std::vector<std::string>{"d", "b"}));
+  // Radius beyond the folder: each other file once.
+  EXPECT_EQ(IRProcessor::neighboringFiles({"a", "b"}, 0, 3), (std::vector<std::string>{"b"}));
+  EXPECT_TRUE(IRProcessor::neighboringFiles(files, 5, 2).empty());
+  EXPECT_TRUE(IRProcessor::neighboringFiles(files, 1, 0).empty());
+}
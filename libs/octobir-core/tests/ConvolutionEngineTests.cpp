@@ -0,0 +1,603 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "octobir-core/ConvolutionCostModel.hpp"
+#include "octobir-core/ConvolutionKernel.hpp"
+#include "octobir-core/DirectConvolutionEngine.hpp"
+#include "octobir-core/IRProcessor.hpp"
+#include "octobir-core/PffftConvolutionEngine.hpp"
+#include "octobir-core/TailWorker.hpp"
+
+using namespace octob;
+
+namespace
+{
+
+constexpr int kBlock = 64;
+
+std::vector<float> randomSignal(size_t length, unsigned int seed)
+{
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+  std::vector<float> signal(length);
+  for (auto& s : signal)
+    s = dist(rng);
+  return signal;
+}
+
+std::vector<float> directConvolution(const std::vector<float>& input, const std::vector<float>& ir)
+{
+  std::vector<float> output(input.size(), 0.0f);
+  for (size_t n = 0; n < input.size(); ++n)
+  {
+    double acc = 0.0;
+    for (size_t k = 0; k < ir.size() && k <= n; ++k)
+      acc += static_cast<double>(ir[k]) * input[n - k];
+    output[n] = static_cast<float>(acc);
+  }
+  return output;
+}
+
+std::shared_ptr<const ConvolutionKernel> makeKernel(const std::vector<std::vector<float>>& channels)
+{
+  std::vector<const float*> ptrs;
+  for (const auto& ch : channels)
+    ptrs.push_back(ch.data());
+  return ConvolutionKernel::create(ptrs.data(), static_cast<int>(ptrs.size()),
+                                   channels[0].size(), kBlock);
+}
+
+const std::vector<int> kHostBlocks = {1, 7, 64, 100, 13, 128, 3, 250};
+
+}  // namespace
+
+TEST(ConvolutionEngineTest, PffftSetKernelRejectsMissingKernel)
+{
+  PffftConvolutionEngine engine;
+  EXPECT_LT(engine.setKernel(nullptr), 0);
+  EXPECT_EQ(engine.setKernel(makeKernel({randomSignal(100, 1)})), kBlock);
+}
+
+TEST(ConvolutionEngineTest, PffftMatchesDirectConvolutionDelayedByOneBlock)
+{
+  const auto irL = randomSignal(700, 2);
+  const auto irR = randomSignal(700, 3);
+  const auto inL = randomSignal(5000, 4);
+  const auto inR = randomSignal(5000, 5);
+
+  PffftConvolutionEngine engine;
+  const int latency = engine.setKernel(makeKernel({irL, irR}));
+  ASSERT_EQ(latency, kBlock);
+
+  std::vector<float> outL(inL.size());
+  std::vector<float> outR(inR.size());
+  size_t offset = 0;
+  for (size_t b = 0; offset < inL.size(); ++b)
+  {
+    const int n = static_cast<int>(
+        std::min(static_cast<size_t>(kHostBlocks[b % kHostBlocks.size()]), inL.size() - offset));
+    const float* inputs[] = {inL.data() + offset, inR.data() + offset};
+    engine.add(inputs, n, 2);
+    ASSERT_GE(engine.avail(n), n);
+
+    Sample** outputs = engine.get();
+    std::copy(outputs[0], outputs[0] + n, outL.data() + offset);
+    std::copy(outputs[1], outputs[1] + n, outR.data() + offset);
+    engine.advance(n);
+    offset += static_cast<size_t>(n);
+  }
+
+  const auto expectedL = directConvolution(inL, irL);
+  const auto expectedR = directConvolution(inR, irR);
+  for (size_t i = 0; i < outL.size(); ++i)
+  {
+    const float wantL = i < static_cast<size_t>(latency) ? 0.0f : expectedL[i - latency];
+    const float wantR = i < static_cast<size_t>(latency) ? 0.0f : expectedR[i - latency];
+    ASSERT_NEAR(outL[i], wantL, 1e-3f) << "sample " << i;
+    ASSERT_NEAR(outR[i], wantR, 1e-3f) << "sample " << i;
+  }
+}
+
+TEST(ConvolutionEngineTest, PffftZeroLatencyMatchesDirectConvolution)
+{
+  const auto irL = randomSignal(700, 9);
+  const auto irR = randomSignal(40, 10);
+  const auto inL = randomSignal(5000, 11);
+  const auto inR = randomSignal(5000, 12);
+
+  // irR is shorter than one block: the whole kernel lives in the direct-form head.
+  std::vector<float> paddedR(irL.size(), 0.0f);
+  std::copy(irR.begin(), irR.end(), paddedR.begin());
+
+  PffftConvolutionEngine engine(kBlock, true);
+  ASSERT_EQ(engine.setKernel(makeKernel({irL, paddedR})), 0);
+
+  std::vector<float> outL(inL.size());
+  std::vector<float> outR(inR.size());
+  size_t offset = 0;
+  for (size_t b = 0; offset < inL.size(); ++b)
+  {
+    const int n = static_cast<int>(
+        std::min(static_cast<size_t>(kHostBlocks[b % kHostBlocks.size()]), inL.size() - offset));
+    const float* inputs[] = {inL.data() + offset, inR.data() + offset};
+    engine.add(inputs, n, 2);
+    ASSERT_EQ(engine.avail(n), n);
+
+    Sample** outputs = engine.get();
+    std::copy(outputs[0], outputs[0] + n, outL.data() + offset);
+    std::copy(outputs[1], outputs[1] + n, outR.data() + offset);
+    engine.advance(n);
+    offset += static_cast<size_t>(n);
+  }
+
+  const auto expectedL = directConvolution(inL, irL);
+  const auto expectedR = directConvolution(inR, irR);
+  for (size_t i = 0; i < outL.size(); ++i)
+  {
+    ASSERT_NEAR(outL[i], expectedL[i], 1e-3f) << "sample " << i;
+    ASSERT_NEAR(outR[i], expectedR[i], 1e-3f) << "sample " << i;
+  }
+}
+
+TEST(ConvolutionEngineTest, PffftCollapsesIdenticalInputsForMonoKernel)
+{
+  const auto input = randomSignal(512, 6);
+  PffftConvolutionEngine engine;
+  ASSERT_EQ(engine.setKernel(makeKernel({randomSignal(300, 7)})), kBlock);
+
+  const float* inputs[] = {input.data(), input.data()};
+  engine.add(inputs, static_cast<int>(input.size()), 2);
+  Sample** outputs = engine.get();
+  EXPECT_EQ(outputs[0], outputs[1]);
+}
+
+// The empty right channel is not convolved: its output is exact silence in both modes.
+TEST(ConvolutionEngineTest, PffftSkipsSilentKernelChannel)
+{
+  const auto irL = randomSignal(700, 13);
+  const std::vector<float> irR(irL.size(), 0.0f);
+  const auto input = randomSignal(3000, 14);
+  const auto expected = directConvolution(input, irL);
+
+  for (bool zeroLatency : {false, true})
+  {
+    PffftConvolutionEngine engine(kBlock, zeroLatency);
+    const int latency = engine.setKernel(makeKernel({irL, irR}));
+    ASSERT_EQ(latency, zeroLatency ? 0 : kBlock);
+
+    const float* inputs[] = {input.data(), input.data()};
+    engine.add(inputs, static_cast<int>(input.size()), 2);
+    ASSERT_GE(engine.avail(0), static_cast<int>(input.size()));
+    Sample** outputs = engine.get();
+    for (size_t i = 0; i < input.size(); ++i)
+    {
+      const float want = i >= static_cast<size_t>(latency) ? expected[i - latency] : 0.0f;
+      ASSERT_NEAR(outputs[0][i], want, 1e-3f) << "sample " << i;
+      ASSERT_EQ(outputs[1][i], 0.0f) << "sample " << i;
+    }
+  }
+}
+
+TEST(ConvolutionEngineTest, IRProcessorReportsKernelDiagnostics)
+{
+  IRProcessor processor;
+  processor.setSampleRate(48000.0);
+  processor.setIRAEngine(ConvolutionEngineType::Pffft);
+  EXPECT_EQ(processor.getIR1KernelDiagnostics().numPartitions, 0);
+
+  std::string error;
+  ASSERT_TRUE(processor.loadImpulseResponse1(std::string(TEST_DATA_DIR) + "/INPUT_ir_a.wav", error))
+      << error;
+  const KernelDiagnostics diagnostics = processor.getIR1KernelDiagnostics();
+  EXPECT_EQ(diagnostics.numChannels, processor.getNumIR1Channels());
+  EXPECT_GT(diagnostics.numPartitions, 0);
+  EXPECT_LT(diagnostics.numSilentPartitions, diagnostics.numPartitions * diagnostics.numChannels);
+  EXPECT_FALSE(diagnostics.monoFallback);
+  EXPECT_EQ(processor.getIR2KernelDiagnostics().numPartitions, 0);
+}
+
+// The diagnostics describe what the kernel lets its convolver skip, so a slot the kernel
+// does not convolve reports none, and the shared-spectrum blend reports both slots.
+TEST(ConvolutionEngineTest, IRProcessorReportsKernelDiagnosticsOnlyWhileTheKernelIsUsed)
+{
+  IRProcessor processor;
+  processor.setSampleRate(48000.0);
+  processor.setIRAEngine(ConvolutionEngineType::Wdl);
+  processor.setIRBEngine(ConvolutionEngineType::Direct);
+
+  std::string error;
+  ASSERT_TRUE(processor.loadImpulseResponse1(std::string(TEST_DATA_DIR) + "/INPUT_ir_a.wav", error))
+      << error;
+  ASSERT_TRUE(processor.loadImpulseResponse2(std::string(TEST_DATA_DIR) + "/INPUT_ir_b.wav", error))
+      << error;
+  EXPECT_EQ(processor.getIR1KernelDiagnostics().numPartitions, 0);
+  EXPECT_EQ(processor.getIR2KernelDiagnostics().numPartitions, 0);
+
+  processor.setIRAEngine(ConvolutionEngineType::Pffft);
+  EXPECT_GT(processor.getIR1KernelDiagnostics().numPartitions, 0);
+  EXPECT_EQ(processor.getIR2KernelDiagnostics().numPartitions, 0);
+
+  processor.setIRAEngine(ConvolutionEngineType::Auto);
+  processor.setIRBEngine(ConvolutionEngineType::Auto);
+  EXPECT_GT(processor.getIR1KernelDiagnostics().numPartitions, 0);
+  EXPECT_GT(processor.getIR2KernelDiagnostics().numPartitions, 0);
+
+  processor.clearImpulseResponse2();
+  EXPECT_EQ(processor.getIR1KernelDiagnostics().numPartitions, 0)
+      << "Auto picks a zero-latency engine that does not use the kernel for one short IR";
+}
+
+TEST(ConvolutionEngineTest, IRProcessorPffftSlotReportsOneBlockOfLatency)
+{
+  IRProcessor processor;
+  processor.setSampleRate(48000.0);
+  processor.setMaxBlockSize(256);
+  EXPECT_EQ(processor.getIRAEngine(), ConvolutionEngineType::Auto);
+
+  std::string error;
+  ASSERT_TRUE(processor.loadImpulseResponse1(std::string(TEST_DATA_DIR) + "/INPUT_ir_a.wav", error))
+      << error;
+  processor.setIRAEngine(ConvolutionEngineType::Pffft);
+  EXPECT_EQ(processor.getIRAEngine(), ConvolutionEngineType::Pffft);
+
+  std::vector<float> buffer(256, 0.0f);
+  processor.processMono(buffer.data(), buffer.data(), buffer.size());
+  EXPECT_EQ(processor.getLatencySamples(), kBlock);
+
+  processor.setIRAEngine(ConvolutionEngineType::Wdl);
+  processor.processMono(buffer.data(), buffer.data(), buffer.size());
+  EXPECT_EQ(processor.getLatencySamples(), 0);
+}
+
+// Slot A on PFFFT and slot B on WDL: latency compensation must delay B so the blend
+// matches the all-WDL blend shifted by the PFFFT block.
+TEST(ConvolutionEngineTest, IRProcessorMixedEnginesStayAligned)
+{
+  const std::string irAPath = std::string(TEST_DATA_DIR) + "/INPUT_ir_a.wav";
+  const std::string irBPath = std::string(TEST_DATA_DIR) + "/INPUT_ir_b.wav";
+  constexpr FrameCount kFrames = 256;
+  const auto input = randomSignal(kFrames * 40, 8);
+
+  auto render = [&](ConvolutionEngineType engineA)
+  {
+    IRProcessor processor;
+    processor.setSampleRate(48000.0);
+    processor.setMaxBlockSize(kFrames);
+    processor.setIRAEngine(engineA);
+    std::string error;
+    EXPECT_TRUE(processor.loadImpulseResponse1(irAPath, error)) << error;
+    EXPECT_TRUE(processor.loadImpulseResponse2(irBPath, error)) << error;
+    processor.setBlend(0.0f);
+
+    std::vector<float> output(input.size());
+    for (size_t offset = 0; offset < input.size(); offset += kFrames)
+      processor.processMono(input.data() + offset, output.data() + offset, kFrames);
+    return output;
+  };
+
+  const auto reference = render(ConvolutionEngineType::Wdl);
+  const auto mixed = render(ConvolutionEngineType::Pffft);
+
+  const size_t latency = PffftConvolutionEngine::DefaultBlockSize;
+  for (size_t i = latency; i < mixed.size(); ++i)
+    ASSERT_NEAR(mixed[i], reference[i - latency], 1e-4f) << "sample " << i;
+}
+
+TEST(ConvolutionEngineTest, IRProcessorZeroLatencyModeRemovesPffftLatency)
+{
+  const std::string irAPath = std::string(TEST_DATA_DIR) + "/INPUT_ir_a.wav";
+  constexpr FrameCount kFrames = 128;
+  const auto input = randomSignal(kFrames * 40, 13);
+
+  auto render = [&](ConvolutionEngineType engine, bool zeroLatency, int& latency)
+  {
+    IRProcessor processor;
+    processor.setSampleRate(48000.0);
+    processor.setMaxBlockSize(kFrames);
+    processor.setIRAEngine(engine);
+    processor.setZeroLatencyMode(zeroLatency);
+    std::string error;
+    EXPECT_TRUE(processor.loadImpulseResponse1(irAPath, error)) << error;
+    processor.setBlend(-0.5f);
+
+    std::vector<float> output(input.size());
+    for (size_t offset = 0; offset < input.size(); offset += kFrames)
+      processor.processMono(input.data() + offset, output.data() + offset, kFrames);
+    latency = processor.getLatencySamples();
+    return output;
+  };
+
+  int wdlLatency = -1;
+  int pffftLatency = -1;
+  const auto reference = render(ConvolutionEngineType::Wdl, false, wdlLatency);
+  const auto zeroLatency = render(ConvolutionEngineType::Pffft, true, pffftLatency);
+
+  EXPECT_EQ(wdlLatency, 0);
+  EXPECT_EQ(pffftLatency, 0);
+  for (size_t i = 0; i < zeroLatency.size(); ++i)
+    ASSERT_NEAR(zeroLatency[i], reference[i], 1e-4f) << "sample " << i;
+}
+
+TEST(ConvolutionEngineTest, IRProcessorZeroLatencyModeRestagesLoadedSlots)
+{
+  IRProcessor processor;
+  processor.setSampleRate(48000.0);
+  processor.setMaxBlockSize(256);
+  processor.setIRAEngine(ConvolutionEngineType::Pffft);
+
+  std::string error;
+  ASSERT_TRUE(processor.loadImpulseResponse1(std::string(TEST_DATA_DIR) + "/INPUT_ir_a.wav", error))
+      << error;
+
+  std::vector<float> buffer(256, 0.0f);
+  processor.processMono(buffer.data(), buffer.data(), buffer.size());
+  EXPECT_EQ(processor.getLatencySamples(), kBlock);
+
+  processor.setZeroLatencyMode(true);
+  EXPECT_TRUE(processor.getZeroLatencyMode());
+  processor.processMono(buffer.data(), buffer.data(), buffer.size());
+  EXPECT_EQ(processor.getLatencySamples(), 0);
+  EXPECT_TRUE(processor.isIR1Loaded());
+}
+
+TEST(ConvolutionEngineTest, DirectMatchesDirectConvolutionWithZeroLatency)
+{
+  const auto irL = randomSignal(300, 14);
+  const auto irR = randomSignal(300, 15);
+  const auto inL = randomSignal(3000, 16);
+  const auto inR = randomSignal(3000, 17);
+
+  DirectConvolutionEngine engine;
+  const float* taps[] = {irL.data(), irR.data()};
+  ASSERT_EQ(engine.setTaps(taps, 2, irL.size()), 0);
+
+  std::vector<float> outL(inL.size());
+  std::vector<float> outR(inR.size());
+  size_t offset = 0;
+  for (size_t b = 0; offset < inL.size(); ++b)
+  {
+    const int n = static_cast<int>(
+        std::min(static_cast<size_t>(kHostBlocks[b % kHostBlocks.size()]), inL.size() - offset));
+    const float* inputs[] = {inL.data() + offset, inR.data() + offset};
+    engine.add(inputs, n, 2);
+    ASSERT_EQ(engine.avail(n), n);
+
+    Sample** outputs = engine.get();
+    std::copy(outputs[0], outputs[0] + n, outL.data() + offset);
+    std::copy(outputs[1], outputs[1] + n, outR.data() + offset);
+    engine.advance(n);
+    offset += static_cast<size_t>(n);
+  }
+
+  const auto expectedL = directConvolution(inL, irL);
+  const auto expectedR = directConvolution(inR, irR);
+  for (size_t i = 0; i < outL.size(); ++i)
+  {
+    ASSERT_NEAR(outL[i], expectedL[i], 1e-4f) << "sample " << i;
+    ASSERT_NEAR(outR[i], expectedR[i], 1e-4f) << "sample " << i;
+  }
+}
+
+TEST(ConvolutionEngineTest, CostModelPicksCheaperEngineAcrossCrossover)
+{
+  // Direct cost doubles with length, FFT cost grows slowly: crossover near 1024.
+  const ConvolutionCostModel model({{256, 10.0, 30.0}, {1024, 40.0, 40.0}, {4096, 160.0, 50.0}});
+
+  EXPECT_EQ(model.choose(128), ConvolutionEngineType::Direct);
+  EXPECT_EQ(model.choose(512), ConvolutionEngineType::Direct);
+  EXPECT_EQ(model.choose(2048), ConvolutionEngineType::Wdl);
+  EXPECT_EQ(model.choose(48000), ConvolutionEngineType::Wdl);
+
+  EXPECT_DOUBLE_EQ(model.estimateDirectNs(640), 25.0);
+  EXPECT_DOUBLE_EQ(model.estimateFftNs(512), 35.0);
+  EXPECT_DOUBLE_EQ(model.estimateDirectNs(8192), 320.0);
+  EXPECT_DOUBLE_EQ(model.estimateFftNs(8192), 50.0);
+
+  EXPECT_EQ(ConvolutionCostModel().choose(128), ConvolutionEngineType::Wdl);
+}
+
+TEST(ConvolutionEngineTest, CostModelMeasuresOncePerBlockSize)
+{
+  const auto first = ConvolutionCostModel::measure(128);
+  ASSERT_FALSE(first.isEmpty());
+  for (size_t i = 1; i < first.getPoints().size(); ++i)
+    EXPECT_GT(first.getPoints()[i].irLength, first.getPoints()[i - 1].irLength);
+  for (const auto& point : first.getPoints())
+  {
+    EXPECT_GT(point.directNs, 0.0);
+    EXPECT_GT(point.fftNs, 0.0);
+  }
+
+  const auto second = ConvolutionCostModel::measure(128);
+  ASSERT_EQ(second.getPoints().size(), first.getPoints().size());
+  for (size_t i = 0; i < first.getPoints().size(); ++i)
+    EXPECT_EQ(second.getPoints()[i].directNs, first.getPoints()[i].directNs);
+
+  EXPECT_TRUE(ConvolutionCostModel::measure(0).isEmpty());
+}
+
+// Whatever engine the cost model picks, Auto must sound like WDL and add no latency.
+TEST(ConvolutionEngineTest, IRProcessorAutoEngineMatchesWdl)
+{
+  const std::string irAPath = std::string(TEST_DATA_DIR) + "/INPUT_ir_a.wav";
+  constexpr FrameCount kFrames = 64;
+  const auto input = randomSignal(kFrames * 80, 18);
+
+  auto render = [&](ConvolutionEngineType engine, int& latency)
+  {
+    IRProcessor processor;
+    processor.setSampleRate(48000.0);
+    processor.setMaxBlockSize(kFrames);
+    processor.setIRAEngine(engine);
+    std::string error;
+    EXPECT_TRUE(processor.loadImpulseResponse1(irAPath, error)) << error;
+    processor.setBlend(-1.0f);
+
+    std::vector<float> output(input.size());
+    for (size_t offset = 0; offset < input.size(); offset += kFrames)
+      processor.processMono(input.data() + offset, output.data() + offset, kFrames);
+    latency = processor.getLatencySamples();
+    return output;
+  };
+
+  int wdlLatency = -1;
+  int autoLatency = -1;
+  const auto reference = render(ConvolutionEngineType::Wdl, wdlLatency);
+  const auto automatic = render(ConvolutionEngineType::Auto, autoLatency);
+
+  EXPECT_EQ(autoLatency, wdlLatency);
+  for (size_t i = 0; i < automatic.size(); ++i)
+    ASSERT_NEAR(automatic[i], reference[i], 1e-4f) << "sample " << i;
+}
+
+// The worker runs the same code as the inline split, only on another thread, so the two
+// must agree to the bit at every host block pattern. The split itself must match the
+// unsplit engine to rounding.
+TEST(ConvolutionEngineTest, PffftBackgroundTailIsBitIdenticalToInline)
+{
+  using TailMode = PffftConvolutionEngine::TailMode;
+
+  // About a second at 48 kHz, decaying like a room.
+  auto irL = randomSignal(48000, 19);
+  auto irR = randomSignal(48000, 20);
+  for (size_t i = 0; i < irL.size(); ++i)
+  {
+    const float decay = std::exp(-static_cast<float>(i) / 4000.0f);
+    irL[i] *= decay;
+    irR[i] *= decay;
+  }
+  const auto kernel = makeKernel({irL, irR});
+  const auto inL = randomSignal(20000, 21);
+  const auto inR = randomSignal(20000, 22);
+
+  auto render = [&](PffftConvolutionEngine& engine, std::vector<float>& outL,
+                    std::vector<float>& outR)
+  {
+    outL.assign(inL.size(), 0.0f);
+    outR.assign(inR.size(), 0.0f);
+    size_t offset = 0;
+    for (size_t b = 0; offset < inL.size(); ++b)
+    {
+      const int n = static_cast<int>(std::min(
+          static_cast<size_t>(kHostBlocks[b % kHostBlocks.size()]), inL.size() - offset));
+      const float* inputs[] = {inL.data() + offset, inR.data() + offset};
+      engine.add(inputs, n, 2);
+      ASSERT_GE(engine.avail(n), n);
+
+      Sample** outputs = engine.get();
+      std::copy(outputs[0], outputs[0] + n, outL.data() + offset);
+      std::copy(outputs[1], outputs[1] + n, outR.data() + offset);
+      engine.advance(n);
+      offset += static_cast<size_t>(n);
+    }
+  };
+
+  for (bool zeroLatency : {false, true})
+  {
+    PffftConvolutionEngine background(kBlock, zeroLatency, TailMode::Background);
+    PffftConvolutionEngine inlineTail(kBlock, zeroLatency, TailMode::Inline);
+    PffftConvolutionEngine unsplit(kBlock, zeroLatency, TailMode::AudioThread);
+    const int latency = background.setKernel(kernel);
+    ASSERT_EQ(inlineTail.setKernel(kernel), latency);
+    ASSERT_EQ(unsplit.setKernel(kernel), latency);
+    ASSERT_NE(background.getTailWorker(), nullptr);
+    EXPECT_TRUE(background.getTailWorker()->isThreaded());
+    EXPECT_FALSE(inlineTail.getTailWorker()->isThreaded());
+    EXPECT_EQ(unsplit.getTailWorker(), nullptr);
+
+    std::vector<float> bgL, bgR, inlineL, inlineR, unsplitL, unsplitR;
+    render(background, bgL, bgR);
+    render(inlineTail, inlineL, inlineR);
+    render(unsplit, unsplitL, unsplitR);
+
+    for (size_t i = 0; i < bgL.size(); ++i)
+    {
+      ASSERT_EQ(bgL[i], inlineL[i]) << "sample " << i << ", zero latency " << zeroLatency;
+      ASSERT_EQ(bgR[i], inlineR[i]) << "sample " << i << ", zero latency " << zeroLatency;
+      ASSERT_NEAR(inlineL[i], unsplitL[i], 1e-3f) << "sample " << i;
+      ASSERT_NEAR(inlineR[i], unsplitR[i], 1e-3f) << "sample " << i;
+    }
+
+    // After a reset the pipeline restarts from silence on both.
+    background.reset();
+    inlineTail.reset();
+    render(background, bgL, bgR);
+    render(inlineTail, inlineL, inlineR);
+    ASSERT_EQ(bgL, inlineL);
+    ASSERT_EQ(bgR, inlineR);
+  }
+}
+
+// With one block of lead, the result is due right after its push and is nearly always
+// late. pop() then finishes the job itself instead of spinning on the worker, and the
+// output still matches the inline worker to the bit.
+TEST(ConvolutionEngineTest, TailWorkerFinishesLateResultsOnTheCallingThread)
+{
+  const auto kernel = makeKernel({randomSignal(kBlock * 40, 25)});
+  const auto input = randomSignal(kBlock * 200, 26);
+
+  auto render = [&](TailWorker& worker)
+  {
+    std::vector<float> output(input.size(), 0.0f);
+    for (size_t offset = 0; offset < input.size(); offset += kBlock)
+    {
+      const float* blocks[] = {input.data() + offset};
+      float* outputs[] = {output.data() + offset};
+      worker.push(blocks, 1);
+      worker.pop(outputs, 1);
+    }
+    return output;
+  };
+
+  TailWorker threaded;
+  TailWorker inlineWorker;
+  ASSERT_TRUE(threaded.prepare(kernel, 1, 1, true));
+  ASSERT_TRUE(inlineWorker.prepare(kernel, 1, 1, false));
+  const auto expected = render(inlineWorker);
+  const auto output = render(threaded);
+  EXPECT_EQ(inlineWorker.getMissedDeadlines(), 0);
+  ASSERT_EQ(output, expected);
+}
+
+TEST(ConvolutionEngineTest, IRProcessorBackgroundTailMatchesAudioThreadTail)
+{
+  const std::string irPath = std::string(TEST_DATA_DIR) + "/INPUT_long_stereo_hall.wav";
+  constexpr FrameCount kFrames = 128;
+  const auto inL = randomSignal(kFrames * 200, 23);
+  const auto inR = randomSignal(kFrames * 200, 24);
+
+  auto render = [&](bool backgroundTail, std::vector<float>& outL, std::vector<float>& outR)
+  {
+    IRProcessor processor;
+    processor.setSampleRate(48000.0);
+    processor.setMaxBlockSize(kFrames);
+    processor.setIRAEngine(ConvolutionEngineType::Pffft);
+    processor.setZeroLatencyMode(true);
+    processor.setBackgroundTailEnabled(backgroundTail);
+    std::string error;
+    EXPECT_TRUE(processor.loadImpulseResponse1(irPath, error)) << error;
+    processor.setBlend(-1.0f);
+    EXPECT_EQ(processor.getLatencySamples(), 0);
+
+    outL.assign(inL.size(), 0.0f);
+    outR.assign(inR.size(), 0.0f);
+    for (size_t offset = 0; offset < inL.size(); offset += kFrames)
+      processor.processStereo(inL.data() + offset, inR.data() + offset, outL.data() + offset,
+                              outR.data() + offset, kFrames);
+  };
+
+  std::vector<float> refL, refR, bgL, bgR;
+  render(false, refL, refR);
+  render(true, bgL, bgR);
+
+  for (size_t i = 0; i < bgL.size(); ++i)
+  {
+    ASSERT_NEAR(bgL[i], refL[i], 1e-4f) << "sample " << i;
+    ASSERT_NEAR(bgR[i], refR[i], 1e-4f) << "sample " << i;
+  }
+}
@@ -0,0 +1,108 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "octobir-core/DelayLine.hpp"
+
+using namespace octob;
+
+namespace
+{
+
+std::vector<Sample> makeRamp(size_t numFrames)
+{
+  std::vector<Sample> signal(numFrames);
+  for (size_t i = 0; i < numFrames; ++i)
+    signal[i] = static_cast<float>(i + 1);
+  return signal;
+}
+
+// The signal delayed by delay frames, silent before it starts.
+Sample delayed(const std::vector<Sample>& signal, size_t index, size_t delay)
+{
+  return index >= delay ? signal[index - delay] : 0.0f;
+}
+
+}  // namespace
+
+TEST(DelayLineTest, Allocate_RoundsCapacityUpToPowerOfTwo)
+{
+  DelayLine line;
+  EXPECT_EQ(line.getCapacity(), 0u);
+
+  line.allocate(1024, 512);
+  EXPECT_EQ(line.getCapacity(), 2048u);
+  line.allocate(1024, 1024);
+  EXPECT_EQ(line.getCapacity(), 2048u);
+  line.allocate(1024, 1025);
+  EXPECT_EQ(line.getCapacity(), 4096u);
+  line.allocate(0, 0);
+  EXPECT_EQ(line.getCapacity(), 1u);
+}
+
+TEST(DelayLineTest, Read_DelaysAcrossWrapsForAnyBlockSize)
+{
+  const auto signal = makeRamp(5000);
+
+  for (size_t delay : {static_cast<size_t>(0), static_cast<size_t>(1), static_cast<size_t>(300)})
+  {
+    for (FrameCount blockSize : {static_cast<FrameCount>(1), static_cast<FrameCount>(37),
+                                 static_cast<FrameCount>(256)})
+    {
+      DelayLine line;
+      line.allocate(300, 256);
+      std::vector<Sample> output(blockSize);
+      for (size_t offset = 0; offset < signal.size(); offset += blockSize)
+      {
+        const FrameCount numFrames = std::min(blockSize, signal.size() - offset);
+        line.write(signal.data() + offset, numFrames);
+        line.read(output.data(), numFrames, delay);
+        for (FrameCount i = 0; i < numFrames; ++i)
+          ASSERT_EQ(output[i], delayed(signal, offset + i, delay))
+              << "delay " << delay << " block size " << blockSize << " at " << offset + i;
+      }
+    }
+  }
+}
+
+// The view addresses the same frames as read() without copying them, split where the
+// ring wraps.
+TEST(DelayLineTest, View_MatchesReadAndSplitsAtWrap)
+{
+  const auto signal = makeRamp(3000);
+  constexpr FrameCount kBlockSize = 100;
+  constexpr size_t kDelay = 50;
+
+  DelayLine line;
+  line.allocate(kDelay, kBlockSize);
+  bool sawSplit = false;
+  for (size_t offset = 0; offset + kBlockSize <= signal.size(); offset += kBlockSize)
+  {
+    line.write(signal.data() + offset, kBlockSize);
+    const DelayLine::View view = line.view(kBlockSize, kDelay);
+    ASSERT_LE(view.firstSize, kBlockSize);
+    sawSplit |= view.firstSize < kBlockSize;
+    for (FrameCount i = 0; i < kBlockSize; ++i)
+    {
+      const Sample sample = i < view.firstSize ? view.first[i] : view.second[i - view.firstSize];
+      ASSERT_EQ(sample, delayed(signal, offset + i, kDelay)) << "at " << offset + i;
+    }
+  }
+  EXPECT_TRUE(sawSplit);
+}
+
+TEST(DelayLineTest, Clear_RestartsFromSilence)
+{
+  const auto signal = makeRamp(64);
+  DelayLine line;
+  line.allocate(32, 64);
+  line.write(signal.data(), signal.size());
+  line.clear();
+
+  std::vector<Sample> output(64, 1.0f);
+  line.write(signal.data(), 16);
+  line.read(output.data(), 16, 32);
+  for (FrameCount i = 0; i < 16; ++i)
+    EXPECT_EQ(output[i], 0.0f) << "at " << i;
+}
@@ -0,0 +1,344 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "octobir-core/ConvolutionKernel.hpp"
+#include "octobir-core/DualKernelConvolver.hpp"
+#include "octobir-core/IRProcessor.hpp"
+
+using namespace octob;
+
+namespace
+{
+
+constexpr int kBlock = 64;
+
+std::vector<float> randomSignal(size_t length, unsigned int seed)
+{
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+  std::vector<float> signal(length);
+  for (auto& s : signal)
+    s = dist(rng);
+  return signal;
+}
+
+std::vector<float> directConvolution(const std::vector<float>& input, const std::vector<float>& ir)
+{
+  std::vector<float> output(input.size(), 0.0f);
+  for (size_t n = 0; n < input.size(); ++n)
+  {
+    double acc = 0.0;
+    for (size_t k = 0; k < ir.size() && k <= n; ++k)
+      acc += static_cast<double>(ir[k]) * input[n - k];
+    output[n] = static_cast<float>(acc);
+  }
+  return output;
+}
+
+std::shared_ptr<const ConvolutionKernel> makeKernel(const std::vector<std::vector<float>>& channels)
+{
+  std::vector<const float*> ptrs;
+  for (const auto& ch : channels)
+    ptrs.push_back(ch.data());
+  return ConvolutionKernel::create(ptrs.data(), static_cast<int>(ptrs.size()),
+                                   channels[0].size(), kBlock);
+}
+
+// Irregular host block sizes, including single samples, so internal block boundaries
+// land mid-call.
+const std::vector<FrameCount> kHostBlocks = {1, 7, 64, 100, 13, 128, 3, 250};
+
+}  // namespace
+
+TEST(DualKernelConvolverTest, PrepareRejectsMissingOrMismatchedKernels)
+{
+  const auto ir = randomSignal(100, 1);
+  auto kernel = makeKernel({ir});
+  const float* channels[] = {ir.data()};
+  auto otherBlock = ConvolutionKernel::create(channels, 1, ir.size(), 32);
+
+  DualKernelConvolver convolver;
+  EXPECT_FALSE(convolver.prepare(kernel, nullptr));
+  EXPECT_FALSE(convolver.prepare(kernel, otherBlock));
+  EXPECT_FALSE(convolver.isPrepared());
+  EXPECT_TRUE(convolver.prepare(kernel, kernel));
+  EXPECT_TRUE(convolver.isPrepared());
+  EXPECT_EQ(convolver.getLatencySamples(), 0);
+}
+
+TEST(DualKernelConvolverTest, MatchesWeightedSumOfDirectConvolutionsWithZeroLatency)
+{
+  const auto irA = randomSignal(300, 2);
+  const auto irB = randomSignal(1000, 3);
+  const auto input = randomSignal(4000, 4);
+  const auto wetA = directConvolution(input, irA);
+  const auto wetB = directConvolution(input, irB);
+
+  DualKernelConvolver convolver;
+  ASSERT_TRUE(convolver.prepare(makeKernel({irA}), makeKernel({irB})));
+
+  const float gainA = 0.6f;
+  const float gainB = -0.4f;
+  std::vector<float> output(input.size());
+  size_t offset = 0;
+  for (size_t b = 0; offset < input.size(); ++b)
+  {
+    const FrameCount n = std::min(kHostBlocks[b % kHostBlocks.size()], input.size() - offset);
+    const float* inputs[] = {input.data() + offset};
+    float* outputs[] = {output.data() + offset};
+    convolver.process(inputs, 1, outputs, 1, n, gainA, gainB);
+    offset += n;
+  }
+
+  for (size_t i = 0; i < output.size(); ++i)
+    ASSERT_NEAR(output[i], gainA * wetA[i] + gainB * wetB[i], 1e-3f) << "sample " << i;
+}
+
+// Gains moving within and across calls weight every sample, head and tail alike, as
+// the per-slot engines' outputs would be weighted.
+TEST(DualKernelConvolverTest, RampedGainsWeightEverySample)
+{
+  const auto irA = randomSignal(300, 24);
+  const auto irB = randomSignal(1000, 25);
+  const auto input = randomSignal(4000, 26);
+  const auto wetA = directConvolution(input, irA);
+  const auto wetB = directConvolution(input, irB);
+
+  DualKernelConvolver convolver;
+  ASSERT_TRUE(convolver.prepare(makeKernel({irA}), makeKernel({irB})));
+
+  std::vector<float> output(input.size());
+  std::vector<float> expected(input.size());
+  float gainA = 1.0f;
+  float gainB = 0.0f;
+  size_t offset = 0;
+  for (size_t b = 0; offset < input.size(); ++b)
+  {
+    const FrameCount n = std::min(kHostBlocks[b % kHostBlocks.size()], input.size() - offset);
+    const float toA = b % 2 ? 1.0f - 0.1f * static_cast<float>(b % 7) : gainA;
+    const float toB = 0.15f * static_cast<float>(b % 5);
+    const float* inputs[] = {input.data() + offset};
+    float* outputs[] = {output.data() + offset};
+    convolver.process(inputs, 1, outputs, 1, n, gainA, toA, gainB, toB);
+
+    for (FrameCount i = 0; i < n; ++i)
+    {
+      const float t = static_cast<float>(i + 1) / static_cast<float>(n);
+      expected[offset + i] = (gainA + (toA - gainA) * t) * wetA[offset + i] +
+                             (gainB + (toB - gainB) * t) * wetB[offset + i];
+    }
+    gainA = toA;
+    gainB = toB;
+    offset += n;
+  }
+
+  for (size_t i = 0; i < output.size(); ++i)
+    ASSERT_NEAR(output[i], expected[i], 1e-3f) << "sample " << i;
+}
+
+// Steady gains finish each tail block with one summed inverse FFT; a gain that moves
+// takes one per kernel. A one-frame call whose gains "move" onto the steady values lands
+// exactly on them, so the two paths weight every sample alike and must agree.
+TEST(DualKernelConvolverTest, SteadyGainsMatchPerKernelPath)
+{
+  const auto irA = randomSignal(300, 27);
+  const auto irB = randomSignal(1000, 28);
+  const auto input = randomSignal(4000, 29);
+  const auto wetA = directConvolution(input, irA);
+  const auto wetB = directConvolution(input, irB);
+
+  DualKernelConvolver summed;
+  DualKernelConvolver split;
+  ASSERT_TRUE(summed.prepare(makeKernel({irA}), makeKernel({irB})));
+  ASSERT_TRUE(split.prepare(makeKernel({irA}), makeKernel({irB})));
+
+  const float gainA = 0.7f;
+  const float gainB = 0.3f;
+  std::vector<float> summedOutput(input.size());
+  std::vector<float> splitOutput(input.size());
+  size_t offset = 0;
+  for (size_t b = 0; offset < input.size(); ++b)
+  {
+    const FrameCount n = std::min(kHostBlocks[b % kHostBlocks.size()], input.size() - offset);
+    const float* inputs[] = {input.data() + offset};
+    float* outputs[] = {summedOutput.data() + offset};
+    summed.process(inputs, 1, outputs, 1, n, gainA, gainB);
+    offset += n;
+  }
+  for (size_t i = 0; i < input.size(); ++i)
+  {
+    const float* inputs[] = {input.data() + i};
+    float* outputs[] = {splitOutput.data() + i};
+    split.process(inputs, 1, outputs, 1, 1, 0.0f, gainA, 0.0f, gainB);
+  }
+
+  for (size_t i = 0; i < input.size(); ++i)
+  {
+    ASSERT_NEAR(summedOutput[i], splitOutput[i], 1e-5f) << "sample " << i;
+    ASSERT_NEAR(summedOutput[i], gainA * wetA[i] + gainB * wetB[i], 1e-3f) << "sample " << i;
+  }
+}
+
+TEST(DualKernelConvolverTest, StereoRoutingFollowsKernelChannels)
+{
+  const auto irAL = randomSignal(200, 5);
+  const auto irAR = randomSignal(200, 6);
+  const auto irB = randomSignal(500, 7);
+  const auto inL = randomSignal(2000, 8);
+  const auto inR = randomSignal(2000, 9);
+
+  DualKernelConvolver convolver;
+  ASSERT_TRUE(convolver.prepare(makeKernel({irAL, irAR}), makeKernel({irB})));
+
+  const float gainA = 0.5f;
+  const float gainB = 0.8f;
+  std::vector<float> outL(inL.size());
+  std::vector<float> outR(inR.size());
+  for (size_t offset = 0; offset < inL.size(); offset += 100)
+  {
+    const float* inputs[] = {inL.data() + offset, inR.data() + offset};
+    float* outputs[] = {outL.data() + offset, outR.data() + offset};
+    convolver.process(inputs, 2, outputs, 2, 100, gainA, gainB);
+  }
+
+  // A stereo kernel maps channel to channel; a mono kernel feeds both sides.
+  const auto aL = directConvolution(inL, irAL);
+  const auto aR = directConvolution(inR, irAR);
+  const auto bL = directConvolution(inL, irB);
+  const auto bR = directConvolution(inR, irB);
+  for (size_t i = 0; i < outL.size(); ++i)
+  {
+    ASSERT_NEAR(outL[i], gainA * aL[i] + gainB * bL[i], 1e-3f) << "sample " << i;
+    ASSERT_NEAR(outR[i], gainA * aR[i] + gainB * bR[i], 1e-3f) << "sample " << i;
+  }
+}
+
+TEST(DualKernelConvolverTest, MonoOutputAveragesStereoKernelChannels)
+{
+  const auto irAL = randomSignal(150, 10);
+  const auto irAR = randomSignal(150, 11);
+  const auto irB = randomSignal(150, 12);
+  const auto input = randomSignal(1000, 13);
+
+  DualKernelConvolver convolver;
+  ASSERT_TRUE(convolver.prepare(makeKernel({irAL, irAR}), makeKernel({irB})));
+
+  std::vector<float> output(input.size());
+  const float* inputs[] = {input.data()};
+  float* outputs[] = {output.data()};
+  convolver.process(inputs, 1, outputs, 1, input.size(), 1.0f, 0.0f);
+
+  const auto aL = directConvolution(input, irAL);
+  const auto aR = directConvolution(input, irAR);
+  for (size_t i = 0; i < output.size(); ++i)
+    ASSERT_NEAR(output[i], 0.5f * (aL[i] + aR[i]), 1e-3f) << "sample " << i;
+}
+
+TEST(DualKernelConvolverTest, InPlaceProcessingMatchesSeparateBuffers)
+{
+  const auto irA = randomSignal(400, 14);
+  const auto irB = randomSignal(90, 15);
+  const auto input = randomSignal(1500, 16);
+
+  DualKernelConvolver separate;
+  DualKernelConvolver inPlace;
+  ASSERT_TRUE(separate.prepare(makeKernel({irA}), makeKernel({irB})));
+  ASSERT_TRUE(inPlace.prepare(makeKernel({irA}), makeKernel({irB})));
+
+  std::vector<float> expected(input.size());
+  std::vector<float> buffer = input;
+  for (size_t offset = 0; offset < input.size(); offset += 50)
+  {
+    const float* inputs[] = {input.data() + offset};
+    float* outputs[] = {expected.data() + offset};
+    separate.process(inputs, 1, outputs, 1, 50, 0.7f, 0.3f);
+
+    const float* inPlaceInputs[] = {buffer.data() + offset};
+    float* inPlaceOutputs[] = {buffer.data() + offset};
+    inPlace.process(inPlaceInputs, 1, inPlaceOutputs, 1, 50, 0.7f, 0.3f);
+  }
+
+  for (size_t i = 0; i < buffer.size(); ++i)
+    ASSERT_FLOAT_EQ(buffer[i], expected[i]) << "sample " << i;
+}
+
+// With both slots loaded, IRProcessor routes through the shared-spectrum engine. The
+// equal-power blend at 0 must still equal the scaled sum of the single-slot outputs.
+TEST(DualKernelConvolverTest, IRProcessorBlendMatchesSumOfSingleSlotOutputs)
+{
+  const std::string irAPath = std::string(TEST_DATA_DIR) + "/INPUT_ir_a.wav";
+  const std::string irBPath = std::string(TEST_DATA_DIR) + "/INPUT_ir_b.wav";
+  constexpr FrameCount kFrames = 256;
+  const auto input = randomSignal(kFrames * 40, 17);
+
+  auto render = [&](bool enableA, bool enableB)
+  {
+    IRProcessor processor;
+    processor.setSampleRate(48000.0);
+    processor.setMaxBlockSize(kFrames);
+    std::string error;
+    EXPECT_TRUE(processor.loadImpulseResponse1(irAPath, error)) << error;
+    EXPECT_TRUE(processor.loadImpulseResponse2(irBPath, error)) << error;
+    processor.setIRAEnabled(enableA);
+    processor.setIRBEnabled(enableB);
+    processor.setBlend(0.0f);
+
+    std::vector<float> output(input.size());
+    for (size_t offset = 0; offset < input.size(); offset += kFrames)
+      processor.processMono(input.data() + offset, output.data() + offset, kFrames);
+    return output;
+  };
+
+  const auto blended = render(true, true);
+  const auto onlyA = render(true, false);
+  const auto onlyB = render(false, true);
+
+  const float equalPower = std::sqrt(0.5f);
+  for (size_t i = 0; i < blended.size(); ++i)
+    ASSERT_NEAR(blended[i], equalPower * (onlyA[i] + onlyB[i]), 1e-4f) << "sample " << i;
+}
+
+// The shared-spectrum engine only stands in for slots left on Auto or Pffft. Pinned slots
+// keep running their own engines while both are active, so slot A's engine already holds
+// the input when B is toggled off and its tail rings on; an engine switched to from the
+// shared path starts over from silence.
+TEST(DualKernelConvolverTest, IRProcessorHonorsPinnedSlotEngines)
+{
+  const std::string irAPath = std::string(TEST_DATA_DIR) + "/INPUT_ir_a.wav";
+  const std::string irBPath = std::string(TEST_DATA_DIR) + "/INPUT_ir_b.wav";
+  constexpr FrameCount kFrames = 256;
+  const auto input = randomSignal(kFrames * 8, 23);
+
+  auto tailAfterToggle = [&](ConvolutionEngineType type)
+  {
+    IRProcessor processor;
+    processor.setSampleRate(48000.0);
+    processor.setMaxBlockSize(kFrames);
+    processor.setIRAEngine(type);
+    processor.setIRBEngine(type);
+    std::string error;
+    EXPECT_TRUE(processor.loadImpulseResponse1(irAPath, error)) << error;
+    EXPECT_TRUE(processor.loadImpulseResponse2(irBPath, error)) << error;
+
+    std::vector<float> output(kFrames);
+    for (size_t offset = 0; offset < input.size(); offset += kFrames)
+      processor.processMono(input.data() + offset, output.data(), kFrames);
+    processor.setIRBEnabled(false);
+    const std::vector<float> silence(kFrames, 0.0f);
+    processor.processMono(silence.data(), output.data(), kFrames);
+
+    float peak = 0.0f;
+    for (float s : output)
+      peak = std::max(peak, std::abs(s));
+    return peak;
+  };
+
+  EXPECT_GT(tailAfterToggle(ConvolutionEngineType::Direct), 1e-3f);
+  EXPECT_GT(tailAfterToggle(ConvolutionEngineType::Wdl), 1e-3f);
+  EXPECT_EQ(tailAfterToggle(ConvolutionEngineType::Auto), 0.0f);
+}
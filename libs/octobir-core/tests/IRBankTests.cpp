@@ -0,0 +1,217 @@
+// clang-format off
+// <cstdlib> must precede <convoengine.h> — WDL heapbuf.h/fastqueue.h use
+// malloc/free without including <cstdlib> themselves, which fails on GCC/Linux.
+#include <cstdlib>
+#include <convoengine.h>
+// clang-format on
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+// DR_WAV_IMPLEMENTATION is compiled into octobir-core via IRLoader.cpp.
+#include "dr_wav.h"
+#include "octobir-core/IRBank.hpp"
+#include "octobir-core/IRKernelStore.hpp"
+#include "octobir-core/IRLoader.hpp"
+
+using namespace octob;
+
+namespace
+{
+
+// Unique per test, so banks from earlier runs are never read back.
+std::string uniquePath(const std::string& name)
+{
+  std::random_device device;
+  return ::testing::TempDir() + "octobir_ir_bank_" + std::to_string(device()) + "_" +
+         ::testing::UnitTest::GetInstance()->current_test_info()->name() + "_" + name;
+}
+
+bool writeWav(const std::string& path, const std::vector<float>& interleaved,
+              unsigned int channels, unsigned int sampleRate)
+{
+  drwav_data_format fmt;
+  fmt.container = drwav_container_riff;
+  fmt.format = DR_WAVE_FORMAT_IEEE_FLOAT;
+  fmt.channels = channels;
+  fmt.sampleRate = sampleRate;
+  fmt.bitsPerSample = 32;
+
+  drwav wav;
+  if (!drwav_init_file_write(&wav, path.c_str(), &fmt, nullptr))
+    return false;
+
+  drwav_write_pcm_frames(&wav, interleaved.size() / channels, interleaved.data());
+  drwav_uninit(&wav);
+  return true;
+}
+
+std::vector<float> makeDecay(size_t numFrames, unsigned int channels, float frequency)
+{
+  std::vector<float> samples(numFrames * channels);
+  for (size_t i = 0; i < numFrames; ++i)
+    for (unsigned int ch = 0; ch < channels; ++ch)
+      samples[i * channels + ch] = std::exp(-static_cast<float>(i) / 300.0f) *
+                                   std::sin(0.01f * frequency * static_cast<float>(i + ch));
+  return samples;
+}
+
+std::vector<std::vector<float>> resampleTo(const IRLoader& loader, SampleRate sampleRate)
+{
+  WDL_ImpulseBuffer buffer;
+  EXPECT_TRUE(loader.resampleAndInitialize(buffer, sampleRate));
+  std::vector<std::vector<float>> channels;
+  for (int ch = 0; ch < buffer.GetNumChannels(); ++ch)
+    channels.emplace_back(buffer.impulses[ch].Get(),
+                          buffer.impulses[ch].Get() + buffer.GetLength());
+  return channels;
+}
+
+// Two WAVs, one mono at 48 kHz and one stereo at 44.1 kHz, packed into a bank.
+struct BankFixture
+{
+  std::string monoPath = uniquePath("mono.wav");
+  std::string stereoPath = uniquePath("stereo.wav");
+  std::string bankPath = uniquePath("bank.oirb");
+
+  bool build(const std::vector<SampleRate>& sampleRates, std::string& error) const
+  {
+    return writeWav(monoPath, makeDecay(2000, 1, 3.0f), 1, 48000) &&
+           writeWav(stereoPath, makeDecay(1500, 2, 7.0f), 2, 44100) &&
+           IRBank::build({{"Stereo Cab #2", stereoPath}, {"Mono Cab", monoPath}}, sampleRates,
+                         bankPath, error);
+  }
+};
+
+}  // namespace
+
+TEST(IRBankTest, Build_IndexesEntriesByName)
+{
+  BankFixture fixture;
+  std::string error;
+  ASSERT_TRUE(fixture.build({48000.0}, error)) << error;
+
+  const auto bank = IRBank::open(fixture.bankPath, error);
+  ASSERT_NE(bank, nullptr) << error;
+  ASSERT_EQ(bank->getNumEntries(), 2u);
+  EXPECT_EQ(bank->getEntryName(0), "Mono Cab");
+  EXPECT_EQ(bank->getEntryName(1), "Stereo Cab #2");
+
+  size_t index = 0;
+  ASSERT_TRUE(bank->findEntry("Stereo Cab #2", index));
+  EXPECT_EQ(index, 1u);
+  EXPECT_FALSE(bank->findEntry("Missing", index));
+
+  IRCacheKey key;
+  ASSERT_TRUE(IRCache::computeKey(fixture.stereoPath, key));
+  EXPECT_EQ(bank->getEntryKey(1).contentHash, key.contentHash);
+  EXPECT_EQ(bank->getEntryKey(1).contentSize, key.contentSize);
+
+  IRBankSection section;
+  ASSERT_TRUE(bank->getSection(1, IRCacheStage::MinimumPhase, 0.0, section));
+  EXPECT_EQ(section.numChannels, 2);
+  EXPECT_EQ(section.numSamples, 1500u);
+  EXPECT_EQ(section.sampleRate, 44100.0);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(section.samples) % 64, 0u);
+  EXPECT_TRUE(bank->getSection(1, IRCacheStage::Resampled, 48000.0, section));
+  EXPECT_FALSE(bank->getSection(1, IRCacheStage::Resampled, 96000.0, section));
+}
+
+TEST(IRBankTest, SplitEntryPath_RequiresBankExtension)
+{
+  std::string bankPath;
+  std::string entryName;
+  ASSERT_TRUE(IRBank::splitEntryPath("/packs/Cabs.OIRB#4x12 #2", bankPath, entryName));
+  EXPECT_EQ(bankPath, "/packs/Cabs.OIRB");
+  EXPECT_EQ(entryName, "4x12 #2");
+  EXPECT_EQ(IRBank::makeEntryPath(bankPath, entryName), "/packs/Cabs.OIRB#4x12 #2");
+
+  EXPECT_FALSE(IRBank::splitEntryPath("/irs/Take #2.wav", bankPath, entryName));
+  EXPECT_FALSE(IRBank::splitEntryPath("/packs/Cabs.oirb#", bankPath, entryName));
+}
+
+// A bank entry loads to exactly what the WAV it was built from loads to, at rates the
+// bank holds and at rates it resamples for.
+TEST(IRBankTest, LoadFromBank_MatchesLoadFromFile)
+{
+  BankFixture fixture;
+  std::string error;
+  ASSERT_TRUE(fixture.build({48000.0}, error)) << error;
+
+  for (const auto& name : {std::string("Mono Cab"), std::string("Stereo Cab #2")})
+  {
+    const std::string source = name == "Mono Cab" ? fixture.monoPath : fixture.stereoPath;
+    IRLoader fromFile;
+    const IRLoadResult expected = fromFile.loadFromFile(source);
+    ASSERT_TRUE(expected.success);
+
+    IRLoader fromBank;
+    const IRLoadResult result =
+        fromBank.loadFromFile(IRBank::makeEntryPath(fixture.bankPath, name));
+    ASSERT_TRUE(result.success) << result.errorMessage;
+    EXPECT_EQ(result.numSamples, expected.numSamples);
+    EXPECT_EQ(result.numChannels, expected.numChannels);
+    EXPECT_EQ(result.sampleRate, expected.sampleRate);
+
+    for (SampleRate rate : {48000.0, 96000.0})
+      EXPECT_EQ(resampleTo(fromBank, rate), resampleTo(fromFile, rate)) << name << " at " << rate;
+  }
+}
+
+TEST(IRBankTest, LoadFromFile_ReportsMissingEntryAndCorruptBank)
+{
+  BankFixture fixture;
+  std::string error;
+  ASSERT_TRUE(fixture.build({}, error)) << error;
+
+  IRLoader loader;
+  IRLoadResult result = loader.loadFromFile(IRBank::makeEntryPath(fixture.bankPath, "Nope"));
+  EXPECT_FALSE(result.success);
+  EXPECT_NE(result.errorMessage.find("Nope"), std::string::npos);
+
+  // Flip a byte in the index.
+  FILE* file = std::fopen(fixture.bankPath.c_str(), "r+b");
+  ASSERT_NE(file, nullptr);
+  std::fseek(file, 70, SEEK_SET);
+  const int byte = std::fgetc(file);
+  std::fseek(file, 70, SEEK_SET);
+  std::fputc(byte ^ 0xff, file);
+  std::fclose(file);
+
+  EXPECT_EQ(IRBank::open(fixture.bankPath, error), nullptr);
+  EXPECT_EQ(error, "IR bank is corrupt");
+}
+
+TEST(IRBankTest, Build_RejectsDuplicateNamesAndBadSources)
+{
+  BankFixture fixture;
+  std::string error;
+  ASSERT_TRUE(writeWav(fixture.monoPath, makeDecay(100, 1, 3.0f), 1, 48000));
+
+  EXPECT_FALSE(IRBank::build({{"A", fixture.monoPath}, {"A", fixture.monoPath}}, {},
+                             fixture.bankPath, error));
+  EXPECT_FALSE(IRBank::build({{"A", fixture.monoPath}, {"B", uniquePath("missing.wav")}}, {},
+                             fixture.bankPath, error));
+  EXPECT_NE(error.find("missing.wav"), std::string::npos);
+  EXPECT_EQ(IRBank::open(fixture.bankPath, error), nullptr);
+}
+
+// Loading a bank entry through the store shares the entry built from its source WAV.
+TEST(IRBankTest, KernelStore_SharesEntryWithSourceFile)
+{
+  BankFixture fixture;
+  std::string error;
+  ASSERT_TRUE(fixture.build({48000.0}, error)) << error;
+
+  IRKernelStore store;
+  const auto fromFile = store.load(fixture.monoPath, 48000.0, nullptr, error);
+  ASSERT_NE(fromFile, nullptr) << error;
+  const auto fromBank =
+      store.load(IRBank::makeEntryPath(fixture.bankPath, "Mono Cab"), 48000.0, nullptr, error);
+  EXPECT_EQ(fromBank, fromFile);
+}
@@ -0,0 +1,158 @@
+// clang-format off
+// <cstdlib> must precede <convoengine.h> — WDL heapbuf.h/fastqueue.h use
+// malloc/free without including <cstdlib> themselves, which fails on GCC/Linux.
+#include <cstdlib>
+#include <convoengine.h>
+// clang-format on
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+// DR_WAV_IMPLEMENTATION is compiled into octobir-core via IRLoader.cpp.
+#include "dr_wav.h"
+#include "octobir-core/IRCache.hpp"
+#include "octobir-core/IRLoader.hpp"
+
+using namespace octob;
+
+namespace
+{
+
+// A fresh directory per test, so entries from earlier runs never turn a cold load warm.
+std::string uniqueCacheDirectory()
+{
+  std::random_device device;
+  return ::testing::TempDir() + "octobir_ir_cache_" + std::to_string(device()) + "_" +
+         ::testing::UnitTest::GetInstance()->current_test_info()->name();
+}
+
+bool fileExists(const std::string& path)
+{
+  FILE* file = std::fopen(path.c_str(), "rb");
+  if (file == nullptr)
+    return false;
+  std::fclose(file);
+  return true;
+}
+
+bool writeTempWavMono(const std::string& path, const std::vector<float>& samples,
+                      unsigned int sampleRate)
+{
+  drwav_data_format fmt;
+  fmt.container = drwav_container_riff;
+  fmt.format = DR_WAVE_FORMAT_IEEE_FLOAT;
+  fmt.channels = 1;
+  fmt.sampleRate = sampleRate;
+  fmt.bitsPerSample = 32;
+
+  drwav wav;
+  if (!drwav_init_file_write(&wav, path.c_str(), &fmt, nullptr))
+    return false;
+
+  drwav_write_pcm_frames(&wav, samples.size(), samples.data());
+  drwav_uninit(&wav);
+  return true;
+}
+
+std::vector<std::vector<float>> loadImpulse(const std::string& path, SampleRate sampleRate,
+                                            std::shared_ptr<const IRCache> cache)
+{
+  IRLoader loader;
+  loader.setCache(std::move(cache));
+  EXPECT_TRUE(loader.loadFromFile(path).success);
+
+  WDL_ImpulseBuffer buffer;
+  EXPECT_TRUE(loader.resampleAndInitialize(buffer, sampleRate));
+  std::vector<std::vector<float>> channels;
+  for (int ch = 0; ch < buffer.GetNumChannels(); ++ch)
+    channels.emplace_back(buffer.impulses[ch].Get(),
+                          buffer.impulses[ch].Get() + buffer.GetLength());
+  return channels;
+}
+
+}  // namespace
+
+TEST(IRCacheTest, StoredEntryReadsBackPerStageAndRate)
+{
+  const IRCache cache(uniqueCacheDirectory());
+  const IRCacheKey key{0x0123456789abcdefULL, 1000};
+  const std::vector<float> left = {1.0f, 2.0f, 3.0f};
+  const std::vector<float> right = {-1.0f, -2.0f, -3.0f};
+  const float* channels[] = {left.data(), right.data()};
+
+  ASSERT_TRUE(cache.store(key, IRCacheStage::Resampled, 48000.0, channels, 2, left.size()));
+
+  auto entry = cache.open(key, IRCacheStage::Resampled, 48000.0);
+  ASSERT_NE(entry, nullptr);
+  EXPECT_EQ(entry->getNumChannels(), 2);
+  EXPECT_EQ(entry->getNumSamples(), left.size());
+  EXPECT_EQ(entry->getSampleRate(), 48000.0);
+  EXPECT_EQ(std::vector<float>(entry->getChannel(0), entry->getChannel(0) + 3), left);
+  EXPECT_EQ(std::vector<float>(entry->getChannel(1), entry->getChannel(1) + 3), right);
+
+  EXPECT_EQ(cache.open(key, IRCacheStage::Resampled, 44100.0), nullptr);
+  EXPECT_EQ(cache.open(key, IRCacheStage::MinimumPhase, 48000.0), nullptr);
+  EXPECT_EQ(cache.open(IRCacheKey{key.contentHash, 999}, IRCacheStage::Resampled, 48000.0),
+            nullptr);
+}
+
+TEST(IRCacheTest, CorruptEntryIsDeletedAndMissed)
+{
+  const IRCache cache(uniqueCacheDirectory());
+  const IRCacheKey key{42, 42};
+  const std::vector<float> samples(256, 0.5f);
+  const float* channels[] = {samples.data()};
+  ASSERT_TRUE(cache.store(key, IRCacheStage::MinimumPhase, 44100.0, channels, 1, samples.size()));
+
+  // Flip one payload byte, as a torn or damaged write would.
+  const std::string path = cache.getEntryPath(key, IRCacheStage::MinimumPhase, 0.0);
+  FILE* file = std::fopen(path.c_str(), "r+b");
+  ASSERT_NE(file, nullptr);
+  std::fseek(file, 100, SEEK_SET);
+  std::fputc(0x7f, file);
+  std::fclose(file);
+
+  EXPECT_EQ(cache.open(key, IRCacheStage::MinimumPhase, 0.0), nullptr);
+  EXPECT_FALSE(fileExists(path));
+}
+
+TEST(IRCacheTest, CachedLoadsMatchUncachedLoads)
+{
+  const std::string path = std::string(TEST_DATA_DIR) + "/INPUT_ir_stereo.wav";
+  auto cache = std::make_shared<const IRCache>(uniqueCacheDirectory());
+
+  IRCacheKey key;
+  ASSERT_TRUE(IRCache::computeKey(path, key));
+
+  for (SampleRate rate : {48000.0, 44100.0, 96000.0})
+  {
+    const auto reference = loadImpulse(path, rate, nullptr);
+    const auto cold = loadImpulse(path, rate, cache);
+    EXPECT_TRUE(fileExists(cache->getEntryPath(key, IRCacheStage::MinimumPhase, 0.0)));
+    EXPECT_TRUE(fileExists(cache->getEntryPath(key, IRCacheStage::Resampled, rate)));
+    const auto warm = loadImpulse(path, rate, cache);
+
+    EXPECT_EQ(cold, reference) << "rate " << rate;
+    EXPECT_EQ(warm, reference) << "rate " << rate;
+  }
+}
+
+TEST(IRCacheTest, EditedFileDoesNotHitOldEntries)
+{
+  const std::string path = ::testing::TempDir() + "octobir_ir_cache_edited.wav";
+  auto cache = std::make_shared<const IRCache>(uniqueCacheDirectory());
+
+  std::vector<float> ir(300, 0.0f);
+  ir[10] = 1.0f;
+  ASSERT_TRUE(writeTempWavMono(path, ir, 48000));
+  loadImpulse(path, 48000.0, cache);
+
+  ir[10] = 0.25f;
+  ir[40] = -0.5f;
+  ASSERT_TRUE(writeTempWavMono(path, ir, 48000));
+  EXPECT_EQ(loadImpulse(path, 48000.0, cache), loadImpulse(path, 48000.0, nullptr));
+}
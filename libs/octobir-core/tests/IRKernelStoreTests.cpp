@@ -0,0 +1,137 @@
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "octobir-core/IRKernelStore.hpp"
+#include "octobir-core/IRProcessor.hpp"
+
+using namespace octob;
+
+namespace
+{
+
+const std::string kIrAPath = std::string(TEST_DATA_DIR) + "/INPUT_ir_a.wav";
+const std::string kIrBPath = std::string(TEST_DATA_DIR) + "/INPUT_ir_b.wav";
+
+}  // namespace
+
+TEST(IRKernelStoreTest, SameFileAndRateShareOneEntry)
+{
+  auto& store = IRKernelStore::getInstance();
+  const size_t baseline = store.getNumLiveEntries();
+  std::string error;
+
+  auto first = store.load(kIrAPath, 48000.0, nullptr, error);
+  auto second = store.load(kIrAPath, 48000.0, nullptr, error);
+  ASSERT_NE(first, nullptr) << error;
+  EXPECT_EQ(first, second);
+  EXPECT_EQ(store.getNumLiveEntries(), baseline + 1);
+
+  auto other = store.load(kIrBPath, 48000.0, nullptr, error);
+  ASSERT_NE(other, nullptr) << error;
+  EXPECT_NE(other->kernel, first->kernel);
+  EXPECT_EQ(store.getNumLiveEntries(), baseline + 2);
+}
+
+TEST(IRKernelStoreTest, OtherRatesReuseTheDecodedSource)
+{
+  auto& store = IRKernelStore::getInstance();
+  std::string error;
+
+  auto at48k = store.load(kIrAPath, 48000.0, nullptr, error);
+  ASSERT_NE(at48k, nullptr) << error;
+  auto at96k = store.resample(*at48k, 96000.0, error);
+  ASSERT_NE(at96k, nullptr) << error;
+
+  EXPECT_NE(at96k, at48k);
+  EXPECT_EQ(at96k->source, at48k->source);
+  EXPECT_EQ(at96k->sampleRate, 96000.0);
+  EXPECT_EQ(store.load(kIrAPath, 96000.0, nullptr, error), at96k);
+}
+
+TEST(IRKernelStoreTest, EntryIsEvictedWithItsLastUser)
+{
+  auto& store = IRKernelStore::getInstance();
+  const size_t baseline = store.getNumLiveEntries();
+  std::string error;
+
+  auto first = store.load(kIrAPath, 44100.0, nullptr, error);
+  auto second = store.load(kIrAPath, 44100.0, nullptr, error);
+  std::weak_ptr<const SharedIR> watch = first;
+  std::weak_ptr<const IRLoader> source = first->source;
+
+  first.reset();
+  EXPECT_FALSE(watch.expired());
+  second.reset();
+  EXPECT_TRUE(watch.expired());
+  EXPECT_TRUE(source.expired());
+  EXPECT_EQ(store.getNumLiveEntries(), baseline);
+}
+
+TEST(IRKernelStoreTest, MissingFileReportsLoaderError)
+{
+  std::string error;
+  EXPECT_EQ(IRKernelStore::getInstance().load("/nonexistent/file.wav", 48000.0, nullptr, error),
+            nullptr);
+  EXPECT_FALSE(error.empty());
+}
+
+// Processors loading the same IR hold one store entry between them, sound the same,
+// and release it when the IR is cleared.
+TEST(IRKernelStoreTest, IRProcessorInstancesShareLoadedIRs)
+{
+  auto& store = IRKernelStore::getInstance();
+  const size_t baseline = store.getNumLiveEntries();
+  constexpr FrameCount kFrames = 128;
+  std::vector<float> input(kFrames * 20, 0.0f);
+  input[0] = 1.0f;
+
+  std::vector<std::unique_ptr<IRProcessor>> processors;
+  std::vector<std::vector<float>> outputs;
+  for (int i = 0; i < 3; ++i)
+  {
+    processors.emplace_back(new IRProcessor());
+    IRProcessor& processor = *processors.back();
+    processor.setSampleRate(48000.0);
+    processor.setMaxBlockSize(kFrames);
+    std::string error;
+    ASSERT_TRUE(processor.loadImpulseResponse1(kIrAPath, error)) << error;
+    processor.setBlend(-1.0f);
+
+    std::vector<float> output(input.size());
+    for (size_t offset = 0; offset < input.size(); offset += kFrames)
+      processor.processMono(input.data() + offset, output.data() + offset, kFrames);
+    outputs.push_back(output);
+  }
+
+  EXPECT_EQ(store.getNumLiveEntries(), baseline + 1);
+  EXPECT_EQ(outputs[1], outputs[0]);
+  EXPECT_EQ(outputs[2], outputs[0]);
+
+  for (auto& processor : processors)
+    processor->clearImpulseResponse1();
+  EXPECT_EQ(store.getNumLiveEntries(), baseline);
+}
+
+// A truncated IR is its own entry, and IRProcessor reports the length it was cut from.
+TEST(IRKernelStoreTest, TailFloorsAreSeparateEntries)
+{
+  IRKernelStore store;
+  std::string error;
+  auto whole = store.load(kIrAPath, 48000.0, nullptr, error);
+  auto truncated = store.load(kIrAPath, 48000.0, nullptr, error, -40.0f);
+  ASSERT_NE(whole, nullptr);
+  ASSERT_NE(truncated, nullptr);
+  EXPECT_NE(truncated, whole);
+  EXPECT_EQ(store.load(kIrAPath, 48000.0, nullptr, error, -40.0f), truncated);
+  EXPECT_LT(truncated->source->getNumSamples(), whole->source->getNumSamples());
+
+  IRProcessor processor;
+  processor.setSampleRate(48000.0);
+  processor.setTailFloorDb(-40.0f);
+  ASSERT_TRUE(processor.loadImpulseResponse1(kIrAPath, error)) << error;
+  EXPECT_EQ(processor.getIR1NumSamples(), truncated->source->getNumSamples());
+  EXPECT_EQ(processor.getIR1OriginalNumSamples(), whole->source->getNumSamples());
+}
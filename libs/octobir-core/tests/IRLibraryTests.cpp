@@ -0,0 +1,349 @@
+#include <gtest/gtest.h>
+
+#ifdef _WIN32
+#include <direct.h>
+#include <sys/utime.h>
+#else
+#include <sys/stat.h>
+#include <utime.h>
+#endif
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+// DR_WAV_IMPLEMENTATION is compiled into octobir-core via IRLoader.cpp.
+#include "dr_wav.h"
+#include "octobir-core/IRLibrary.hpp"
+
+using namespace octob;
+
+namespace
+{
+
+constexpr unsigned int kSampleRate = 48000;
+
+bool makeDirectory(const std::string& path)
+{
+#ifdef _WIN32
+  return _mkdir(path.c_str()) == 0;
+#else
+  return mkdir(path.c_str(), 0755) == 0;
+#endif
+}
+
+// A fresh folder per test, so files from earlier runs never show up in the index.
+std::string uniqueLibraryDirectory()
+{
+  std::random_device device;
+  const std::string path =
+      ::testing::TempDir() + "octobir_ir_library_" + std::to_string(device()) + "_" +
+      ::testing::UnitTest::GetInstance()->current_test_info()->name();
+  EXPECT_TRUE(makeDirectory(path));
+  return path;
+}
+
+bool setModifiedTime(const std::string& path, long seconds)
+{
+#ifdef _WIN32
+  struct _utimbuf times = {seconds, seconds};
+  return _utime(path.c_str(), &times) == 0;
+#else
+  struct utimbuf times = {seconds, seconds};
+  return utime(path.c_str(), &times) == 0;
+#endif
+}
+
+bool writeWavMono(const std::string& path, const std::vector<float>& samples)
+{
+  drwav_data_format fmt;
+  fmt.container = drwav_container_riff;
+  fmt.format = DR_WAVE_FORMAT_IEEE_FLOAT;
+  fmt.channels = 1;
+  fmt.sampleRate = kSampleRate;
+  fmt.bitsPerSample = 32;
+
+  drwav wav;
+  if (!drwav_init_file_write(&wav, path.c_str(), &fmt, nullptr))
+    return false;
+
+  drwav_write_pcm_frames(&wav, samples.size(), samples.data());
+  drwav_uninit(&wav);
+  return true;
+}
+
+bool writeText(const std::string& path, const std::string& text)
+{
+  FILE* file = std::fopen(path.c_str(), "wb");
+  if (file == nullptr)
+    return false;
+  std::fwrite(text.data(), 1, text.size(), file);
+  std::fclose(file);
+  return true;
+}
+
+// A decaying sine: a crude cab-like resonance at frequency.
+std::vector<float> makeResonance(float frequency, size_t numSamples)
+{
+  std::vector<float> samples(numSamples);
+  for (size_t i = 0; i < numSamples; ++i)
+  {
+    const float t = static_cast<float>(i) / kSampleRate;
+    samples[i] = std::exp(-t * 40.0f) * std::sin(6.2831853f * frequency * t);
+  }
+  return samples;
+}
+
+std::vector<float> makeNoise(size_t numSamples)
+{
+  std::mt19937 generator(7);
+  std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+  std::vector<float> samples(numSamples);
+  for (auto& sample : samples)
+    sample = distribution(generator);
+  return samples;
+}
+
+std::string join(const std::string& directory, const std::string& name)
+{
+  return directory + "/" + name;
+}
+
+}  // namespace
+
+TEST(IRLibraryTest, AddFolder_IndexesFilesRecursively)
+{
+  const std::string root = uniqueLibraryDirectory();
+  const std::string nested = join(root, "nested");
+  ASSERT_TRUE(makeDirectory(nested));
+  ASSERT_TRUE(writeWavMono(join(root, "b.wav"), makeResonance(200.0f, 2400)));
+  ASSERT_TRUE(writeWavMono(join(root, "a.WAV"), makeResonance(300.0f, 1200)));
+  ASSERT_TRUE(writeText(join(root, "amp.nam"), "{}"));
+  ASSERT_TRUE(writeText(join(root, "notes.txt"), "not an IR"));
+  ASSERT_TRUE(writeWavMono(join(nested, "c.wav"), makeNoise(512)));
+
+  IRLibrary library;
+  EXPECT_FALSE(library.hasFolder(root));
+  library.addFolder(root);
+
+  EXPECT_TRUE(library.hasFolder(root));
+  EXPECT_TRUE(library.hasFolder(nested));
+  EXPECT_EQ(library.getNumEntries(), 4u);
+  EXPECT_EQ(library.getFolderFiles(root, LibraryFileKind::ImpulseResponse),
+            std::vector<std::string>({join(root, "a.WAV"), join(root, "b.wav")}));
+  EXPECT_EQ(library.getFolderFiles(root + "/", LibraryFileKind::NamModel),
+            std::vector<std::string>({join(root, "amp.nam")}));
+  EXPECT_EQ(library.getFolderFiles(nested, LibraryFileKind::ImpulseResponse),
+            std::vector<std::string>({join(nested, "c.wav")}));
+
+  LibraryEntry entry;
+  ASSERT_TRUE(library.getEntry(join(root, "b.wav"), entry));
+  EXPECT_EQ(entry.kind, LibraryFileKind::ImpulseResponse);
+  EXPECT_EQ(entry.sampleRate, static_cast<SampleRate>(kSampleRate));
+  EXPECT_EQ(entry.numSamples, 2400u);
+  EXPECT_EQ(entry.numChannels, 1u);
+  EXPECT_TRUE(entry.contentKey.isValid());
+
+  ASSERT_TRUE(library.getEntry(join(root, "amp.nam"), entry));
+  EXPECT_EQ(entry.kind, LibraryFileKind::NamModel);
+  EXPECT_EQ(entry.numSamples, 0u);
+}
+
+TEST(IRLibraryTest, AddFolder_RescanPicksUpChanges)
+{
+  const std::string root = uniqueLibraryDirectory();
+  ASSERT_TRUE(writeWavMono(join(root, "keep.wav"), makeResonance(200.0f, 1000)));
+  ASSERT_TRUE(writeWavMono(join(root, "delete.wav"), makeResonance(200.0f, 1000)));
+  ASSERT_TRUE(writeWavMono(join(root, "edit.wav"), makeResonance(200.0f, 1000)));
+
+  IRLibrary library;
+  library.addFolder(root);
+  ASSERT_EQ(library.getNumEntries(), 3u);
+
+  ASSERT_EQ(std::remove(join(root, "delete.wav").c_str()), 0);
+  ASSERT_TRUE(writeWavMono(join(root, "edit.wav"), makeResonance(200.0f, 3000)));
+  ASSERT_TRUE(writeWavMono(join(root, "new.wav"), makeResonance(200.0f, 500)));
+  library.addFolder(root);
+
+  EXPECT_EQ(library.getFolderFiles(root, LibraryFileKind::ImpulseResponse),
+            std::vector<std::string>(
+                {join(root, "edit.wav"), join(root, "keep.wav"), join(root, "new.wav")}));
+  LibraryEntry entry;
+  ASSERT_TRUE(library.getEntry(join(root, "edit.wav"), entry));
+  EXPECT_EQ(entry.numSamples, 3000u);
+  EXPECT_FALSE(library.getEntry(join(root, "delete.wav"), entry));
+}
+
+// Duplicates share content wherever they live; similar IRs are ranked by fingerprint and
+// never include copies of the reference.
+TEST(IRLibraryTest, FindDuplicatesAndSimilar)
+{
+  const std::string root = uniqueLibraryDirectory();
+  const std::string copies = join(root, "copies");
+  ASSERT_TRUE(makeDirectory(copies));
+  ASSERT_TRUE(writeWavMono(join(root, "200.wav"), makeResonance(200.0f, 4800)));
+  ASSERT_TRUE(writeWavMono(join(copies, "200 copy.wav"), makeResonance(200.0f, 4800)));
+  ASSERT_TRUE(writeWavMono(join(root, "220.wav"), makeResonance(220.0f, 4800)));
+  ASSERT_TRUE(writeWavMono(join(root, "4000.wav"), makeResonance(4000.0f, 4800)));
+  ASSERT_TRUE(writeWavMono(join(root, "noise.wav"), makeNoise(4800)));
+
+  IRLibrary library;
+  library.addFolder(root);
+
+  EXPECT_EQ(library.findDuplicates(join(root, "200.wav")),
+            std::vector<std::string>({join(copies, "200 copy.wav")}));
+  EXPECT_TRUE(library.findDuplicates(join(root, "220.wav")).empty());
+
+  const auto similar = library.findSimilar(join(root, "200.wav"), 2);
+  ASSERT_EQ(similar.size(), 2u);
+  EXPECT_EQ(similar[0], join(root, "220.wav"));
+  EXPECT_EQ(library.findSimilar(join(root, "200.wav"), 10).size(), 3u);
+}
+
+TEST(IRLibraryTest, SaveAndLoad_RestoresIndex)
+{
+  const std::string root = uniqueLibraryDirectory();
+  ASSERT_TRUE(writeWavMono(join(root, "a.wav"), makeResonance(200.0f, 1000)));
+  ASSERT_TRUE(writeText(join(root, "b.nam"), "{}"));
+  const std::string indexFile = join(root, "library.idx");
+
+  LibraryEntry original;
+  {
+    IRLibrary library;
+    library.addFolder(root);
+    ASSERT_TRUE(library.getEntry(join(root, "a.wav"), original));
+    ASSERT_TRUE(library.save(indexFile));
+  }
+
+  IRLibrary restored;
+  ASSERT_TRUE(restored.load(indexFile));
+  EXPECT_TRUE(restored.hasFolder(root));
+  EXPECT_EQ(restored.getNumEntries(), 2u);
+  EXPECT_EQ(restored.getFolderFiles(root, LibraryFileKind::NamModel),
+            std::vector<std::string>({join(root, "b.nam")}));
+
+  LibraryEntry entry;
+  ASSERT_TRUE(restored.getEntry(join(root, "a.wav"), entry));
+  EXPECT_EQ(entry.modifiedTime, original.modifiedTime);
+  EXPECT_EQ(entry.contentKey.contentHash, original.contentKey.contentHash);
+  EXPECT_EQ(entry.numSamples, original.numSamples);
+  for (int band = 0; band < LibraryEntry::FingerprintBands; ++band)
+    EXPECT_EQ(entry.fingerprint[band], original.fingerprint[band]);
+
+  ASSERT_TRUE(writeText(join(root, "corrupt.idx"), "OCTBLIB1 truncated"));
+  EXPECT_FALSE(restored.load(join(root, "corrupt.idx")));
+  EXPECT_EQ(restored.getNumEntries(), 2u);
+}
+
+// Files added and deleted while no session was running reach a restored index.
+TEST(IRLibraryTest, Load_RescansRestoredFolders)
+{
+  const std::string root = uniqueLibraryDirectory();
+  ASSERT_TRUE(writeWavMono(join(root, "a.wav"), makeResonance(200.0f, 1000)));
+  ASSERT_TRUE(writeWavMono(join(root, "b.wav"), makeResonance(200.0f, 1000)));
+  const std::string indexFile = join(root, "library.idx");
+  {
+    IRLibrary library;
+    library.addFolder(root);
+    ASSERT_TRUE(library.save(indexFile));
+  }
+
+  ASSERT_EQ(std::remove(join(root, "a.wav").c_str()), 0);
+  ASSERT_TRUE(writeWavMono(join(root, "c.wav"), makeResonance(200.0f, 1000)));
+
+  IRLibrary restored;
+  ASSERT_TRUE(restored.load(indexFile));
+  restored.waitUntilIdle();
+  EXPECT_EQ(restored.getFolderFiles(root, LibraryFileKind::ImpulseResponse),
+            std::vector<std::string>({join(root, "b.wav"), join(root, "c.wav")}));
+}
+
+TEST(IRLibraryTest, AddFolderInBackground_IndexesOffTheCallingThread)
+{
+  const std::string root = uniqueLibraryDirectory();
+  ASSERT_TRUE(writeWavMono(join(root, "a.wav"), makeResonance(200.0f, 1000)));
+
+  IRLibrary library;
+  library.addFolderInBackground(root);
+  library.waitUntilIdle();
+  EXPECT_TRUE(library.hasFolder(root));
+  EXPECT_EQ(library.getNumEntries(), 1u);
+}
+
+// Without a watcher, a folder is listed directly until it is indexed, and rescanned only
+// once its modification time moves.
+TEST(IRLibraryTest, ListFolder_RescansOnlyChangedFolders)
+{
+  const std::string root = uniqueLibraryDirectory();
+  ASSERT_TRUE(writeWavMono(join(root, "a.wav"), makeResonance(200.0f, 1000)));
+  ASSERT_TRUE(writeText(join(root, "b.nam"), "{}"));
+
+  IRLibrary library;
+  std::vector<std::string> files;
+  EXPECT_FALSE(library.listFolder(join(root, "missing"), LibraryFileKind::NamModel, files));
+  ASSERT_TRUE(library.listFolder(root, LibraryFileKind::NamModel, files));
+  EXPECT_EQ(files, std::vector<std::string>({join(root, "b.nam")}));
+  library.waitUntilIdle();
+  ASSERT_TRUE(library.hasFolder(root));
+
+  // Rewriting a file in place leaves the folder's time alone, so the index keeps the
+  // entry it has.
+  ASSERT_TRUE(writeWavMono(join(root, "a.wav"), makeResonance(200.0f, 3000)));
+  ASSERT_TRUE(library.listFolder(root, LibraryFileKind::ImpulseResponse, files));
+  EXPECT_EQ(files, std::vector<std::string>({join(root, "a.wav")}));
+  library.waitUntilIdle();
+  LibraryEntry entry;
+  ASSERT_TRUE(library.getEntry(join(root, "a.wav"), entry));
+  EXPECT_EQ(entry.numSamples, 1000u);
+
+  ASSERT_TRUE(setModifiedTime(root, 1));
+  library.listFolder(root, LibraryFileKind::ImpulseResponse, files);
+  library.waitUntilIdle();
+  ASSERT_TRUE(library.getEntry(join(root, "a.wav"), entry));
+  EXPECT_EQ(entry.numSamples, 3000u);
+}
+
+#ifdef __linux__
+// With a watcher, files written, edited and deleted after the scan reach the index
+// without another scan.
+TEST(IRLibraryTest, Watching_AppliesChangesAsTheyHappen)
+{
+  const std::string root = uniqueLibraryDirectory();
+  ASSERT_TRUE(writeWavMono(join(root, "a.wav"), makeResonance(200.0f, 1000)));
+
+  IRLibrary library;
+  ASSERT_TRUE(library.startWatching());
+  library.addFolder(root);
+
+  const auto waitFor = [&](size_t numEntries)
+  {
+    for (int i = 0; i < 500 && library.getNumEntries() != numEntries; ++i)
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    library.waitUntilIdle();
+    return library.getNumEntries() == numEntries;
+  };
+
+  ASSERT_TRUE(writeWavMono(join(root, "b.wav"), makeResonance(200.0f, 2000)));
+  ASSERT_TRUE(waitFor(2));
+  LibraryEntry entry;
+  ASSERT_TRUE(library.getEntry(join(root, "b.wav"), entry));
+  EXPECT_EQ(entry.numSamples, 2000u);
+
+  const std::string nested = join(root, "nested");
+  ASSERT_TRUE(makeDirectory(nested));
+  ASSERT_TRUE(waitFor(2));
+  ASSERT_TRUE(writeWavMono(join(nested, "c.wav"), makeResonance(200.0f, 500)));
+  ASSERT_TRUE(waitFor(3));
+
+  ASSERT_EQ(std::remove(join(root, "a.wav").c_str()), 0);
+  ASSERT_TRUE(waitFor(2));
+  EXPECT_FALSE(library.getEntry(join(root, "a.wav"), entry));
+
+  library.stopWatching();
+  EXPECT_FALSE(library.isWatching());
+}
+#endif
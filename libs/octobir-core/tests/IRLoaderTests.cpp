@@ -8,11 +8,13 @@
 #include <gtest/gtest.h>
 
 #include <cmath>
+#include <memory>
 #include <string>
 #include <vector>
 
 // DR_WAV_IMPLEMENTATION is compiled into octobir-core via IRLoader.cpp.
 #include "dr_wav.h"
+#include "octobir-core/IRCache.hpp"
 #include "octobir-core/IRLoader.hpp"
 
 using namespace octob;
@@ -39,6 +41,15 @@ bool writeTempWavMono(const std::string& path, const std::vector<float>& samples
   return true;
 }
 
+// An exponential decay, already minimum phase, padded with silence to paddedLength.
+std::vector<float> makePaddedDecay(int decayLength, int paddedLength)
+{
+  std::vector<float> ir(paddedLength, 0.0f);
+  for (int n = 0; n < decayLength; ++n)
+    ir[n] = std::pow(0.99f, static_cast<float>(n));
+  return ir;
+}
+
 }  // namespace
 
 class IRLoaderTest : public ::testing::Test
@@ -158,3 +169,66 @@ TEST_F(IRLoaderTest, MinimumPhase_EnergyPreserved)
 
   EXPECT_NEAR(bufEnergy, expectedEnergy, expectedEnergy * 0.01);
 }
+
+TEST_F(IRLoaderTest, TailTruncation_OffByDefault)
+{
+  const std::string path = ::testing::TempDir() + "octobir_test_padded_decay_full.wav";
+  ASSERT_TRUE(writeTempWavMono(path, makePaddedDecay(1000, 20000), 48000u));
+
+  IRLoadResult result = loader.loadFromFile(path);
+  ASSERT_TRUE(result.success);
+  EXPECT_EQ(result.numSamples, 20000u);
+  EXPECT_EQ(result.originalNumSamples, 20000u);
+  EXPECT_EQ(result.convolutionCostSaved, 0.0f);
+}
+
+// 0.99^n keeps -60 dB of its energy past n = ln(1e-6) / (2 ln 0.99), about 687 samples;
+// the silence after the decay is cut with it.
+TEST_F(IRLoaderTest, TailTruncation_CutsAtEnergyFloor)
+{
+  const std::string path = ::testing::TempDir() + "octobir_test_padded_decay.wav";
+  ASSERT_TRUE(writeTempWavMono(path, makePaddedDecay(1000, 20000), 48000u));
+
+  loader.setTailFloorDb(-60.0f);
+  IRLoadResult result = loader.loadFromFile(path);
+  ASSERT_TRUE(result.success);
+  EXPECT_NEAR(static_cast<double>(result.numSamples), 687.0, 5.0);
+  EXPECT_EQ(result.originalNumSamples, 20000u);
+  EXPECT_EQ(loader.getNumSamples(), result.numSamples);
+  EXPECT_EQ(loader.getOriginalNumSamples(), 20000u);
+  // 11 of 313 64-sample partitions remain.
+  EXPECT_NEAR(result.convolutionCostSaved, 1.0f - 11.0f / 313.0f, 1e-4f);
+
+  std::vector<float> ir(result.numSamples);
+  loader.copyChannel(0, ir.data());
+  const float compensationGain = std::exp(IrCompensationGainDb * DbToLinearScalar);
+  EXPECT_NEAR(ir[0], compensationGain, compensationGain * 0.01f);
+  // The fade ends the IR near zero rather than at the decay's -60 dB level.
+  EXPECT_LT(std::abs(ir.back()), 0.01f * compensationGain * std::pow(0.99f, 687.0f));
+}
+
+// The cache keeps the whole minimum-phase IR; resampled entries are kept per tail floor.
+TEST_F(IRLoaderTest, TailTruncation_SharesCacheWithWholeIR)
+{
+  const std::string path = ::testing::TempDir() + "octobir_test_padded_decay_cached.wav";
+  ASSERT_TRUE(writeTempWavMono(path, makePaddedDecay(1000, 20000), 48000u));
+  auto cache = std::make_shared<const IRCache>(::testing::TempDir() +
+                                               "octobir_test_tail_truncation_cache");
+
+  auto resampledLength = [&](float floorDb)
+  {
+    IRLoader cached;
+    cached.setCache(cache);
+    cached.setTailFloorDb(floorDb);
+    EXPECT_TRUE(cached.loadFromFile(path).success);
+    WDL_ImpulseBuffer buf;
+    EXPECT_TRUE(cached.resampleAndInitialize(buf, 96000.0));
+    return buf.GetLength();
+  };
+
+  const int truncated = resampledLength(-60.0f);
+  EXPECT_LT(truncated, 2000);
+  EXPECT_EQ(resampledLength(0.0f), 40000);
+  EXPECT_EQ(resampledLength(-60.0f), truncated);
+  EXPECT_EQ(resampledLength(0.0f), 40000);
+}
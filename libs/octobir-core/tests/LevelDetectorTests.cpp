@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "octobir-core/LevelDetector.hpp"
+
+using namespace octob;
+
+namespace
+{
+
+std::vector<Sample> makeNoise(size_t numFrames, float amplitude, unsigned int seed)
+{
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<float> dist(-amplitude, amplitude);
+  std::vector<Sample> noise(numFrames);
+  for (auto& sample : noise)
+    sample = dist(rng);
+  return noise;
+}
+
+// RMS in dB of the window samples ending at end, summed from scratch.
+float referenceRmsDb(const std::vector<Sample>& signal, size_t end, size_t window)
+{
+  double sum = 0.0;
+  for (size_t i = end > window ? end - window : 0; i < end; ++i)
+    sum += static_cast<double>(signal[i]) * signal[i];
+  const double rms = std::sqrt(sum / static_cast<double>(window));
+  return rms < 1e-6 ? LevelDetector::FloorDb : static_cast<float>(20.0 * std::log10(rms));
+}
+
+}  // namespace
+
+TEST(LevelDetectorTest, Peak_FindsLargestMagnitudeAnywhere)
+{
+  std::vector<Sample> buffer(37, 0.1f);
+  EXPECT_FLOAT_EQ(PeakDetector::findPeak(buffer.data(), buffer.size()), 0.1f);
+
+  buffer[5] = -0.75f;
+  EXPECT_FLOAT_EQ(PeakDetector::findPeak(buffer.data(), buffer.size()), 0.75f);
+
+  // In the tail after the last full group of lanes
+  buffer[36] = 0.9f;
+  EXPECT_FLOAT_EQ(PeakDetector::findPeak(buffer.data(), buffer.size()), 0.9f);
+
+  PeakDetector detector;
+  EXPECT_NEAR(detector.process(buffer.data(), buffer.size()), 20.0f * std::log10(0.9f), 1e-4f);
+  EXPECT_FLOAT_EQ(detector.process(buffer.data(), 0), LevelDetector::FloorDb);
+}
+
+TEST(LevelDetectorTest, Rms_MatchesSlidingWindowForAnyBlockSize)
+{
+  constexpr size_t kWindow = 441;
+  const auto signal = makeNoise(kWindow * 7 + 13, 0.5f, 11);
+
+  for (size_t blockSize : {static_cast<size_t>(1), static_cast<size_t>(64),
+                           static_cast<size_t>(1000)})
+  {
+    RmsDetector detector(kWindow * 2);
+    detector.setWindowLength(kWindow);
+    for (size_t offset = 0; offset < signal.size(); offset += blockSize)
+    {
+      const size_t numFrames = std::min(blockSize, signal.size() - offset);
+      const float level = detector.process(signal.data() + offset, numFrames);
+      ASSERT_NEAR(level, referenceRmsDb(signal, offset + numFrames, kWindow), 1e-3f)
+          << "block size " << blockSize << " at " << offset;
+    }
+  }
+}
+
+// Loud input followed by silence must settle back to the floor rather than leaving
+// rounding residue in the running sum.
+TEST(LevelDetectorTest, Rms_DoesNotDriftOverLongRuns)
+{
+  constexpr size_t kWindow = 480;
+  RmsDetector detector(kWindow);
+  detector.setWindowLength(kWindow);
+
+  const auto loud = makeNoise(4096, 1.0f, 5);
+  for (int i = 0; i < 500; ++i)
+    detector.process(loud.data(), loud.size());
+
+  const std::vector<Sample> silence(kWindow * 2, 0.0f);
+  EXPECT_FLOAT_EQ(detector.process(silence.data(), silence.size()), LevelDetector::FloorDb);
+}
+
+TEST(LevelDetectorTest, Rms_WindowLengthIsClampedAndRestarts)
+{
+  RmsDetector detector(100);
+  detector.setWindowLength(1000);
+  EXPECT_EQ(detector.getWindowLength(), 100u);
+  detector.setWindowLength(0);
+  EXPECT_EQ(detector.getWindowLength(), 1u);
+
+  detector.setWindowLength(50);
+  const std::vector<Sample> loud(50, 0.5f);
+  EXPECT_NEAR(detector.process(loud.data(), loud.size()), 20.0f * std::log10(0.5f), 1e-4f);
+
+  detector.setWindowLength(40);
+  const Sample zero = 0.0f;
+  EXPECT_FLOAT_EQ(detector.process(&zero, 1), LevelDetector::FloorDb);
+}
@@ -0,0 +1,258 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "octobir-core/ConvolutionKernel.hpp"
+#include "octobir-core/PartitionedConvolver.hpp"
+
+using namespace octob;
+
+namespace
+{
+
+std::vector<float> randomSignal(size_t length, unsigned int seed)
+{
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+  std::vector<float> signal(length);
+  for (auto& s : signal)
+    s = dist(rng);
+  return signal;
+}
+
+std::vector<float> directConvolution(const std::vector<float>& input, const std::vector<float>& ir)
+{
+  std::vector<float> output(input.size(), 0.0f);
+  for (size_t n = 0; n < input.size(); ++n)
+  {
+    double acc = 0.0;
+    for (size_t k = 0; k < ir.size() && k <= n; ++k)
+      acc += static_cast<double>(ir[k]) * input[n - k];
+    output[n] = static_cast<float>(acc);
+  }
+  return output;
+}
+
+}  // namespace
+
+TEST(ConvolutionKernelTest, RejectsInvalidArguments)
+{
+  std::vector<float> ir(100, 0.5f);
+  const float* channels[] = {ir.data()};
+
+  EXPECT_EQ(ConvolutionKernel::create(channels, 1, 0, 64), nullptr);
+  EXPECT_EQ(ConvolutionKernel::create(channels, 0, ir.size(), 64), nullptr);
+  EXPECT_EQ(ConvolutionKernel::create(channels, 1, ir.size(), 48), nullptr);
+  EXPECT_EQ(ConvolutionKernel::create(channels, 1, ir.size(), 8), nullptr);
+}
+
+TEST(ConvolutionKernelTest, PartitionCountCoversLength)
+{
+  std::vector<float> ir(130, 0.1f);
+  const float* channels[] = {ir.data(), ir.data()};
+
+  auto kernel = ConvolutionKernel::create(channels, 2, ir.size(), 64);
+  ASSERT_NE(kernel, nullptr);
+  EXPECT_EQ(kernel->getNumChannels(), 2);
+  EXPECT_EQ(kernel->getNumPartitions(), 3);
+  EXPECT_EQ(kernel->getBlockSize(), 64);
+  EXPECT_EQ(kernel->getFftSize(), 128);
+  EXPECT_EQ(kernel->getLength(), ir.size());
+}
+
+// Four partitions: signal, a gap, signal. The second channel is empty.
+TEST(ConvolutionKernelTest, EnergyMapMarksSilentPartitionsAndChannels)
+{
+  constexpr int kBlock = 64;
+  auto ir = randomSignal(4 * kBlock, 9);
+  std::fill(ir.begin() + kBlock, ir.begin() + 3 * kBlock, 0.0f);
+  ir[2 * kBlock] = 1e-7f;
+  const std::vector<float> empty(ir.size(), 0.0f);
+  const float* channels[] = {ir.data(), empty.data()};
+
+  auto kernel = ConvolutionKernel::create(channels, 2, ir.size(), kBlock);
+  ASSERT_NE(kernel, nullptr);
+  EXPECT_FALSE(kernel->isPartitionSilent(0, 0));
+  EXPECT_TRUE(kernel->isPartitionSilent(0, 1));
+  EXPECT_TRUE(kernel->isPartitionSilent(0, 2));
+  EXPECT_FALSE(kernel->isPartitionSilent(0, 3));
+  EXPECT_FLOAT_EQ(kernel->getPartitionEnergy(0, 2), 1e-14f);
+  EXPECT_FALSE(kernel->isChannelSilent(0));
+  EXPECT_TRUE(kernel->isChannelSilent(1));
+
+  const KernelDiagnostics& diagnostics = kernel->getDiagnostics();
+  EXPECT_EQ(diagnostics.numChannels, 2);
+  EXPECT_EQ(diagnostics.numPartitions, 4);
+  EXPECT_EQ(diagnostics.numSilentPartitions, 6);
+  EXPECT_EQ(diagnostics.numSilentChannels, 1);
+  EXPECT_TRUE(diagnostics.monoFallback);
+
+  const float* mono[] = {ir.data()};
+  auto monoKernel = ConvolutionKernel::create(mono, 1, ir.size(), kBlock);
+  EXPECT_FALSE(monoKernel->getDiagnostics().monoFallback);
+}
+
+// Partitions below the floor are skipped, and the result still matches in full.
+TEST(PartitionedConvolverTest, SkippedPartitionsLeaveOutputUnchanged)
+{
+  constexpr int kBlock = 32;
+  auto ir = randomSignal(12 * kBlock, 10);
+  std::fill(ir.begin() + 2 * kBlock, ir.begin() + 9 * kBlock, 0.0f);
+  const auto input = randomSignal(kBlock * 30, 11);
+  const auto expected = directConvolution(input, ir);
+
+  const float* channels[] = {ir.data()};
+  auto kernel = ConvolutionKernel::create(channels, 1, ir.size(), kBlock);
+  ASSERT_NE(kernel, nullptr);
+  EXPECT_EQ(kernel->getDiagnostics().numSilentPartitions, 7);
+
+  PartitionedConvolver convolver;
+  ASSERT_TRUE(convolver.prepare(kBlock, kernel->getNumPartitions(), 1));
+  std::vector<float> output(input.size());
+  for (size_t offset = 0; offset < input.size(); offset += kBlock)
+  {
+    convolver.pushBlock(input.data() + offset);
+    convolver.accumulate(*kernel, 0, 1.0f, 0);
+    convolver.finish(0, output.data() + offset);
+  }
+
+  for (size_t i = 0; i < output.size(); ++i)
+    ASSERT_NEAR(output[i], expected[i], 1e-3f) << "sample " << i;
+}
+
+TEST(PartitionedConvolverTest, MatchesDirectConvolution)
+{
+  constexpr int kBlock = 64;
+  const auto ir = randomSignal(1000, 1);
+  const auto input = randomSignal(kBlock * 40, 2);
+  const auto expected = directConvolution(input, ir);
+
+  const float* channels[] = {ir.data()};
+  auto kernel = ConvolutionKernel::create(channels, 1, ir.size(), kBlock);
+  ASSERT_NE(kernel, nullptr);
+
+  PartitionedConvolver convolver;
+  ASSERT_TRUE(convolver.prepare(kBlock, kernel->getNumPartitions(), 1));
+
+  std::vector<float> output(input.size());
+  for (size_t offset = 0; offset < input.size(); offset += kBlock)
+  {
+    convolver.pushBlock(input.data() + offset);
+    convolver.accumulate(*kernel, 0, 1.0f, 0);
+    convolver.finish(0, output.data() + offset);
+  }
+
+  for (size_t i = 0; i < output.size(); ++i)
+    ASSERT_NEAR(output[i], expected[i], 1e-3f) << "sample " << i;
+}
+
+TEST(PartitionedConvolverTest, AccumulatesWeightedKernelsWithOneInverse)
+{
+  constexpr int kBlock = 32;
+  const auto irA = randomSignal(200, 3);
+  const auto irB = randomSignal(90, 4);
+  const auto input = randomSignal(kBlock * 20, 5);
+  const auto expectedA = directConvolution(input, irA);
+  const auto expectedB = directConvolution(input, irB);
+
+  const float* channelsA[] = {irA.data()};
+  const float* channelsB[] = {irB.data()};
+  auto kernelA = ConvolutionKernel::create(channelsA, 1, irA.size(), kBlock);
+  auto kernelB = ConvolutionKernel::create(channelsB, 1, irB.size(), kBlock);
+  ASSERT_NE(kernelA, nullptr);
+  ASSERT_NE(kernelB, nullptr);
+
+  PartitionedConvolver convolver;
+  ASSERT_TRUE(convolver.prepare(kBlock, kernelA->getNumPartitions(), 1));
+
+  const float gainA = 0.7f;
+  const float gainB = -0.3f;
+  std::vector<float> output(input.size());
+  for (size_t offset = 0; offset < input.size(); offset += kBlock)
+  {
+    convolver.pushBlock(input.data() + offset);
+    convolver.accumulate(*kernelA, 0, gainA, 0);
+    convolver.accumulate(*kernelB, 0, gainB, 0);
+    convolver.finish(0, output.data() + offset);
+  }
+
+  for (size_t i = 0; i < output.size(); ++i)
+    ASSERT_NEAR(output[i], gainA * expectedA[i] + gainB * expectedB[i], 1e-3f) << "sample " << i;
+}
+
+TEST(PartitionedConvolverTest, SharedKernelServesIndependentConvolvers)
+{
+  constexpr int kBlock = 64;
+  const auto ir = randomSignal(300, 6);
+  const auto input1 = randomSignal(kBlock * 10, 7);
+  const auto input2 = randomSignal(kBlock * 10, 8);
+
+  const float* channels[] = {ir.data()};
+  auto kernel = ConvolutionKernel::create(channels, 1, ir.size(), kBlock);
+  ASSERT_NE(kernel, nullptr);
+
+  PartitionedConvolver voice1;
+  PartitionedConvolver voice2;
+  ASSERT_TRUE(voice1.prepare(kBlock, kernel->getNumPartitions(), 1));
+  ASSERT_TRUE(voice2.prepare(kBlock, kernel->getNumPartitions(), 1));
+
+  const auto expected1 = directConvolution(input1, ir);
+  const auto expected2 = directConvolution(input2, ir);
+  std::vector<float> out1(input1.size());
+  std::vector<float> out2(input2.size());
+  for (size_t offset = 0; offset < input1.size(); offset += kBlock)
+  {
+    voice1.pushBlock(input1.data() + offset);
+    voice2.pushBlock(input2.data() + offset);
+    voice1.accumulate(*kernel, 0, 1.0f, 0);
+    voice2.accumulate(*kernel, 0, 1.0f, 0);
+    voice1.finish(0, out1.data() + offset);
+    voice2.finish(0, out2.data() + offset);
+  }
+
+  for (size_t i = 0; i < out1.size(); ++i)
+  {
+    ASSERT_NEAR(out1[i], expected1[i], 1e-3f);
+    ASSERT_NEAR(out2[i], expected2[i], 1e-3f);
+  }
+}
+
+TEST(PartitionedConvolverTest, ResetClearsHistory)
+{
+  constexpr int kBlock = 16;
+  std::vector<float> ir(64, 0.25f);
+  const float* channels[] = {ir.data()};
+  auto kernel = ConvolutionKernel::create(channels, 1, ir.size(), kBlock);
+  ASSERT_NE(kernel, nullptr);
+
+  PartitionedConvolver convolver;
+  ASSERT_TRUE(convolver.prepare(kBlock, kernel->getNumPartitions(), 1));
+
+  std::vector<float> loud(kBlock, 1.0f);
+  std::vector<float> silence(kBlock, 0.0f);
+  std::vector<float> output(kBlock);
+  convolver.pushBlock(loud.data());
+  convolver.accumulate(*kernel, 0, 1.0f, 0);
+  convolver.finish(0, output.data());
+
+  convolver.reset();
+  convolver.pushBlock(silence.data());
+  convolver.accumulate(*kernel, 0, 1.0f, 0);
+  convolver.finish(0, output.data());
+
+  for (float s : output)
+    EXPECT_NEAR(s, 0.0f, 1e-6f);
+}
+
+TEST(PartitionedConvolverTest, PrepareRejectsInvalidBlockSize)
+{
+  PartitionedConvolver convolver;
+  EXPECT_FALSE(convolver.prepare(100, 4, 1));
+  EXPECT_FALSE(convolver.prepare(64, 0, 1));
+  EXPECT_TRUE(convolver.prepare(64, 4, 2));
+  EXPECT_EQ(convolver.getBlockSize(), 64);
+  EXPECT_EQ(convolver.getMaxPartitions(), 4);
+}
@@ -0,0 +1,224 @@
+#include "RealtimeGuard.hpp"
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+// Sanitizers interpose malloc and the pthread functions themselves; under them only
+// operator new and delete are replaced.
+#if defined(__SANITIZE_ADDRESS__) || defined(__SANITIZE_THREAD__)
+#define OCTOB_REALTIME_GUARD_SANITIZED 1
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer) || __has_feature(thread_sanitizer) || \
+    __has_feature(memory_sanitizer)
+#define OCTOB_REALTIME_GUARD_SANITIZED 1
+#endif
+#endif
+
+#if defined(__GLIBC__) && !defined(OCTOB_REALTIME_GUARD_SANITIZED)
+#define OCTOB_REALTIME_GUARD_LIBC 1
+#include <dlfcn.h>
+#include <errno.h>
+#include <pthread.h>
+#endif
+
+namespace octob
+{
+
+thread_local RealtimeScope* RealtimeScope::active_ = nullptr;
+
+RealtimeScope::RealtimeScope() : previous_(active_)
+{
+  active_ = this;
+}
+
+RealtimeScope::~RealtimeScope()
+{
+  active_ = previous_;
+}
+
+void RealtimeScope::noteAllocation()
+{
+  if (active_ != nullptr)
+    ++active_->report_.allocations;
+}
+
+void RealtimeScope::noteFree()
+{
+  if (active_ != nullptr)
+    ++active_->report_.frees;
+}
+
+void RealtimeScope::noteLock()
+{
+  if (active_ != nullptr)
+    ++active_->report_.locks;
+}
+
+bool RealtimeScope::detectsLocks()
+{
+#if defined(OCTOB_REALTIME_GUARD_LIBC)
+  return true;
+#else
+  return false;
+#endif
+}
+
+std::string RealtimeReport::describe() const
+{
+  return std::to_string(allocations) + " allocations, " + std::to_string(frees) + " frees, " +
+         std::to_string(locks) + " mutex locks";
+}
+
+}  // namespace octob
+
+#if defined(OCTOB_REALTIME_GUARD_LIBC)
+
+// glibc lets the executable replace the C allocator. Forward to its internal entry
+// points so allocation itself is unchanged; operator new and delete go through these.
+extern "C"
+{
+  void* __libc_malloc(size_t size);
+  void* __libc_calloc(size_t count, size_t size);
+  void* __libc_realloc(void* ptr, size_t size);
+  void* __libc_memalign(size_t alignment, size_t size);
+  void __libc_free(void* ptr);
+
+  void* malloc(size_t size) noexcept
+  {
+    octob::RealtimeScope::noteAllocation();
+    return __libc_malloc(size);
+  }
+
+  void* calloc(size_t count, size_t size) noexcept
+  {
+    octob::RealtimeScope::noteAllocation();
+    return __libc_calloc(count, size);
+  }
+
+  void* realloc(void* ptr, size_t size) noexcept
+  {
+    octob::RealtimeScope::noteAllocation();
+    return __libc_realloc(ptr, size);
+  }
+
+  void* memalign(size_t alignment, size_t size) noexcept
+  {
+    octob::RealtimeScope::noteAllocation();
+    return __libc_memalign(alignment, size);
+  }
+
+  void* aligned_alloc(size_t alignment, size_t size) noexcept
+  {
+    octob::RealtimeScope::noteAllocation();
+    return __libc_memalign(alignment, size);
+  }
+
+  int posix_memalign(void** ptr, size_t alignment, size_t size) noexcept
+  {
+    octob::RealtimeScope::noteAllocation();
+    if (alignment < sizeof(void*) || (alignment & (alignment - 1)) != 0)
+      return EINVAL;
+    void* block = __libc_memalign(alignment, size);
+    if (block == nullptr)
+      return ENOMEM;
+    *ptr = block;
+    return 0;
+  }
+
+  void free(void* ptr) noexcept
+  {
+    if (ptr != nullptr)
+      octob::RealtimeScope::noteFree();
+    __libc_free(ptr);
+  }
+
+  // std::mutex::lock() ends up here. The real function is looked up once at startup;
+  // the dynamic loader's own locking does not go through this symbol.
+  using PthreadMutexLock = int (*)(pthread_mutex_t*);
+
+  static PthreadMutexLock realMutexLock()
+  {
+    static PthreadMutexLock lock = nullptr;
+    if (lock == nullptr)
+      lock = reinterpret_cast<PthreadMutexLock>(dlsym(RTLD_NEXT, "pthread_mutex_lock"));
+    return lock;
+  }
+
+  int pthread_mutex_lock(pthread_mutex_t* mutex) noexcept
+  {
+    octob::RealtimeScope::noteLock();
+    return realMutexLock()(mutex);
+  }
+}
+
+namespace
+{
+
+struct ResolveAtStartup
+{
+  ResolveAtStartup() { realMutexLock(); }
+} resolveAtStartup;
+
+}  // namespace
+
+#else
+
+// Elsewhere only C++ allocations are counted and locks are not detected.
+void* operator new(std::size_t size)
+{
+  octob::RealtimeScope::noteAllocation();
+  if (void* block = std::malloc(size == 0 ? 1 : size))
+    return block;
+  throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+  return ::operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+  octob::RealtimeScope::noteAllocation();
+  return std::malloc(size == 0 ? 1 : size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t& tag) noexcept
+{
+  return ::operator new(size, tag);
+}
+
+void operator delete(void* ptr) noexcept
+{
+  if (ptr != nullptr)
+    octob::RealtimeScope::noteFree();
+  std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+  ::operator delete(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+  ::operator delete(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept
+{
+  ::operator delete(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept
+{
+  ::operator delete(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept
+{
+  ::operator delete(ptr);
+}
+
+#endif
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <string>
+
+namespace octob
+{
+
+// Test-only check that audio-thread code neither allocates nor blocks.
+//
+// While a RealtimeScope is alive, heap allocations, frees and mutex locks made by the
+// thread that created it are counted; other threads are unaffected. Test executables
+// link RealtimeGuard.cpp, which replaces the global allocation functions and, on glibc
+// without sanitizers, malloc, free and pthread_mutex_lock to do the counting.
+struct RealtimeReport
+{
+  long allocations = 0;
+  long frees = 0;
+  long locks = 0;
+
+  bool isClean() const { return allocations == 0 && frees == 0 && locks == 0; }
+  std::string describe() const;
+};
+
+class RealtimeScope
+{
+ public:
+  RealtimeScope();
+  ~RealtimeScope();
+
+  RealtimeScope(const RealtimeScope&) = delete;
+  RealtimeScope& operator=(const RealtimeScope&) = delete;
+
+  const RealtimeReport& getReport() const { return report_; }
+
+  // Whether mutex locks are intercepted on this platform. Allocations always are.
+  static bool detectsLocks();
+
+  // Called by the replaced functions.
+  static void noteAllocation();
+  static void noteFree();
+  static void noteLock();
+
+ private:
+  static thread_local RealtimeScope* active_;
+
+  RealtimeScope* previous_;
+  RealtimeReport report_;
+};
+
+// Runs fn inside a RealtimeScope and returns what it did.
+template <typename Fn>
+RealtimeReport runRealtime(Fn&& fn)
+{
+  RealtimeScope scope;
+  fn();
+  return scope.getReport();
+}
+
+}  // namespace octob
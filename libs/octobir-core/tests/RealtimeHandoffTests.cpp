@@ -0,0 +1,195 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "octobir-core/ConvolutionEngine.hpp"
+#include "octobir-core/IRProcessor.hpp"
+#include "octobir-core/RealtimeHandoff.hpp"
+
+using namespace octob;
+
+namespace
+{
+
+std::atomic<int> liveObjects{0};
+
+struct Counted
+{
+  explicit Counted(int v) : value(v) { ++liveObjects; }
+  ~Counted() { --liveObjects; }
+  int value;
+};
+
+std::unique_ptr<Counted> make(int value)
+{
+  return std::unique_ptr<Counted>(new Counted(value));
+}
+
+constexpr FrameCount kBlock = 256;
+
+const std::string kIrAPath = std::string(TEST_DATA_DIR) + "/INPUT_ir_a.wav";
+const std::string kIrBPath = std::string(TEST_DATA_DIR) + "/INPUT_ir_b.wav";
+
+std::vector<Sample> renderImpulse(IRProcessor& processor)
+{
+  std::vector<Sample> input(kBlock * 16, 0.0f);
+  input[0] = 1.0f;
+  std::vector<Sample> output(input.size(), 0.0f);
+  for (size_t offset = 0; offset < input.size(); offset += kBlock)
+    processor.processMono(input.data() + offset, output.data() + offset, kBlock);
+  return output;
+}
+
+}  // namespace
+
+TEST(RealtimeHandoffTest, ReaderSeesNothingUntilAcquire)
+{
+  RealtimeHandoff<Counted> handoff;
+  EXPECT_EQ(handoff.get(), nullptr);
+  EXPECT_FALSE(handoff.acquire());
+
+  handoff.publish(make(1));
+  EXPECT_EQ(handoff.get(), nullptr);
+  ASSERT_TRUE(handoff.acquire());
+  EXPECT_EQ(handoff.get()->value, 1);
+  EXPECT_FALSE(handoff.acquire());
+}
+
+TEST(RealtimeHandoffTest, UnacquiredPublicationIsReplacedAndFreed)
+{
+  liveObjects = 0;
+  {
+    RealtimeHandoff<Counted> handoff;
+    handoff.publish(make(1));
+    handoff.publish(make(2));
+    EXPECT_EQ(liveObjects.load(), 1);
+
+    ASSERT_TRUE(handoff.acquire());
+    EXPECT_EQ(handoff.get()->value, 2);
+  }
+  EXPECT_EQ(liveObjects.load(), 0);
+}
+
+// The reader only parks the object it replaces; the control side frees it later.
+TEST(RealtimeHandoffTest, RetiredObjectsAreFreedByControlSide)
+{
+  liveObjects = 0;
+  RealtimeHandoff<Counted> handoff;
+  handoff.publish(make(1));
+  handoff.acquire();
+  handoff.publish(make(2));
+  handoff.acquire();
+  EXPECT_EQ(liveObjects.load(), 2);
+
+  handoff.collect();
+  EXPECT_EQ(liveObjects.load(), 1);
+  EXPECT_EQ(handoff.get()->value, 2);
+}
+
+TEST(RealtimeHandoffTest, ConcurrentReaderSeesPublicationsInOrder)
+{
+  liveObjects = 0;
+  constexpr int kPublications = 20000;
+  {
+    RealtimeHandoff<Counted> handoff;
+    std::atomic<bool> done{false};
+    bool ordered = true;
+    int last = 0;
+
+    std::thread reader(
+        [&]
+        {
+          for (;;)
+          {
+            const bool finished = done.load();
+            if (handoff.acquire())
+            {
+              ordered = ordered && handoff.get()->value > last;
+              last = handoff.get()->value;
+            }
+            else if (finished)
+            {
+              break;
+            }
+          }
+        });
+
+    for (int i = 1; i <= kPublications; ++i)
+      handoff.publish(make(i));
+    done = true;
+    reader.join();
+
+    EXPECT_TRUE(ordered);
+    EXPECT_EQ(last, kPublications);
+  }
+  EXPECT_EQ(liveObjects.load(), 0);
+}
+
+// Loads, clears, swaps and engine changes land while another thread is processing;
+// once the control side stops, the output matches a processor set up directly.
+TEST(RealtimeHandoffTest, IRProcessorHotSwapsWhileProcessing)
+{
+  IRProcessor processor;
+  processor.setSampleRate(48000.0);
+  processor.setMaxBlockSize(kBlock);
+
+  std::atomic<bool> done{false};
+  std::thread audio(
+      [&]
+      {
+        // Silence, so no engine or delay line holds signal once the swaps stop.
+        std::vector<Sample> input(kBlock, 0.0f);
+        std::vector<Sample> outputL(kBlock);
+        std::vector<Sample> outputR(kBlock);
+        while (!done.load())
+          processor.processStereo(input.data(), input.data(), outputL.data(), outputR.data(),
+                                  kBlock);
+      });
+
+  std::string error;
+  for (int i = 0; i < 20; ++i)
+  {
+    EXPECT_TRUE(processor.loadImpulseResponse1(i % 2 ? kIrAPath : kIrBPath, error)) << error;
+    EXPECT_TRUE(processor.loadImpulseResponse2(kIrAPath, error)) << error;
+    processor.setIRAEngine(i % 3 == 0 ? ConvolutionEngineType::Pffft : ConvolutionEngineType::Auto);
+    processor.swapIRSlots();
+    processor.clearImpulseResponse2();
+  }
+  processor.setIRAEngine(ConvolutionEngineType::Pffft);
+  ASSERT_TRUE(processor.loadImpulseResponse2(kIrBPath, error)) << error;
+  done = true;
+  audio.join();
+
+  IRProcessor reference;
+  reference.setSampleRate(48000.0);
+  reference.setMaxBlockSize(kBlock);
+  reference.setIRAEngine(ConvolutionEngineType::Pffft);
+  ASSERT_TRUE(reference.loadImpulseResponse1(processor.getCurrentIR1Path(), error)) << error;
+  ASSERT_TRUE(reference.loadImpulseResponse2(kIrBPath, error)) << error;
+
+  const auto output = renderImpulse(processor);
+  const auto expected = renderImpulse(reference);
+  EXPECT_EQ(processor.getLatencySamples(), reference.getLatencySamples());
+  for (size_t i = 0; i < output.size(); ++i)
+    ASSERT_NEAR(output[i], expected[i], 1e-5f) << "sample " << i;
+}
+
+// Engine latency stays within the bound the alignment buffers are allocated for.
+TEST(RealtimeHandoffTest, EngineLatencyStaysWithinPreallocatedBound)
+{
+  IRProcessor processor;
+  processor.setSampleRate(48000.0);
+  processor.setMaxBlockSize(kBlock);
+  processor.setIRAEngine(ConvolutionEngineType::Pffft);
+
+  std::string error;
+  ASSERT_TRUE(processor.loadImpulseResponse1(kIrAPath, error)) << error;
+  renderImpulse(processor);
+  const int bound = ConvolutionEngine::MaxLatencySamples;
+  EXPECT_GT(processor.getLatencySamples(), 0);
+  EXPECT_LE(processor.getLatencySamples(), bound);
+}
@@ -0,0 +1,186 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "RealtimeGuard.hpp"
+#include "octobir-core/IRProcessor.hpp"
+
+using namespace octob;
+
+// Every process* entry point must run without allocating, freeing or locking once the
+// processor is prepared, including on the call that picks up a new IR.
+
+namespace
+{
+
+constexpr FrameCount kBlock = 256;
+
+const std::string kIrAPath = std::string(TEST_DATA_DIR) + "/INPUT_ir_a.wav";
+const std::string kIrBPath = std::string(TEST_DATA_DIR) + "/INPUT_ir_b.wav";
+
+// Every engine type. WDL grows its internal queues on first use, so IRProcessor warms
+// it up on the control thread before handing it to the audio thread.
+struct EngineSetup
+{
+  const char* name;
+  ConvolutionEngineType type;
+  bool zeroLatency;
+  bool backgroundTail;
+};
+
+const EngineSetup kEngineSetups[] = {
+    {"Pffft", ConvolutionEngineType::Pffft, false, false},
+    {"PffftZeroLatency", ConvolutionEngineType::Pffft, true, false},
+    {"PffftBackgroundTail", ConvolutionEngineType::Pffft, true, true},
+    {"Direct", ConvolutionEngineType::Direct, false, false},
+    {"Wdl", ConvolutionEngineType::Wdl, false, false},
+    {"Auto", ConvolutionEngineType::Auto, false, false},
+};
+
+struct Buffers
+{
+  std::vector<Sample> inL = std::vector<Sample>(kBlock, 0.1f);
+  std::vector<Sample> inR = std::vector<Sample>(kBlock, -0.1f);
+  std::vector<Sample> sideL = std::vector<Sample>(kBlock, 0.5f);
+  std::vector<Sample> sideR = std::vector<Sample>(kBlock, 0.5f);
+  std::vector<Sample> outL = std::vector<Sample>(kBlock);
+  std::vector<Sample> outR = std::vector<Sample>(kBlock);
+};
+
+// Runs each entry point once.
+void processEveryEntryPoint(IRProcessor& processor, Buffers& b)
+{
+  processor.processMono(b.inL.data(), b.outL.data(), kBlock);
+  processor.processStereo(b.inL.data(), b.inR.data(), b.outL.data(), b.outR.data(), kBlock);
+  processor.processMonoToStereo(b.inL.data(), b.outL.data(), b.outR.data(), kBlock);
+  processor.processMonoWithSidechain(b.inL.data(), b.sideL.data(), b.outL.data(), kBlock);
+  processor.processMonoToStereoWithSidechain(b.inL.data(), b.sideL.data(), b.outL.data(),
+                                             b.outR.data(), kBlock);
+  processor.processStereoWithSidechain(b.inL.data(), b.inR.data(), b.sideL.data(),
+                                       b.sideR.data(), b.outL.data(), b.outR.data(), kBlock);
+}
+
+void prepare(IRProcessor& processor, const EngineSetup& setup)
+{
+  processor.setSampleRate(48000.0);
+  processor.setMaxBlockSize(kBlock);
+  processor.setIRAEngine(setup.type);
+  processor.setIRBEngine(setup.type);
+  processor.setZeroLatencyMode(setup.zeroLatency);
+  processor.setBackgroundTailEnabled(setup.backgroundTail);
+}
+
+}  // namespace
+
+TEST(RealtimeSafetyTest, GuardCountsAllocationsAndLocks)
+{
+  std::mutex mutex;
+  const RealtimeReport report = runRealtime(
+      [&]
+      {
+        std::unique_ptr<int> value(new int(1));
+        std::lock_guard<std::mutex> lock(mutex);
+      });
+
+  EXPECT_EQ(report.allocations, 1);
+  EXPECT_EQ(report.frees, 1);
+  if (RealtimeScope::detectsLocks())
+  {
+    EXPECT_EQ(report.locks, 1);
+  }
+  EXPECT_TRUE(runRealtime([] {}).isClean());
+}
+
+TEST(RealtimeSafetyTest, EntryPointsAreRealtimeSafeInEveryMode)
+{
+  for (const auto& setup : kEngineSetups)
+  {
+    for (int detectionMode = 0; detectionMode < 2; ++detectionMode)
+    {
+      SCOPED_TRACE(std::string(setup.name) + " detection " + std::to_string(detectionMode));
+      IRProcessor processor;
+      prepare(processor, setup);
+      processor.setDynamicModeEnabled(true);
+      processor.setDetectionMode(detectionMode);
+      Buffers buffers;
+
+      std::string error;
+      ASSERT_TRUE(processor.loadImpulseResponse1(kIrAPath, error)) << error;
+      auto report = runRealtime([&] { processEveryEntryPoint(processor, buffers); });
+      EXPECT_TRUE(report.isClean()) << "one slot: " << report.describe();
+
+      ASSERT_TRUE(processor.loadImpulseResponse2(kIrBPath, error)) << error;
+      report = runRealtime([&] { processEveryEntryPoint(processor, buffers); });
+      EXPECT_TRUE(report.isClean()) << "both slots: " << report.describe();
+
+      processor.swapIRSlots();
+      processor.clearImpulseResponse1();
+      report = runRealtime([&] { processEveryEntryPoint(processor, buffers); });
+      EXPECT_TRUE(report.isClean()) << "after swap and clear: " << report.describe();
+    }
+  }
+}
+
+// A second thread keeps loading, clearing and swapping IRs and changing the sample
+// rate and engines while the audio thread sets parameters and processes.
+TEST(RealtimeSafetyTest, EntryPointsStayRealtimeSafeUnderConcurrentChanges)
+{
+  IRProcessor processor;
+  prepare(processor, kEngineSetups[0]);
+  processor.setDynamicModeEnabled(true);
+  std::string error;
+  ASSERT_TRUE(processor.loadImpulseResponse1(kIrAPath, error)) << error;
+
+  std::atomic<bool> done{false};
+  std::atomic<int> requestsDone{0};
+  std::thread control(
+      [&]
+      {
+        std::string loadError;
+        for (int i = 0; i < 12; ++i)
+        {
+          processor.loadImpulseResponse2(i % 2 ? kIrAPath : kIrBPath, loadError);
+          processor.requestLoad(1, i % 2 ? kIrBPath : kIrAPath,
+                                [&](const IRLoadCompletion&) { ++requestsDone; });
+          processor.swapIRSlots();
+          processor.setSampleRate(i % 3 == 0 ? 44100.0 : 48000.0);
+          processor.setIRBEngine(i % 2 ? ConvolutionEngineType::Direct
+                                       : ConvolutionEngineType::Pffft);
+          processor.setZeroLatencyMode(i % 4 == 0);
+          processor.clearImpulseResponse2();
+        }
+        processor.cancelPendingLoads();
+        done = true;
+      });
+
+  Buffers buffers;
+  RealtimeReport total;
+  long blocks = 0;
+  while (!done.load())
+  {
+    // Hosts such as Rack apply parameters from the audio thread; RMS detection follows
+    // the sample rate changes.
+    const RealtimeReport report = runRealtime(
+        [&]
+        {
+          processor.setDetectionMode(1);
+          processor.setBlend(blocks % 2 ? 0.5f : -0.5f);
+          processor.setAttackTime(blocks % 2 ? 10.0f : 50.0f);
+          processEveryEntryPoint(processor, buffers);
+        });
+    total.allocations += report.allocations;
+    total.frees += report.frees;
+    total.locks += report.locks;
+    ++blocks;
+  }
+  control.join();
+
+  EXPECT_GT(blocks, 0);
+  EXPECT_EQ(requestsDone.load(), 12);
+  EXPECT_TRUE(total.isClean()) << total.describe() << " over " << blocks << " blocks";
+}
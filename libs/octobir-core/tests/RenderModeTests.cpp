@@ -0,0 +1,213 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "octobir-core/ForkJoinWorker.hpp"
+#include "octobir-core/IRProcessor.hpp"
+#include "octobir-core/PffftConvolutionEngine.hpp"
+
+using namespace octob;
+
+static const std::string kIrAPath = std::string(TEST_DATA_DIR) + "/INPUT_ir_a.wav";
+static const std::string kIrBPath = std::string(TEST_DATA_DIR) + "/INPUT_ir_b.wav";
+static const std::string kHallPath = std::string(TEST_DATA_DIR) + "/INPUT_long_stereo_hall.wav";
+
+namespace
+{
+
+constexpr int kBlockSize = 256;
+constexpr int kNumBlocks = 40;
+
+std::vector<Sample> makeNoise(size_t numFrames)
+{
+  std::mt19937 rng(7);
+  std::uniform_real_distribution<float> dist(-0.5f, 0.5f);
+  std::vector<Sample> noise(numFrames);
+  for (auto& sample : noise)
+    sample = dist(rng);
+  return noise;
+}
+
+std::vector<Sample> render(IRProcessor& processor, const std::vector<Sample>& input)
+{
+  std::vector<Sample> output(input.size(), 0.0f);
+  for (size_t offset = 0; offset < input.size(); offset += kBlockSize)
+    processor.processMono(input.data() + offset, output.data() + offset, kBlockSize);
+  return output;
+}
+
+void prepare(IRProcessor& processor)
+{
+  processor.setSampleRate(48000.0);
+  processor.setMaxBlockSize(kBlockSize);
+}
+
+// Compares a against b once each is shifted back by its latency.
+void expectAligned(const std::vector<Sample>& a, int latencyA, const std::vector<Sample>& b,
+                   int latencyB, float tolerance)
+{
+  const size_t length = a.size() - static_cast<size_t>(std::max(latencyA, latencyB));
+  float peak = 0.0f;
+  for (size_t i = 0; i < length; ++i)
+  {
+    const Sample expected = b[i + static_cast<size_t>(latencyB)];
+    peak = std::max(peak, std::abs(expected));
+    ASSERT_NEAR(a[i + static_cast<size_t>(latencyA)], expected, tolerance) << "at sample " << i;
+  }
+  EXPECT_GT(peak, 1e-3f);
+}
+
+}  // namespace
+
+TEST(ForkJoinWorkerTest, RunsTaskInlineWithoutThread)
+{
+  ForkJoinWorker worker;
+  int value = 0;
+  worker.fork([](void* context) { *static_cast<int*>(context) = 42; }, &value);
+  EXPECT_EQ(value, 42);
+  worker.join();
+  EXPECT_FALSE(worker.isRunning());
+}
+
+TEST(ForkJoinWorkerTest, RunsTaskOnHelperThreadUntilJoin)
+{
+  ForkJoinWorker worker;
+  worker.start();
+  ASSERT_TRUE(worker.isRunning());
+
+  std::atomic<int> count{0};
+  for (int i = 0; i < 1000; ++i)
+  {
+    worker.fork([](void* context) { static_cast<std::atomic<int>*>(context)->fetch_add(1); },
+                &count);
+    worker.join();
+    ASSERT_EQ(count.load(), i + 1);
+  }
+}
+
+TEST(RenderModeTest, PffftSlotUsesRenderBlockLatency)
+{
+  IRProcessor processor;
+  prepare(processor);
+  std::string err;
+  processor.setIRAEngine(ConvolutionEngineType::Pffft);
+  ASSERT_TRUE(processor.loadImpulseResponse1(kIrAPath, err)) << err;
+  processor.setIRBEnabled(false);
+
+  processor.setRenderMode(true);
+  EXPECT_TRUE(processor.getRenderMode());
+  EXPECT_EQ(processor.getStagedLatencySamples(), PffftConvolutionEngine::RenderBlockSize);
+
+  std::vector<Sample> block(kBlockSize, 0.0f);
+  processor.processMono(block.data(), block.data(), kBlockSize);
+  EXPECT_EQ(processor.getLatencySamples(), PffftConvolutionEngine::RenderBlockSize);
+}
+
+TEST(RenderModeTest, AutoPicksLargePartitionsForLongIR)
+{
+  IRProcessor processor;
+  prepare(processor);
+  std::string err;
+  ASSERT_TRUE(processor.loadImpulseResponse1(kHallPath, err)) << err;
+  EXPECT_EQ(processor.getStagedLatencySamples(), 0);
+
+  processor.setRenderMode(true);
+  EXPECT_EQ(processor.getStagedLatencySamples(), PffftConvolutionEngine::RenderBlockSize);
+}
+
+TEST(RenderModeTest, ZeroLatencyModeKeepsRealtimeEngines)
+{
+  IRProcessor processor;
+  prepare(processor);
+  std::string err;
+  processor.setZeroLatencyMode(true);
+  processor.setIRAEngine(ConvolutionEngineType::Pffft);
+  ASSERT_TRUE(processor.loadImpulseResponse1(kIrAPath, err)) << err;
+
+  processor.setRenderMode(true);
+  EXPECT_EQ(processor.getStagedLatencySamples(), 0);
+}
+
+TEST(RenderModeTest, MatchesRealtimeOutputAfterLatency)
+{
+  const auto input = makeNoise(kBlockSize * kNumBlocks);
+  std::string err;
+
+  IRProcessor realtime;
+  prepare(realtime);
+  realtime.setIRAEngine(ConvolutionEngineType::Pffft);
+  ASSERT_TRUE(realtime.loadImpulseResponse1(kHallPath, err)) << err;
+  realtime.setIRBEnabled(false);
+  const auto expected = render(realtime, input);
+
+  IRProcessor rendering;
+  prepare(rendering);
+  rendering.setIRAEngine(ConvolutionEngineType::Pffft);
+  ASSERT_TRUE(rendering.loadImpulseResponse1(kHallPath, err)) << err;
+  rendering.setIRBEnabled(false);
+  rendering.setRenderMode(true);
+  const auto output = render(rendering, input);
+
+  expectAligned(output, rendering.getLatencySamples(), expected, realtime.getLatencySamples(),
+                1e-4f);
+}
+
+// Both slots run their own engines, slot B on the helper thread.
+TEST(RenderModeTest, ParallelSlotsMatchRealtimeBlend)
+{
+  // Leading silence lets the blend smoothing settle in both before the aligned signal.
+  auto input = makeNoise(kBlockSize * kNumBlocks);
+  std::fill(input.begin(), input.begin() + kBlockSize * 10, 0.0f);
+  std::string err;
+
+  IRProcessor realtime;
+  prepare(realtime);
+  realtime.setIRAEngine(ConvolutionEngineType::Pffft);
+  realtime.setIRBEngine(ConvolutionEngineType::Pffft);
+  ASSERT_TRUE(realtime.loadImpulseResponse1(kIrAPath, err)) << err;
+  ASSERT_TRUE(realtime.loadImpulseResponse2(kIrBPath, err)) << err;
+  realtime.setBlend(0.3f);
+  const auto expected = render(realtime, input);
+
+  IRProcessor rendering;
+  prepare(rendering);
+  rendering.setIRAEngine(ConvolutionEngineType::Pffft);
+  rendering.setIRBEngine(ConvolutionEngineType::Pffft);
+  ASSERT_TRUE(rendering.loadImpulseResponse1(kIrAPath, err)) << err;
+  ASSERT_TRUE(rendering.loadImpulseResponse2(kIrBPath, err)) << err;
+  rendering.setBlend(0.3f);
+  rendering.setRenderMode(true);
+  const auto output = render(rendering, input);
+
+  EXPECT_EQ(rendering.getLatencySamples(), PffftConvolutionEngine::RenderBlockSize);
+  expectAligned(output, rendering.getLatencySamples(), expected, realtime.getLatencySamples(),
+                1e-4f);
+}
+
+TEST(RenderModeTest, SwitchingBackRestoresRealtimeLatency)
+{
+  IRProcessor processor;
+  prepare(processor);
+  std::string err;
+  processor.setIRAEngine(ConvolutionEngineType::Pffft);
+  ASSERT_TRUE(processor.loadImpulseResponse1(kIrAPath, err)) << err;
+
+  std::vector<Sample> block(kBlockSize, 0.0f);
+  processor.processMono(block.data(), block.data(), kBlockSize);
+  const int realtimeLatency = processor.getLatencySamples();
+
+  processor.setRenderMode(true);
+  processor.processMono(block.data(), block.data(), kBlockSize);
+  ASSERT_EQ(processor.getLatencySamples(), PffftConvolutionEngine::RenderBlockSize);
+
+  processor.setRenderMode(false);
+  EXPECT_FALSE(processor.getRenderMode());
+  EXPECT_EQ(processor.getStagedLatencySamples(), realtimeLatency);
+  processor.processMono(block.data(), block.data(), kBlockSize);
+  EXPECT_EQ(processor.getLatencySamples(), realtimeLatency);
+}
@@ -111,3 +111,101 @@ TEST_F(ResetTest, Reset_FlushesConvolutionTail_Stereo)
     EXPECT_NEAR(outR[i], 0.0f, 1e-6f) << "Stale R tail at sample " << i;
   }
 }
+
+// After reset(), a processor must render exactly what a new one with the same settings
+// does: envelope, blend smoothing, RMS window and alignment delays included.
+TEST_F(ResetTest, Reset_RendersLikeFreshProcessor)
+{
+  static const std::string kIrBPath = std::string(TEST_DATA_DIR) + "/INPUT_ir_b.wav";
+  auto configure = [](IRProcessor& p)
+  {
+    p.setSampleRate(44100.0);
+    p.setMaxBlockSize(kBlockSize);
+    p.setIRAEngine(ConvolutionEngineType::Pffft);
+    p.setIRBEngine(ConvolutionEngineType::Direct);
+    p.setDynamicModeEnabled(true);
+    p.setDetectionMode(1);
+    std::string err;
+    ASSERT_TRUE(p.loadImpulseResponse1(kIrAPath, err)) << err;
+    ASSERT_TRUE(p.loadImpulseResponse2(kIrBPath, err)) << err;
+  };
+
+  std::vector<Sample> input(8 * kBlockSize);
+  for (size_t i = 0; i < input.size(); ++i)
+    input[i] = 0.8f * std::sin(0.01f * static_cast<float>(i)) * (i % 3000 < 1500 ? 1.0f : 0.05f);
+
+  auto render = [&](IRProcessor& p)
+  {
+    std::vector<Sample> outL(input.size());
+    std::vector<Sample> outR(input.size());
+    for (size_t pos = 0; pos < input.size(); pos += kBlockSize)
+      p.processMonoToStereo(input.data() + pos, outL.data() + pos, outR.data() + pos,
+                            kBlockSize);
+    outL.insert(outL.end(), outR.begin(), outR.end());
+    return outL;
+  };
+
+  configure(processor);
+  render(processor);
+  ASSERT_GT(processor.getLatencySamples(), 0) << "alignment delays should be in use";
+  processor.reset();
+  const std::vector<Sample> afterReset = render(processor);
+
+  IRProcessor fresh;
+  configure(fresh);
+  const std::vector<Sample> expected = render(fresh);
+
+  ASSERT_EQ(afterReset.size(), expected.size());
+  for (size_t i = 0; i < expected.size(); ++i)
+    ASSERT_EQ(afterReset[i], expected[i]) << "sample " << i;
+}
+
+// A slot toggled off leaves its engine, or the shared dual-kernel engine, out of the
+// blocks that follow. Toggling it back on must start from silence rather than playing
+// out the history from before the toggle as a late burst.
+TEST_F(ResetTest, SlotToggle_DoesNotReplayStaleHistory)
+{
+  static const std::string kIrBPath = std::string(TEST_DATA_DIR) + "/INPUT_ir_b.wav";
+  std::string err;
+  ASSERT_TRUE(processor.loadImpulseResponse1(kIrAPath, err)) << err;
+  ASSERT_TRUE(processor.loadImpulseResponse2(kIrBPath, err)) << err;
+  processor.setBlend(0.0f);
+
+  std::vector<Sample> loud(kBlockSize);
+  for (int i = 0; i < kBlockSize; ++i)
+    loud[i] = 0.5f * std::sin(0.05f * static_cast<float>(i));
+  // Quiet enough to read as silence at the output, loud enough that the processor keeps
+  // running the engines rather than skipping silent blocks.
+  const std::vector<Sample> quiet(kBlockSize, 1e-5f);
+  std::vector<Sample> output(kBlockSize, 0.0f);
+
+  auto run = [&](const std::vector<Sample>& input, int numBlocks)
+  {
+    float peak = 0.0f;
+    for (int b = 0; b < numBlocks; ++b)
+    {
+      processor.processMono(input.data(), output.data(), kBlockSize);
+      for (int i = 0; i < kBlockSize; ++i)
+        peak = std::max(peak, std::abs(output[i]));
+    }
+    return peak;
+  };
+  const int tailBlocks = processor.getTailLengthSamples() / kBlockSize + 2;
+
+  // Both slots, then A alone long enough for A's tail to die out, then both again.
+  ASSERT_GT(run(loud, 4), 0.01f);
+  processor.setIRBEnabled(false);
+  run(quiet, tailBlocks);
+  processor.setIRBEnabled(true);
+  EXPECT_LT(run(quiet, tailBlocks), 0.01f) << "stale history after re-enabling slot B";
+
+  // A alone, then B alone, then A alone again.
+  processor.setIRBEnabled(false);
+  ASSERT_GT(run(loud, 4), 0.01f);
+  processor.setIRAEnabled(false);
+  processor.setIRBEnabled(true);
+  run(quiet, tailBlocks);
+  processor.setIRAEnabled(true);
+  processor.setIRBEnabled(false);
+  EXPECT_LT(run(quiet, tailBlocks), 0.01f) << "stale history after re-enabling slot A";
+}
@@ -0,0 +1,151 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "octobir-core/IRProcessor.hpp"
+#include "octobir-core/SilenceDetector.hpp"
+
+using namespace octob;
+
+static const std::string kIrAPath = std::string(TEST_DATA_DIR) + "/INPUT_ir_a.wav";
+static const std::string kIrBPath = std::string(TEST_DATA_DIR) + "/INPUT_ir_b.wav";
+
+namespace
+{
+
+constexpr int kBlockSize = 256;
+
+std::vector<Sample> makeNoise(size_t numFrames, unsigned int seed)
+{
+  std::vector<Sample> buffer(numFrames);
+  unsigned int state = seed;
+  for (auto& sample : buffer)
+  {
+    state = state * 1664525u + 1013904223u;
+    sample = static_cast<float>(static_cast<int>(state)) / static_cast<float>(0x7FFFFFFF) * 0.5f;
+  }
+  return buffer;
+}
+
+std::vector<Sample> render(IRProcessor& processor, const std::vector<Sample>& input)
+{
+  std::vector<Sample> output(input.size(), 0.0f);
+  for (size_t offset = 0; offset < input.size(); offset += kBlockSize)
+    processor.processMono(input.data() + offset, output.data() + offset, kBlockSize);
+  return output;
+}
+
+}  // namespace
+
+TEST(SilenceDetectorTest, IsSilent_DetectsSignalAnywhereInBlock)
+{
+  std::vector<Sample> buffer(37, 0.0f);
+  EXPECT_TRUE(SilenceDetector::isSilent(buffer.data(), buffer.size()));
+
+  buffer[20] = 1.0e-9f;
+  EXPECT_TRUE(SilenceDetector::isSilent(buffer.data(), buffer.size()));
+
+  // In the last full chunk and in the remainder after it
+  buffer[20] = -1.0e-3f;
+  EXPECT_FALSE(SilenceDetector::isSilent(buffer.data(), buffer.size()));
+  buffer[20] = 0.0f;
+  buffer[36] = 1.0e-3f;
+  EXPECT_FALSE(SilenceDetector::isSilent(buffer.data(), buffer.size()));
+}
+
+TEST(SilenceDetectorTest, Skip_WaitsOutTailAndWakesOnSignal)
+{
+  SilenceDetector detector;
+  detector.setTailSamples(300);
+
+  EXPECT_FALSE(detector.skip(true, 128));
+  EXPECT_FALSE(detector.skip(true, 128));
+  EXPECT_FALSE(detector.skip(true, 128));
+  EXPECT_FALSE(detector.isIdle());
+  EXPECT_TRUE(detector.skip(true, 128));
+  EXPECT_TRUE(detector.isIdle());
+
+  EXPECT_FALSE(detector.skip(false, 128));
+  EXPECT_FALSE(detector.isIdle());
+  EXPECT_FALSE(detector.skip(true, 128));
+}
+
+TEST(IRProcessorSilenceTest, TailLength_CoversLoadedIRs)
+{
+  IRProcessor processor;
+  processor.setSampleRate(48000.0);
+  processor.setMaxBlockSize(kBlockSize);
+  EXPECT_EQ(processor.getTailLengthSamples(), 0);
+
+  std::string err;
+  ASSERT_TRUE(processor.loadImpulseResponse1(kIrAPath, err)) << err;
+  const int tailA = processor.getTailLengthSamples();
+  EXPECT_GT(tailA, 0);
+
+  processor.setIRAEngine(ConvolutionEngineType::Pffft);
+  EXPECT_EQ(processor.getTailLengthSamples(), tailA + processor.getStagedLatencySamples());
+
+  ASSERT_TRUE(processor.loadImpulseResponse2(kIrBPath, err)) << err;
+  EXPECT_GE(processor.getTailLengthSamples(), tailA);
+
+  processor.clearImpulseResponse1();
+  processor.clearImpulseResponse2();
+  EXPECT_EQ(processor.getTailLengthSamples(), 0);
+}
+
+// Output after a long silence is exactly silent, and signal returning mid-block is
+// rendered from its first sample as by a processor that never went idle.
+TEST(IRProcessorSilenceTest, IdleOutputsSilenceAndWakesSampleAccurately)
+{
+  std::string err;
+  IRProcessor processor;
+  processor.setSampleRate(48000.0);
+  processor.setMaxBlockSize(kBlockSize);
+  ASSERT_TRUE(processor.loadImpulseResponse1(kIrAPath, err)) << err;
+  ASSERT_TRUE(processor.loadImpulseResponse2(kIrBPath, err)) << err;
+  processor.setIRAEngine(ConvolutionEngineType::Wdl);
+  processor.setIRBEngine(ConvolutionEngineType::Wdl);
+  processor.setBlend(0.0f);
+
+  render(processor, makeNoise(kBlockSize * 4, 3));
+  const size_t tail = static_cast<size_t>(processor.getTailLengthSamples());
+  ASSERT_GT(tail, 0u);
+
+  // Enough silence to cover the tail plus a few skipped blocks
+  const size_t silentBlocks = tail / kBlockSize + 4;
+  const auto silentOutput = render(processor, std::vector<Sample>(silentBlocks * kBlockSize));
+  // Blocks are skipped from the first one starting after the tail; before that only FFT
+  // rounding residue is left.
+  const size_t firstSkipped = (tail + kBlockSize - 1) / kBlockSize * kBlockSize;
+  for (size_t i = tail; i < firstSkipped; ++i)
+    ASSERT_LT(std::abs(silentOutput[i]), 1e-6f) << "at sample " << i;
+  for (size_t i = firstSkipped; i < silentOutput.size(); ++i)
+    ASSERT_EQ(silentOutput[i], 0.0f) << "at sample " << i;
+
+  // Signal returns 100 samples into a block
+  auto wake = makeNoise(kBlockSize * 8, 5);
+  std::fill(wake.begin(), wake.begin() + 100, 0.0f);
+  const auto output = render(processor, wake);
+
+  IRProcessor reference;
+  reference.setSampleRate(48000.0);
+  reference.setMaxBlockSize(kBlockSize);
+  ASSERT_TRUE(reference.loadImpulseResponse1(kIrAPath, err)) << err;
+  ASSERT_TRUE(reference.loadImpulseResponse2(kIrBPath, err)) << err;
+  reference.setIRAEngine(ConvolutionEngineType::Wdl);
+  reference.setIRBEngine(ConvolutionEngineType::Wdl);
+  reference.setBlend(0.0f);
+  render(reference, std::vector<Sample>(kBlockSize * 20));
+  const auto expected = render(reference, wake);
+
+  float peak = 0.0f;
+  for (size_t i = 0; i < output.size(); ++i)
+  {
+    peak = std::max(peak, std::abs(expected[i]));
+    ASSERT_NEAR(output[i], expected[i], 1e-5f) << "at sample " << i;
+  }
+  EXPECT_GT(peak, 1e-3f);
+}
@@ -1,6 +1,7 @@
 #include "PluginEditor.h"
 
 #include <BinaryData.h>
+#include <octobir-core/IRLibrary.hpp>
 
 static void drawScrew(juce::Graphics& g, float cx, float cy)
 {
@@ -585,6 +586,25 @@ void OctoBassEditor::namNextClicked()
   cycleNamFile(1);
 }
 
+// The files the prev/next buttons step through: the folder's files of one kind, sorted;
+// see IRLibrary::listFolder().
+static juce::Array<juce::File> listLibraryFolder(const juce::File& directory,
+                                                 octob::LibraryFileKind kind)
+{
+  std::vector<std::string> paths;
+  octob::IRLibrary::getShared().listFolder(directory.getFullPathName().toStdString(), kind,
+                                           paths);
+  juce::Array<juce::File> files;
+  for (const auto& path : paths)
+    files.add(juce::File(path));
+  return files;
+}
+
+static juce::Array<juce::File> listIRFolder(const juce::File& directory)
+{
+  return listLibraryFolder(directory, octob::LibraryFileKind::ImpulseResponse);
+}
+
 void OctoBassEditor::cycleNamFile(int direction)
 {
   juce::String currentPath = audioProcessor.getCurrentNamModelPath();
@@ -595,20 +615,11 @@ void OctoBassEditor::cycleNamFile(int direction)
   if (!currentFile.existsAsFile())
     return;
 
-  juce::File directory = currentFile.getParentDirectory();
-  juce::Array<juce::File> namFiles;
-
-  for (const auto& entry : juce::RangedDirectoryIterator(
-           directory, false, "*.nam", juce::File::findFiles | juce::File::ignoreHiddenFiles))
-  {
-    namFiles.add(entry.getFile());
-  }
-
+  juce::Array<juce::File> namFiles =
+      listLibraryFolder(currentFile.getParentDirectory(), octob::LibraryFileKind::NamModel);
   if (namFiles.isEmpty())
     return;
 
-  namFiles.sort();
-
   int currentIndex = namFiles.indexOf(currentFile);
   if (currentIndex < 0)
     return;
@@ -656,6 +667,7 @@ void OctoBassEditor::irLoadClicked()
                            if (success)
                            {
                              irLCDDisplay_.setText(file.getFileName());
+                             prefetchNeighboringIRs(file);
                            }
                            else
                            {
@@ -693,20 +705,10 @@ void OctoBassEditor::cycleIRFile(int direction)
   if (!currentFile.existsAsFile())
     return;
 
-  juce::File directory = currentFile.getParentDirectory();
-  juce::Array<juce::File> wavFiles;
-
-  for (const auto& entry : juce::RangedDirectoryIterator(
-           directory, false, "*.wav", juce::File::findFiles | juce::File::ignoreHiddenFiles))
-  {
-    wavFiles.add(entry.getFile());
-  }
-
+  juce::Array<juce::File> wavFiles = listIRFolder(currentFile.getParentDirectory());
   if (wavFiles.isEmpty())
     return;
 
-  wavFiles.sort();
-
   int currentIndex = wavFiles.indexOf(currentFile);
   if (currentIndex < 0)
     return;
@@ -723,6 +725,7 @@ void OctoBassEditor::cycleIRFile(int direction)
   if (success)
   {
     irLCDDisplay_.setText(newFile.getFileName());
+    prefetchNeighboringIRs(newFile);
   }
   else
   {
@@ -732,6 +735,22 @@ void OctoBassEditor::cycleIRFile(int direction)
   }
 }
 
+// Prepares the files either side of file in the background, so the next prev/next click
+// swaps in a ready IR.
+void OctoBassEditor::prefetchNeighboringIRs(const juce::File& file)
+{
+  const juce::Array<juce::File> wavFiles = listIRFolder(file.getParentDirectory());
+  const int index = wavFiles.indexOf(file);
+  if (index < 0)
+    return;
+
+  std::vector<std::string> paths;
+  for (const auto& wavFile : wavFiles)
+    paths.push_back(wavFile.getFullPathName().toStdString());
+  audioProcessor.prefetchImpulseResponses(
+      octob::IRProcessor::neighboringFiles(paths, static_cast<size_t>(index), kPrefetchRadius));
+}
+
 // --- Directory helpers ---
 
 juce::File OctoBassEditor::getLastBrowsedDirectory() const
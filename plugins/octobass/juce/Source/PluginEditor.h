@@ -98,9 +98,12 @@ class OctoBassEditor : public juce::AudioProcessorEditor, private juce::Timer
   void irNextClicked();
   void cycleNamFile(int direction);
   void cycleIRFile(int direction);
+  void prefetchNeighboringIRs(const juce::File& file);
   juce::File getLastBrowsedDirectory() const;
   void updateLastBrowsedDirectory(const juce::File& file);
 
+  // Files prefetched on either side of the IR for the prev/next buttons.
+  static constexpr int kPrefetchRadius = 2;
   juce::File lastBrowsedDirectory_;
   juce::Image logoImage_;
 
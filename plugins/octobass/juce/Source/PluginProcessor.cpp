@@ -1,7 +1,25 @@
 #include "PluginProcessor.h"
 
+#include <octobir-core/IRLibrary.hpp>
+
 #include "PluginEditor.h"
 
+namespace
+{
+
+// Where the shared IRLibrary keeps its index, so a new session navigates from the previous
+// session's scan.
+std::string getLibraryIndexFile()
+{
+  const auto directory = juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+                             .getChildFile("October Production Co")
+                             .getChildFile("OctoBass");
+  directory.createDirectory();
+  return directory.getChildFile("Library.idx").getFullPathName().toStdString();
+}
+
+}  // namespace
+
 OctoBassProcessor::OctoBassProcessor()
     : AudioProcessor(BusesProperties()
                          .withInput("Input", juce::AudioChannelSet::mono(), true)
@@ -11,6 +29,7 @@ OctoBassProcessor::OctoBassProcessor()
   for (int i = 0; i < octob::kGraphicEQNumBands; ++i)
     eqBandGainParams_[static_cast<size_t>(i)] =
         apvts_.getRawParameterValue("eqBandGain" + juce::String(i));
+  octob::IRLibrary::getShared().setIndexFile(getLibraryIndexFile());
 }
 
 OctoBassProcessor::~OctoBassProcessor() = default;
@@ -103,10 +122,21 @@ void OctoBassProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
   bassProcessor_.setSampleRate(sampleRate);
   bassProcessor_.setMaxBlockSize(static_cast<size_t>(samplesPerBlock));
   spectrumFifo_.reset();
+  bassProcessor_.setRenderMode(isNonRealtime());
+  setLatencySamples(bassProcessor_.getStagedLatencySamples());
 }
 
 void OctoBassProcessor::releaseResources() {}
 
+// Offline bounces render with large convolution partitions and a helper thread; the
+// latency they add is reported right away so the host compensates from the first block.
+void OctoBassProcessor::setNonRealtime(bool isNonRealtime) noexcept
+{
+  juce::AudioProcessor::setNonRealtime(isNonRealtime);
+  bassProcessor_.setRenderMode(isNonRealtime);
+  setLatencySamples(bassProcessor_.getStagedLatencySamples());
+}
+
 bool OctoBassProcessor::isBusesLayoutSupported(const BusesLayout& layouts) const
 {
   return layouts.getMainOutputChannelSet() == juce::AudioChannelSet::mono() &&
@@ -209,7 +239,7 @@ double OctoBassProcessor::getTailLengthSeconds() const
   const double sr = getSampleRate();
   if (sr <= 0.0)
     return 0.0;
-  return static_cast<double>(bassProcessor_.getLatencySamples()) / sr;
+  return static_cast<double>(bassProcessor_.getTailLengthSamples()) / sr;
 }
 
 int OctoBassProcessor::getNumPrograms()
@@ -280,6 +310,11 @@ bool OctoBassProcessor::loadImpulseResponse(const juce::String& filepath,
   return false;
 }
 
+void OctoBassProcessor::prefetchImpulseResponses(const std::vector<std::string>& filepaths)
+{
+  bassProcessor_.prefetchImpulseResponses(filepaths);
+}
+
 void OctoBassProcessor::clearImpulseResponse()
 {
   bassProcessor_.clearImpulseResponse();
@@ -15,6 +15,7 @@ class OctoBassProcessor : public juce::AudioProcessor, private juce::AsyncUpdate
 
   void prepareToPlay(double sampleRate, int samplesPerBlock) override;
   void releaseResources() override;
+  void setNonRealtime(bool isNonRealtime) noexcept override;
 
   bool isBusesLayoutSupported(const BusesLayout& layouts) const override;
 
@@ -52,6 +53,9 @@ class OctoBassProcessor : public juce::AudioProcessor, private juce::AsyncUpdate
   void clearImpulseResponse();
   bool isIRLoaded() const;
   juce::String getCurrentIRPath() const;
+  // Prepares IR files in the background for the prev/next buttons; see
+  // IRProcessor::prefetchImpulseResponses().
+  void prefetchImpulseResponses(const std::vector<std::string>& filepaths);
 
   int getLatencySamples() const;
 
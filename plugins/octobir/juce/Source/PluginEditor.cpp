@@ -1,6 +1,7 @@
 #include "PluginEditor.h"
 
 #include <BinaryData.h>
+#include <octobir-core/IRLibrary.hpp>
 
 #include "PluginProcessor.h"
 
@@ -199,9 +200,9 @@ OctobIREditor::OctobIREditor(OctobIRProcessor& p) : AudioProcessorEditor(&p), au
   addAndMakeVisible(ir1LCDDisplay_);
   ir1LCDDisplay_.setTextColour(juce::Colour(0xff1c1c30));
   ir1LCDDisplay_.setOnClick([this] { loadButton1Clicked(); });
-  ir1LCDDisplay_.setText(audioProcessor.getCurrentIR1Path().isEmpty()
+  ir1LCDDisplay_.setText(audioProcessor.getRequestedIRPath(1).isEmpty()
                              ? "No IR loaded"
-                             : juce::File(audioProcessor.getCurrentIR1Path()).getFileName());
+                             : juce::File(audioProcessor.getRequestedIRPath(1)).getFileName());
 
   addAndMakeVisible(ir1EnableButton_);
   ir1EnableButton_.setPaintingIsUnclipped(true);
@@ -236,9 +237,9 @@ OctobIREditor::OctobIREditor(OctobIRProcessor& p) : AudioProcessorEditor(&p), au
   addAndMakeVisible(ir2LCDDisplay_);
   ir2LCDDisplay_.setTextColour(juce::Colour(0xff1c1c30));
   ir2LCDDisplay_.setOnClick([this] { loadButton2Clicked(); });
-  ir2LCDDisplay_.setText(audioProcessor.getCurrentIR2Path().isEmpty()
+  ir2LCDDisplay_.setText(audioProcessor.getRequestedIRPath(2).isEmpty()
                              ? "No IR loaded"
-                             : juce::File(audioProcessor.getCurrentIR2Path()).getFileName());
+                             : juce::File(audioProcessor.getRequestedIRPath(2)).getFileName());
 
   addAndMakeVisible(ir2EnableButton_);
   ir2EnableButton_.setPaintingIsUnclipped(true);
@@ -353,6 +354,10 @@ OctobIREditor::OctobIREditor(OctobIRProcessor& p) : AudioProcessorEditor(&p), au
   logoImage_ =
       juce::ImageCache::getFromMemory(BinaryData::OctoberLogo_png, BinaryData::OctoberLogo_pngSize);
 
+  audioProcessor.onImpulseResponseLoaded =
+      [this](int slot, const juce::String& filepath, const juce::String& errorMessage)
+  { irLoadFinished(slot, filepath, errorMessage); };
+
   startTimerHz(30);
 
   setResizable(true, true);
@@ -365,6 +370,7 @@ OctobIREditor::OctobIREditor(OctobIRProcessor& p) : AudioProcessorEditor(&p), au
 
 OctobIREditor::~OctobIREditor()
 {
+  audioProcessor.onImpulseResponseLoaded = nullptr;
   stopTimer();
   setLookAndFeel(nullptr);
 }
@@ -581,18 +587,7 @@ void OctobIREditor::loadButton1Clicked()
         if (file.existsAsFile())
         {
           updateLastBrowsedDirectory(file);
-          juce::String error;
-          bool success = audioProcessor.loadImpulseResponse1(file.getFullPathName(), error);
-          if (success)
-          {
-            ir1LCDDisplay_.setText(file.getFileName());
-          }
-          else
-          {
-            juce::AlertWindow::showMessageBoxAsync(juce::AlertWindow::WarningIcon,
-                                                   "Failed to Load IR 1", error, "OK");
-            ir1LCDDisplay_.setText("Failed to load IR");
-          }
+          requestIRFile(1, file);
         }
       });
 }
@@ -618,18 +613,7 @@ void OctobIREditor::loadButton2Clicked()
         if (file.existsAsFile())
         {
           updateLastBrowsedDirectory(file);
-          juce::String error;
-          bool success = audioProcessor.loadImpulseResponse2(file.getFullPathName(), error);
-          if (success)
-          {
-            ir2LCDDisplay_.setText(file.getFileName());
-          }
-          else
-          {
-            juce::AlertWindow::showMessageBoxAsync(juce::AlertWindow::WarningIcon,
-                                                   "Failed to Load IR 2", error, "OK");
-            ir2LCDDisplay_.setText("Failed to load IR");
-          }
+          requestIRFile(2, file);
         }
       });
 }
@@ -672,10 +656,23 @@ void OctobIREditor::nextButton2Clicked()
   cycleIRFile(2, 1);
 }
 
+// The files the prev/next buttons step through: the folder's IRs, sorted; see
+// IRLibrary::listFolder().
+static juce::Array<juce::File> listIRFolder(const juce::File& directory)
+{
+  std::vector<std::string> paths;
+  octob::IRLibrary::getShared().listFolder(directory.getFullPathName().toStdString(),
+                                           octob::LibraryFileKind::ImpulseResponse, paths);
+  juce::Array<juce::File> wavFiles;
+  for (const auto& path : paths)
+    wavFiles.add(juce::File(path));
+  return wavFiles;
+}
+
 void OctobIREditor::cycleIRFile(int irIndex, int direction)
 {
-  juce::String currentPath =
-      irIndex == 1 ? audioProcessor.getCurrentIR1Path() : audioProcessor.getCurrentIR2Path();
+  // Step from the newest requested file so rapid clicks move on before loads finish.
+  juce::String currentPath = audioProcessor.getRequestedIRPath(irIndex);
 
   if (currentPath.isEmpty())
     return;
@@ -684,20 +681,10 @@ void OctobIREditor::cycleIRFile(int irIndex, int direction)
   if (!currentFile.existsAsFile())
     return;
 
-  juce::File directory = currentFile.getParentDirectory();
-  juce::Array<juce::File> wavFiles;
-
-  for (const auto& entry : juce::RangedDirectoryIterator(
-           directory, false, "*.wav", juce::File::findFiles | juce::File::ignoreHiddenFiles))
-  {
-    wavFiles.add(entry.getFile());
-  }
-
+  juce::Array<juce::File> wavFiles = listIRFolder(currentFile.getParentDirectory());
   if (wavFiles.isEmpty())
     return;
 
-  wavFiles.sort();
-
   int currentIndex = wavFiles.indexOf(currentFile);
   if (currentIndex < 0)
     return;
@@ -708,37 +695,49 @@ void OctobIREditor::cycleIRFile(int irIndex, int direction)
   else if (newIndex >= wavFiles.size())
     newIndex = 0;
 
-  juce::File newFile = wavFiles[newIndex];
-  juce::String error;
-  bool success;
+  requestIRFile(irIndex, wavFiles[newIndex]);
+}
 
-  if (irIndex == 1)
+// Loads run in the background: the display shows the requested file straight away and
+// irLoadFinished() reports failures.
+void OctobIREditor::requestIRFile(int irIndex, const juce::File& file)
+{
+  audioProcessor.requestImpulseResponse(irIndex, file.getFullPathName());
+  (irIndex == 1 ? ir1LCDDisplay_ : ir2LCDDisplay_).setText(file.getFileName());
+  prefetchNeighboringIRs(irIndex, file);
+}
+
+// Prepares the files either side of file in the background, so the next prev/next click
+// swaps in a ready IR.
+void OctobIREditor::prefetchNeighboringIRs(int irIndex, const juce::File& file)
+{
+  const juce::Array<juce::File> wavFiles = listIRFolder(file.getParentDirectory());
+  const int index = wavFiles.indexOf(file);
+  if (index < 0)
+    return;
+
+  std::vector<std::string> paths;
+  for (const auto& wavFile : wavFiles)
+    paths.push_back(wavFile.getFullPathName().toStdString());
+  audioProcessor.prefetchImpulseResponses(
+      irIndex,
+      octob::IRProcessor::neighboringFiles(paths, static_cast<size_t>(index), kPrefetchRadius));
+}
+
+void OctobIREditor::irLoadFinished(int irIndex, const juce::String& filepath,
+                                   const juce::String& errorMessage)
+{
+  LCDDisplay& display = irIndex == 1 ? ir1LCDDisplay_ : ir2LCDDisplay_;
+  if (errorMessage.isEmpty())
   {
-    success = audioProcessor.loadImpulseResponse1(newFile.getFullPathName(), error);
-    if (success)
-    {
-      ir1LCDDisplay_.setText(newFile.getFileName());
-    }
-    else
-    {
-      juce::AlertWindow::showMessageBoxAsync(juce::AlertWindow::WarningIcon, "Failed to Load IR 1",
-                                             error, "OK");
-      ir1LCDDisplay_.setText("Failed to load IR");
-    }
+    display.setText(juce::File(filepath).getFileName());
   }
   else
   {
-    success = audioProcessor.loadImpulseResponse2(newFile.getFullPathName(), error);
-    if (success)
-    {
-      ir2LCDDisplay_.setText(newFile.getFileName());
-    }
-    else
-    {
-      juce::AlertWindow::showMessageBoxAsync(juce::AlertWindow::WarningIcon, "Failed to Load IR 2",
-                                             error, "OK");
-      ir2LCDDisplay_.setText("Failed to load IR");
-    }
+    juce::AlertWindow::showMessageBoxAsync(juce::AlertWindow::WarningIcon,
+                                           "Failed to Load IR " + juce::String(irIndex),
+                                           errorMessage, "OK");
+    display.setText("Failed to load IR");
   }
 }
 
@@ -159,9 +159,14 @@ class OctobIREditor : public juce::AudioProcessorEditor, private juce::Timer
   void swapIROrderClicked();
   void updateMeters();
   void cycleIRFile(int irIndex, int direction);
+  void requestIRFile(int irIndex, const juce::File& file);
+  void prefetchNeighboringIRs(int irIndex, const juce::File& file);
+  void irLoadFinished(int irIndex, const juce::String& filepath, const juce::String& errorMessage);
   juce::File getLastBrowsedDirectory() const;
   void updateLastBrowsedDirectory(const juce::File& file);
 
+  // Files prefetched on either side of a slot's IR for the prev/next buttons.
+  static constexpr int kPrefetchRadius = 2;
   juce::File lastBrowsedDirectory_;
   juce::Image logoImage_;
 
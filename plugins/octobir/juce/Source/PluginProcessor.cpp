@@ -1,7 +1,39 @@
 #include "PluginProcessor.h"
 
+#include <octobir-core/IRLibrary.hpp>
+
 #include "PluginEditor.h"
 
+namespace
+{
+
+// One cache for every instance in the process, so a session that loads the same IR in
+// many instances only preprocesses it once.
+std::shared_ptr<const octob::IRCache> getSharedIRCache()
+{
+  static const auto cache = std::make_shared<const octob::IRCache>(
+      juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+          .getChildFile("October Production Co")
+          .getChildFile("OctobIR")
+          .getChildFile("IRCache")
+          .getFullPathName()
+          .toStdString());
+  return cache;
+}
+
+// Where the shared IRLibrary keeps its index, so a new session navigates from the previous
+// session's scan.
+std::string getLibraryIndexFile()
+{
+  const auto directory = juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+                             .getChildFile("October Production Co")
+                             .getChildFile("OctobIR");
+  directory.createDirectory();
+  return directory.getChildFile("Library.idx").getFullPathName().toStdString();
+}
+
+}  // namespace
+
 OctobIRProcessor::OctobIRProcessor()
     : AudioProcessor(BusesProperties()
                          .withInput("Input", juce::AudioChannelSet::stereo(), true)
@@ -9,10 +41,14 @@ OctobIRProcessor::OctobIRProcessor()
                          .withOutput("Output", juce::AudioChannelSet::stereo(), true)),
       apvts_(*this, nullptr, "Parameters", createParameterLayout())
 {
+  irProcessor_.setIRCache(getSharedIRCache());
+  octob::IRLibrary::getShared().setIndexFile(getLibraryIndexFile());
 }
 
 OctobIRProcessor::~OctobIRProcessor()
 {
+  // Load callbacks post to this object; let them finish before members go away.
+  irProcessor_.cancelPendingLoads();
   cancelPendingUpdate();
 }
 
@@ -105,9 +141,8 @@ double OctobIRProcessor::getTailLengthSeconds() const
   const double sr = getSampleRate();
   if (sr <= 0.0)
     return 0.0;
-  const size_t maxSamples =
-      std::max(irProcessor_.getIR1NumSamples(), irProcessor_.getIR2NumSamples());
-  return static_cast<double>(maxSamples) / sr;
+  // The longest IR plus latency; hosts may stop calling processBlock once it has passed.
+  return static_cast<double>(irProcessor_.getTailLengthSamples()) / sr;
 }
 
 int OctobIRProcessor::getNumPrograms()
@@ -140,6 +175,8 @@ void OctobIRProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
 {
   irProcessor_.setSampleRate(sampleRate);
   irProcessor_.setMaxBlockSize(static_cast<octob::FrameCount>(samplesPerBlock));
+  irProcessor_.setRenderMode(isNonRealtime());
+  setLatencySamples(irProcessor_.getStagedLatencySamples());
 }
 
 void OctobIRProcessor::releaseResources()
@@ -147,6 +184,15 @@ void OctobIRProcessor::releaseResources()
   irProcessor_.reset();
 }
 
+// Offline bounces render with large convolution partitions and a helper thread; the
+// latency they add is reported right away so the host compensates from the first block.
+void OctobIRProcessor::setNonRealtime(bool isNonRealtime) noexcept
+{
+  juce::AudioProcessor::setNonRealtime(isNonRealtime);
+  irProcessor_.setRenderMode(isNonRealtime);
+  setLatencySamples(irProcessor_.getStagedLatencySamples());
+}
+
 bool OctobIRProcessor::isBusesLayoutSupported(const BusesLayout& layouts) const
 {
   auto inputSet = layouts.getMainInputChannelSet();
@@ -297,8 +343,8 @@ juce::AudioProcessorEditor* OctobIRProcessor::createEditor()
 void OctobIRProcessor::getStateInformation(juce::MemoryBlock& destData)
 {
   auto state = apvts_.copyState();
-  state.setProperty("ir1Path", currentIR1Path_, nullptr);
-  state.setProperty("ir2Path", currentIR2Path_, nullptr);
+  state.setProperty("ir1Path", getRequestedIRPath(1), nullptr);
+  state.setProperty("ir2Path", getRequestedIRPath(2), nullptr);
   state.setProperty("editorWidth", lastEditorWidth_.load(), nullptr);
   state.setProperty("editorHeight", lastEditorHeight_.load(), nullptr);
 
@@ -331,6 +377,7 @@ void OctobIRProcessor::setStateInformation(const void* data, int sizeInBytes)
 void OctobIRProcessor::handleAsyncUpdate()
 {
   setLatencySamples(irProcessor_.getLatencySamples());
+  applyCompletedLoads();
 
   juce::ValueTree state;
   {
@@ -344,22 +391,94 @@ void OctobIRProcessor::handleAsyncUpdate()
 
   juce::String path = state.getProperty("ir1Path").toString();
   if (path.isNotEmpty())
-  {
-    juce::String error;
-    loadImpulseResponse1(path, error);
-  }
+    requestImpulseResponse(1, path);
 
   juce::String path2 = state.getProperty("ir2Path").toString();
   if (path2.isNotEmpty())
+    requestImpulseResponse(2, path2);
+}
+
+void OctobIRProcessor::requestImpulseResponse(int slot, const juce::String& filepath)
+{
+  const int index = slot == 2 ? 1 : 0;
+  pendingIRPaths_[index] = filepath;
+  latestLoads_[index] = irProcessor_.requestLoad(
+      index + 1, filepath.toStdString(),
+      [this](const octob::IRLoadCompletion& completion)
+      {
+        {
+          const juce::SpinLock::ScopedLockType lock(completedLoadsLock_);
+          completedLoads_.push_back(completion);
+        }
+        triggerAsyncUpdate();
+      });
+}
+
+juce::String OctobIRProcessor::getRequestedIRPath(int slot) const
+{
+  const int index = slot == 2 ? 1 : 0;
+  if (pendingIRPaths_[index].isNotEmpty())
+    return pendingIRPaths_[index];
+  return index == 0 ? currentIR1Path_ : currentIR2Path_;
+}
+
+void OctobIRProcessor::prefetchImpulseResponses(int slot, const std::vector<std::string>& filepaths)
+{
+  irProcessor_.prefetchImpulseResponses(slot == 2 ? 2 : 1, filepaths);
+}
+
+void OctobIRProcessor::forgetPendingLoad(int slot)
+{
+  const int index = slot == 2 ? 1 : 0;
+  latestLoads_[index] = 0;
+  pendingIRPaths_[index].clear();
+}
+
+void OctobIRProcessor::applyCompletedLoads()
+{
+  std::vector<octob::IRLoadCompletion> completed;
+  {
+    const juce::SpinLock::ScopedLockType lock(completedLoadsLock_);
+    completed.swap(completedLoads_);
+  }
+
+  for (const auto& completion : completed)
   {
+    const int index = completion.slot - 1;
+    if (completion.ticket != latestLoads_[index])
+      continue;
+
+    forgetPendingLoad(completion.slot);
+    const juce::String path(completion.filepath);
     juce::String error;
-    loadImpulseResponse2(path2, error);
+
+    if (completion.status == octob::IRLoadStatus::Loaded)
+    {
+      (index == 0 ? currentIR1Path_ : currentIR2Path_) = path;
+      DBG("Loaded IR" + juce::String(completion.slot) + ": " + path);
+
+      if (auto* param = apvts_.getParameter(index == 0 ? "irAEnable" : "irBEnable"))
+        param->setValueNotifyingHost(1.0f);
+    }
+    else if (completion.status == octob::IRLoadStatus::Failed)
+    {
+      error = juce::String(completion.errorMessage);
+      DBG("Failed to load IR" + juce::String(completion.slot) + ": " + error);
+    }
+    else
+    {
+      continue;
+    }
+
+    if (onImpulseResponseLoaded)
+      onImpulseResponseLoaded(completion.slot, path, error);
   }
 }
 
 bool OctobIRProcessor::loadImpulseResponse1(const juce::String& filepath,
                                             juce::String& errorMessage)
 {
+  forgetPendingLoad(1);
   std::string error;
   if (irProcessor_.loadImpulseResponse1(filepath.toStdString(), error))
   {
@@ -386,6 +505,7 @@ bool OctobIRProcessor::loadImpulseResponse1(const juce::String& filepath,
 bool OctobIRProcessor::loadImpulseResponse2(const juce::String& filepath,
                                             juce::String& errorMessage)
 {
+  forgetPendingLoad(2);
   std::string error;
   if (irProcessor_.loadImpulseResponse2(filepath.toStdString(), error))
   {
@@ -411,6 +531,7 @@ bool OctobIRProcessor::loadImpulseResponse2(const juce::String& filepath,
 
 void OctobIRProcessor::clearImpulseResponse1()
 {
+  forgetPendingLoad(1);
   irProcessor_.clearImpulseResponse1();
   currentIR1Path_.clear();
 
@@ -424,6 +545,7 @@ void OctobIRProcessor::clearImpulseResponse1()
 
 void OctobIRProcessor::clearImpulseResponse2()
 {
+  forgetPendingLoad(2);
   irProcessor_.clearImpulseResponse2();
   currentIR2Path_.clear();
 
@@ -442,8 +564,8 @@ void OctobIRProcessor::swapImpulseResponses()
   const float trimA = apvts_.getRawParameterValue("irATrimGain")->load();
   const float trimB = apvts_.getRawParameterValue("irBTrimGain")->load();
 
-  const juce::String path1 = currentIR1Path_;
-  const juce::String path2 = currentIR2Path_;
+  const juce::String path1 = getRequestedIRPath(1);
+  const juce::String path2 = getRequestedIRPath(2);
 
   DBG("Swapping IRs: slot1=" + path1 + " slot2=" + path2);
 
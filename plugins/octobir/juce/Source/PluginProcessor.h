@@ -2,7 +2,9 @@
 
 #include <juce_audio_processors/juce_audio_processors.h>
 
+#include <functional>
 #include <octobir-core/IRProcessor.hpp>
+#include <vector>
 
 class OctobIRProcessor : public juce::AudioProcessor, private juce::AsyncUpdater
 {
@@ -12,6 +14,7 @@ class OctobIRProcessor : public juce::AudioProcessor, private juce::AsyncUpdater
 
   void prepareToPlay(double sampleRate, int samplesPerBlock) override;
   void releaseResources() override;
+  void setNonRealtime(bool isNonRealtime) noexcept override;
 
   bool isBusesLayoutSupported(const BusesLayout& layouts) const override;
 
@@ -44,6 +47,20 @@ class OctobIRProcessor : public juce::AudioProcessor, private juce::AsyncUpdater
   juce::String getCurrentIR1Path() const { return currentIR1Path_; }
   juce::String getCurrentIR2Path() const { return currentIR2Path_; }
 
+  // Loads an IR into slot 1 or 2 on the core's worker pool without blocking the message
+  // thread. The result is applied on the message thread and reported through
+  // onImpulseResponseLoaded. A newer request, load or clear of the slot supersedes it.
+  void requestImpulseResponse(int slot, const juce::String& filepath);
+  // The newest requested file for a slot while it is loading, otherwise the current one.
+  juce::String getRequestedIRPath(int slot) const;
+  // Prepares these files for slot 1 or 2 in the background so a later request for one
+  // of them is a swap; see IRProcessor::prefetchImpulseResponses().
+  void prefetchImpulseResponses(int slot, const std::vector<std::string>& filepaths);
+  // Called on the message thread when the latest request for a slot finishes;
+  // errorMessage is empty on success.
+  std::function<void(int slot, const juce::String& filepath, const juce::String& errorMessage)>
+      onImpulseResponseLoaded;
+
   juce::AudioProcessorValueTreeState& getAPVTS() { return apvts_; }
 
   float getCurrentInputLevel() const { return irProcessor_.getCurrentInputLevel(); }
@@ -65,5 +82,13 @@ class OctobIRProcessor : public juce::AudioProcessor, private juce::AsyncUpdater
   juce::ValueTree pendingState_;
   void handleAsyncUpdate() override;
 
+  // Message thread only: the request each slot waits for (0 if none) and its file.
+  octob::IRLoadTicket latestLoads_[2] = {0, 0};
+  juce::String pendingIRPaths_[2];
+  juce::SpinLock completedLoadsLock_;
+  std::vector<octob::IRLoadCompletion> completedLoads_;
+  void applyCompletedLoads();
+  void forgetPendingLoad(int slot);
+
   JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(OctobIRProcessor)
 };
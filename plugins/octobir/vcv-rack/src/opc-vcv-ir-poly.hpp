@@ -0,0 +1,570 @@
+#pragma once
+
+#ifdef OCTOBIR_VCV_HEADLESS_TEST
+#include "rack_stub.hpp"
+#else
+#include <rack.hpp>
+
+#include "plugin.hpp"
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <octobir-core/ConvolutionKernel.hpp>
+#include <octobir-core/IRKernelStore.hpp>
+#include <octobir-core/IRProcessor.hpp>
+#include <octobir-core/LevelDetector.hpp>
+#include <octobir-core/PartitionedConvolver.hpp>
+#include <octobir-core/RealtimeHandoff.hpp>
+#include <string>
+
+// Polyphonic path for OpcVcvIr: runs up to 16 voices through the same IR pair.
+//
+// Each slot holds one ConvolutionKernel that every voice reads from, taken from the
+// process-wide IRKernelStore, so the module's IRProcessor and any other instance with
+// the same IR use the same one; a voice only owns its input history. Convolution runs
+// in blocks of kBlockSize samples (which is also the added latency), and the per-voice
+// blend and mixing math runs four voices at a time in simd::float_4 lanes. Sample FIFOs
+// are voice-interleaved (kMaxVoices floats per frame) so lanes load contiguously.
+//
+// Blend, dynamics and gain settings are read from the module's IRProcessor so both
+// paths share one source of truth. Each voice also follows the IRProcessor level law:
+// the same core detectors, run over the same sub-blocks the monophonic path hands
+// IRProcessor, with the blend smoothed and the gains ramped per sample across them, so
+// a voice sounds like the monophonic path delayed by kBlockSize.
+struct OpcVcvIrPolyEngine
+{
+  static constexpr int kMaxVoices = 16;
+  static constexpr int kNumGroups = kMaxVoices / 4;
+  static constexpr int kBlockSize = octob::IRKernelStore::KernelBlockSize;
+
+  enum class InputLayout : uint8_t
+  {
+    Mono,
+    Stereo
+  };
+
+ private:
+  static constexpr int kFrameStride = kMaxVoices;
+  static constexpr int kFifoSize = kBlockSize * kFrameStride;
+  static constexpr float kRmsWindowMs = 10.0f;
+  // RMS windows are sized for rates up to 384 kHz, as in IRProcessor, so a sample rate
+  // change only moves the window length.
+  static constexpr size_t kRmsCapacity = static_cast<size_t>(kRmsWindowMs * 384.0f);
+  static constexpr float kBlendSmoothTimeMs = 5.0f;
+
+  struct Bank
+  {
+    std::shared_ptr<const octob::ConvolutionKernel> kernels[2];
+    // [voice][input channel]
+    octob::PartitionedConvolver convolvers[kMaxVoices][2];
+  };
+
+  // Control-thread state, guarded by controlMutex_.
+  std::mutex controlMutex_;
+  std::shared_ptr<const octob::SharedIR> irs_[2];
+  std::shared_ptr<const octob::ConvolutionKernel> kernels_[2];
+  float sampleRate_ = 44100.f;
+
+  // Hand-off to the audio thread, same as IRProcessor's engines. Publishing is
+  // serialized by controlMutex_.
+  octob::RealtimeHandoff<Bank> banks_;
+
+  // Audio-thread state.
+  Bank* active_ = nullptr;
+  int fifoPos_ = 0;
+  int activeVoices_ = 0;
+  InputLayout activeLayout_ = InputLayout::Mono;
+  float inputL_[kFifoSize] = {};
+  float inputR_[kFifoSize] = {};
+  float sidechain_[kFifoSize] = {};
+  float outputL_[kFifoSize] = {};
+  float outputR_[kFifoSize] = {};
+  float wet_[2][2][kFifoSize] = {};  // [slot][output channel]
+  float voiceScratch_[kBlockSize] = {};
+  simd::float_4 levelDb_[kNumGroups];
+  simd::float_4 smoothedBlend_[kNumGroups];
+  // Blend gains at the end of the previous sub-block, before trims and output gain.
+  simd::float_4 gainA_[kNumGroups];
+  simd::float_4 gainB_[kNumGroups];
+  int gainLaw_ = -1;
+  int detectionMode_ = 0;
+  octob::PeakDetector peakDetector_;
+  std::unique_ptr<octob::RmsDetector> rmsDetectors_[kMaxVoices];
+
+ public:
+  OpcVcvIrPolyEngine()
+  {
+    for (auto& detector : rmsDetectors_)
+      detector.reset(new octob::RmsDetector(kRmsCapacity));
+    setRmsWindow();
+    resetDynamics();
+
+    banks_.publish(std::unique_ptr<Bank>(new Bank()));
+    banks_.acquire();
+    active_ = banks_.get();
+  }
+
+  // ---- control thread ----------------------------------------------------
+
+  bool loadSlot(int slot, const std::string& path, std::string& error)
+  {
+    float sampleRate = 0.0f;
+    {
+      std::lock_guard<std::mutex> lock(controlMutex_);
+      sampleRate = sampleRate_;
+    }
+
+    auto& store = octob::IRKernelStore::getInstance();
+    auto ir = store.load(path, sampleRate, nullptr, error);
+    if (!ir)
+      return false;
+
+    std::lock_guard<std::mutex> lock(controlMutex_);
+    if (sampleRate != sampleRate_)
+      ir = store.resample(*ir, sampleRate_, error);
+    if (!ir)
+      return false;
+
+    kernels_[slot] = ir->kernel;
+    irs_[slot] = std::move(ir);
+    stageBank();
+    return true;
+  }
+
+  void clearSlot(int slot)
+  {
+    std::lock_guard<std::mutex> lock(controlMutex_);
+    irs_[slot].reset();
+    kernels_[slot].reset();
+    stageBank();
+  }
+
+  void swapSlots()
+  {
+    std::lock_guard<std::mutex> lock(controlMutex_);
+    std::swap(irs_[0], irs_[1]);
+    std::swap(kernels_[0], kernels_[1]);
+    stageBank();
+  }
+
+  // Called from onSampleRateChange, which Rack never runs concurrently with process().
+  void setSampleRate(float sampleRate)
+  {
+    {
+      std::lock_guard<std::mutex> lock(controlMutex_);
+      if (sampleRate == sampleRate_)
+        return;
+      sampleRate_ = sampleRate;
+      std::string error;
+      for (int slot = 0; slot < 2; ++slot)
+      {
+        if (!irs_[slot])
+          continue;
+        irs_[slot] = octob::IRKernelStore::getInstance().resample(*irs_[slot], sampleRate_, error);
+        kernels_[slot] = irs_[slot] ? irs_[slot]->kernel : nullptr;
+      }
+      stageBank();
+    }
+    setRmsWindow();
+  }
+
+  // ---- audio thread ------------------------------------------------------
+
+  bool isBlockStart() const { return fifoPos_ == 0; }
+  int getLatencySamples() const { return kBlockSize; }
+
+  void writeFrame(int group, simd::float_4 left, simd::float_4 right, simd::float_4 sidechain)
+  {
+    const int offset = fifoPos_ * kFrameStride + group * 4;
+    left.store(inputL_ + offset);
+    right.store(inputR_ + offset);
+    sidechain.store(sidechain_ + offset);
+  }
+
+  simd::float_4 readLeft(int group) const
+  {
+    return simd::float_4::load(outputL_ + fifoPos_ * kFrameStride + group * 4);
+  }
+
+  simd::float_4 readRight(int group) const
+  {
+    return simd::float_4::load(outputR_ + fifoPos_ * kFrameStride + group * 4);
+  }
+
+  // Completes the current frame. Once a full block has been collected, the block is
+  // convolved and mixed into the output FIFO, which readLeft/readRight drain during
+  // the following block. Levels are detected and the blend smoothed every detectFrames
+  // samples, the length of the monophonic path's IRProcessor calls; it is clamped to
+  // [1, kBlockSize].
+  void advance(const octob::IRProcessor& settings, int numVoices, InputLayout layout,
+               bool sidechainActive, int detectFrames)
+  {
+    if (++fifoPos_ < kBlockSize)
+      return;
+
+    fifoPos_ = 0;
+    const int voices = numVoices < 1 ? 1 : (numVoices > kMaxVoices ? kMaxVoices : numVoices);
+    const int frames =
+        detectFrames < 1 ? 1 : (detectFrames > kBlockSize ? kBlockSize : detectFrames);
+    processBlock(settings, voices, layout, sidechainActive, frames);
+  }
+
+  float getVoiceBlend(int voice) const { return smoothedBlend_[voice / 4][voice % 4]; }
+  float getVoiceLevelDb(int voice) const { return levelDb_[voice / 4][voice % 4]; }
+
+  // Called when the input drops back to mono. Every voice is idle from here on, so all
+  // of them start over from silence when poly input returns, and the FIFOs are cleared
+  // rather than played out then.
+  void reset()
+  {
+    activeVoices_ = 0;
+    fifoPos_ = 0;
+    for (float* fifo : {inputL_, inputR_, sidechain_, outputL_, outputR_})
+      std::fill(fifo, fifo + kFifoSize, 0.0f);
+    resetDynamics();
+  }
+
+ private:
+  // Per-sample coefficients as IRProcessor computes them, raised to the sub-block
+  // length as it does with pow(coeff, numFrames).
+  struct BlendCoeffs
+  {
+    float attack;
+    float release;
+    float smooth;
+  };
+
+  // Level, blend and gain state start over as in a fresh IRProcessor.
+  void resetDynamics()
+  {
+    for (int g = 0; g < kNumGroups; ++g)
+    {
+      levelDb_[g] = simd::float_4(octob::LevelDetector::FloorDb);
+      smoothedBlend_[g] = simd::float_4::zero();
+    }
+    gainLaw_ = -1;
+    for (auto& detector : rmsDetectors_)
+      detector->reset();
+  }
+
+  // Called from the constructor and from setSampleRate, never alongside process().
+  // Allocates nothing; a new length restarts each window from silence.
+  void setRmsWindow()
+  {
+    const auto length = static_cast<size_t>(kRmsWindowMs / 1000.0f * sampleRate_);
+    for (auto& detector : rmsDetectors_)
+      detector->setWindowLength(length);
+  }
+
+  // Must be called with controlMutex_ held.
+  void stageBank()
+  {
+    std::unique_ptr<Bank> bank(new Bank());
+    int maxPartitions = 0;
+    for (int slot = 0; slot < 2; ++slot)
+    {
+      bank->kernels[slot] = kernels_[slot];
+      if (kernels_[slot])
+        maxPartitions = std::max(maxPartitions, kernels_[slot]->getNumPartitions());
+    }
+
+    if (maxPartitions > 0)
+    {
+      for (auto& voice : bank->convolvers)
+      {
+        for (auto& convolver : voice)
+          convolver.prepare(kBlockSize, maxPartitions, 1);
+      }
+    }
+
+    // The replaced bank is freed here, on the control thread, the next time a bank is
+    // staged.
+    banks_.publish(std::move(bank));
+  }
+
+  void applyPendingBank()
+  {
+    if (!banks_.acquire())
+      return;
+
+    active_ = banks_.get();
+    activeVoices_ = 0;
+  }
+
+  // Voices that were idle (or an input channel that was unused) hold stale history;
+  // clear it when they come back into use.
+  void resetNewlyActiveVoices(int numVoices, InputLayout layout)
+  {
+    for (int v = 0; v < numVoices; ++v)
+    {
+      if (v >= activeVoices_)
+      {
+        active_->convolvers[v][0].reset();
+        active_->convolvers[v][1].reset();
+      }
+      else if (layout == InputLayout::Stereo && activeLayout_ == InputLayout::Mono)
+      {
+        active_->convolvers[v][1].reset();
+      }
+    }
+    activeVoices_ = numVoices;
+    activeLayout_ = layout;
+  }
+
+  void processBlock(const octob::IRProcessor& settings, int numVoices, InputLayout layout,
+                    bool sidechainActive, int detectFrames)
+  {
+    applyPendingBank();
+
+    const bool stereo = layout == InputLayout::Stereo;
+    const bool hasA = active_->kernels[0] && settings.getIRAEnabled();
+    const bool hasB = active_->kernels[1] && settings.getIRBEnabled();
+    const int numGroups = (numVoices + 3) / 4;
+    const float outputGain = std::pow(10.0f, settings.getOutputGain() / 20.0f);
+
+    if (!hasA && !hasB)
+    {
+      for (int i = 0; i < kBlockSize; ++i)
+      {
+        for (int g = 0; g < numGroups; ++g)
+        {
+          const int offset = i * kFrameStride + g * 4;
+          const simd::float_4 left = simd::float_4::load(inputL_ + offset);
+          const simd::float_4 right = stereo ? simd::float_4::load(inputR_ + offset) : left;
+          (left * outputGain).store(outputL_ + offset);
+          (right * outputGain).store(outputR_ + offset);
+        }
+      }
+      gainLaw_ = 0;
+      return;
+    }
+
+    // A window left over from the last time RMS was selected would start the new mode
+    // from a stale level.
+    if (settings.getDetectionMode() != detectionMode_)
+    {
+      detectionMode_ = settings.getDetectionMode();
+      for (auto& detector : rmsDetectors_)
+        detector->reset();
+    }
+
+    resetNewlyActiveVoices(numVoices, layout);
+    convolve(numVoices, stereo, hasA, hasB);
+
+    // Same gain law key as IRProcessor: a new law starts steady instead of ramping from
+    // the old one.
+    const int gainLaw = (hasA ? 1 : 0) | (hasB ? 2 : 0) | (settings.getIRAEnabled() ? 4 : 0) |
+                        (settings.getIRBEnabled() ? 8 : 0);
+    bool steady = gainLaw != gainLaw_;
+    gainLaw_ = gainLaw;
+
+    const BlendCoeffs coeffs = blendCoeffs(settings, detectFrames);
+    for (int start = 0; start < kBlockSize; start += detectFrames)
+    {
+      const int frames = std::min(detectFrames, kBlockSize - start);
+      detectLevels(numVoices, stereo, sidechainActive, start, frames);
+      updateBlend(settings, numGroups, frames == detectFrames ? coeffs
+                                                               : blendCoeffs(settings, frames));
+      mix(settings, numGroups, stereo, hasA, hasB, outputGain, start, frames, steady);
+      steady = false;
+    }
+  }
+
+  // The main input or the sidechain, as IRProcessor picks it. A stereo layout runs both
+  // channels through the voice's detector and keeps the louder, as IRProcessor does.
+  void detectLevels(int numVoices, bool stereo, bool sidechainActive, int start, int numFrames)
+  {
+    const float* left = sidechainActive ? sidechain_ : inputL_;
+    const float* right = sidechainActive ? sidechain_ : inputR_;
+    for (int v = 0; v < numVoices; ++v)
+    {
+      float level = detectLevel(v, left, start, numFrames);
+      if (stereo)
+        level = std::max(level, detectLevel(v, right, start, numFrames));
+      levelDb_[v / 4][v % 4] = level;
+    }
+  }
+
+  float detectLevel(int voice, const float* fifo, int start, int numFrames)
+  {
+    for (int i = 0; i < numFrames; ++i)
+      voiceScratch_[i] = fifo[(start + i) * kFrameStride + voice];
+
+    octob::LevelDetector& detector =
+        detectionMode_ == 1 ? static_cast<octob::LevelDetector&>(*rmsDetectors_[voice])
+                            : peakDetector_;
+    return detector.process(voiceScratch_, static_cast<octob::FrameCount>(numFrames));
+  }
+
+  // Vector form of IRProcessor::calculateDynamicBlend.
+  static simd::float_4 dynamicBlend(const octob::IRProcessor& settings, simd::float_4 levelDb)
+  {
+    const float threshold = settings.getThreshold();
+    const float range = settings.getRangeDb();
+    const float knee = settings.getKneeWidthDb();
+    const float kneeStart = threshold - knee / 2.0f;
+    const float kneeEnd = threshold + knee / 2.0f;
+
+    const simd::float_4 overshoot = (levelDb - kneeStart) / std::max(knee, 1e-6f);
+    const simd::float_4 inKnee = overshoot * overshoot / 2.0f;
+
+    const float kneeContribution = knee > 0.0f ? 0.5f : 0.0f;
+    const float effectiveRange = range - knee / 2.0f;
+    const simd::float_4 aboveKnee =
+        simd::fmin(1.0f, kneeContribution +
+                             (levelDb - kneeEnd) / effectiveRange * (1.0f - kneeContribution));
+
+    simd::float_4 position = simd::ifelse(levelDb < kneeEnd, inKnee, aboveKnee);
+    position = simd::ifelse(levelDb >= threshold + range, 1.0f, position);
+    position = simd::ifelse(levelDb <= kneeStart, 0.0f, position);
+    return -1.0f + 2.0f * position;
+  }
+
+  BlendCoeffs blendCoeffs(const octob::IRProcessor& settings, int numFrames) const
+  {
+    const float frames = static_cast<float>(numFrames);
+    return {std::pow(smoothingCoeff(settings.getAttackTime()), frames),
+            std::pow(smoothingCoeff(settings.getReleaseTime()), frames),
+            std::pow(smoothingCoeff(kBlendSmoothTimeMs), frames)};
+  }
+
+  float smoothingCoeff(float timeMs) const
+  {
+    return timeMs > 0.0f ? std::exp(-1.0f / (timeMs / 1000.0f * sampleRate_)) : 0.0f;
+  }
+
+  void updateBlend(const octob::IRProcessor& settings, int numGroups, const BlendCoeffs& coeffs)
+  {
+    for (int g = 0; g < numGroups; ++g)
+    {
+      simd::float_4 target;
+      simd::float_4 coeff;
+      if (settings.getDynamicModeEnabled())
+      {
+        target = dynamicBlend(settings, levelDb_[g]);
+        coeff = simd::ifelse(target > smoothedBlend_[g], coeffs.attack, coeffs.release);
+      }
+      else
+      {
+        target = simd::float_4(settings.getBlend());
+        coeff = simd::float_4(coeffs.smooth);
+      }
+      smoothedBlend_[g] = smoothedBlend_[g] * coeff + target * (1.0f - coeff);
+    }
+  }
+
+  void scatter(float* interleaved, int voice) const
+  {
+    for (int i = 0; i < kBlockSize; ++i)
+      interleaved[i * kFrameStride + voice] = voiceScratch_[i];
+  }
+
+  void convolve(int numVoices, bool stereo, bool hasA, bool hasB)
+  {
+    for (int v = 0; v < numVoices; ++v)
+    {
+      octob::PartitionedConvolver& left = active_->convolvers[v][0];
+      octob::PartitionedConvolver& right = active_->convolvers[v][1];
+
+      for (int i = 0; i < kBlockSize; ++i)
+        voiceScratch_[i] = inputL_[i * kFrameStride + v];
+      left.pushBlock(voiceScratch_);
+
+      if (stereo)
+      {
+        for (int i = 0; i < kBlockSize; ++i)
+          voiceScratch_[i] = inputR_[i * kFrameStride + v];
+        right.pushBlock(voiceScratch_);
+      }
+
+      for (int slot = 0; slot < 2; ++slot)
+      {
+        if ((slot == 0 && !hasA) || (slot == 1 && !hasB))
+          continue;
+
+        const octob::ConvolutionKernel& kernel = *active_->kernels[slot];
+        const int rightChannel = kernel.getNumChannels() > 1 ? 1 : 0;
+
+        left.accumulate(kernel, 0, 1.0f, 0);
+        left.finish(0, voiceScratch_);
+        scatter(wet_[slot][0], v);
+
+        // A mono input through a mono IR yields identical channels; reuse the
+        // left result instead of a second multiply/inverse pass.
+        if (stereo || rightChannel == 1)
+        {
+          octob::PartitionedConvolver& source = stereo ? right : left;
+          source.accumulate(kernel, rightChannel, 1.0f, 0);
+          source.finish(0, voiceScratch_);
+        }
+        scatter(wet_[slot][1], v);
+      }
+    }
+  }
+
+  // Mixes one sub-block. As in IRProcessor::mixSlots, the blend gains move linearly
+  // from the previous sub-block's to this one's, landing on them at the last frame,
+  // with the trims and the output gain folded in.
+  void mix(const octob::IRProcessor& settings, int numGroups, bool stereo, bool hasA, bool hasB,
+           float outputGain, int start, int numFrames, bool steady)
+  {
+    const float scaleA =
+        (hasA ? std::pow(10.0f, settings.getIRATrimGain() / 20.0f) : 1.0f) * outputGain;
+    const float scaleB =
+        (hasB ? std::pow(10.0f, settings.getIRBTrimGain() / 20.0f) : 1.0f) * outputGain;
+    const float frames = static_cast<float>(numFrames);
+
+    for (int g = 0; g < numGroups; ++g)
+    {
+      // Same gain law as IRProcessor::resolveBlendGains. An empty-but-enabled slot
+      // passes dry signal; a disabled slot drops out of the blend.
+      const simd::float_4 position = (smoothedBlend_[g] + 1.0f) * 0.5f;
+      simd::float_4 gainA;
+      simd::float_4 gainB;
+      if (hasA && hasB)
+      {
+        gainA = simd::sqrt(1.0f - position);
+        gainB = simd::sqrt(position);
+      }
+      else if (hasA)
+      {
+        gainA = settings.getIRBEnabled() ? 1.0f - position : simd::float_4(1.0f);
+        gainB = settings.getIRBEnabled() ? position : simd::float_4::zero();
+      }
+      else
+      {
+        gainA = settings.getIRAEnabled() ? 1.0f - position : simd::float_4::zero();
+        gainB = settings.getIRAEnabled() ? position : simd::float_4(1.0f);
+      }
+      const simd::float_4 fromA = steady ? gainA : gainA_[g];
+      const simd::float_4 fromB = steady ? gainB : gainB_[g];
+      gainA_[g] = gainA;
+      gainB_[g] = gainB;
+
+      const simd::float_4 stepA = (gainA - fromA) * scaleA / frames;
+      const simd::float_4 stepB = (gainB - fromB) * scaleB / frames;
+      for (int i = 0; i < numFrames; ++i)
+      {
+        const int offset = (start + i) * kFrameStride + g * 4;
+        const float frame = static_cast<float>(i + 1);
+        const simd::float_4 rampA = fromA * scaleA + stepA * frame;
+        const simd::float_4 rampB = fromB * scaleB + stepB * frame;
+
+        const simd::float_4 dryL = simd::float_4::load(inputL_ + offset);
+        const simd::float_4 dryR = stereo ? simd::float_4::load(inputR_ + offset) : dryL;
+
+        const simd::float_4 aL = hasA ? simd::float_4::load(wet_[0][0] + offset) : dryL;
+        const simd::float_4 aR = hasA ? simd::float_4::load(wet_[0][1] + offset) : dryR;
+        const simd::float_4 bL = hasB ? simd::float_4::load(wet_[1][0] + offset) : dryL;
+        const simd::float_4 bR = hasB ? simd::float_4::load(wet_[1][1] + offset) : dryR;
+
+        (rampA * aL + rampB * bL).store(outputL_ + offset);
+        (rampA * aR + rampB * bR).store(outputR_ + offset);
+      }
+    }
+  }
+};
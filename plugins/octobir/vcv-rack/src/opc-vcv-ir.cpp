@@ -1,12 +1,10 @@
 #include "opc-vcv-ir.hpp"
 
-#include <dirent.h>
+#include <octobir-core/IRLibrary.hpp>
 #include <osdialog.h>
-#include <sys/stat.h>
 
 #include <algorithm>
 #include <array>
-#include <cctype>
 #include <cmath>
 #include <vector>
 
@@ -458,20 +456,45 @@ std::string getFilename(const std::string& path)
   return (pos != std::string::npos) ? path.substr(pos + 1) : path;
 }
 
-bool isAudioExtension(const std::string& name)
+// Names of the audio files in dir, sorted: the files the nav buttons step through; see
+// IRLibrary::listFolder(). Returns false if the directory cannot be opened.
+bool listAudioFiles(const std::string& dir, std::vector<std::string>& entries)
 {
-  const size_t dot = name.rfind('.');
-  if (dot == std::string::npos)
+  std::vector<std::string> paths;
+  if (!octob::IRLibrary::getShared().listFolder(dir, octob::LibraryFileKind::ImpulseResponse,
+                                                paths))
     return false;
-  std::string ext = name.substr(dot);
-  for (char& c : ext)
-    c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
-  return ext == ".wav" || ext == ".aiff" || ext == ".aif" || ext == ".flac";
+  for (const auto& path : paths)
+    entries.push_back(getFilename(path));
+  return true;
+}
+
+// Files prefetched on either side of a slot's IR for the nav buttons.
+constexpr int kPrefetchRadius = 2;
+
+// Prepares the files next to path in the background, so the next nav click swaps in a
+// ready IR.
+void prefetchNeighboringIRs(OpcVcvIr* module, bool isIR2, const std::string& path)
+{
+  const std::string dir = getParentDir(path);
+  std::vector<std::string> entries;
+  if (!listAudioFiles(dir, entries))
+    return;
+
+  const auto it = std::find(entries.begin(), entries.end(), getFilename(path));
+  if (it == entries.end())
+    return;
+
+  for (auto& entry : entries)
+    entry = dir + "/" + entry;
+  module->prefetchIRs(isIR2, octob::IRProcessor::neighboringFiles(
+                                 entries, static_cast<size_t>(std::distance(entries.begin(), it)),
+                                 kPrefetchRadius));
 }
 
 void openIRFileDialog(OpcVcvIr* module, bool isIR2)
 {
-  osdialog_filters* filters = osdialog_filters_parse("Audio files:wav,aiff,aif,flac;All files:*");
+  osdialog_filters* filters = osdialog_filters_parse("Audio files:wav,aiff,aif;All files:*");
   if (filters == nullptr)
   {
     WARN("openIRFileDialog: failed to parse file dialog filters");
@@ -481,10 +504,8 @@ void openIRFileDialog(OpcVcvIr* module, bool isIR2)
   char* path = osdialog_file(OSDIALOG_OPEN, nullptr, nullptr, filters);
   if (path != nullptr)
   {
-    if (isIR2)
-      module->loadIR2(std::string(path));
-    else
-      module->loadIR(std::string(path));
+    module->requestIR(isIR2, std::string(path));
+    prefetchNeighboringIRs(module, isIR2, std::string(path));
     free(path);
   }
   osdialog_filters_free(filters);
@@ -803,38 +824,26 @@ struct OpcIrNavButton : OpaqueWidget
  private:
   void loadAdjacentFile()
   {
-    const std::string currentPath = module->getLoadedFilePath(isIR2);
+    const std::string currentPath = module->getNavigationPath(isIR2);
     if (currentPath.empty())
       return;
 
     const std::string dir = getParentDir(currentPath);
     const std::string currentName = getFilename(currentPath);
 
-    DIR* dp = opendir(dir.c_str());
-    if (dp == nullptr)
+    std::vector<std::string> entries;
+    if (!listAudioFiles(dir, entries))
     {
       WARN("OpcIrNavButton: could not open directory %s", dir.c_str());
       return;
     }
 
-    std::vector<std::string> entries;
-    struct dirent* ep = nullptr;
-    while ((ep = readdir(dp)) != nullptr)
-    {
-      std::string name(ep->d_name);
-      if (isAudioExtension(name))
-        entries.push_back(name);
-    }
-    closedir(dp);
-
     if (entries.empty())
     {
       WARN("OpcIrNavButton: no audio files found in %s", dir.c_str());
       return;
     }
 
-    std::sort(entries.begin(), entries.end());
-
     const auto it = std::find(entries.begin(), entries.end(), currentName);
     if (it == entries.end())
     {
@@ -848,10 +857,8 @@ struct OpcIrNavButton : OpaqueWidget
 
     const std::string newPath = dir + "/" + entries[static_cast<size_t>(newIdx)];
     INFO("OpcIrNavButton: loading adjacent file %s", newPath.c_str());
-    if (isIR2)
-      module->loadIR2(newPath);
-    else
-      module->loadIR(newPath);
+    module->requestIR(isIR2, newPath);
+    prefetchNeighboringIRs(module, isIR2, newPath);
   }
 };
 
@@ -1465,6 +1472,26 @@ struct OpcVcvIrWidget final : ModuleWidget
 
     menu->addChild(new MenuSeparator);
 
+    // Larger blocks amortize the per-call overhead of the convolution core at the cost
+    // of the listed extra latency. Index 0 keeps the per-sample path.
+    static const int kBlockSizes[] = {0, 16, 32, 64, 128};
+    menu->addChild(createIndexSubmenuItem(
+        "Processing block size",
+        {"Off (0 extra latency)", "16 samples", "32 samples", "64 samples", "128 samples"},
+        [module]()
+        {
+          const int current = module->getBufferedBlockSize();
+          for (size_t i = 0; i < sizeof(kBlockSizes) / sizeof(kBlockSizes[0]); ++i)
+          {
+            if (kBlockSizes[i] == current)
+              return i;
+          }
+          return size_t{0};
+        },
+        [module](size_t index) { module->setBufferedBlockSize(kBlockSizes[index]); }));
+
+    menu->addChild(new MenuSeparator);
+
     menu->addChild(
         createMenuItem("Swap IR Order", "", [module]() { module->swapImpulseResponses(); }));
   }
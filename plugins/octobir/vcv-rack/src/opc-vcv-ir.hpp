@@ -8,10 +8,15 @@
 #include "plugin.hpp"
 #endif
 
+#include <algorithm>
 #include <atomic>
+#include <iterator>
 #include <mutex>
 #include <octobir-core/IRProcessor.hpp>
 #include <string>
+#include <vector>
+
+#include "opc-vcv-ir-poly.hpp"
 
 struct OpcVcvIr final : Module
 {
@@ -65,8 +70,32 @@ struct OpcVcvIr final : Module
   }
   float getCurrentBlend() const { return currentBlend_.load(std::memory_order_relaxed); }
   const octob::IRProcessor& getIRProcessor() const { return irProcessor_; }
+  const OpcVcvIrPolyEngine& getPolyEngine() const { return polyEngine_; }
   uint32_t getLastSystemSampleRate() const { return lastSystemSampleRate_; }
 
+  static bool isValidBufferedBlockSize(int blockSize)
+  {
+    return blockSize == 0 || blockSize == 16 || blockSize == 32 || blockSize == 64 ||
+           blockSize == 128;
+  }
+
+  // Selects block-buffered processing. Unsupported sizes fall back to 0 (per-sample
+  // processing, no extra latency). Safe to call from the UI thread.
+  void setBufferedBlockSize(int blockSize)
+  {
+    requestedBlockSize_.store(isValidBufferedBlockSize(blockSize) ? blockSize : 0,
+                              std::memory_order_relaxed);
+  }
+  int getBufferedBlockSize() const { return requestedBlockSize_.load(std::memory_order_relaxed); }
+
+  // Delay added on top of the convolution latency by the block FIFOs. Polyphonic
+  // input always runs in fixed blocks of OpcVcvIrPolyEngine::kBlockSize.
+  int getExtraLatencySamples() const
+  {
+    return polyActive_.load(std::memory_order_relaxed) ? polyEngine_.getLatencySamples()
+                                                       : getBufferedBlockSize();
+  }
+
  private:
   // VCV Rack audio convention is +/-5 V; the core IRProcessor expects normalized
   // +/-1.0 samples (DAW convention). Scale on the way in and out so the detector,
@@ -74,13 +103,43 @@ struct OpcVcvIr final : Module
   static constexpr float kVcvAudioToNormalized = 0.2f;
   static constexpr float kNormalizedToVcvAudio = 5.0f;
 
+  // Block-buffered processing: 0 runs the core once per sample (no extra latency);
+  // otherwise samples are accumulated into FIFOs and the core runs once per block.
+  static constexpr int kMaxBufferedBlockSize = 128;
+
+  enum class Routing : uint8_t
+  {
+    Silent,
+    Stereo,
+    LeftMono,
+    RightMono
+  };
+
   octob::IRProcessor irProcessor_;
+  OpcVcvIrPolyEngine polyEngine_;
+  std::atomic<bool> polyActive_{false};
+  std::atomic<int> requestedBlockSize_{0};
+  int activeBlockSize_ = 0;
+  int fifoPos_ = 0;
+  Routing routing_ = Routing::Silent;
+  bool sidechainActive_ = false;
+  float inputL_[kMaxBufferedBlockSize] = {};
+  float inputR_[kMaxBufferedBlockSize] = {};
+  float sidechain_[kMaxBufferedBlockSize] = {};
+  float outputL_[kMaxBufferedBlockSize] = {};
+  float outputR_[kMaxBufferedBlockSize] = {};
   std::atomic<float> currentInputLevelDb_{-96.f};
   std::atomic<float> currentBlend_{0.f};
   uint32_t lastSystemSampleRate_ = 44100;
   std::string loaded_file_path1_;
   std::string loaded_file_path2_;
   mutable std::mutex path_mutex_;
+  // Files of requests still loading, guarded by path_mutex_.
+  std::string pendingLoadPaths_[2];
+  // Serializes applying load results to the poly engine and paths. latestLoads_ holds
+  // the ticket of the request each slot is waiting for, or 0.
+  std::mutex loadMutex_;
+  octob::IRLoadTicket latestLoads_[2] = {0, 0};
   bool sidechainConnTracked_ = false;
   bool prevSidechainConnected_ = false;
   bool blendCvConnTracked_ = false;
@@ -126,13 +185,17 @@ struct OpcVcvIr final : Module
     configLight(static_cast<int>(LightId::SidechainLight), "Sidechain Active");
 
     irProcessor_.setSampleRate(44100.0);
-    irProcessor_.setMaxBlockSize(1);
+    irProcessor_.setMaxBlockSize(kMaxBufferedBlockSize);
   }
 
+  // Load callbacks reference this module; let them finish before members go away.
+  ~OpcVcvIr() override { irProcessor_.cancelPendingLoads(); }
+
   void onSampleRateChange(const SampleRateChangeEvent& e) override
   {
     lastSystemSampleRate_ = static_cast<uint32_t>(e.sampleRate);
     irProcessor_.setSampleRate(e.sampleRate);
+    polyEngine_.setSampleRate(e.sampleRate);
   }
 
   std::string getLoadedFilePath(bool ir2) const
@@ -141,11 +204,46 @@ struct OpcVcvIr final : Module
     return ir2 ? loaded_file_path2_ : loaded_file_path1_;
   }
 
+  // The file navigation steps from: the newest requested one while it is still loading.
+  std::string getNavigationPath(bool ir2) const
+  {
+    std::lock_guard<std::mutex> lock(path_mutex_);
+    const std::string& pending = pendingLoadPaths_[ir2 ? 1 : 0];
+    if (!pending.empty())
+      return pending;
+    return ir2 ? loaded_file_path2_ : loaded_file_path1_;
+  }
+
+  // Loads on the core's worker pool and returns at once, for the UI thread. A later
+  // request, load or clear of the slot supersedes it.
+  void requestIR(bool ir2, const std::string& file_path)
+  {
+    std::lock_guard<std::mutex> loadLock(loadMutex_);
+    setPendingLoad(ir2 ? 1 : 0, file_path);
+    latestLoads_[ir2 ? 1 : 0] =
+        irProcessor_.requestLoad(ir2 ? 2 : 1, file_path,
+                                 [this](const octob::IRLoadCompletion& completion)
+                                 { onLoadCompleted(completion); });
+  }
+
+  // Prepares files for slot A or B in the background so a later request for one of them
+  // is a swap; see IRProcessor::prefetchImpulseResponses().
+  void prefetchIRs(bool ir2, const std::vector<std::string>& file_paths)
+  {
+    irProcessor_.prefetchImpulseResponses(ir2 ? 2 : 1, file_paths);
+  }
+
   void loadIR(const std::string& file_path)
   {
+    std::lock_guard<std::mutex> loadLock(loadMutex_);
+    latestLoads_[0] = 0;
+    setPendingLoad(0, std::string());
     std::string error;
     if (irProcessor_.loadImpulseResponse1(file_path, error))
     {
+      if (!polyEngine_.loadSlot(0, file_path, error))
+        WARN("IR A unavailable for polyphonic input: %s", error.c_str());
+
       std::lock_guard<std::mutex> lock(path_mutex_);
       loaded_file_path1_ = file_path;
       INFO("Loaded IR A: %s (%zu samples, %.0f Hz)", file_path.c_str(),
@@ -154,6 +252,7 @@ struct OpcVcvIr final : Module
     else
     {
       WARN("Failed to load IR A file %s: %s", file_path.c_str(), error.c_str());
+      polyEngine_.clearSlot(0);
       std::lock_guard<std::mutex> lock(path_mutex_);
       loaded_file_path1_.clear();
     }
@@ -161,9 +260,15 @@ struct OpcVcvIr final : Module
 
   void loadIR2(const std::string& file_path)
   {
+    std::lock_guard<std::mutex> loadLock(loadMutex_);
+    latestLoads_[1] = 0;
+    setPendingLoad(1, std::string());
     std::string error;
     if (irProcessor_.loadImpulseResponse2(file_path, error))
     {
+      if (!polyEngine_.loadSlot(1, file_path, error))
+        WARN("IR B unavailable for polyphonic input: %s", error.c_str());
+
       std::lock_guard<std::mutex> lock(path_mutex_);
       loaded_file_path2_ = file_path;
       INFO("Loaded IR B: %s (%zu samples, %.0f Hz)", file_path.c_str(),
@@ -172,6 +277,7 @@ struct OpcVcvIr final : Module
     else
     {
       WARN("Failed to load IR B file %s: %s", file_path.c_str(), error.c_str());
+      polyEngine_.clearSlot(1);
       std::lock_guard<std::mutex> lock(path_mutex_);
       loaded_file_path2_.clear();
     }
@@ -179,7 +285,11 @@ struct OpcVcvIr final : Module
 
   void clearIR1()
   {
+    std::lock_guard<std::mutex> loadLock(loadMutex_);
+    latestLoads_[0] = 0;
+    setPendingLoad(0, std::string());
     irProcessor_.clearImpulseResponse1();
+    polyEngine_.clearSlot(0);
     {
       std::lock_guard<std::mutex> lock(path_mutex_);
       loaded_file_path1_.clear();
@@ -189,7 +299,11 @@ struct OpcVcvIr final : Module
 
   void clearIR2()
   {
+    std::lock_guard<std::mutex> loadLock(loadMutex_);
+    latestLoads_[1] = 0;
+    setPendingLoad(1, std::string());
     irProcessor_.clearImpulseResponse2();
+    polyEngine_.clearSlot(1);
     {
       std::lock_guard<std::mutex> lock(path_mutex_);
       loaded_file_path2_.clear();
@@ -199,10 +313,16 @@ struct OpcVcvIr final : Module
 
   void swapImpulseResponses()
   {
-    irProcessor_.swapIRSlots();
-
     {
+      std::lock_guard<std::mutex> loadLock(loadMutex_);
+      latestLoads_[0] = 0;
+      latestLoads_[1] = 0;
+      irProcessor_.swapIRSlots();
+      polyEngine_.swapSlots();
+
       std::lock_guard<std::mutex> lock(path_mutex_);
+      pendingLoadPaths_[0].clear();
+      pendingLoadPaths_[1].clear();
       std::swap(loaded_file_path1_, loaded_file_path2_);
     }
 
@@ -216,11 +336,151 @@ struct OpcVcvIr final : Module
   {
     (void)args;
 
-    bool dynamicMode =
-        inputs[static_cast<int>(InputId::DynamicsEnableCvIn)].isConnected()
-            ? inputs[static_cast<int>(InputId::DynamicsEnableCvIn)].getVoltage() > 1.0f
-            : params[static_cast<int>(ParamId::DynamicModeParam)].getValue() > 0.5f;
+    trackCableEdges();
+
+    const int numVoices =
+        std::max(inputs[static_cast<int>(InputId::AudioInL)].getChannels(),
+                 inputs[static_cast<int>(InputId::AudioInR)].getChannels());
+    if (numVoices > 1)
+    {
+      processPoly(numVoices);
+      return;
+    }
+    if (polyActive_.load(std::memory_order_relaxed))
+    {
+      polyActive_.store(false, std::memory_order_relaxed);
+      outputs[static_cast<int>(OutputId::OutputL)].setChannels(1);
+      outputs[static_cast<int>(OutputId::OutputR)].setChannels(1);
+
+      // Neither path ran while the other was in use, so both hold history from before
+      // the switch.
+      polyEngine_.reset();
+      irProcessor_.reset();
+      resetBlockFifos();
+    }
+
+    // Block size changes requested from the UI thread take effect here, at a sample
+    // boundary on the audio thread. Flushing the FIFOs drops at most one block.
+    const int requestedBlockSize = requestedBlockSize_.load(std::memory_order_relaxed);
+    if (requestedBlockSize != activeBlockSize_)
+    {
+      activeBlockSize_ = requestedBlockSize;
+      resetBlockFifos();
+    }
+
+    const int fifoIndex = activeBlockSize_ > 0 ? fifoPos_ : 0;
+    inputL_[fifoIndex] =
+        inputs[static_cast<int>(InputId::AudioInL)].getVoltage() * kVcvAudioToNormalized;
+    inputR_[fifoIndex] =
+        inputs[static_cast<int>(InputId::AudioInR)].getVoltage() * kVcvAudioToNormalized;
+    sidechain_[fifoIndex] =
+        inputs[static_cast<int>(InputId::SidechainIn)].getVoltage() * kVcvAudioToNormalized;
+
+    if (activeBlockSize_ == 0)
+    {
+      updateProcessorParams();
+      runCore(1);
+      writeOutputs(0);
+      return;
+    }
+
+    // Block mode: emit the previous block's output for this slot, then run the core
+    // once the input FIFO is full. This adds exactly activeBlockSize_ samples of delay.
+    writeOutputs(fifoPos_);
+    if (++fifoPos_ == activeBlockSize_)
+    {
+      updateProcessorParams();
+      runCore(activeBlockSize_);
+      fifoPos_ = 0;
+    }
+  }
+
+  json_t* dataToJson() override
+  {
+    json_t* rootJ = json_object();
+    std::lock_guard<std::mutex> lock(path_mutex_);
+    json_object_set_new(rootJ, "ir1Path", json_string(loaded_file_path1_.c_str()));
+    json_object_set_new(rootJ, "ir2Path", json_string(loaded_file_path2_.c_str()));
+    json_object_set_new(rootJ, "blockSize", json_integer(getBufferedBlockSize()));
+    return rootJ;
+  }
+
+  void dataFromJson(json_t* rootJ) override
+  {
+    // Patches saved before block buffering existed have no key and keep the
+    // zero-latency default.
+    json_t* blockSizeJ = json_object_get(rootJ, "blockSize");
+    if (json_is_integer(blockSizeJ))
+      setBufferedBlockSize(static_cast<int>(json_integer_value(blockSizeJ)));
+
+    json_t* ir1PathJ = json_object_get(rootJ, "ir1Path");
+    if (json_is_string(ir1PathJ))
+    {
+      std::string path = json_string_value(ir1PathJ);
+      if (!path.empty())
+        loadIR(path);
+    }
+
+    json_t* ir2PathJ = json_object_get(rootJ, "ir2Path");
+    if (json_is_string(ir2PathJ))
+    {
+      std::string path = json_string_value(ir2PathJ);
+      if (!path.empty())
+        loadIR2(path);
+    }
+  }
+
+ private:
+  // Runs on a worker thread once the core has staged (or given up on) a request.
+  void onLoadCompleted(const octob::IRLoadCompletion& completion)
+  {
+    const int index = completion.slot - 1;
+    std::lock_guard<std::mutex> loadLock(loadMutex_);
+    if (completion.ticket != latestLoads_[index])
+      return;
+    latestLoads_[index] = 0;
+    setPendingLoad(index, std::string());
+
+    if (completion.status == octob::IRLoadStatus::Loaded)
+    {
+      std::string error;
+      if (!polyEngine_.loadSlot(index, completion.filepath, error))
+        WARN("IR %s unavailable for polyphonic input: %s", slotName(index), error.c_str());
+
+      std::lock_guard<std::mutex> lock(path_mutex_);
+      (index == 0 ? loaded_file_path1_ : loaded_file_path2_) = completion.filepath;
+      INFO("Loaded IR %s: %s", slotName(index), completion.filepath.c_str());
+    }
+    else if (completion.status == octob::IRLoadStatus::Failed)
+    {
+      WARN("Failed to load IR %s file %s: %s", slotName(index), completion.filepath.c_str(),
+           completion.errorMessage.c_str());
+      polyEngine_.clearSlot(index);
+      std::lock_guard<std::mutex> lock(path_mutex_);
+      (index == 0 ? loaded_file_path1_ : loaded_file_path2_).clear();
+    }
+  }
+
+  static const char* slotName(int index) { return index == 0 ? "A" : "B"; }
+
+  void setPendingLoad(int index, const std::string& file_path)
+  {
+    std::lock_guard<std::mutex> lock(path_mutex_);
+    pendingLoadPaths_[index] = file_path;
+  }
 
+  void resetBlockFifos()
+  {
+    fifoPos_ = 0;
+    std::fill(std::begin(inputL_), std::end(inputL_), 0.0f);
+    std::fill(std::begin(inputR_), std::end(inputR_), 0.0f);
+    std::fill(std::begin(sidechain_), std::end(sidechain_), 0.0f);
+    std::fill(std::begin(outputL_), std::end(outputL_), 0.0f);
+    std::fill(std::begin(outputR_), std::end(outputR_), 0.0f);
+  }
+
+  void trackCableEdges()
+  {
     const bool scConnected = inputs[static_cast<int>(InputId::SidechainIn)].isConnected();
 
     // Auto-enable the sidechain button on the rising edge of an SC cable being
@@ -262,7 +522,18 @@ struct OpcVcvIr final : Module
       }
     }
     prevBlendCvConnected_ = blendCvConnected;
+  }
 
+  // Pushes knob/CV state into the core and picks the input routing. Called once per
+  // core invocation, so in block mode parameters and CV are sampled at block rate.
+  void updateProcessorParams()
+  {
+    bool dynamicMode =
+        inputs[static_cast<int>(InputId::DynamicsEnableCvIn)].isConnected()
+            ? inputs[static_cast<int>(InputId::DynamicsEnableCvIn)].getVoltage() > 1.0f
+            : params[static_cast<int>(ParamId::DynamicModeParam)].getValue() > 0.5f;
+
+    const bool scConnected = inputs[static_cast<int>(InputId::SidechainIn)].isConnected();
     bool sidechainEnabled =
         params[static_cast<int>(ParamId::SidechainEnableParam)].getValue() > 0.5f;
 
@@ -315,119 +586,103 @@ struct OpcVcvIr final : Module
     lights[static_cast<int>(LightId::DynamicModeLight)].setBrightness(dynamicMode ? 1.0f : 0.0f);
     lights[static_cast<int>(LightId::SidechainLight)].setBrightness(sidechainEnabled ? 1.0f : 0.0f);
 
-    if (dynamicMode && sidechainEnabled && scConnected)
-    {
-      float sc =
-          inputs[static_cast<int>(InputId::SidechainIn)].getVoltage() * kVcvAudioToNormalized;
-
-      if (leftConnected && rightConnected)
-      {
-        float inputL =
-            inputs[static_cast<int>(InputId::AudioInL)].getVoltage() * kVcvAudioToNormalized;
-        float inputR =
-            inputs[static_cast<int>(InputId::AudioInR)].getVoltage() * kVcvAudioToNormalized;
-        float outputL = 0.0f;
-        float outputR = 0.0f;
-        irProcessor_.processStereoWithSidechain(&inputL, &inputR, &sc, &sc, &outputL, &outputR, 1);
-        outputs[static_cast<int>(OutputId::OutputL)].setVoltage(outputL * kNormalizedToVcvAudio);
-        outputs[static_cast<int>(OutputId::OutputR)].setVoltage(outputR * kNormalizedToVcvAudio);
-      }
-      else if (leftConnected)
-      {
-        float input =
-            inputs[static_cast<int>(InputId::AudioInL)].getVoltage() * kVcvAudioToNormalized;
-        float outputL = 0.0f;
-        float outputR = 0.0f;
-        irProcessor_.processMonoToStereoWithSidechain(&input, &sc, &outputL, &outputR, 1);
-        outputs[static_cast<int>(OutputId::OutputL)].setVoltage(outputL * kNormalizedToVcvAudio);
-        outputs[static_cast<int>(OutputId::OutputR)].setVoltage(outputR * kNormalizedToVcvAudio);
-      }
-      else if (rightConnected)
-      {
-        float input =
-            inputs[static_cast<int>(InputId::AudioInR)].getVoltage() * kVcvAudioToNormalized;
-        float outputL = 0.0f;
-        float outputR = 0.0f;
-        irProcessor_.processMonoToStereoWithSidechain(&input, &sc, &outputL, &outputR, 1);
-        outputs[static_cast<int>(OutputId::OutputL)].setVoltage(outputL * kNormalizedToVcvAudio);
-        outputs[static_cast<int>(OutputId::OutputR)].setVoltage(outputR * kNormalizedToVcvAudio);
-      }
-      else
-      {
-        outputs[static_cast<int>(OutputId::OutputL)].setVoltage(0.0f);
-        outputs[static_cast<int>(OutputId::OutputR)].setVoltage(0.0f);
-      }
-    }
+    sidechainActive_ = dynamicMode && sidechainEnabled && scConnected;
+    if (leftConnected && rightConnected)
+      routing_ = Routing::Stereo;
+    else if (leftConnected)
+      routing_ = Routing::LeftMono;
+    else if (rightConnected)
+      routing_ = Routing::RightMono;
     else
+      routing_ = Routing::Silent;
+  }
+
+  void runCore(int numFrames)
+  {
+    const auto frames = static_cast<size_t>(numFrames);
+
+    switch (routing_)
     {
-      if (leftConnected && rightConnected)
-      {
-        float inputL =
-            inputs[static_cast<int>(InputId::AudioInL)].getVoltage() * kVcvAudioToNormalized;
-        float inputR =
-            inputs[static_cast<int>(InputId::AudioInR)].getVoltage() * kVcvAudioToNormalized;
-        float outputL = 0.0f;
-        float outputR = 0.0f;
-        irProcessor_.processStereo(&inputL, &inputR, &outputL, &outputR, 1);
-        outputs[static_cast<int>(OutputId::OutputL)].setVoltage(outputL * kNormalizedToVcvAudio);
-        outputs[static_cast<int>(OutputId::OutputR)].setVoltage(outputR * kNormalizedToVcvAudio);
-      }
-      else if (leftConnected)
+      case Routing::Stereo:
+        if (sidechainActive_)
+          irProcessor_.processStereoWithSidechain(inputL_, inputR_, sidechain_, sidechain_,
+                                                  outputL_, outputR_, frames);
+        else
+          irProcessor_.processStereo(inputL_, inputR_, outputL_, outputR_, frames);
+        break;
+      case Routing::LeftMono:
+      case Routing::RightMono:
       {
-        float input =
-            inputs[static_cast<int>(InputId::AudioInL)].getVoltage() * kVcvAudioToNormalized;
-        float outputL = 0.0f;
-        float outputR = 0.0f;
-        irProcessor_.processMonoToStereo(&input, &outputL, &outputR, 1);
-        outputs[static_cast<int>(OutputId::OutputL)].setVoltage(outputL * kNormalizedToVcvAudio);
-        outputs[static_cast<int>(OutputId::OutputR)].setVoltage(outputR * kNormalizedToVcvAudio);
-      }
-      else if (rightConnected)
-      {
-        float input =
-            inputs[static_cast<int>(InputId::AudioInR)].getVoltage() * kVcvAudioToNormalized;
-        float outputL = 0.0f;
-        float outputR = 0.0f;
-        irProcessor_.processMonoToStereo(&input, &outputL, &outputR, 1);
-        outputs[static_cast<int>(OutputId::OutputL)].setVoltage(outputL * kNormalizedToVcvAudio);
-        outputs[static_cast<int>(OutputId::OutputR)].setVoltage(outputR * kNormalizedToVcvAudio);
-      }
-      else
-      {
-        outputs[static_cast<int>(OutputId::OutputL)].setVoltage(0.0f);
-        outputs[static_cast<int>(OutputId::OutputR)].setVoltage(0.0f);
+        const float* input = routing_ == Routing::LeftMono ? inputL_ : inputR_;
+        if (sidechainActive_)
+          irProcessor_.processMonoToStereoWithSidechain(input, sidechain_, outputL_, outputR_,
+                                                        frames);
+        else
+          irProcessor_.processMonoToStereo(input, outputL_, outputR_, frames);
+        break;
       }
+      case Routing::Silent:
+        std::fill(outputL_, outputL_ + numFrames, 0.0f);
+        std::fill(outputR_, outputR_ + numFrames, 0.0f);
+        break;
     }
 
     currentInputLevelDb_.store(irProcessor_.getCurrentInputLevel(), std::memory_order_relaxed);
     currentBlend_.store(irProcessor_.getCurrentBlend(), std::memory_order_relaxed);
   }
 
-  json_t* dataToJson() override
-  {
-    json_t* rootJ = json_object();
-    std::lock_guard<std::mutex> lock(path_mutex_);
-    json_object_set_new(rootJ, "ir1Path", json_string(loaded_file_path1_.c_str()));
-    json_object_set_new(rootJ, "ir2Path", json_string(loaded_file_path2_.c_str()));
-    return rootJ;
-  }
-
-  void dataFromJson(json_t* rootJ) override
+  // Polyphonic input: every voice shares the IR kernels loaded into polyEngine_ and
+  // follows the same knob/CV settings, with its own detector and blend state.
+  void processPoly(int numVoices)
   {
-    json_t* ir1PathJ = json_object_get(rootJ, "ir1Path");
-    if (json_is_string(ir1PathJ))
+    polyActive_.store(true, std::memory_order_relaxed);
+    if (polyEngine_.isBlockStart())
+      updateProcessorParams();
+
+    auto& inL = inputs[static_cast<int>(InputId::AudioInL)];
+    auto& inR = inputs[static_cast<int>(InputId::AudioInR)];
+    auto& sc = inputs[static_cast<int>(InputId::SidechainIn)];
+    auto& outL = outputs[static_cast<int>(OutputId::OutputL)];
+    auto& outR = outputs[static_cast<int>(OutputId::OutputR)];
+    const auto& mono = routing_ == Routing::RightMono ? inR : inL;
+    const bool stereo = routing_ == Routing::Stereo;
+
+    outL.setChannels(numVoices);
+    outR.setChannels(numVoices);
+    for (int c = 0; c < numVoices; c += 4)
     {
-      std::string path = json_string_value(ir1PathJ);
-      if (!path.empty())
-        loadIR(path);
+      const int group = c / 4;
+      outL.setVoltageSimd(polyEngine_.readLeft(group) * kNormalizedToVcvAudio, c);
+      outR.setVoltageSimd(polyEngine_.readRight(group) * kNormalizedToVcvAudio, c);
+
+      const simd::float_4 left =
+          (stereo ? inL : mono).getPolyVoltageSimd<simd::float_4>(c) * kVcvAudioToNormalized;
+      const simd::float_4 right =
+          stereo ? inR.getPolyVoltageSimd<simd::float_4>(c) * kVcvAudioToNormalized : left;
+      const simd::float_4 sidechain =
+          sc.getPolyVoltageSimd<simd::float_4>(c) * kVcvAudioToNormalized;
+      polyEngine_.writeFrame(group, left, right, sidechain);
     }
 
-    json_t* ir2PathJ = json_object_get(rootJ, "ir2Path");
-    if (json_is_string(ir2PathJ))
+    // Voices detect over the same lengths the monophonic path would run the core for.
+    const int blockSize = requestedBlockSize_.load(std::memory_order_relaxed);
+    polyEngine_.advance(irProcessor_, numVoices,
+                        stereo ? OpcVcvIrPolyEngine::InputLayout::Stereo
+                               : OpcVcvIrPolyEngine::InputLayout::Mono,
+                        sidechainActive_, blockSize > 0 ? blockSize : 1);
+
+    if (polyEngine_.isBlockStart())
     {
-      std::string path = json_string_value(ir2PathJ);
-      if (!path.empty())
-        loadIR2(path);
+      currentInputLevelDb_.store(polyEngine_.getVoiceLevelDb(0), std::memory_order_relaxed);
+      currentBlend_.store(polyEngine_.getVoiceBlend(0), std::memory_order_relaxed);
     }
   }
+
+  void writeOutputs(int index)
+  {
+    outputs[static_cast<int>(OutputId::OutputL)].setVoltage(outputL_[index] *
+                                                            kNormalizedToVcvAudio);
+    outputs[static_cast<int>(OutputId::OutputR)].setVoltage(outputR_[index] *
+                                                            kNormalizedToVcvAudio);
+  }
 };
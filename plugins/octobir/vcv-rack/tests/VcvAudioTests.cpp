@@ -1194,3 +1194,312 @@ TEST_F(VcvAudioTest, EmptyEnabledSlotA_BlendFullA_OutputMatchesDry)
   EXPECT_GT(r, 0.999) << "With blend fully toward empty-but-enabled slot A, "
                       << "output should match dry input (r=" << r << ")";
 }
+
+// ---------------------------------------------------------------------------
+// Block-buffered processing
+// ---------------------------------------------------------------------------
+
+// Block mode should reproduce the per-sample output, delayed by exactly the
+// reported extra latency.
+TEST_F(VcvAudioTest, BlockMode_MatchesPerSampleDelayedByBlockSize)
+{
+  for (int blockSize : {16, 64, 128})
+  {
+    OpcVcvIr reference;
+    OpcVcvIr blocked;
+    for (OpcVcvIr* module : {&reference, &blocked})
+    {
+      SampleRateChangeEvent sr{kSampleRate};
+      module->onSampleRateChange(sr);
+      module->loadIR(kIrAPath);
+      module->loadIR2(kIrBPath);
+      module->params[static_cast<int>(OpcVcvIr::ParamId::BlendParam)].setValue(0.3f);
+    }
+    blocked.setBufferedBlockSize(blockSize);
+    ASSERT_EQ(blocked.getExtraLatencySamples(), blockSize);
+
+    auto refOut = processMonoInput(reference, dryInput_);
+    auto blockOut = processMonoInput(blocked, dryInput_);
+    ASSERT_EQ(refOut.L.size(), blockOut.L.size());
+
+    const auto delay = static_cast<size_t>(blockSize);
+    float maxDiff = 0.0f;
+    for (size_t i = delay; i < blockOut.L.size(); ++i)
+    {
+      maxDiff = std::max(maxDiff, std::abs(blockOut.L[i] - refOut.L[i - delay]));
+      maxDiff = std::max(maxDiff, std::abs(blockOut.R[i] - refOut.R[i - delay]));
+    }
+    EXPECT_LT(maxDiff, 1e-3f) << "Block size " << blockSize << " diverged from per-sample output";
+  }
+}
+
+TEST_F(VcvAudioTest, BlockMode_SwitchingBackToZeroRestoresPerSampleOutput)
+{
+  OpcVcvIr module;
+  SampleRateChangeEvent sr{kSampleRate};
+  module.onSampleRateChange(sr);
+  module.loadIR(kIrAPath);
+  module.setBufferedBlockSize(32);
+
+  const int inL = static_cast<int>(OpcVcvIr::InputId::AudioInL);
+  module.inputs[static_cast<size_t>(inL)].connected = true;
+  ProcessArgs args{kSampleRate, 1.f / kSampleRate};
+  for (int i = 0; i < 1000; ++i)
+    module.process(args);
+
+  module.setBufferedBlockSize(0);
+  EXPECT_EQ(module.getExtraLatencySamples(), 0);
+
+  auto out = processMonoInput(module, dryInput_);
+  float peak = 0.0f;
+  for (float s : out.L)
+    peak = std::max(peak, std::abs(s));
+  EXPECT_GT(peak, 1e-6f);
+}
+
+// ---------------------------------------------------------------------------
+// Polyphonic input
+// ---------------------------------------------------------------------------
+
+struct PolyOutput
+{
+  std::vector<std::vector<float>> L;
+  std::vector<std::vector<float>> R;
+};
+
+// Drives the left input with numVoices channels, each a scaled copy of input.
+static PolyOutput processPolyMonoInput(OpcVcvIr& module, const std::vector<float>& input,
+                                       const std::vector<float>& voiceGains)
+{
+  const int inL = static_cast<int>(OpcVcvIr::InputId::AudioInL);
+  const int outL = static_cast<int>(OpcVcvIr::OutputId::OutputL);
+  const int outR = static_cast<int>(OpcVcvIr::OutputId::OutputR);
+  const int numVoices = static_cast<int>(voiceGains.size());
+
+  auto& port = module.inputs[static_cast<size_t>(inL)];
+  port.connected = true;
+  port.channels = numVoices;
+  for (int v = 0; v < numVoices; ++v)
+    port.setVoltage(0.f, v);
+
+  ProcessArgs args{kSampleRate, 1.f / kSampleRate};
+  for (size_t i = 0; i < kLatencyFlushFrames; ++i)
+    module.process(args);
+
+  PolyOutput out;
+  out.L.assign(voiceGains.size(), std::vector<float>());
+  out.R.assign(voiceGains.size(), std::vector<float>());
+  for (float sample : input)
+  {
+    for (int v = 0; v < numVoices; ++v)
+      port.setVoltage(sample * voiceGains[static_cast<size_t>(v)], v);
+    module.process(args);
+    for (int v = 0; v < numVoices; ++v)
+    {
+      const auto voice = static_cast<size_t>(v);
+      out.L[voice].push_back(module.outputs[static_cast<size_t>(outL)].getVoltage(v));
+      out.R[voice].push_back(module.outputs[static_cast<size_t>(outR)].getVoltage(v));
+    }
+  }
+  return out;
+}
+
+// Every voice runs the same IR pair, so with a static blend each voice is the
+// monophonic output scaled by its input gain, delayed by the poly block size.
+TEST_F(VcvAudioTest, PolyInput_VoicesMatchMonoOutputDelayedByPolyBlock)
+{
+  OpcVcvIr reference;
+  OpcVcvIr poly;
+  for (OpcVcvIr* module : {&reference, &poly})
+  {
+    SampleRateChangeEvent sr{kSampleRate};
+    module->onSampleRateChange(sr);
+    module->loadIR(kIrAPath);
+    module->loadIR2(kIrStereoPath);
+    module->params[static_cast<int>(OpcVcvIr::ParamId::BlendParam)].setValue(0.3f);
+  }
+
+  const std::vector<float> gains = {1.0f, 0.5f, -0.75f, 0.25f, 0.8f, -1.0f};
+  auto refOut = processMonoInput(reference, dryInput_);
+  auto polyOut = processPolyMonoInput(poly, dryInput_, gains);
+
+  const int outL = static_cast<int>(OpcVcvIr::OutputId::OutputL);
+  EXPECT_EQ(poly.outputs[static_cast<size_t>(outL)].getChannels(), static_cast<int>(gains.size()));
+  EXPECT_EQ(poly.getExtraLatencySamples(), poly.getPolyEngine().getLatencySamples());
+
+  const auto delay = static_cast<size_t>(OpcVcvIrPolyEngine::kBlockSize);
+  for (size_t v = 0; v < gains.size(); ++v)
+  {
+    float maxDiff = 0.0f;
+    for (size_t i = delay; i < refOut.L.size(); ++i)
+    {
+      maxDiff = std::max(maxDiff, std::abs(polyOut.L[v][i] - gains[v] * refOut.L[i - delay]));
+      maxDiff = std::max(maxDiff, std::abs(polyOut.R[v][i] - gains[v] * refOut.R[i - delay]));
+    }
+    EXPECT_LT(maxDiff, 1e-3f) << "Voice " << v << " diverged from the monophonic output";
+  }
+}
+
+TEST_F(VcvAudioTest, PolyInput_DynamicBlendIsPerVoice)
+{
+  OpcVcvIr module;
+  SampleRateChangeEvent sr{kSampleRate};
+  module.onSampleRateChange(sr);
+  module.loadIR(kIrAPath);
+  module.loadIR2(kIrBPath);
+  module.params[static_cast<int>(OpcVcvIr::ParamId::DynamicModeParam)].setValue(1.f);
+  module.params[static_cast<int>(OpcVcvIr::ParamId::ThresholdParam)].setValue(-40.f);
+
+  processPolyMonoInput(module, dryInput_, {1.0f, 0.001f});
+
+  const auto& engine = module.getPolyEngine();
+  EXPECT_GT(engine.getVoiceBlend(0), engine.getVoiceBlend(1) + 0.1f)
+      << "A loud voice should blend further toward IR B than a quiet one";
+  EXPECT_FLOAT_EQ(module.getCurrentBlend(), engine.getVoiceBlend(0));
+}
+
+// The voices detect and smooth their levels with the same law as the monophonic path,
+// per sample by default and per buffered block otherwise, so with dynamic mode on a
+// voice still matches the monophonic output in either detection mode.
+TEST_F(VcvAudioTest, PolyInput_DynamicVoicesMatchMonoOutput)
+{
+  for (int blockSize : {0, 32})
+  {
+    for (int mode : {0, 1})
+    {
+      OpcVcvIr reference;
+      OpcVcvIr poly;
+      for (OpcVcvIr* module : {&reference, &poly})
+      {
+        SampleRateChangeEvent sr{kSampleRate};
+        module->onSampleRateChange(sr);
+        module->setBufferedBlockSize(blockSize);
+        module->loadIR(kIrAPath);
+        module->loadIR2(kIrBPath);
+        module->params[static_cast<int>(OpcVcvIr::ParamId::DynamicModeParam)].setValue(1.f);
+        module->params[static_cast<int>(OpcVcvIr::ParamId::ThresholdParam)].setValue(-30.f);
+        module->params[static_cast<int>(OpcVcvIr::ParamId::DetectionModeParam)].setValue(
+            static_cast<float>(mode));
+        module->params[static_cast<int>(OpcVcvIr::ParamId::AttackTimeParam)].setValue(1.f);
+        module->params[static_cast<int>(OpcVcvIr::ParamId::ReleaseTimeParam)].setValue(20.f);
+      }
+
+      // Both detectors ignore the sign, so an inverted voice is the inverted output.
+      const std::vector<float> gains = {1.0f, -1.0f};
+      auto refOut = processMonoInput(reference, dryInput_);
+      auto polyOut = processPolyMonoInput(poly, dryInput_, gains);
+
+      const auto delay = static_cast<size_t>(OpcVcvIrPolyEngine::kBlockSize - blockSize);
+      for (size_t v = 0; v < gains.size(); ++v)
+      {
+        float maxDiff = 0.0f;
+        for (size_t i = delay; i < refOut.L.size(); ++i)
+        {
+          maxDiff = std::max(maxDiff, std::abs(polyOut.L[v][i] - gains[v] * refOut.L[i - delay]));
+          maxDiff = std::max(maxDiff, std::abs(polyOut.R[v][i] - gains[v] * refOut.R[i - delay]));
+        }
+        EXPECT_LT(maxDiff, 1e-3f) << "Voice " << v << " diverged with block size " << blockSize
+                                  << " and detection mode " << mode;
+      }
+    }
+  }
+}
+
+// Switching back to RMS must not resume from the window left by the last RMS run.
+TEST_F(VcvAudioTest, PolyInput_DetectionModeChangeClearsRmsWindow)
+{
+  OpcVcvIr module;
+  SampleRateChangeEvent sr{kSampleRate};
+  module.onSampleRateChange(sr);
+  module.loadIR(kIrAPath);
+  module.loadIR2(kIrBPath);
+  auto& mode = module.params[static_cast<int>(OpcVcvIr::ParamId::DetectionModeParam)];
+  auto& port = module.inputs[static_cast<size_t>(OpcVcvIr::InputId::AudioInL)];
+  port.connected = true;
+  port.channels = 2;
+
+  ProcessArgs args{kSampleRate, 1.f / kSampleRate};
+  auto run = [&](float voltage, int frames)
+  {
+    port.setVoltage(voltage, 0);
+    port.setVoltage(voltage, 1);
+    for (int i = 0; i < frames; ++i)
+      module.process(args);
+  };
+
+  mode.setValue(1.f);
+  run(5.f, 4096);
+  EXPECT_GT(module.getPolyEngine().getVoiceLevelDb(0), -10.0f);
+
+  mode.setValue(0.f);
+  run(0.f, 2 * OpcVcvIrPolyEngine::kBlockSize);
+  mode.setValue(1.f);
+  run(0.f, 2 * OpcVcvIrPolyEngine::kBlockSize);
+  EXPECT_FLOAT_EQ(module.getPolyEngine().getVoiceLevelDb(0), octob::LevelDetector::FloorDb);
+}
+
+TEST_F(VcvAudioTest, PolyInput_MonophonicCableRestoresSingleChannelOutput)
+{
+  OpcVcvIr module;
+  SampleRateChangeEvent sr{kSampleRate};
+  module.onSampleRateChange(sr);
+  module.loadIR(kIrAPath);
+
+  processPolyMonoInput(module, std::vector<float>(256, 0.1f), {1.0f, 1.0f, 1.0f});
+  const int outL = static_cast<int>(OpcVcvIr::OutputId::OutputL);
+  EXPECT_EQ(module.outputs[static_cast<size_t>(outL)].getChannels(), 3);
+
+  const int inL = static_cast<int>(OpcVcvIr::InputId::AudioInL);
+  module.inputs[static_cast<size_t>(inL)].channels = 1;
+  auto out = processMonoInput(module, dryInput_);
+  EXPECT_EQ(module.outputs[static_cast<size_t>(outL)].getChannels(), 1);
+  EXPECT_EQ(module.getExtraLatencySamples(), 0);
+
+  float peak = 0.0f;
+  for (float s : out.L)
+    peak = std::max(peak, std::abs(s));
+  EXPECT_GT(peak, 1e-6f);
+}
+
+// Only one of the mono and poly paths runs at a time, so switching back to either must
+// start it from silence instead of playing out what it held before the switch.
+TEST_F(VcvAudioTest, PolyInput_SwitchingPathsDoesNotReplayStaleHistory)
+{
+  OpcVcvIr module;
+  SampleRateChangeEvent sr{kSampleRate};
+  module.onSampleRateChange(sr);
+  module.loadIR(kIrAPath);
+
+  const int inL = static_cast<int>(OpcVcvIr::InputId::AudioInL);
+  const int outL = static_cast<int>(OpcVcvIr::OutputId::OutputL);
+  auto& port = module.inputs[static_cast<size_t>(inL)];
+  port.connected = true;
+  ProcessArgs args{kSampleRate, 1.f / kSampleRate};
+
+  // Runs numFrames on numVoices voices, the input loud or silent, and returns the
+  // output peak across the voices.
+  auto run = [&](int numVoices, bool loud, size_t numFrames)
+  {
+    port.channels = numVoices;
+    float peak = 0.0f;
+    for (size_t i = 0; i < numFrames; ++i)
+    {
+      const float sample = loud ? 5.0f * std::sin(0.05f * static_cast<float>(i)) : 0.0f;
+      for (int v = 0; v < numVoices; ++v)
+        port.setVoltage(sample, v);
+      module.process(args);
+      for (int v = 0; v < numVoices; ++v)
+        peak = std::max(peak,
+                        std::abs(module.outputs[static_cast<size_t>(outL)].getVoltage(v)));
+    }
+    return peak;
+  };
+
+  ASSERT_GT(run(1, true, 4096), 0.1f);
+  run(2, false, 256);
+  EXPECT_LT(run(1, false, 2048), 1e-4f) << "mono path replayed history from before poly";
+
+  ASSERT_GT(run(2, true, 4096), 0.1f);
+  run(1, false, 256);
+  EXPECT_LT(run(2, false, 2048), 1e-4f) << "poly path replayed history from before mono";
+}
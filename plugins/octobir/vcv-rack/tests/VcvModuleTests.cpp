@@ -1,5 +1,8 @@
 #include <gtest/gtest.h>
 
+#include <chrono>
+#include <thread>
+
 #include "opc-vcv-ir.hpp"
 
 static const std::string kIrAPath = std::string(TEST_DATA_DIR) + "/INPUT_ir_a.wav";
@@ -67,6 +70,48 @@ TEST(VcvModuleTest, LoadIR_SetsIsIR1Loaded)
   EXPECT_TRUE(module.getIRProcessor().isIR1Loaded());
 }
 
+// Polls until the slot's loaded path matches, for requests completing on a worker.
+static bool waitForLoadedPath(const OpcVcvIr& module, bool ir2, const std::string& path)
+{
+  for (int i = 0; i < 3000; ++i)
+  {
+    if (module.getLoadedFilePath(ir2) == path)
+      return true;
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  return false;
+}
+
+TEST(VcvModuleTest, RequestIR_LoadsInBackground)
+{
+  OpcVcvIr module;
+  module.requestIR(true, kIrBPath);
+  EXPECT_EQ(module.getNavigationPath(true), kIrBPath);
+  ASSERT_TRUE(waitForLoadedPath(module, true, kIrBPath));
+  EXPECT_EQ(module.getIRProcessor().getCurrentIR2Path(), kIrBPath);
+}
+
+TEST(VcvModuleTest, RequestIR_LastRequestWins)
+{
+  OpcVcvIr module;
+  module.requestIR(false, kIrBPath);
+  module.requestIR(false, kIrAPath);
+  EXPECT_EQ(module.getNavigationPath(false), kIrAPath);
+  ASSERT_TRUE(waitForLoadedPath(module, false, kIrAPath));
+  EXPECT_EQ(module.getIRProcessor().getCurrentIR1Path(), kIrAPath);
+}
+
+TEST(VcvModuleTest, RequestIR_ClearSupersedesRequest)
+{
+  OpcVcvIr module;
+  module.requestIR(false, kIrAPath);
+  module.clearIR1();
+  EXPECT_TRUE(module.getNavigationPath(false).empty());
+  module.loadIR2(kIrBPath);
+  EXPECT_TRUE(module.getLoadedFilePath(false).empty());
+  EXPECT_TRUE(module.getIRProcessor().getCurrentIR1Path().empty());
+}
+
 // ---------------------------------------------------------------------------
 // Sample rate
 // ---------------------------------------------------------------------------
@@ -160,3 +205,45 @@ TEST(VcvModuleTest, Serialization_EmptyPaths_DoesNotCrash)
   EXPECT_TRUE(reader.getLoadedFilePath(false).empty());
   EXPECT_TRUE(reader.getLoadedFilePath(true).empty());
 }
+
+// ---------------------------------------------------------------------------
+// Block-buffered processing
+// ---------------------------------------------------------------------------
+
+TEST(VcvModuleTest, BlockSize_DefaultsToZeroExtraLatency)
+{
+  OpcVcvIr module;
+  EXPECT_EQ(module.getBufferedBlockSize(), 0);
+  EXPECT_EQ(module.getExtraLatencySamples(), 0);
+}
+
+TEST(VcvModuleTest, BlockSize_ReportsExtraLatency)
+{
+  OpcVcvIr module;
+  module.setBufferedBlockSize(64);
+  EXPECT_EQ(module.getBufferedBlockSize(), 64);
+  EXPECT_EQ(module.getExtraLatencySamples(), 64);
+}
+
+TEST(VcvModuleTest, BlockSize_UnsupportedValueFallsBackToZero)
+{
+  OpcVcvIr module;
+  module.setBufferedBlockSize(32);
+  module.setBufferedBlockSize(100);
+  EXPECT_EQ(module.getBufferedBlockSize(), 0);
+}
+
+TEST(VcvModuleTest, Serialization_BlockSizeRoundTrip)
+{
+  OpcVcvIr writer;
+  writer.setBufferedBlockSize(128);
+
+  json_t* state = writer.dataToJson();
+  ASSERT_NE(state, nullptr);
+
+  OpcVcvIr reader;
+  reader.dataFromJson(state);
+  json_decref(state);
+
+  EXPECT_EQ(reader.getBufferedBlockSize(), 128);
+}
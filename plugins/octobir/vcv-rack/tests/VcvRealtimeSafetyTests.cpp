@@ -0,0 +1,81 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+
+#include "RealtimeGuard.hpp"
+#include "opc-vcv-ir.hpp"
+
+// process() must not allocate, free or lock while IRs are requested, cleared and
+// swapped from another thread. Covers the polyphonic path, which is the module's own
+// convolution; the monophonic path runs IRProcessor's entry points, which octobir-core's
+// RealtimeSafetyTests cover for every engine the repo implements.
+
+static const std::string kIrAPath = std::string(TEST_DATA_DIR) + "/INPUT_ir_a.wav";
+static const std::string kIrBPath = std::string(TEST_DATA_DIR) + "/INPUT_ir_b.wav";
+
+static constexpr int kNumVoices = 16;
+
+static void connectPolyInput(OpcVcvIr& module)
+{
+  auto& port = module.inputs[static_cast<size_t>(OpcVcvIr::InputId::AudioInL)];
+  port.connected = true;
+  port.channels = kNumVoices;
+  for (int c = 0; c < kNumVoices; ++c)
+    port.setVoltage(0.5f + 0.1f * static_cast<float>(c), c);
+}
+
+TEST(VcvRealtimeSafetyTest, PolyProcessIsRealtimeSafe)
+{
+  OpcVcvIr module;
+  connectPolyInput(module);
+  module.loadIR(kIrAPath);
+  module.loadIR2(kIrBPath);
+  module.params[static_cast<size_t>(OpcVcvIr::ParamId::DynamicModeParam)].setValue(1.f);
+
+  const ProcessArgs args{44100.f, 1.f / 44100.f};
+  const octob::RealtimeReport report = octob::runRealtime(
+      [&]
+      {
+        for (int i = 0; i < 4 * OpcVcvIrPolyEngine::kBlockSize; ++i)
+          module.process(args);
+      });
+  EXPECT_TRUE(report.isClean()) << report.describe();
+}
+
+TEST(VcvRealtimeSafetyTest, PolyProcessStaysRealtimeSafeUnderConcurrentChanges)
+{
+  OpcVcvIr module;
+  connectPolyInput(module);
+  module.loadIR(kIrAPath);
+
+  std::atomic<bool> done{false};
+  std::thread control(
+      [&]
+      {
+        for (int i = 0; i < 12; ++i)
+        {
+          module.requestIR(false, i % 2 ? kIrAPath : kIrBPath);
+          module.loadIR2(i % 2 ? kIrBPath : kIrAPath);
+          module.swapImpulseResponses();
+          module.clearIR2();
+        }
+        done = true;
+      });
+
+  const ProcessArgs args{44100.f, 1.f / 44100.f};
+  octob::RealtimeReport total;
+  long frames = 0;
+  while (!done.load())
+  {
+    const octob::RealtimeReport report = octob::runRealtime([&] { module.process(args); });
+    total.allocations += report.allocations;
+    total.frees += report.frees;
+    total.locks += report.locks;
+    ++frames;
+  }
+  control.join();
+
+  EXPECT_GT(frames, 0);
+  EXPECT_TRUE(total.isClean()) << total.describe() << " over " << frames << " frames";
+}
@@ -4,7 +4,9 @@
 // Provides just enough surface area to compile and run the module struct
 // without a running Rack engine or GUI.
 
+#include <cmath>
 #include <cstdint>
+#include <cstring>
 #include <map>
 #include <string>
 #include <vector>
@@ -25,13 +27,17 @@
 enum json_type_t : uint8_t
 {
   JSON_OBJECT_T,
-  JSON_STRING_T
+  JSON_STRING_T,
+  JSON_INTEGER_T
 };
 
+using json_int_t = long long;
+
 struct json_t
 {
   json_type_t type;
   std::string strValue;
+  json_int_t intValue = 0;
   std::map<std::string, json_t*> children;
 
   ~json_t()
@@ -60,6 +66,13 @@ inline json_t* json_string(const char* s)
   return j;
 }
 
+inline json_t* json_integer(json_int_t value)
+{
+  auto* j = new json_t{JSON_INTEGER_T};
+  j->intValue = value;
+  return j;
+}
+
 inline void json_object_set_new(json_t* obj, const char* key, json_t* val)
 {
   if (obj != nullptr && key != nullptr && val != nullptr)
@@ -84,6 +97,16 @@ inline const char* json_string_value(const json_t* j)
   return (j != nullptr && j->type == JSON_STRING_T) ? j->strValue.c_str() : "";
 }
 
+inline bool json_is_integer(const json_t* j)
+{
+  return j != nullptr && j->type == JSON_INTEGER_T;
+}
+
+inline json_int_t json_integer_value(const json_t* j)
+{
+  return (j != nullptr && j->type == JSON_INTEGER_T) ? j->intValue : 0;
+}
+
 inline void json_decref(json_t* j)
 {
   delete j;
@@ -109,21 +132,190 @@ struct Param
   void setValue(float v) { value = v; }
 };
 
+constexpr int PORT_MAX_CHANNELS = 16;  // NOLINT(readability-identifier-naming)
+
+// ---------------------------------------------------------------------------
+// Minimal rack::simd::float_4 (scalar lanes)
+// ---------------------------------------------------------------------------
+namespace simd
+{
+
+// NOLINTBEGIN(readability-identifier-naming)
+struct float_4
+{
+  float s[4] = {};
+
+  float_4() = default;
+  float_4(float x) : s{x, x, x, x} {}  // NOLINT(google-explicit-constructor)
+  float_4(float a, float b, float c, float d) : s{a, b, c, d} {}
+
+  static float_4 zero() { return float_4(0.f); }
+  static float_4 load(const float* p) { return float_4(p[0], p[1], p[2], p[3]); }
+  void store(float* p) const
+  {
+    for (int i = 0; i < 4; ++i)
+      p[i] = s[i];
+  }
+  float& operator[](int i) { return s[i]; }
+  const float& operator[](int i) const { return s[i]; }
+};
+
+template <typename F>
+inline float_4 lanewise(const float_4& a, const float_4& b, F f)
+{
+  return float_4(f(a.s[0], b.s[0]), f(a.s[1], b.s[1]), f(a.s[2], b.s[2]), f(a.s[3], b.s[3]));
+}
+
+inline float maskBits(bool on)
+{
+  const uint32_t bits = on ? 0xFFFFFFFFu : 0u;
+  float f;
+  std::memcpy(&f, &bits, sizeof(f));
+  return f;
+}
+
+inline bool maskSet(float m)
+{
+  uint32_t bits;
+  std::memcpy(&bits, &m, sizeof(bits));
+  return bits != 0;
+}
+
+inline float_4 operator+(const float_4& a, const float_4& b)
+{
+  return lanewise(a, b, [](float x, float y) { return x + y; });
+}
+inline float_4 operator-(const float_4& a, const float_4& b)
+{
+  return lanewise(a, b, [](float x, float y) { return x - y; });
+}
+inline float_4 operator*(const float_4& a, const float_4& b)
+{
+  return lanewise(a, b, [](float x, float y) { return x * y; });
+}
+inline float_4 operator/(const float_4& a, const float_4& b)
+{
+  return lanewise(a, b, [](float x, float y) { return x / y; });
+}
+inline float_4 operator-(const float_4& a)
+{
+  return float_4(0.f) - a;
+}
+inline float_4& operator+=(float_4& a, const float_4& b)
+{
+  return a = a + b;
+}
+inline float_4& operator*=(float_4& a, const float_4& b)
+{
+  return a = a * b;
+}
+inline float_4 operator<(const float_4& a, const float_4& b)
+{
+  return lanewise(a, b, [](float x, float y) { return maskBits(x < y); });
+}
+inline float_4 operator<=(const float_4& a, const float_4& b)
+{
+  return lanewise(a, b, [](float x, float y) { return maskBits(x <= y); });
+}
+inline float_4 operator>(const float_4& a, const float_4& b)
+{
+  return lanewise(a, b, [](float x, float y) { return maskBits(x > y); });
+}
+inline float_4 operator>=(const float_4& a, const float_4& b)
+{
+  return lanewise(a, b, [](float x, float y) { return maskBits(x >= y); });
+}
+inline float_4 ifelse(const float_4& mask, const float_4& a, const float_4& b)
+{
+  float_4 r;
+  for (int i = 0; i < 4; ++i)
+    r.s[i] = maskSet(mask.s[i]) ? a.s[i] : b.s[i];
+  return r;
+}
+inline float_4 fmax(const float_4& a, const float_4& b)
+{
+  return lanewise(a, b, [](float x, float y) { return std::fmax(x, y); });
+}
+inline float_4 fmin(const float_4& a, const float_4& b)
+{
+  return lanewise(a, b, [](float x, float y) { return std::fmin(x, y); });
+}
+inline float_4 sqrt(const float_4& a)
+{
+  return float_4(std::sqrt(a.s[0]), std::sqrt(a.s[1]), std::sqrt(a.s[2]), std::sqrt(a.s[3]));
+}
+inline float_4 log(const float_4& a)
+{
+  return float_4(std::log(a.s[0]), std::log(a.s[1]), std::log(a.s[2]), std::log(a.s[3]));
+}
+// NOLINTEND(readability-identifier-naming)
+
+}  // namespace simd
+
 struct Input
 {
   float voltage = 0.f;
+  // Channels 1..15 of a polyphonic cable; channel 0 is `voltage`.
+  float polyVoltages[PORT_MAX_CHANNELS] = {};
   bool connected = false;
+  int channels = 1;
 
   [[nodiscard]] bool isConnected() const { return connected; }
-  [[nodiscard]] float getVoltage() const { return voltage; }
+  [[nodiscard]] int getChannels() const { return connected ? channels : 0; }
+  [[nodiscard]] bool isMonophonic() const { return getChannels() == 1; }
+  [[nodiscard]] float getVoltage(int channel = 0) const
+  {
+    return channel == 0 ? voltage : polyVoltages[channel];
+  }
+  [[nodiscard]] float getPolyVoltage(int channel) const
+  {
+    return isMonophonic() ? getVoltage(0) : getVoltage(channel);
+  }
+  template <typename T>
+  [[nodiscard]] T getVoltageSimd(int firstChannel) const
+  {
+    return T(getVoltage(firstChannel), getVoltage(firstChannel + 1), getVoltage(firstChannel + 2),
+             getVoltage(firstChannel + 3));
+  }
+  template <typename T>
+  [[nodiscard]] T getPolyVoltageSimd(int firstChannel) const
+  {
+    return isMonophonic() ? T(getVoltage(0)) : getVoltageSimd<T>(firstChannel);
+  }
+  void setVoltage(float v, int channel = 0)
+  {
+    if (channel == 0)
+      voltage = v;
+    else
+      polyVoltages[channel] = v;
+  }
 };
 
 struct Output
 {
   float voltage = 0.f;
+  float polyVoltages[PORT_MAX_CHANNELS] = {};
+  int channels = 1;
 
-  void setVoltage(float v) { voltage = v; }
-  [[nodiscard]] float getVoltage() const { return voltage; }
+  void setChannels(int n) { channels = n; }
+  [[nodiscard]] int getChannels() const { return channels; }
+  void setVoltage(float v, int channel = 0)
+  {
+    if (channel == 0)
+      voltage = v;
+    else
+      polyVoltages[channel] = v;
+  }
+  [[nodiscard]] float getVoltage(int channel = 0) const
+  {
+    return channel == 0 ? voltage : polyVoltages[channel];
+  }
+  template <typename T>
+  void setVoltageSimd(T v, int firstChannel)
+  {
+    for (int i = 0; i < 4 && firstChannel + i < PORT_MAX_CHANNELS; ++i)
+      setVoltage(v[i], firstChannel + i);
+  }
 };
 
 struct Light
@@ -0,0 +1,135 @@
+#include <octobir-core/IRBank.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <system_error>
+#include <vector>
+
+using namespace octob;
+
+namespace
+{
+
+void printUsage()
+{
+  std::fprintf(stderr,
+               "usage: octob-irbank <IR folder> <bank.oirb> [--rates R1,R2,...]\n"
+               "       octob-irbank --list <bank.oirb>\n"
+               "\n"
+               "Packs every WAV/AIFF under the folder into one memory-mapped IR bank,\n"
+               "pre-resampled for the given rates (default 44100,48000,88200,96000;\n"
+               "--rates none stores each IR at its own rate only). Entries are named by\n"
+               "their path relative to the folder. See tools/octob-irbank/README.md.\n");
+}
+
+bool parseRates(const char* text, std::vector<SampleRate>& rates)
+{
+  rates.clear();
+  if (std::strcmp(text, "none") == 0)
+    return true;
+  for (const char* start = text; *start != '\0';)
+  {
+    char* end = nullptr;
+    const double rate = std::strtod(start, &end);
+    if (end == start || rate < 8000.0 || rate > 768000.0 || (*end != ',' && *end != '\0'))
+      return false;
+    rates.push_back(rate);
+    start = *end == ',' ? end + 1 : end;
+  }
+  return !rates.empty();
+}
+
+bool isImpulseResponse(const std::filesystem::path& path)
+{
+  std::string ext = path.extension().string();
+  for (char& c : ext)
+    c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+  return ext == ".wav" || ext == ".aif" || ext == ".aiff";
+}
+
+int listBank(const std::string& path)
+{
+  std::string error;
+  const auto bank = IRBank::open(path, error);
+  if (!bank)
+  {
+    std::fprintf(stderr, "octob-irbank: %s: %s\n", path.c_str(), error.c_str());
+    return 1;
+  }
+  for (size_t i = 0; i < bank->getNumEntries(); ++i)
+  {
+    IRBankSection section;
+    bank->getSection(i, IRCacheStage::MinimumPhase, 0.0, section);
+    std::printf("%s (%d ch, %zu samples at %.0f Hz)\n", bank->getEntryName(i).c_str(),
+                section.numChannels, section.numSamples, section.sampleRate);
+  }
+  std::printf("%zu entries\n", bank->getNumEntries());
+  return 0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+  if (argc == 3 && std::strcmp(argv[1], "--list") == 0)
+    return listBank(argv[2]);
+
+  std::vector<std::string> paths;
+  std::vector<SampleRate> rates = IRBank::getDefaultSampleRates();
+  for (int i = 1; i < argc; ++i)
+  {
+    if (std::strcmp(argv[i], "--rates") == 0 && i + 1 < argc && parseRates(argv[i + 1], rates))
+      ++i;
+    else if (argv[i][0] != '-' && paths.size() < 2)
+      paths.push_back(argv[i]);
+    else
+    {
+      printUsage();
+      return 2;
+    }
+  }
+  if (paths.size() != 2)
+  {
+    printUsage();
+    return 2;
+  }
+
+  namespace fs = std::filesystem;
+  const fs::path folder(paths[0]);
+  std::vector<IRBankSource> sources;
+  std::error_code ec;
+  fs::recursive_directory_iterator it(folder, fs::directory_options::skip_permission_denied, ec);
+  for (; !ec && it != fs::recursive_directory_iterator(); it.increment(ec))
+  {
+    if (it->is_regular_file(ec) && isImpulseResponse(it->path()))
+      sources.push_back(
+          {fs::relative(it->path(), folder, ec).generic_string(), it->path().string()});
+  }
+  if (ec)
+  {
+    std::fprintf(stderr, "octob-irbank: %s: %s\n", paths[0].c_str(), ec.message().c_str());
+    return 1;
+  }
+  if (sources.empty())
+  {
+    std::fprintf(stderr, "octob-irbank: no IRs found under %s\n", paths[0].c_str());
+    return 1;
+  }
+
+  std::string error;
+  if (!IRBank::build(sources, rates, paths[1], error))
+  {
+    std::fprintf(stderr, "octob-irbank: %s\n", error.c_str());
+    return 1;
+  }
+
+  const auto bytes = fs::file_size(paths[1], ec);
+  std::printf("%zu IRs, %zu rates -> %s (%.1f MB)\n", sources.size(), rates.size(),
+              paths[1].c_str(), ec ? 0.0 : static_cast<double>(bytes) / (1024.0 * 1024.0));
+  return 0;
+}
@@ -0,0 +1,306 @@
+#include "RenderJob.hpp"
+
+#include <octobass-core/Types.hpp>
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+namespace octob
+{
+
+namespace
+{
+
+constexpr FrameCount kMaxBlockSize = 65536;
+
+std::string trim(const std::string& text)
+{
+  const auto begin = text.find_first_not_of(" \t\r");
+  if (begin == std::string::npos)
+    return {};
+  const auto end = text.find_last_not_of(" \t\r");
+  return text.substr(begin, end - begin + 1);
+}
+
+bool parseFloat(const std::string& text, float& value)
+{
+  char* end = nullptr;
+  value = std::strtof(text.c_str(), &end);
+  return !text.empty() && end == text.c_str() + text.size();
+}
+
+bool parseInt(const std::string& text, long& value)
+{
+  char* end = nullptr;
+  value = std::strtol(text.c_str(), &end, 10);
+  return !text.empty() && end == text.c_str() + text.size();
+}
+
+bool parseBool(const std::string& text, bool& value)
+{
+  if (text == "true" || text == "on" || text == "1")
+    value = true;
+  else if (text == "false" || text == "off" || text == "0")
+    value = false;
+  else
+    return false;
+  return true;
+}
+
+bool parseEngine(const std::string& text, ConvolutionEngineType& engine)
+{
+  if (text == "auto")
+    engine = ConvolutionEngineType::Auto;
+  else if (text == "wdl")
+    engine = ConvolutionEngineType::Wdl;
+  else if (text == "pffft")
+    engine = ConvolutionEngineType::Pffft;
+  else if (text == "direct")
+    engine = ConvolutionEngineType::Direct;
+  else
+    return false;
+  return true;
+}
+
+std::string resolve(const std::string& baseDir, const std::string& path)
+{
+  const std::filesystem::path p(path);
+  if (p.is_absolute() || baseDir.empty())
+    return p.lexically_normal().string();
+  return (std::filesystem::path(baseDir) / p).lexically_normal().string();
+}
+
+}  // namespace
+
+const std::map<std::string, float>& RenderJob::defaultParameters(RenderChain chain)
+{
+  // The OctobIR plugin's slot switches default off; the renderer turns on the slots the
+  // job loads unless irAEnable/irBEnable are given.
+  static const std::map<std::string, float> octobir = {
+      {"irAEnable", 0.0f},
+      {"irBEnable", 0.0f},
+      {"dynamicMode", 0.0f},
+      {"sidechainEnable", 0.0f},
+      {"blend", 0.0f},
+      {"threshold", -30.0f},
+      {"rangeDb", 20.0f},
+      {"kneeWidthDb", 5.0f},
+      {"detectionMode", 0.0f},
+      {"attackTime", 50.0f},
+      {"releaseTime", 200.0f},
+      {"outputGain", 0.0f},
+      {"irATrimGain", 0.0f},
+      {"irBTrimGain", 0.0f},
+  };
+  static const std::map<std::string, float> octobass = []
+  {
+    std::map<std::string, float> defaults = {
+        {"crossoverFrequency", DefaultCrossoverFrequency},
+        {"squash", DefaultSquashAmount},
+        {"compressionMode", static_cast<float>(DefaultCompressionMode)},
+        {"lowBandLevel", DefaultBandLevelDb},
+        {"highInputGain", DefaultHighInputGainDb},
+        {"highOutputGain", DefaultHighOutputGainDb},
+        {"outputGain", DefaultOutputGainDb},
+        {"dryWetMix", DefaultDryWetMix},
+        {"gateThreshold", DefaultGateThresholdDb},
+        {"highBandMix", DefaultHighBandMix},
+        {"lowBandSolo", 0.0f},
+        {"highBandSolo", 0.0f},
+    };
+    for (int i = 0; i < kGraphicEQNumBands; ++i)
+      defaults["eqBandGain" + std::to_string(i)] = DefaultGraphicEQGainDb;
+    return defaults;
+  }();
+  return chain == RenderChain::OctobIR ? octobir : octobass;
+}
+
+bool RenderJob::parse(const std::string& text, const std::string& baseDir,
+                      std::string& errorMessage)
+{
+  *this = RenderJob();
+  std::string outputDir = resolve(baseDir, "renders");
+  std::vector<std::string> outputNames;
+  std::map<std::string, int> parameterLines;
+
+  std::istringstream lines(text);
+  std::string line;
+  int lineNumber = 0;
+  while (std::getline(lines, line))
+  {
+    ++lineNumber;
+    const auto comment = line.find('#');
+    if (comment != std::string::npos)
+      line.erase(comment);
+    line = trim(line);
+    if (line.empty())
+      continue;
+
+    const std::string where = "line " + std::to_string(lineNumber) + ": ";
+    const auto equals = line.find('=');
+    if (equals == std::string::npos)
+    {
+      errorMessage = where + "expected key = value";
+      return false;
+    }
+    const std::string key = trim(line.substr(0, equals));
+    const std::string value = trim(line.substr(equals + 1));
+    if (key.empty() || value.empty())
+    {
+      errorMessage = where + "expected key = value";
+      return false;
+    }
+
+    bool valid = true;
+    long intValue = 0;
+    float floatValue = 0.0f;
+    if (key == "chain")
+    {
+      if (value == "octobir")
+        chain = RenderChain::OctobIR;
+      else if (value == "octobass")
+        chain = RenderChain::OctoBass;
+      else
+        valid = false;
+    }
+    else if (key == "block_size")
+    {
+      valid = parseInt(value, intValue) && intValue >= 1 &&
+              intValue <= static_cast<long>(kMaxBlockSize);
+      blockSize = static_cast<FrameCount>(intValue);
+    }
+    else if (key == "threads")
+    {
+      valid = parseInt(value, intValue) && intValue >= 0;
+      numThreads = static_cast<int>(intValue);
+    }
+    else if (key == "tail_seconds")
+    {
+      valid = parseFloat(value, floatValue) && floatValue >= 0.0f;
+      tailSeconds = floatValue;
+    }
+    else if (key == "engine")
+      valid = parseEngine(value, engine);
+    else if (key == "mono_to_stereo")
+      valid = parseBool(value, monoToStereo);
+    else if (key == "output_dir")
+      outputDir = resolve(baseDir, value);
+    else if (key == "ir_a")
+      irA = resolve(baseDir, value);
+    else if (key == "ir_b")
+      irB = resolve(baseDir, value);
+    else if (key == "ir")
+      ir = resolve(baseDir, value);
+    else if (key == "nam")
+      namModel = resolve(baseDir, value);
+    else if (key == "input")
+    {
+      inputs.push_back(RenderInput{resolve(baseDir, value), {}, {}});
+      outputNames.push_back(std::filesystem::path(value).filename().string());
+    }
+    else if (key == "sidechain" || key == "output")
+    {
+      if (inputs.empty())
+      {
+        errorMessage = where + key + " must follow an input";
+        return false;
+      }
+      if (key == "sidechain")
+        inputs.back().sidechainPath = resolve(baseDir, value);
+      else
+        outputNames.back() = value;
+    }
+    else
+    {
+      bool flag = false;
+      if (parseBool(value, flag) && !parseFloat(value, floatValue))
+        floatValue = flag ? 1.0f : 0.0f;
+      else if (!parseFloat(value, floatValue))
+      {
+        errorMessage = where + "expected a number for " + key;
+        return false;
+      }
+      parameters[key] = floatValue;
+      parameterLines[key] = lineNumber;
+    }
+
+    if (!valid)
+    {
+      errorMessage = where + "invalid value '" + value + "' for " + key;
+      return false;
+    }
+  }
+
+  const auto& defaults = defaultParameters(chain);
+  for (const auto& parameter : parameters)
+  {
+    if (defaults.find(parameter.first) == defaults.end())
+    {
+      errorMessage = "line " + std::to_string(parameterLines[parameter.first]) +
+                     ": unknown parameter '" + parameter.first + "' for " +
+                     (chain == RenderChain::OctobIR ? "octobir" : "octobass");
+      return false;
+    }
+  }
+
+  if (chain == RenderChain::OctobIR && irA.empty() && irB.empty())
+  {
+    errorMessage = "octobir jobs need ir_a or ir_b";
+    return false;
+  }
+  if (chain == RenderChain::OctoBass && (!irA.empty() || !irB.empty()))
+  {
+    errorMessage = "octobass jobs take ir, not ir_a/ir_b";
+    return false;
+  }
+  if (chain == RenderChain::OctobIR && (!ir.empty() || !namModel.empty()))
+  {
+    errorMessage = "octobir jobs take ir_a/ir_b, not ir/nam";
+    return false;
+  }
+  if (inputs.empty())
+  {
+    errorMessage = "no input files";
+    return false;
+  }
+
+  for (size_t i = 0; i < inputs.size(); ++i)
+  {
+    if (chain == RenderChain::OctoBass && !inputs[i].sidechainPath.empty())
+    {
+      errorMessage = "octobass has no sidechain input";
+      return false;
+    }
+    inputs[i].outputPath = resolve(outputDir, outputNames[i]);
+    if (inputs[i].outputPath == inputs[i].path)
+    {
+      errorMessage = "output for " + inputs[i].path + " would overwrite the input";
+      return false;
+    }
+  }
+  return true;
+}
+
+bool RenderJob::loadFromFile(const std::string& filepath, std::string& errorMessage)
+{
+  std::ifstream file(filepath);
+  if (!file)
+  {
+    errorMessage = "cannot open job file " + filepath;
+    return false;
+  }
+  std::stringstream text;
+  text << file.rdbuf();
+
+  const std::string baseDir = std::filesystem::path(filepath).parent_path().string();
+  if (!parse(text.str(), baseDir, errorMessage))
+  {
+    errorMessage = filepath + ": " + errorMessage;
+    return false;
+  }
+  return true;
+}
+
+}  // namespace octob
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <octobir-core/ConvolutionEngine.hpp>
+#include <octobir-core/Types.hpp>
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace octob
+{
+
+enum class RenderChain
+{
+  OctobIR,
+  OctoBass,
+};
+
+struct RenderInput
+{
+  std::string path;
+  std::string sidechainPath;  // OctobIR only; empty for none
+  std::string outputPath;
+};
+
+// Settings shared by every file of an octob-render run, read from a job file of
+// `key = value` lines (see tools/octob-render/README.md). Relative paths are resolved
+// against the job file's directory.
+struct RenderJob
+{
+  RenderChain chain = RenderChain::OctobIR;
+  FrameCount blockSize = 4096;
+  int numThreads = 0;  // 0: one per hardware thread
+  double tailSeconds = 0.0;
+  ConvolutionEngineType engine = ConvolutionEngineType::Auto;
+  bool monoToStereo = false;
+
+  std::string irA;  // OctobIR
+  std::string irB;  // OctobIR
+  std::string ir;   // OctoBASS
+  std::string namModel;  // OctoBASS
+
+  // Plugin parameter IDs and values, as in the JUCE plugins' parameter layouts. Values
+  // are plain (dB, ms, 0/1 for switches, the index for choices).
+  std::map<std::string, float> parameters;
+
+  std::vector<RenderInput> inputs;
+
+  bool parse(const std::string& text, const std::string& baseDir, std::string& errorMessage);
+  bool loadFromFile(const std::string& filepath, std::string& errorMessage);
+
+  // Every parameter the chain's plugin exposes, with the plugin's default value.
+  static const std::map<std::string, float>& defaultParameters(RenderChain chain);
+};
+
+}  // namespace octob
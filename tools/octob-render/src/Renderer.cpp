@@ -0,0 +1,500 @@
+#include "Renderer.hpp"
+
+#include <octobass-core/BassProcessor.hpp>
+#include <octobir-core/IRProcessor.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+
+#if defined(__SSE__) || defined(_M_X64) || defined(_M_IX86)
+#include <xmmintrin.h>
+#endif
+
+// DR_WAV_IMPLEMENTATION is compiled into octobir-core via IRLoader.cpp.
+#include "dr_wav.h"
+
+namespace octob
+{
+
+namespace
+{
+
+// Sets flush-to-zero and denormals-are-zero for the current thread, as JUCE's
+// ScopedNoDenormals does around every plugin processBlock(); without it, quiet tails
+// would round differently from the plugins.
+class ScopedNoDenormals
+{
+ public:
+  ScopedNoDenormals()
+  {
+#if defined(__SSE__) || defined(_M_X64) || defined(_M_IX86)
+    saved_ = _mm_getcsr();
+    _mm_setcsr(saved_ | 0x8040);
+#elif defined(__aarch64__)
+    uint64_t fpcr = 0;
+    asm volatile("mrs %0, fpcr" : "=r"(fpcr));
+    saved_ = fpcr;
+    fpcr |= uint64_t(1) << 24;
+    asm volatile("msr fpcr, %0" : : "r"(fpcr));
+#endif
+  }
+
+  ~ScopedNoDenormals()
+  {
+#if defined(__SSE__) || defined(_M_X64) || defined(_M_IX86)
+    _mm_setcsr(static_cast<unsigned int>(saved_));
+#elif defined(__aarch64__)
+    asm volatile("msr fpcr, %0" : : "r"(saved_));
+#endif
+  }
+
+  ScopedNoDenormals(const ScopedNoDenormals&) = delete;
+  ScopedNoDenormals& operator=(const ScopedNoDenormals&) = delete;
+
+ private:
+  uint64_t saved_ = 0;
+};
+
+struct AudioFile
+{
+  std::vector<std::vector<Sample>> channels;
+  SampleRate sampleRate = 0.0;
+  FrameCount numFrames = 0;
+
+  int getNumChannels() const { return static_cast<int>(channels.size()); }
+};
+
+bool readWav(const std::string& path, AudioFile& file, std::string& errorMessage)
+{
+  unsigned int numChannels = 0;
+  unsigned int sampleRate = 0;
+  drwav_uint64 numFrames = 0;
+  float* samples = drwav_open_file_and_read_pcm_frames_f32(path.c_str(), &numChannels,
+                                                           &sampleRate, &numFrames, nullptr);
+  if (samples == nullptr)
+  {
+    errorMessage = "cannot read " + path;
+    return false;
+  }
+
+  file.sampleRate = static_cast<SampleRate>(sampleRate);
+  file.numFrames = static_cast<FrameCount>(numFrames);
+  file.channels.assign(numChannels, std::vector<Sample>(file.numFrames));
+  for (FrameCount i = 0; i < file.numFrames; ++i)
+    for (unsigned int ch = 0; ch < numChannels; ++ch)
+      file.channels[ch][i] = samples[i * numChannels + ch];
+  drwav_free(samples, nullptr);
+  return true;
+}
+
+bool writeWav(const std::string& path, const std::vector<std::vector<Sample>>& channels,
+              SampleRate sampleRate, std::string& errorMessage)
+{
+  std::error_code error;
+  const auto directory = std::filesystem::path(path).parent_path();
+  if (!directory.empty())
+    std::filesystem::create_directories(directory, error);
+
+  drwav_data_format format;
+  format.container = drwav_container_riff;
+  format.format = DR_WAVE_FORMAT_IEEE_FLOAT;
+  format.channels = static_cast<drwav_uint32>(channels.size());
+  format.sampleRate = static_cast<drwav_uint32>(sampleRate);
+  format.bitsPerSample = 32;
+
+  drwav wav;
+  if (!drwav_init_file_write(&wav, path.c_str(), &format, nullptr))
+  {
+    errorMessage = "cannot write " + path;
+    return false;
+  }
+
+  const size_t numChannels = channels.size();
+  const size_t numFrames = channels.empty() ? 0 : channels[0].size();
+  std::vector<float> interleaved(numFrames * numChannels);
+  for (size_t i = 0; i < numFrames; ++i)
+    for (size_t ch = 0; ch < numChannels; ++ch)
+      interleaved[i * numChannels + ch] = channels[ch][i];
+
+  const drwav_uint64 written = drwav_write_pcm_frames(&wav, numFrames, interleaved.data());
+  drwav_uninit(&wav);
+  if (written != numFrames)
+  {
+    errorMessage = "short write to " + path;
+    return false;
+  }
+  return true;
+}
+
+// Copies frames [start, start + numFrames) of each channel into blocks, zero-filling
+// past the end of the file.
+void readBlock(const AudioFile& file, FrameCount start, FrameCount numFrames,
+               const std::vector<Sample*>& blocks)
+{
+  const FrameCount available = start < file.numFrames ? file.numFrames - start : 0;
+  const FrameCount count = std::min(available, numFrames);
+  for (size_t ch = 0; ch < file.channels.size(); ++ch)
+  {
+    std::copy_n(file.channels[ch].data() + start, count, blocks[ch]);
+    std::fill(blocks[ch] + count, blocks[ch] + numFrames, 0.0f);
+  }
+}
+
+bool isOn(float value)
+{
+  return value > 0.5f;
+}
+
+class OctobIRRenderer : public ChainRenderer
+{
+ public:
+  explicit OctobIRRenderer(const RenderJob& job) : ChainRenderer(job)
+  {
+    irAEnable_ = hasParameter("irAEnable") ? isOn(getParameter("irAEnable")) : !job.irA.empty();
+    irBEnable_ = hasParameter("irBEnable") ? isOn(getParameter("irBEnable")) : !job.irB.empty();
+    dynamicMode_ = isOn(getParameter("dynamicMode"));
+    sidechainEnable_ = isOn(getParameter("sidechainEnable"));
+    blend_ = getParameter("blend");
+    threshold_ = getParameter("threshold");
+    rangeDb_ = getParameter("rangeDb");
+    kneeWidthDb_ = getParameter("kneeWidthDb");
+    detectionMode_ = static_cast<int>(getParameter("detectionMode"));
+    attackTime_ = getParameter("attackTime");
+    releaseTime_ = getParameter("releaseTime");
+    outputGain_ = getParameter("outputGain");
+    irATrimGain_ = getParameter("irATrimGain");
+    irBTrimGain_ = getParameter("irBTrimGain");
+  }
+
+ protected:
+  bool prepare(SampleRate sampleRate, std::string& errorMessage) override
+  {
+    processor_.setSampleRate(sampleRate);
+    processor_.setMaxBlockSize(job_.blockSize);
+    if (loaded_)
+      return true;
+
+    if (job_.engine != ConvolutionEngineType::Auto)
+    {
+      processor_.setIRAEngine(job_.engine);
+      processor_.setIRBEngine(job_.engine);
+    }
+    if (!job_.irA.empty() && !processor_.loadImpulseResponse1(job_.irA, errorMessage))
+      return false;
+    if (!job_.irB.empty() && !processor_.loadImpulseResponse2(job_.irB, errorMessage))
+      return false;
+    loaded_ = true;
+    return true;
+  }
+
+  bool supportsChannels(int numChannels) const override
+  {
+    return numChannels == 1 || numChannels == 2;
+  }
+
+  int getNumOutputChannels(int numInputChannels) const override
+  {
+    return numInputChannels == 2 || job_.monoToStereo ? 2 : 1;
+  }
+
+  int getLatencySamples() const override { return processor_.getLatencySamples(); }
+
+  void reset() override { processor_.reset(); }
+
+  // Mirrors OctobIRProcessor::processBlock().
+  void processBlock(const std::vector<Sample*>& buffer, int numInputChannels,
+                    const std::vector<const Sample*>& sidechain, FrameCount numFrames) override
+  {
+    const bool hasSidechain = !sidechain.empty();
+    const int numOutputChannels = static_cast<int>(buffer.size());
+
+    processor_.setIRAEnabled(irAEnable_);
+    processor_.setIRBEnabled(irBEnable_);
+    processor_.setDynamicModeEnabled(dynamicMode_);
+    processor_.setSidechainEnabled(dynamicMode_ && sidechainEnable_ && hasSidechain);
+    processor_.setBlend(blend_);
+    processor_.setThreshold(threshold_);
+    processor_.setRangeDb(rangeDb_);
+    processor_.setKneeWidthDb(kneeWidthDb_);
+    processor_.setDetectionMode(detectionMode_);
+    processor_.setAttackTime(attackTime_);
+    processor_.setReleaseTime(releaseTime_);
+    processor_.setOutputGain(outputGain_);
+    processor_.setIRATrimGain(irATrimGain_);
+    processor_.setIRBTrimGain(irBTrimGain_);
+
+    const bool monoToStereo = numInputChannels == 1 && numOutputChannels >= 2;
+
+    if (dynamicMode_ && sidechainEnable_ && hasSidechain)
+    {
+      const Sample* scL = sidechain[0];
+      const Sample* scR = sidechain.size() >= 2 ? sidechain[1] : scL;
+      if (numInputChannels >= 2 && numOutputChannels >= 2)
+        processor_.processStereoWithSidechain(buffer[0], buffer[1], scL, scR, buffer[0],
+                                              buffer[1], numFrames);
+      else if (monoToStereo)
+        processor_.processMonoToStereoWithSidechain(buffer[0], scL, buffer[0], buffer[1],
+                                                    numFrames);
+      else
+        processor_.processMonoWithSidechain(buffer[0], scL, buffer[0], numFrames);
+    }
+    else
+    {
+      if (numInputChannels >= 2 && numOutputChannels >= 2)
+        processor_.processStereo(buffer[0], buffer[1], buffer[0], buffer[1], numFrames);
+      else if (monoToStereo)
+        processor_.processMonoToStereo(buffer[0], buffer[0], buffer[1], numFrames);
+      else
+        processor_.processMono(buffer[0], buffer[0], numFrames);
+    }
+  }
+
+ private:
+  IRProcessor processor_;
+  bool loaded_ = false;
+
+  bool irAEnable_ = false;
+  bool irBEnable_ = false;
+  bool dynamicMode_ = false;
+  bool sidechainEnable_ = false;
+  float blend_ = 0.0f;
+  float threshold_ = 0.0f;
+  float rangeDb_ = 0.0f;
+  float kneeWidthDb_ = 0.0f;
+  int detectionMode_ = 0;
+  float attackTime_ = 0.0f;
+  float releaseTime_ = 0.0f;
+  float outputGain_ = 0.0f;
+  float irATrimGain_ = 0.0f;
+  float irBTrimGain_ = 0.0f;
+};
+
+class OctoBassRenderer : public ChainRenderer
+{
+ public:
+  explicit OctoBassRenderer(const RenderJob& job) : ChainRenderer(job)
+  {
+    crossoverFrequency_ = getParameter("crossoverFrequency");
+    squash_ = getParameter("squash");
+    compressionMode_ = static_cast<int>(getParameter("compressionMode"));
+    lowBandLevel_ = getParameter("lowBandLevel");
+    highInputGain_ = getParameter("highInputGain");
+    highOutputGain_ = getParameter("highOutputGain");
+    outputGain_ = getParameter("outputGain");
+    dryWetMix_ = getParameter("dryWetMix");
+    gateThreshold_ = getParameter("gateThreshold");
+    highBandMix_ = getParameter("highBandMix");
+    for (int i = 0; i < kGraphicEQNumBands; ++i)
+      eqBandGains_[i] = getParameter("eqBandGain" + std::to_string(i));
+
+    // The plugin resolves both solos being on in its first block, in favour of the low band.
+    lowBandSolo_ = getParameter("lowBandSolo") >= 0.5f;
+    highBandSolo_ = getParameter("highBandSolo") >= 0.5f && !lowBandSolo_;
+  }
+
+ protected:
+  bool prepare(SampleRate sampleRate, std::string& errorMessage) override
+  {
+    processor_.setSampleRate(sampleRate);
+    processor_.setMaxBlockSize(job_.blockSize);
+    if (loaded_)
+      return true;
+
+    if (job_.engine != ConvolutionEngineType::Auto)
+      processor_.setIREngine(job_.engine);
+    if (!job_.ir.empty() && !processor_.loadImpulseResponse(job_.ir, errorMessage))
+      return false;
+    if (!job_.namModel.empty() && !processor_.loadNamModel(job_.namModel, errorMessage))
+      return false;
+    loaded_ = true;
+    return true;
+  }
+
+  bool supportsChannels(int numChannels) const override { return numChannels == 1; }
+
+  int getNumOutputChannels(int /*numInputChannels*/) const override { return 1; }
+
+  int getLatencySamples() const override { return processor_.getLatencySamples(); }
+
+  void reset() override { processor_.reset(); }
+
+  // Mirrors OctoBassProcessor::processBlock().
+  void processBlock(const std::vector<Sample*>& buffer, int /*numInputChannels*/,
+                    const std::vector<const Sample*>& /*sidechain*/,
+                    FrameCount numFrames) override
+  {
+    processor_.setCrossoverFrequency(crossoverFrequency_);
+    processor_.setSquash(squash_);
+    processor_.setCompressionMode(compressionMode_);
+    processor_.setLowBandLevel(lowBandLevel_);
+    processor_.setHighInputGain(highInputGain_);
+    processor_.setHighOutputGain(highOutputGain_);
+    processor_.setOutputGain(outputGain_);
+    processor_.setDryWetMix(dryWetMix_);
+    processor_.setGateThreshold(gateThreshold_);
+    processor_.setHighBandMix(highBandMix_);
+    for (int i = 0; i < kGraphicEQNumBands; ++i)
+      processor_.setGraphicEQBandGain(i, eqBandGains_[i]);
+    processor_.setLowBandSolo(lowBandSolo_);
+    processor_.setHighBandSolo(highBandSolo_);
+
+    processor_.processMono(buffer[0], buffer[0], numFrames);
+  }
+
+ private:
+  BassProcessor processor_;
+  bool loaded_ = false;
+
+  float crossoverFrequency_ = 0.0f;
+  float squash_ = 0.0f;
+  int compressionMode_ = 0;
+  float lowBandLevel_ = 0.0f;
+  float highInputGain_ = 0.0f;
+  float highOutputGain_ = 0.0f;
+  float outputGain_ = 0.0f;
+  float dryWetMix_ = 0.0f;
+  float gateThreshold_ = 0.0f;
+  float highBandMix_ = 0.0f;
+  float eqBandGains_[kGraphicEQNumBands] = {};
+  bool lowBandSolo_ = false;
+  bool highBandSolo_ = false;
+};
+
+}  // namespace
+
+std::unique_ptr<ChainRenderer> ChainRenderer::create(const RenderJob& job)
+{
+  if (job.chain == RenderChain::OctoBass)
+    return std::unique_ptr<ChainRenderer>(new OctoBassRenderer(job));
+  return std::unique_ptr<ChainRenderer>(new OctobIRRenderer(job));
+}
+
+ChainRenderer::ChainRenderer(const RenderJob& job) : job_(job) {}
+
+float ChainRenderer::getParameter(const std::string& id) const
+{
+  const auto it = job_.parameters.find(id);
+  if (it != job_.parameters.end())
+    return it->second;
+  return RenderJob::defaultParameters(job_.chain).at(id);
+}
+
+bool ChainRenderer::hasParameter(const std::string& id) const
+{
+  return job_.parameters.find(id) != job_.parameters.end();
+}
+
+RenderResult ChainRenderer::render(const RenderInput& input)
+{
+  RenderResult result;
+  const auto start = std::chrono::steady_clock::now();
+
+  AudioFile main;
+  if (!readWav(input.path, main, result.errorMessage))
+    return result;
+  if (!supportsChannels(main.getNumChannels()))
+  {
+    result.errorMessage = input.path + ": " + std::to_string(main.getNumChannels()) +
+                          "-channel input is not supported by this chain";
+    return result;
+  }
+
+  AudioFile sidechain;
+  if (!input.sidechainPath.empty())
+  {
+    if (!readWav(input.sidechainPath, sidechain, result.errorMessage))
+      return result;
+    if (sidechain.sampleRate != main.sampleRate || sidechain.getNumChannels() > 2)
+    {
+      result.errorMessage =
+          input.sidechainPath + ": sidechain must be mono or stereo at the input's sample rate";
+      return result;
+    }
+  }
+
+  if (main.sampleRate != preparedSampleRate_)
+  {
+    // Loads may have partly succeeded; prepare from scratch for the next file.
+    preparedSampleRate_ = 0.0;
+    if (!prepare(main.sampleRate, result.errorMessage))
+      return result;
+    preparedSampleRate_ = main.sampleRate;
+  }
+  reset();
+
+  const FrameCount blockSize = job_.blockSize;
+  const FrameCount tailFrames =
+      static_cast<FrameCount>(std::lround(job_.tailSeconds * main.sampleRate));
+  const FrameCount numFrames = main.numFrames + tailFrames;
+  const int numInputChannels = main.getNumChannels();
+  const int numOutputChannels = getNumOutputChannels(numInputChannels);
+
+  std::vector<std::vector<Sample>> blockStorage(static_cast<size_t>(numOutputChannels),
+                                                std::vector<Sample>(blockSize));
+  std::vector<Sample*> block;
+  for (auto& channel : blockStorage)
+    block.push_back(channel.data());
+
+  std::vector<std::vector<Sample>> sidechainStorage(sidechain.channels.size(),
+                                                    std::vector<Sample>(blockSize));
+  std::vector<Sample*> sidechainBlock;
+  std::vector<const Sample*> sidechainInput;
+  for (auto& channel : sidechainStorage)
+  {
+    sidechainBlock.push_back(channel.data());
+    sidechainInput.push_back(channel.data());
+  }
+
+  std::vector<std::vector<Sample>> output(static_cast<size_t>(numOutputChannels),
+                                          std::vector<Sample>(numFrames));
+
+  {
+    ScopedNoDenormals noDenormals;
+
+    // The processor's output lags its input by the latency it reports once its IRs are
+    // swapped in on the first block; keep feeding zeros until the lagged output covers
+    // the file and its tail, and drop the leading latency frames.
+    FrameCount processed = 0;
+    FrameCount latency = 0;
+    bool latencyKnown = false;
+    while (!latencyKnown || processed < numFrames + latency)
+    {
+      readBlock(main, processed, blockSize, block);
+      for (int ch = numInputChannels; ch < numOutputChannels; ++ch)
+        std::fill_n(block[static_cast<size_t>(ch)], blockSize, 0.0f);
+      readBlock(sidechain, processed, blockSize, sidechainBlock);
+
+      processBlock(block, numInputChannels, sidechainInput, blockSize);
+      if (!latencyKnown)
+      {
+        latency = static_cast<FrameCount>(std::max(0, getLatencySamples()));
+        latencyKnown = true;
+      }
+
+      const FrameCount first = std::max(processed, latency);
+      const FrameCount last = std::min(processed + blockSize, numFrames + latency);
+      if (first < last)
+      {
+        for (size_t ch = 0; ch < output.size(); ++ch)
+          std::copy_n(block[ch] + (first - processed), last - first,
+                      output[ch].data() + (first - latency));
+      }
+      processed += blockSize;
+    }
+  }
+
+  if (!writeWav(input.outputPath, output, main.sampleRate, result.errorMessage))
+    return result;
+
+  result.success = true;
+  result.numFrames = numFrames;
+  result.sampleRate = main.sampleRate;
+  result.renderSeconds =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  return result;
+}
+
+}  // namespace octob
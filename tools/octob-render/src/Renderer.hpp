@@ -0,0 +1,76 @@
+#pragma once
+
+#include <octobir-core/Types.hpp>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "RenderJob.hpp"
+
+namespace octob
+{
+
+struct RenderResult
+{
+  bool success = false;
+  std::string errorMessage;
+  FrameCount numFrames = 0;  // Frames written, including the tail
+  SampleRate sampleRate = 0.0;
+  double renderSeconds = 0.0;
+
+  double getAudioSeconds() const
+  {
+    return sampleRate > 0.0 ? static_cast<double>(numFrames) / sampleRate : 0.0;
+  }
+};
+
+// Renders files through one instance of a chain, the way its plugin would in a host that
+// bounces in fixed blocks of job.blockSize: every parameter is applied before each block,
+// denormals are flushed, and the plugin's reported latency is removed from the output as
+// host delay compensation would. With the engine pinned (engine = pffft/wdl/direct), the
+// output is bit-identical to the plugin at that block size.
+//
+// A renderer keeps its IRs and model loaded across files and only reloads when a file's
+// sample rate differs from the last one; the processor is reset() between files. It is
+// not thread-safe; give each worker its own.
+class ChainRenderer
+{
+ public:
+  static std::unique_ptr<ChainRenderer> create(const RenderJob& job);
+
+  virtual ~ChainRenderer() = default;
+
+  ChainRenderer(const ChainRenderer&) = delete;
+  ChainRenderer& operator=(const ChainRenderer&) = delete;
+
+  // Reads input.path (and input.sidechainPath), renders it and writes input.outputPath
+  // as 32-bit float WAV, creating its directory if needed.
+  RenderResult render(const RenderInput& input);
+
+ protected:
+  explicit ChainRenderer(const RenderJob& job);
+
+  // Called when the sample rate changes, before the first file at that rate.
+  virtual bool prepare(SampleRate sampleRate, std::string& errorMessage) = 0;
+  virtual bool supportsChannels(int numChannels) const = 0;
+  virtual int getNumOutputChannels(int numInputChannels) const = 0;
+  virtual int getLatencySamples() const = 0;
+  virtual void reset() = 0;
+  // Processes one block in place, like a plugin's processBlock(): buffer holds
+  // getNumOutputChannels() channels, the first numInputChannels carrying the main input
+  // and the rest cleared. sidechain is empty when the file has none.
+  virtual void processBlock(const std::vector<Sample*>& buffer, int numInputChannels,
+                            const std::vector<const Sample*>& sidechain,
+                            FrameCount numFrames) = 0;
+
+  float getParameter(const std::string& id) const;
+  bool hasParameter(const std::string& id) const;
+
+  const RenderJob job_;
+
+ private:
+  SampleRate preparedSampleRate_ = 0.0;
+};
+
+}  // namespace octob
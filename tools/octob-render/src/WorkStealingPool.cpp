@@ -0,0 +1,63 @@
+#include "WorkStealingPool.hpp"
+
+#include <algorithm>
+#include <thread>
+
+namespace octob
+{
+
+WorkStealingPool::WorkStealingPool(int numWorkers) : numWorkers_(std::max(1, numWorkers))
+{
+  for (int i = 0; i < numWorkers_; ++i)
+    queues_.push_back(std::make_unique<Queue>());
+}
+
+void WorkStealingPool::run(size_t count, const Task& task)
+{
+  for (size_t i = 0; i < count; ++i)
+    queues_[i % queues_.size()]->indices.push_back(i);
+
+  auto work = [this, &task](int worker)
+  {
+    size_t index = 0;
+    while (next(worker, index))
+      task(worker, index);
+  };
+
+  std::vector<std::thread> threads;
+  for (int worker = 1; worker < numWorkers_; ++worker)
+    threads.emplace_back(work, worker);
+  work(0);
+  for (auto& thread : threads)
+    thread.join();
+}
+
+bool WorkStealingPool::next(int worker, size_t& index)
+{
+  {
+    Queue& own = *queues_[static_cast<size_t>(worker)];
+    std::lock_guard<std::mutex> lock(own.mutex);
+    if (!own.indices.empty())
+    {
+      index = own.indices.front();
+      own.indices.pop_front();
+      return true;
+    }
+  }
+
+  // Nothing is ever added during a run, so one empty sweep means the batch is handed out.
+  for (int offset = 1; offset < numWorkers_; ++offset)
+  {
+    Queue& victim = *queues_[static_cast<size_t>((worker + offset) % numWorkers_)];
+    std::lock_guard<std::mutex> lock(victim.mutex);
+    if (!victim.indices.empty())
+    {
+      index = victim.indices.back();
+      victim.indices.pop_back();
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace octob
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace octob
+{
+
+// Runs a known set of independent tasks on a fixed number of workers. Task indices are
+// dealt round-robin into one queue per worker; each worker takes from the front of its
+// own queue and, once that is empty, steals from the back of the others', so a worker
+// that drew long files does not hold up the rest of the batch.
+//
+// Tasks receive the index of the worker running them, so per-worker state such as a
+// prepared processor can be reused across tasks without locking.
+class WorkStealingPool
+{
+ public:
+  using Task = std::function<void(int worker, size_t index)>;
+
+  explicit WorkStealingPool(int numWorkers);
+
+  WorkStealingPool(const WorkStealingPool&) = delete;
+  WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+  // Runs task for every index in [0, count) and returns when all have finished. The
+  // calling thread is worker 0.
+  void run(size_t count, const Task& task);
+
+  int getNumWorkers() const { return numWorkers_; }
+
+ private:
+  struct Queue
+  {
+    std::mutex mutex;
+    std::deque<size_t> indices;
+  };
+
+  bool next(int worker, size_t& index);
+
+  int numWorkers_;
+  std::vector<std::unique_ptr<Queue>> queues_;
+};
+
+}  // namespace octob
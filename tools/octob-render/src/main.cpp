@@ -0,0 +1,124 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "RenderJob.hpp"
+#include "Renderer.hpp"
+#include "WorkStealingPool.hpp"
+
+using namespace octob;
+
+namespace
+{
+
+void printUsage()
+{
+  std::fprintf(stderr,
+               "usage: octob-render <job file> [--threads N] [--block-size N]\n"
+               "\n"
+               "Renders every input of the job through OctobIR or OctoBASS, one file per\n"
+               "worker at a time. See tools/octob-render/README.md for the job format.\n");
+}
+
+bool parseCount(const char* text, long minimum, long& value)
+{
+  char* end = nullptr;
+  value = std::strtol(text, &end, 10);
+  return *text != '\0' && *end == '\0' && value >= minimum;
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+  std::string jobPath;
+  long threads = -1;
+  long blockSize = -1;
+  for (int i = 1; i < argc; ++i)
+  {
+    const bool hasValue = i + 1 < argc;
+    if (std::strcmp(argv[i], "--threads") == 0 && hasValue && parseCount(argv[i + 1], 0, threads))
+      ++i;
+    else if (std::strcmp(argv[i], "--block-size") == 0 && hasValue &&
+             parseCount(argv[i + 1], 1, blockSize))
+      ++i;
+    else if (argv[i][0] != '-' && jobPath.empty())
+      jobPath = argv[i];
+    else
+    {
+      printUsage();
+      return 2;
+    }
+  }
+  if (jobPath.empty())
+  {
+    printUsage();
+    return 2;
+  }
+
+  RenderJob job;
+  std::string error;
+  if (!job.loadFromFile(jobPath, error))
+  {
+    std::fprintf(stderr, "octob-render: %s\n", error.c_str());
+    return 1;
+  }
+  if (threads >= 0)
+    job.numThreads = static_cast<int>(threads);
+  if (blockSize > 0)
+    job.blockSize = static_cast<FrameCount>(blockSize);
+
+  int numWorkers = job.numThreads;
+  if (numWorkers == 0)
+    numWorkers = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+  numWorkers = std::min(numWorkers, static_cast<int>(job.inputs.size()));
+
+  // One chain per worker, each loading the job's IRs and model once and reused for every
+  // file the worker takes.
+  std::vector<std::unique_ptr<ChainRenderer>> renderers;
+  for (int i = 0; i < numWorkers; ++i)
+    renderers.push_back(ChainRenderer::create(job));
+
+  std::vector<RenderResult> results(job.inputs.size());
+  WorkStealingPool pool(numWorkers);
+
+  const auto start = std::chrono::steady_clock::now();
+  pool.run(job.inputs.size(), [&](int worker, size_t index)
+           { results[index] = renderers[static_cast<size_t>(worker)]->render(job.inputs[index]); });
+  const double wallSeconds =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  int failures = 0;
+  double audioSeconds = 0.0;
+  for (size_t i = 0; i < results.size(); ++i)
+  {
+    const RenderResult& result = results[i];
+    if (!result.success)
+    {
+      ++failures;
+      std::fprintf(stderr, "FAILED %s: %s\n", job.inputs[i].path.c_str(),
+                   result.errorMessage.c_str());
+      continue;
+    }
+    audioSeconds += result.getAudioSeconds();
+    std::printf("%s -> %s (%.2f s audio in %.2f s)\n", job.inputs[i].path.c_str(),
+                job.inputs[i].outputPath.c_str(), result.getAudioSeconds(),
+                result.renderSeconds);
+  }
+
+  std::printf("%zu files, %.2f s audio in %.2f s on %d workers: %.1fx real time\n",
+              results.size() - static_cast<size_t>(failures), audioSeconds, wallSeconds,
+              numWorkers, wallSeconds > 0.0 ? audioSeconds / wallSeconds : 0.0);
+  if (failures > 0)
+  {
+    std::fprintf(stderr, "%d of %zu files failed\n", failures, results.size());
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,111 @@
+#include <gtest/gtest.h>
+
+#include <octobass-core/Types.hpp>
+
+#include <string>
+
+#include "RenderJob.hpp"
+
+using namespace octob;
+
+TEST(RenderJobTest, Parse_ReadsSettingsInputsAndParameters)
+{
+  const std::string text =
+      "# OctobIR batch\n"
+      "chain = octobir\n"
+      "block_size = 1024   # host buffer\n"
+      "threads = 3\n"
+      "tail_seconds = 1.5\n"
+      "engine = pffft\n"
+      "mono_to_stereo = on\n"
+      "ir_a = irs/a.wav\n"
+      "ir_b = /abs/b.wav\n"
+      "blend = -0.25\n"
+      "dynamicMode = true\n"
+      "\n"
+      "input = di/take1.wav\n"
+      "sidechain = di/kick.wav\n"
+      "input = di/take2.wav\n"
+      "output = take2_rendered.wav\n";
+
+  RenderJob job;
+  std::string err;
+  ASSERT_TRUE(job.parse(text, "/jobs", err)) << err;
+
+  EXPECT_EQ(job.chain, RenderChain::OctobIR);
+  EXPECT_EQ(job.blockSize, 1024u);
+  EXPECT_EQ(job.numThreads, 3);
+  EXPECT_DOUBLE_EQ(job.tailSeconds, 1.5);
+  EXPECT_EQ(job.engine, ConvolutionEngineType::Pffft);
+  EXPECT_TRUE(job.monoToStereo);
+  EXPECT_EQ(job.irA, "/jobs/irs/a.wav");
+  EXPECT_EQ(job.irB, "/abs/b.wav");
+  EXPECT_FLOAT_EQ(job.parameters.at("blend"), -0.25f);
+  EXPECT_FLOAT_EQ(job.parameters.at("dynamicMode"), 1.0f);
+
+  ASSERT_EQ(job.inputs.size(), 2u);
+  EXPECT_EQ(job.inputs[0].path, "/jobs/di/take1.wav");
+  EXPECT_EQ(job.inputs[0].sidechainPath, "/jobs/di/kick.wav");
+  EXPECT_EQ(job.inputs[0].outputPath, "/jobs/renders/take1.wav");
+  EXPECT_TRUE(job.inputs[1].sidechainPath.empty());
+  EXPECT_EQ(job.inputs[1].outputPath, "/jobs/renders/take2_rendered.wav");
+}
+
+TEST(RenderJobTest, Parse_OutputDirAppliesToEveryInput)
+{
+  RenderJob job;
+  std::string err;
+  ASSERT_TRUE(job.parse("chain = octobass\noutput_dir = out\ninput = a.wav\ninput = b.wav\n",
+                        "/jobs", err))
+      << err;
+  EXPECT_EQ(job.inputs[0].outputPath, "/jobs/out/a.wav");
+  EXPECT_EQ(job.inputs[1].outputPath, "/jobs/out/b.wav");
+}
+
+TEST(RenderJobTest, DefaultParameters_CoverEveryPluginParameter)
+{
+  const auto& octobir = RenderJob::defaultParameters(RenderChain::OctobIR);
+  EXPECT_EQ(octobir.size(), 14u);
+  EXPECT_FLOAT_EQ(octobir.at("threshold"), -30.0f);
+
+  const auto& octobass = RenderJob::defaultParameters(RenderChain::OctoBass);
+  EXPECT_EQ(octobass.size(), 12u + kGraphicEQNumBands);
+  EXPECT_EQ(octobass.count("eqBandGain23"), 1u);
+}
+
+TEST(RenderJobTest, Parse_RejectsUnknownParameterWithItsLine)
+{
+  RenderJob job;
+  std::string err;
+  EXPECT_FALSE(job.parse("chain = octobass\nir = a.wav\nblend = 0.5\ninput = x.wav\n", "", err));
+  EXPECT_NE(err.find("line 3"), std::string::npos) << err;
+  EXPECT_NE(err.find("blend"), std::string::npos) << err;
+}
+
+TEST(RenderJobTest, Parse_RejectsMalformedLines)
+{
+  RenderJob job;
+  std::string err;
+  EXPECT_FALSE(job.parse("ir_a = a.wav\nblock_size 512\ninput = x.wav\n", "", err));
+  EXPECT_NE(err.find("line 2"), std::string::npos) << err;
+  EXPECT_FALSE(job.parse("ir_a = a.wav\nblock_size = 0\ninput = x.wav\n", "", err));
+  EXPECT_FALSE(job.parse("ir_a = a.wav\nengine = fast\ninput = x.wav\n", "", err));
+  EXPECT_FALSE(job.parse("ir_a = a.wav\nblend = loud\ninput = x.wav\n", "", err));
+}
+
+TEST(RenderJobTest, Parse_RejectsInvalidJobs)
+{
+  RenderJob job;
+  std::string err;
+  EXPECT_FALSE(job.parse("input = x.wav\n", "", err)) << "octobir needs an IR";
+  EXPECT_FALSE(job.parse("ir_a = a.wav\n", "", err)) << "no inputs";
+  EXPECT_FALSE(job.parse("ir_a = a.wav\nsidechain = sc.wav\ninput = x.wav\n", "", err))
+      << "sidechain before any input";
+  EXPECT_FALSE(job.parse("chain = octobass\ninput = x.wav\nsidechain = sc.wav\n", "", err))
+      << "octobass has no sidechain";
+  EXPECT_FALSE(job.parse("chain = octobass\nir_a = a.wav\ninput = x.wav\n", "", err));
+  EXPECT_FALSE(job.parse("ir_a = a.wav\nnam = m.nam\ninput = x.wav\n", "", err));
+  EXPECT_FALSE(
+      job.parse("ir_a = a.wav\noutput_dir = .\ninput = x.wav\n", "/jobs", err))
+      << "output would overwrite the input";
+}
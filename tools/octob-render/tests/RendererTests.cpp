@@ -0,0 +1,197 @@
+#include <gtest/gtest.h>
+
+#include <octobir-core/IRProcessor.hpp>
+
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "RenderJob.hpp"
+#include "Renderer.hpp"
+
+// DR_WAV_IMPLEMENTATION is compiled into octobir-core via IRLoader.cpp.
+#include "dr_wav.h"
+
+using namespace octob;
+
+namespace
+{
+
+const std::string kIrAPath = std::string(TEST_DATA_DIR) + "/INPUT_ir_a.wav";
+const std::string kIrBPath = std::string(TEST_DATA_DIR) + "/INPUT_ir_b.wav";
+constexpr unsigned int kSampleRate = 44100;
+constexpr FrameCount kBlockSize = 512;
+
+std::string tempPath(const std::string& name)
+{
+  static const std::string prefix = [] {
+    std::random_device device;
+    return ::testing::TempDir() + "octob_render_" + std::to_string(device()) + "_";
+  }();
+  return prefix + name;
+}
+
+// Planar channels, written and read as 32-bit float.
+using Channels = std::vector<std::vector<float>>;
+
+void writeWav(const std::string& path, const Channels& channels)
+{
+  drwav_data_format format;
+  format.container = drwav_container_riff;
+  format.format = DR_WAVE_FORMAT_IEEE_FLOAT;
+  format.channels = static_cast<drwav_uint32>(channels.size());
+  format.sampleRate = kSampleRate;
+  format.bitsPerSample = 32;
+
+  std::vector<float> interleaved;
+  for (size_t i = 0; i < channels[0].size(); ++i)
+    for (const auto& channel : channels)
+      interleaved.push_back(channel[i]);
+
+  drwav wav;
+  ASSERT_TRUE(drwav_init_file_write(&wav, path.c_str(), &format, nullptr));
+  drwav_write_pcm_frames(&wav, channels[0].size(), interleaved.data());
+  drwav_uninit(&wav);
+}
+
+Channels readWav(const std::string& path)
+{
+  unsigned int numChannels = 0;
+  unsigned int sampleRate = 0;
+  drwav_uint64 numFrames = 0;
+  float* samples = drwav_open_file_and_read_pcm_frames_f32(path.c_str(), &numChannels,
+                                                           &sampleRate, &numFrames, nullptr);
+  Channels channels(numChannels, std::vector<float>(numFrames));
+  for (drwav_uint64 i = 0; i < numFrames; ++i)
+    for (unsigned int ch = 0; ch < numChannels; ++ch)
+      channels[ch][i] = samples[i * numChannels + ch];
+  drwav_free(samples, nullptr);
+  return channels;
+}
+
+// A decaying tone with a loud and a quiet phrase, so dynamic blending moves.
+std::vector<float> phrase(size_t numFrames, float frequency)
+{
+  std::vector<float> samples(numFrames);
+  for (size_t i = 0; i < numFrames; ++i)
+  {
+    const float level = (i / 6000) % 2 == 0 ? 0.8f : 0.05f;
+    samples[i] = level * std::sin(frequency * static_cast<float>(i));
+  }
+  return samples;
+}
+
+RenderJob makeJob(const std::string& text)
+{
+  RenderJob job;
+  std::string err;
+  EXPECT_TRUE(job.parse(text, "", err)) << err;
+  return job;
+}
+
+void expectIdentical(const Channels& actual, const Channels& expected)
+{
+  ASSERT_EQ(actual.size(), expected.size());
+  for (size_t ch = 0; ch < expected.size(); ++ch)
+  {
+    ASSERT_EQ(actual[ch].size(), expected[ch].size()) << "channel " << ch;
+    for (size_t i = 0; i < expected[ch].size(); ++i)
+      ASSERT_EQ(actual[ch][i], expected[ch][i]) << "channel " << ch << ", frame " << i;
+  }
+}
+
+}  // namespace
+
+// With the engine pinned, a render equals the processor run block by block at the same
+// block size, shifted by its latency.
+TEST(RendererTest, Render_MatchesProcessorAtSameBlockSize)
+{
+  const std::string inputPath = tempPath("match_in.wav");
+  const std::string outputPath = tempPath("match_out.wav");
+  const std::vector<float> input = phrase(20000, 0.03f);
+  writeWav(inputPath, {input});
+
+  const RenderJob job = makeJob("block_size = 512\nengine = pffft\nir_a = " + kIrAPath +
+                                "\ninput = " + inputPath + "\noutput = " + outputPath + "\n");
+  auto renderer = ChainRenderer::create(job);
+  const RenderResult result = renderer->render(job.inputs[0]);
+  ASSERT_TRUE(result.success) << result.errorMessage;
+  EXPECT_EQ(result.numFrames, input.size());
+
+  IRProcessor processor;
+  processor.setSampleRate(kSampleRate);
+  processor.setMaxBlockSize(kBlockSize);
+  processor.setIRAEngine(ConvolutionEngineType::Pffft);
+  std::string err;
+  ASSERT_TRUE(processor.loadImpulseResponse1(kIrAPath, err)) << err;
+  processor.setIRBEnabled(false);
+
+  std::vector<float> padded(input);
+  padded.resize(input.size() + 4 * kBlockSize, 0.0f);
+  std::vector<float> processed(padded.size());
+  for (size_t pos = 0; pos + kBlockSize <= padded.size(); pos += kBlockSize)
+    processor.processMono(padded.data() + pos, processed.data() + pos, kBlockSize);
+  const int latency = processor.getLatencySamples();
+  ASSERT_GT(latency, 0);
+  ASSERT_LE(latency, static_cast<int>(3 * kBlockSize));
+
+  const std::vector<float> expected(processed.begin() + latency,
+                                    processed.begin() + latency + input.size());
+  expectIdentical(readWav(outputPath), {expected});
+}
+
+// Workers reuse one renderer across files; the second file must come out as if it had
+// been rendered by a renderer of its own.
+TEST(RendererTest, Render_ReusedRendererMatchesFreshOne)
+{
+  const std::string firstPath = tempPath("reuse_first.wav");
+  const std::string secondPath = tempPath("reuse_second.wav");
+  writeWav(firstPath, {phrase(30000, 0.02f), phrase(30000, 0.05f)});
+  writeWav(secondPath, {phrase(25000, 0.04f), phrase(25000, 0.01f)});
+
+  const std::string settings = "block_size = 512\nengine = pffft\ndynamicMode = on\n"
+                               "detectionMode = 1\ntail_seconds = 0.25\nir_a = " +
+                               kIrAPath + "\nir_b = " + kIrBPath + "\n";
+  const RenderJob job = makeJob(settings + "input = " + firstPath + "\noutput = " +
+                                tempPath("reuse_first_out.wav") + "\ninput = " + secondPath +
+                                "\noutput = " + tempPath("reuse_second_out.wav") + "\n");
+  auto reused = ChainRenderer::create(job);
+  ASSERT_TRUE(reused->render(job.inputs[0]).success);
+  ASSERT_TRUE(reused->render(job.inputs[1]).success);
+  const Channels afterReuse = readWav(job.inputs[1].outputPath);
+  EXPECT_EQ(afterReuse[0].size(), 25000u + kSampleRate / 4);
+
+  auto fresh = ChainRenderer::create(job);
+  ASSERT_TRUE(fresh->render(job.inputs[1]).success);
+  expectIdentical(afterReuse, readWav(job.inputs[1].outputPath));
+}
+
+TEST(RendererTest, Render_MonoToStereoWritesTwoChannels)
+{
+  const std::string inputPath = tempPath("m2s_in.wav");
+  writeWav(inputPath, {phrase(8000, 0.03f)});
+
+  const RenderJob job = makeJob("mono_to_stereo = on\nir_a = " + kIrAPath + "\ninput = " +
+                                inputPath + "\noutput = " + tempPath("m2s_out.wav") + "\n");
+  ASSERT_TRUE(ChainRenderer::create(job)->render(job.inputs[0]).success);
+  const Channels output = readWav(job.inputs[0].outputPath);
+  ASSERT_EQ(output.size(), 2u);
+  EXPECT_EQ(output[0].size(), 8000u);
+}
+
+TEST(RendererTest, Render_ReportsUnreadableAndUnsupportedInputs)
+{
+  const RenderJob missing = makeJob("ir_a = " + kIrAPath + "\ninput = " +
+                                    tempPath("does_not_exist.wav") + "\n");
+  const RenderResult missingResult = ChainRenderer::create(missing)->render(missing.inputs[0]);
+  EXPECT_FALSE(missingResult.success);
+  EXPECT_FALSE(missingResult.errorMessage.empty());
+
+  const std::string stereoPath = tempPath("bass_stereo.wav");
+  writeWav(stereoPath, {phrase(1000, 0.03f), phrase(1000, 0.03f)});
+  const RenderJob bass = makeJob("chain = octobass\ninput = " + stereoPath + "\noutput = " +
+                                 tempPath("bass_stereo_out.wav") + "\n");
+  const RenderResult bassResult = ChainRenderer::create(bass)->render(bass.inputs[0]);
+  EXPECT_FALSE(bassResult.success) << "OctoBASS is mono only";
+}
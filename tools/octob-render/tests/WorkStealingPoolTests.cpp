@@ -0,0 +1,77 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "WorkStealingPool.hpp"
+
+using namespace octob;
+
+TEST(WorkStealingPoolTest, RunsEveryIndexOnce)
+{
+  WorkStealingPool pool(4);
+  std::vector<std::atomic<int>> runs(1000);
+  pool.run(runs.size(), [&](int, size_t index) { runs[index]++; });
+
+  for (size_t i = 0; i < runs.size(); ++i)
+    EXPECT_EQ(runs[i].load(), 1) << "index " << i;
+}
+
+TEST(WorkStealingPoolTest, SingleWorkerRunsOnCallingThread)
+{
+  WorkStealingPool pool(0);
+  EXPECT_EQ(pool.getNumWorkers(), 1);
+
+  const auto caller = std::this_thread::get_id();
+  bool allOnCaller = true;
+  std::vector<size_t> order;
+  pool.run(5,
+           [&](int worker, size_t index)
+           {
+             allOnCaller = allOnCaller && worker == 0 && std::this_thread::get_id() == caller;
+             order.push_back(index);
+           });
+  EXPECT_TRUE(allOnCaller);
+  EXPECT_EQ(order, (std::vector<size_t>{0, 1, 2, 3, 4}));
+}
+
+// Index 0 is dealt to worker 0 along with every other even index. While it is blocked
+// on index 0, worker 1 has to steal the even indices for the batch to finish.
+TEST(WorkStealingPoolTest, IdleWorkerStealsFromBusyOne)
+{
+  constexpr size_t kCount = 20;
+  WorkStealingPool pool(2);
+  std::mutex mutex;
+  std::condition_variable allOthersDone;
+  size_t completed = 0;
+  bool othersFinished = false;
+
+  pool.run(kCount,
+           [&](int, size_t index)
+           {
+             std::unique_lock<std::mutex> lock(mutex);
+             if (index == 0)
+             {
+               othersFinished = allOthersDone.wait_for(lock, std::chrono::seconds(10),
+                                                       [&] { return completed == kCount - 1; });
+               return;
+             }
+             if (++completed == kCount - 1)
+               allOthersDone.notify_all();
+           });
+
+  EXPECT_TRUE(othersFinished);
+}
+
+TEST(WorkStealingPoolTest, PoolCanRunSeveralBatches)
+{
+  WorkStealingPool pool(3);
+  std::atomic<int> total{0};
+  pool.run(10, [&](int, size_t) { total++; });
+  pool.run(7, [&](int, size_t) { total++; });
+  EXPECT_EQ(total.load(), 17);
+}